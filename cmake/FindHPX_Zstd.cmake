@@ -0,0 +1,14 @@
+# Copyright (c) 2014 Hartmut Kaiser
+#
+# Distributed under the Boost Software License, Version 1.0. (See accompanying
+# file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+if(NOT HPX_FINDPACKAGE_LOADED)
+  include(HPX_FindPackage)
+endif()
+
+hpx_find_package(ZSTD
+  LIBRARIES zstd libzstd
+  LIBRARY_PATHS lib64 lib
+  HEADERS zstd.h
+  HEADER_PATHS include)
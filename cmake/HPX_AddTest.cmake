@@ -65,6 +65,11 @@ macro(add_hpx_test category name)
           NAME "${category}.distributed.mpi.${name}"
           COMMAND ${cmd} "-p" "mpi" "-r" "mpi" ${args})
       endif()
+      if(HPX_HAVE_PARCELPORT_SHMEM)
+        add_test(
+          NAME "${category}.distributed.shmem.${name}"
+          COMMAND ${cmd} "-p" "shmem" ${args})
+      endif()
       if(HPX_HAVE_PARCELPORT_TCP)
         add_test(
           NAME "${category}.distributed.tcp.${name}"
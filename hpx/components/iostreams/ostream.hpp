@@ -9,17 +9,23 @@
 
 #include <hpx/hpx_fwd.hpp>
 #include <hpx/lcos/local/recursive_mutex.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/runtime/threads/thread_specific_ptr.hpp>
+#include <hpx/util/interval_timer.hpp>
 
 #include <iterator>
 #include <ios>
+#include <vector>
 
 #include <boost/swap.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <hpx/state.hpp>
 #include <hpx/include/client.hpp>
+#include <hpx/components/iostreams/export_definitions.hpp>
 #include <hpx/components/iostreams/manipulators.hpp>
 #include <hpx/components/iostreams/stubs/output_stream.hpp>
 #include <hpx/util/move.hpp>
@@ -67,6 +73,55 @@ namespace hpx { namespace iostreams
             ostream& os_;
         };
 
+        ///////////////////////////////////////////////////////////////////////
+        struct thread_stream;
+
+        /// This is a Boost.IoStreams Sink writing to the buffer of a
+        /// thread_stream.
+        template <typename Char = char>
+        struct thread_buffer_sink
+        {
+            typedef Char char_type;
+
+            struct category
+              : boost::iostreams::sink_tag,
+                boost::iostreams::flushable_tag
+            {};
+
+            explicit thread_buffer_sink(thread_stream& ts)
+              : ts_(ts)
+            {}
+
+            inline std::streamsize write(char_type const* s, std::streamsize n);
+            inline bool flush();
+
+        private:
+            thread_stream& ts_;
+        };
+
+        /// Each HPX thread writes to its own (unbuffered) stream, which
+        /// avoids acquiring the lock shared by all threads for every
+        /// streaming operation. Flushing the stream moves the collected
+        /// output to the current batch of the owning ostream. The stream is
+        /// bound to the HPX thread (not to the worker thread it runs on), so
+        /// output of threads which are suspended in the middle of a line
+        /// is never mixed with the output of other threads.
+        struct thread_stream
+          : buffer
+          , boost::iostreams::stream<thread_buffer_sink<char> >
+        {
+            typedef boost::iostreams::stream<thread_buffer_sink<char> >
+                stream_base_type;
+
+            explicit thread_stream(ostream& os)
+              : buffer()
+              , stream_base_type(thread_buffer_sink<char>(*this), 0)
+              , os_(os)
+            {}
+
+            ostream& os_;
+        };
+
         ///////////////////////////////////////////////////////////////////////
         template <typename Char = char>
         struct ostream_creator
@@ -82,6 +137,9 @@ namespace hpx { namespace iostreams
 
         void register_ostreams();
         void unregister_ostreams();
+
+        // performance counters for the output forwarded to the console
+        HPX_IOSTREAMS_EXPORT void register_counter_types();
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -99,112 +157,132 @@ namespace hpx { namespace iostreams
         HPX_MOVABLE_BUT_NOT_COPYABLE(ostream);
 
     private:
+        typedef lcos::local::spinlock batch_mutex_type;
+
         mutex_type mtx_;
         boost::atomic<boost::uint64_t> generational_count_;
 
+        // Output is forwarded to the console in batches. Each flush of a
+        // stream appends the output written so far to the current batch as
+        // one message. The batch is sent whenever it grows larger than
+        // batch_size_ bytes, after batch_interval milliseconds, or on a
+        // synchronous flush. The timer is started only once a batch becomes
+        // non-empty.
+        batch_mutex_type batch_mtx_;
+        detail::buffer batch_;
+        std::size_t batch_messages_;
+        std::size_t batch_size_;
+
+        boost::shared_ptr<util::interval_timer> timer_;
+
+#if HPX_THREAD_MAINTAIN_LOCAL_STORAGE
+        threads::thread_specific_ptr<detail::thread_stream> thread_stream_;
+#endif
+
+        // Return the stream of the calling HPX thread, returns zero if this
+        // is not called on an HPX thread or if batching is disabled.
+        detail::thread_stream* get_thread_stream()
+        {
+#if HPX_THREAD_MAINTAIN_LOCAL_STORAGE
+            if (0 == batch_size_ || 0 == threads::get_self_ptr())
+                return 0;
+
+            detail::thread_stream* ts = thread_stream_.get();
+            if (0 == ts)
+            {
+                ts = new detail::thread_stream(*this);
+                thread_stream_.reset(ts);
+            }
+            return ts;
+#else
+            return 0;
+#endif
+        }
+
+        // Move the remaining output of an exiting HPX thread to the current
+        // batch.
+        HPX_IOSTREAMS_EXPORT static void release_thread_stream(
+            detail::thread_stream* ts);
+
         // Performs a lazy streaming operation.
         template <typename T>
         ostream& streaming_operator_lazy(T const& subject)
         { // {{{
+            // apply the subject to the stream of the calling HPX thread
+            detail::thread_stream* ts = get_thread_stream();
+            if (0 != ts)
+            {
+                *static_cast<detail::thread_stream::stream_base_type*>(ts)
+                    << subject;
+                return *this;
+            }
+
             // apply the subject to the local stream
+            mutex_type::scoped_lock l(mtx_);
             *static_cast<stream_base_type*>(this) << subject;
             return *this;
         } // }}}
 
         // Performs an asynchronous streaming operation.
-        template <typename T, typename Lock>
-        ostream& streaming_operator_async(T const& subject, Lock& l)
+        template <typename T>
+        ostream& streaming_operator_async(T const& subject)
         { // {{{
-            // apply the subject to the local stream
-            *static_cast<stream_base_type*>(this) << subject;
-
-            // If the buffer isn't empty, send it asynchronously to the
-            // destination.
-            if (!this->detail::buffer::empty())
-            {
-                // Create the next buffer, returns the previous buffer
-                buffer next = this->detail::buffer::init();
-
-                // Unlock the mutex before we cleanup.
-                l.unlock();
-
-                // Perform the write operation, then destroy the old buffer and
-                // stream.
-                this->base_type::write_async(get_gid(), hpx::get_locality_id(),
-                    generational_count_++, next);
-            }
+            // apply the subject, this moves the output to the current batch
+            streaming_operator_lazy(subject);
 
+            // send the batch asynchronously if it has grown large enough
+            send_batch(false, batch_size_);
             return *this;
         } // }}}
 
         // Performs a synchronous streaming operation.
-        template <typename T, typename Lock>
-        ostream& streaming_operator_sync(T const& subject, Lock& l)
+        template <typename T>
+        ostream& streaming_operator_sync(T const& subject)
         { // {{{
-            // apply the subject to the local stream
-            *static_cast<stream_base_type*>(this) << subject;
-
-            // If the buffer isn't empty, send it to the destination.
-            if (!this->detail::buffer::empty())
-            {
-                // Create the next buffer, returns the previous buffer
-                buffer next = this->detail::buffer::init();
-
-                // Unlock the mutex before we cleanup.
-                l.unlock();
-
-                // Perform the write operation, then destroy the old buffer and
-                // stream.
-                this->base_type::write_sync(get_gid(), hpx::get_locality_id(),
-                    generational_count_++, next);
-            }
+            // apply the subject, this moves the output to the current batch
+            streaming_operator_lazy(subject);
 
+            // send the batch and wait for it to be written
+            send_batch(true);
             return *this;
         } // }}}
 
         ///////////////////////////////////////////////////////////////////////
         friend struct detail::buffer_sink<char>;
+        friend struct detail::thread_buffer_sink<char>;
 
         bool flush()
         {
             mutex_type::scoped_lock l(mtx_);
-            if (!this->detail::buffer::empty())
-            {
-                // Create the next buffer, returns the previous buffer
-                buffer next = this->detail::buffer::init();
-
-                // Unlock the mutex before we cleanup.
-                l.unlock();
-
-                // Perform the write operation, then destroy the old buffer and
-                // stream.
-                this->base_type::write_async(get_gid(), hpx::get_locality_id(),
-                    generational_count_++, next);
-            }
+            enqueue(*this);
             return true;
         }
 
+        // Append the content of the given buffer to the current batch.
+        HPX_IOSTREAMS_EXPORT void enqueue(detail::buffer& b);
+
+        // Send the current batch to the destination if it holds at least
+        // min_size bytes.
+        HPX_IOSTREAMS_EXPORT void send_batch(bool sync,
+            std::size_t min_size = 0);
+
         ///////////////////////////////////////////////////////////////////////
         friend void detail::register_ostreams();
         friend void detail::unregister_ostreams();
 
+        HPX_IOSTREAMS_EXPORT void init_batching();
+        HPX_IOSTREAMS_EXPORT bool send_pending_batch();
+
         // late initialization during runtime system startup
         template <typename Tag>
         void initialize(Tag tag)
         {
             *static_cast<base_type*>(this) = detail::create_ostream(tag);
+            init_batching();
         }
 
         // reset this object during runtime system shutdown
-        void uninitialize()
-        {
-            mutex_type::scoped_lock l(mtx_, boost::try_to_lock);
-            if (l)
-            {
-                streaming_operator_sync(hpx::async_flush, l);   // unlocks l
-            }
-            this->base_type::free();
-        }
+        HPX_IOSTREAMS_EXPORT void uninitialize();
 
     public:
         ostream()
@@ -212,45 +290,50 @@ namespace hpx { namespace iostreams
           , buffer()
           , stream_base_type(*this)
           , generational_count_(0)
+          , batch_messages_(0)
+          , batch_size_(0)
+#if HPX_THREAD_MAINTAIN_LOCAL_STORAGE
+          , thread_stream_(&ostream::release_thread_stream)
+#endif
         {}
 
         // hpx::flush manipulator
         ostream& operator<<(hpx::iostreams::flush_type const& m)
         {
-            mutex_type::scoped_lock l(mtx_);
-            return streaming_operator_sync(m, l);
+            return streaming_operator_sync(m);
         }
 
         // hpx::endl manipulator
         ostream& operator<<(hpx::iostreams::endl_type const& m)
         {
-            mutex_type::scoped_lock l(mtx_);
-            return streaming_operator_sync(m, l);
+            return streaming_operator_sync(m);
         }
 
         // hpx::async_flush manipulator
         ostream& operator<<(hpx::iostreams::async_flush_type const& m)
         {
-            mutex_type::scoped_lock l(mtx_);
-            return streaming_operator_async(m, l);
+            return streaming_operator_async(m);
         }
 
         // hpx::async_endl manipulator
         ostream& operator<<(hpx::iostreams::async_endl_type const& m)
         {
-            mutex_type::scoped_lock l(mtx_);
-            return streaming_operator_async(m, l);
+            return streaming_operator_async(m);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // std::endl, std::flush, etc.
+        ostream& operator<<(std::ostream& (*manip)(std::ostream&))
+        {
+            return streaming_operator_lazy(manip);
         }
 
         ///////////////////////////////////////////////////////////////////////
         template <typename T>
         ostream& operator<<(T const& subject)
         {
-            mutex_type::scoped_lock l(mtx_);
             return streaming_operator_lazy(subject);
         }
-
-        using stream_base_type::operator<<;
     };
 
     ///////////////////////////////////////////////////////////////////////////
@@ -268,6 +351,20 @@ namespace hpx { namespace iostreams
         {
             return os_.flush();
         }
+
+        template <typename Char>
+        inline std::streamsize thread_buffer_sink<Char>::write(
+            Char const* s, std::streamsize n)
+        {
+            return static_cast<buffer&>(ts_).write(s, n);
+        }
+
+        template <typename Char>
+        inline bool thread_buffer_sink<Char>::flush()
+        {
+            ts_.os_.enqueue(ts_);
+            return true;
+        }
     }
 }}
 
@@ -43,6 +43,12 @@ namespace hpx { namespace iostreams { namespace detail
             return !data_.get() || data_->empty();
         }
 
+        std::size_t size() const
+        {
+            mutex_type::scoped_lock l(mtx_);
+            return data_.get() ? data_->size() : 0;
+        }
+
         buffer init()
         {
             mutex_type::scoped_lock l(mtx_);
@@ -60,6 +66,19 @@ namespace hpx { namespace iostreams { namespace detail
             return n;
         }
 
+        // append the data stored in the given buffer, which must not be
+        // modified concurrently (as returned from init())
+        void append(buffer const& rhs)
+        {
+            if (rhs.empty())
+                return;
+
+            mutex_type::scoped_lock l(mtx_);
+            if (!data_.get())
+                data_.reset(new std::vector<char>);
+            data_->insert(data_->end(), rhs.data_->begin(), rhs.data_->end());
+        }
+
         template <typename Mutex>
         void write(write_function_type const& f, Mutex& mtx)
         {
@@ -22,9 +22,18 @@
 #include <hpx/util/function.hpp>
 #include <hpx/include/lcos.hpp>
 #include <hpx/include/util.hpp>
+#include <hpx/include/parallel_copy.hpp>
+#include <hpx/include/parallel_count.hpp>
+#include <hpx/include/parallel_fill.hpp>
+#include <hpx/include/parallel_find.hpp>
+#include <hpx/include/parallel_for_each.hpp>
+#include <hpx/include/parallel_reduce.hpp>
+#include <hpx/include/parallel_transform.hpp>
 
 #include <vector>
 
+#include <boost/serialization/vector.hpp>
+
 #include <boost/assign/std.hpp>
 
 /** @brief Defines the type of value stored by elements in the chunk_vector.*/
@@ -380,9 +389,10 @@ namespace hpx
                                 size_type last,
                                 hpx::util::function<void(VALUE_TYPE &)> fn)
             {
-                std::for_each( chunk_vector_.begin() + first,
-                               chunk_vector_.begin() + last,
-                               fn);
+                hpx::parallel::for_each(hpx::parallel::par,
+                                        chunk_vector_.begin() + first,
+                                        chunk_vector_.begin() + last,
+                                        fn);
             }
 
             /** @brief Apply the function \a fn to each element in the range
@@ -404,9 +414,152 @@ namespace hpx
                                 hpx::util::function<void(VALUE_TYPE const&)> fn
                                       ) const
             {
-                std::for_each( chunk_vector_.begin() + first,
-                               chunk_vector_.begin() + last,
-                               fn);
+                hpx::parallel::for_each(hpx::parallel::par,
+                                        chunk_vector_.begin() + first,
+                                        chunk_vector_.begin() + last,
+                                        fn);
+            }
+
+            /** @brief Assign \a val to each element in the range [first, last).
+             *
+             *  @param first    Initial position of the element in the sequence
+             *  @param last     Final position of the element in the sequence
+             *                   [Note the last element is not inclusive in the
+             *                   range[first, last)]
+             *  @param val      Value to be assigned
+             */
+            void chunk_fill(size_type first, size_type last, VALUE_TYPE val)
+            {
+                hpx::parallel::fill(hpx::parallel::par,
+                                    chunk_vector_.begin() + first,
+                                    chunk_vector_.begin() + last,
+                                    val);
+            }
+
+            /** @brief Count the elements equal to \a val in the range
+             *          [first, last).
+             *
+             *  @return Number of elements equal to \a val
+             */
+            size_type chunk_count(size_type first,
+                                  size_type last,
+                                  VALUE_TYPE val) const
+            {
+                return static_cast<size_type>(
+                    hpx::parallel::count(hpx::parallel::par,
+                                         chunk_vector_.begin() + first,
+                                         chunk_vector_.begin() + last,
+                                         val));
+            }
+
+            /** @brief Count the elements in the range [first, last) for which
+             *          \a fn returns true.
+             *
+             *  @return Number of elements satisfying \a fn
+             */
+            size_type chunk_count_if(
+                                size_type first,
+                                size_type last,
+                                hpx::util::function<bool(VALUE_TYPE const&)> fn
+                                    ) const
+            {
+                return static_cast<size_type>(
+                    hpx::parallel::count_if(hpx::parallel::par,
+                                            chunk_vector_.begin() + first,
+                                            chunk_vector_.begin() + last,
+                                            fn));
+            }
+
+            /** @brief Reduce the elements in the non-empty range [first, last)
+             *          using the binary function \a fn.
+             *
+             *  @return The first element combined with all others using \a fn
+             */
+            VALUE_TYPE chunk_reduce(
+                    size_type first,
+                    size_type last,
+                    hpx::util::function<
+                        VALUE_TYPE(VALUE_TYPE const&, VALUE_TYPE const&)
+                                       > fn) const
+            {
+                HPX_ASSERT(first < last);
+                return hpx::parallel::reduce(hpx::parallel::par,
+                                             chunk_vector_.begin() + first + 1,
+                                             chunk_vector_.begin() + last,
+                                             chunk_vector_[first],
+                                             fn);
+            }
+
+            /** @brief Sum up the elements in the range [first, last).
+             *
+             *  @return The sum of all elements
+             */
+            VALUE_TYPE chunk_sum(size_type first, size_type last) const
+            {
+                return hpx::parallel::reduce(hpx::parallel::par,
+                                             chunk_vector_.begin() + first,
+                                             chunk_vector_.begin() + last,
+                                             VALUE_TYPE());
+            }
+
+            /** @brief Find the first element equal to \a val in the range
+             *          [first, last).
+             *
+             *  @return The offset of the element relative to \a first or
+             *           (last - first) if there is no such element
+             */
+            size_type chunk_find(size_type first,
+                                 size_type last,
+                                 VALUE_TYPE val) const
+            {
+                return static_cast<size_type>(
+                    std::distance(chunk_vector_.begin() + first,
+                        hpx::parallel::find(hpx::parallel::par,
+                                            chunk_vector_.begin() + first,
+                                            chunk_vector_.begin() + last,
+                                            val)));
+            }
+
+            /** @brief Apply the function \a fn to each element in the range
+             *          [first, last).
+             *
+             *  @return The results of \a fn in the order of the elements
+             */
+            std::vector<VALUE_TYPE> chunk_transform(
+                    size_type first,
+                    size_type last,
+                    hpx::util::function<VALUE_TYPE(VALUE_TYPE const&)> fn
+                                                   ) const
+            {
+                std::vector<VALUE_TYPE> result(last - first);
+                hpx::parallel::transform(hpx::parallel::par,
+                                         chunk_vector_.begin() + first,
+                                         chunk_vector_.begin() + last,
+                                         result.begin(),
+                                         fn);
+                return result;
+            }
+
+            /** @brief Return the copy of the elements in the range
+             *          [first, last).
+             */
+            std::vector<VALUE_TYPE> chunk_get_values(size_type first,
+                                                     size_type last) const
+            {
+                return std::vector<VALUE_TYPE>(chunk_vector_.begin() + first,
+                                               chunk_vector_.begin() + last);
+            }
+
+            /** @brief Copy \a values into the elements starting at position
+             *          \a first.
+             */
+            void chunk_set_values(size_type first,
+                                  std::vector<VALUE_TYPE> const& values)
+            {
+                HPX_ASSERT(first + values.size() <= chunk_vector_.size());
+                hpx::parallel::copy(hpx::parallel::par,
+                                    values.begin(), values.end(),
+                                    chunk_vector_.begin() + first);
             }
 
             //
@@ -498,6 +651,43 @@ namespace hpx
              */
             HPX_DEFINE_COMPONENT_CONST_ACTION(chunk_vector, chunk_for_each_const);
 
+            /** @brief Macro to define \a chunk_fill function as HPX component
+             *          action type.
+             */
+            HPX_DEFINE_COMPONENT_ACTION(chunk_vector, chunk_fill);
+            /** @brief Macro to define \a chunk_count function as HPX component
+             *          action type.
+             */
+            HPX_DEFINE_COMPONENT_CONST_ACTION(chunk_vector, chunk_count);
+            /** @brief Macro to define \a chunk_count_if function as HPX
+             *          component action type.
+             */
+            HPX_DEFINE_COMPONENT_CONST_ACTION(chunk_vector, chunk_count_if);
+            /** @brief Macro to define \a chunk_reduce function as HPX
+             *          component action type.
+             */
+            HPX_DEFINE_COMPONENT_CONST_ACTION(chunk_vector, chunk_reduce);
+            /** @brief Macro to define \a chunk_sum function as HPX component
+             *          action type.
+             */
+            HPX_DEFINE_COMPONENT_CONST_ACTION(chunk_vector, chunk_sum);
+            /** @brief Macro to define \a chunk_find function as HPX component
+             *          action type.
+             */
+            HPX_DEFINE_COMPONENT_CONST_ACTION(chunk_vector, chunk_find);
+            /** @brief Macro to define \a chunk_transform function as HPX
+             *          component action type.
+             */
+            HPX_DEFINE_COMPONENT_CONST_ACTION(chunk_vector, chunk_transform);
+            /** @brief Macro to define \a chunk_get_values function as HPX
+             *          component action type.
+             */
+            HPX_DEFINE_COMPONENT_CONST_ACTION(chunk_vector, chunk_get_values);
+            /** @brief Macro to define \a chunk_set_values function as HPX
+             *          component action type.
+             */
+            HPX_DEFINE_COMPONENT_ACTION(chunk_vector, chunk_set_values);
+
 
         private:
             /** @brief It it the std::vector of VALUE_TYPE. */
@@ -1025,6 +1215,141 @@ namespace hpx
 
             }//end of chunk_vector_for_each_const_async
 
+            /** @brief Assign \a val to each element in the range [first, last)
+             *          in chunk_vector component.
+             */
+            static void_future chunk_fill_async(hpx_id const& gid,
+                                                size_type first,
+                                                size_type last,
+                                                VALUE_TYPE val)
+            {
+                return hpx::async<base_type::chunk_fill_action>(gid,
+                                                                first,
+                                                                last,
+                                                                val);
+            }//end of chunk_fill_async
+
+            /** @brief Count the elements equal to \a val in the range
+             *          [first, last) in chunk_vector component.
+             */
+            static size_future chunk_count_async(hpx_id const& gid,
+                                                 size_type first,
+                                                 size_type last,
+                                                 VALUE_TYPE val)
+            {
+                return hpx::async<base_type::chunk_count_action>(gid,
+                                                                 first,
+                                                                 last,
+                                                                 val);
+            }//end of chunk_count_async
+
+            /** @brief Count the elements in the range [first, last) in
+             *          chunk_vector component for which \a fn returns true.
+             */
+            static size_future chunk_count_if_async(
+                                            hpx_id const& gid,
+                                            size_type first,
+                                            size_type last,
+                                            hpx::util::function<
+                                                bool(VALUE_TYPE const&)
+                                                                > fn)
+            {
+                return hpx::async<base_type::chunk_count_if_action>(gid,
+                                                                    first,
+                                                                    last,
+                                                                    fn);
+            }//end of chunk_count_if_async
+
+            /** @brief Reduce the elements in the non-empty range [first, last)
+             *          in chunk_vector component using \a fn.
+             */
+            static value_future chunk_reduce_async(
+                                            hpx_id const& gid,
+                                            size_type first,
+                                            size_type last,
+                                            hpx::util::function<
+                                                VALUE_TYPE(VALUE_TYPE const&,
+                                                           VALUE_TYPE const&)
+                                                                > fn)
+            {
+                return hpx::async<base_type::chunk_reduce_action>(gid,
+                                                                  first,
+                                                                  last,
+                                                                  fn);
+            }//end of chunk_reduce_async
+
+            /** @brief Sum up the elements in the range [first, last) in
+             *          chunk_vector component.
+             */
+            static value_future chunk_sum_async(hpx_id const& gid,
+                                                size_type first,
+                                                size_type last)
+            {
+                return hpx::async<base_type::chunk_sum_action>(gid,
+                                                               first,
+                                                               last);
+            }//end of chunk_sum_async
+
+            /** @brief Find the first element equal to \a val in the range
+             *          [first, last) in chunk_vector component.
+             *
+             * @return The offset of the element relative to \a first or
+             *          (last - first) if there is no such element
+             */
+            static size_future chunk_find_async(hpx_id const& gid,
+                                                size_type first,
+                                                size_type last,
+                                                VALUE_TYPE val)
+            {
+                return hpx::async<base_type::chunk_find_action>(gid,
+                                                                first,
+                                                                last,
+                                                                val);
+            }//end of chunk_find_async
+
+            /** @brief Apply \a fn to each element in the range [first, last)
+             *          in chunk_vector component and return the results.
+             */
+            static hpx::lcos::future<std::vector<VALUE_TYPE> >
+            chunk_transform_async(hpx_id const& gid,
+                                  size_type first,
+                                  size_type last,
+                                  hpx::util::function<
+                                      VALUE_TYPE(VALUE_TYPE const&)
+                                                     > fn)
+            {
+                return hpx::async<base_type::chunk_transform_action>(gid,
+                                                                     first,
+                                                                     last,
+                                                                     fn);
+            }//end of chunk_transform_async
+
+            /** @brief Return the copy of the elements in the range
+             *          [first, last) in chunk_vector component.
+             */
+            static hpx::lcos::future<std::vector<VALUE_TYPE> >
+            chunk_get_values_async(hpx_id const& gid,
+                                   size_type first,
+                                   size_type last)
+            {
+                return hpx::async<base_type::chunk_get_values_action>(gid,
+                                                                      first,
+                                                                      last);
+            }//end of chunk_get_values_async
+
+            /** @brief Copy \a values into the elements of chunk_vector
+             *          component starting at position \a first.
+             */
+            static void_future chunk_set_values_async(
+                                        hpx_id const& gid,
+                                        size_type first,
+                                        std::vector<VALUE_TYPE> const& values)
+            {
+                return hpx::async<base_type::chunk_set_values_action>(gid,
+                                                                      first,
+                                                                      values);
+            }//end of chunk_set_values_async
+
         };//end of struct chunk_vector(stubs)
 
     }//end of the namespace stubs
@@ -1358,6 +1683,60 @@ HPX_REGISTER_ACTION_DECLARATION(
 HPX_REGISTER_ACTION_DECLARATION(
     hpx::server::chunk_vector::chunk_for_each_const_action,
     chunk_vector_chunk_for_each_const_action);
+/** @brief Macro to register \a chunk_fill component action type with HPX
+ *          AGAS.
+ */
+HPX_REGISTER_ACTION_DECLARATION(
+    hpx::server::chunk_vector::chunk_fill_action,
+    chunk_vector_chunk_fill_action);
+/** @brief Macro to register \a chunk_count component action type with HPX
+ *          AGAS.
+ */
+HPX_REGISTER_ACTION_DECLARATION(
+    hpx::server::chunk_vector::chunk_count_action,
+    chunk_vector_chunk_count_action);
+/** @brief Macro to register \a chunk_count_if component action type with HPX
+ *          AGAS.
+ */
+HPX_REGISTER_ACTION_DECLARATION(
+    hpx::server::chunk_vector::chunk_count_if_action,
+    chunk_vector_chunk_count_if_action);
+/** @brief Macro to register \a chunk_reduce component action type with HPX
+ *          AGAS.
+ */
+HPX_REGISTER_ACTION_DECLARATION(
+    hpx::server::chunk_vector::chunk_reduce_action,
+    chunk_vector_chunk_reduce_action);
+/** @brief Macro to register \a chunk_sum component action type with HPX
+ *          AGAS.
+ */
+HPX_REGISTER_ACTION_DECLARATION(
+    hpx::server::chunk_vector::chunk_sum_action,
+    chunk_vector_chunk_sum_action);
+/** @brief Macro to register \a chunk_find component action type with HPX
+ *          AGAS.
+ */
+HPX_REGISTER_ACTION_DECLARATION(
+    hpx::server::chunk_vector::chunk_find_action,
+    chunk_vector_chunk_find_action);
+/** @brief Macro to register \a chunk_transform component action type with HPX
+ *          AGAS.
+ */
+HPX_REGISTER_ACTION_DECLARATION(
+    hpx::server::chunk_vector::chunk_transform_action,
+    chunk_vector_chunk_transform_action);
+/** @brief Macro to register \a chunk_get_values component action type with HPX
+ *          AGAS.
+ */
+HPX_REGISTER_ACTION_DECLARATION(
+    hpx::server::chunk_vector::chunk_get_values_action,
+    chunk_vector_chunk_get_values_action);
+/** @brief Macro to register \a chunk_set_values component action type with HPX
+ *          AGAS.
+ */
+HPX_REGISTER_ACTION_DECLARATION(
+    hpx::server::chunk_vector::chunk_set_values_action,
+    chunk_vector_chunk_set_values_action);
 
 		
 #endif // CHUNK_VECTOR_COMPONENT_HPP
@@ -27,6 +27,11 @@
 #include <boost/integer.hpp>
 
 #include <hpx/components/vector/chunk_vector_component.hpp>
+#include <hpx/parallel/segmented_iterator_traits.hpp>
+
+#include <functional>
+#include <iterator>
+#include <vector>
 
 #define VALUE_TYPE double
 
@@ -56,6 +61,14 @@ namespace hpx
     public:
         typedef std::size_t             size_type;
 
+        // standard iterator typedefs, these allow to use the iterator with
+        // the parallel algorithms (see hpx/parallel/algorithm.hpp)
+        typedef std::bidirectional_iterator_tag     iterator_category;
+        typedef VALUE_TYPE                          value_type;
+        typedef std::ptrdiff_t                      difference_type;
+        typedef VALUE_TYPE const*                   pointer;
+        typedef VALUE_TYPE                          reference;
+
     private:
         // This typedef helps to call object of same class.
         typedef const_segmented_vector_iterator     self_type;
@@ -810,4 +823,206 @@ namespace hpx
 
 }//end of hpx namespace
 
+namespace hpx { namespace parallel { namespace traits
+{
+    namespace detail
+    {
+        // PROGRAMMER DOCUMENTATION:
+        //  This represent the part [first_, last_) of the chunk_vector
+        //  component referred to by the (base_index, gid) pair bfg_.
+        struct vector_segment
+        {
+            typedef std::vector<
+                    std::pair<std::size_t,
+                        hpx::lcos::shared_future<hpx::naming::id_type> >
+                > vector_type;
+
+            vector_type::const_iterator     bfg_;
+            hpx::naming::id_type            id_;
+            std::size_t                     first_;
+            std::size_t                     last_;
+        };
+
+        // PROGRAMMER DOCUMENTATION:
+        //  The segmented iterator interface used by the parallel algorithms
+        //  (see hpx/parallel/segmented_iterator_traits.hpp). Every segment
+        //  operation is executed by the chunk_vector component owning the
+        //  segment.
+        template <typename Iterator>
+        struct vector_segmented_iterator_traits
+        {
+            typedef boost::mpl::true_   is_segmented_iterator;
+            typedef VALUE_TYPE          value_type;
+            typedef vector_segment      segment_type;
+
+            typedef hpx::stubs::chunk_vector chunk_vector_stubs;
+            typedef segment_type::vector_type::const_iterator bfg_iterator;
+
+            static std::vector<segment_type>
+            segments(Iterator first, Iterator last)
+            {
+                bfg_iterator sfirst = Iterator::segment(first);
+                bfg_iterator slast = Iterator::segment(last);
+
+                std::vector<segment_type> result;
+                if (sfirst == slast)
+                {
+                    add_segment(result, sfirst, Iterator::local(first).second,
+                        Iterator::local(last).second);
+                    return result;
+                }
+
+                // query the sizes of all touched chunks concurrently
+                std::vector<hpx::lcos::future<std::size_t> > sizes;
+                for (bfg_iterator it = sfirst; it != slast; ++it)
+                {
+                    sizes.push_back(
+                        chunk_vector_stubs::size_async(it->second.get()));
+                }
+
+                add_segment(result, sfirst, Iterator::local(first).second,
+                    sizes[0].get());
+                std::size_t i = 1;
+                for (bfg_iterator it = sfirst + 1; it != slast; ++it, ++i)
+                    add_segment(result, it, 0, sizes[i].get());
+                add_segment(result, slast, 0, Iterator::local(last).second);
+
+                return result;
+            }
+
+            static std::size_t size(segment_type const& seg)
+            {
+                return seg.last_ - seg.first_;
+            }
+
+            static segment_type subrange(segment_type const& seg,
+                std::size_t offset, std::size_t count)
+            {
+                segment_type result = seg;
+                result.first_ = seg.first_ + offset;
+                result.last_ = result.first_ + count;
+                return result;
+            }
+
+            static Iterator compose(segment_type const& seg,
+                std::size_t offset)
+            {
+                return Iterator(seg.bfg_, seg.first_ + offset, hpx::valid);
+            }
+
+            static hpx::lcos::future<std::size_t>
+            count(segment_type const& seg, value_type const& val)
+            {
+                return chunk_vector_stubs::chunk_count_async(
+                    seg.id_, seg.first_, seg.last_, val);
+            }
+
+            template <typename F>
+            static hpx::lcos::future<std::size_t>
+            count_if(segment_type const& seg, F const& f)
+            {
+                return chunk_vector_stubs::chunk_count_if_async(
+                    seg.id_, seg.first_, seg.last_, f);
+            }
+
+            template <typename F>
+            static hpx::lcos::future<value_type>
+            reduce(segment_type const& seg, F const& f)
+            {
+                return chunk_vector_stubs::chunk_reduce_async(
+                    seg.id_, seg.first_, seg.last_, f);
+            }
+
+            // std::plus can't be sent to the chunk, use the dedicated action
+            static hpx::lcos::future<value_type>
+            reduce(segment_type const& seg, std::plus<value_type> const&)
+            {
+                return chunk_vector_stubs::chunk_sum_async(
+                    seg.id_, seg.first_, seg.last_);
+            }
+
+            static hpx::lcos::future<std::size_t>
+            find(segment_type const& seg, value_type const& val)
+            {
+                return chunk_vector_stubs::chunk_find_async(
+                    seg.id_, seg.first_, seg.last_, val);
+            }
+
+            template <typename F>
+            static hpx::lcos::future<std::vector<value_type> >
+            transform(segment_type const& seg, F const& f)
+            {
+                return chunk_vector_stubs::chunk_transform_async(
+                    seg.id_, seg.first_, seg.last_, f);
+            }
+
+            static hpx::lcos::future<std::vector<value_type> >
+            get_values(segment_type const& seg)
+            {
+                return chunk_vector_stubs::chunk_get_values_async(
+                    seg.id_, seg.first_, seg.last_);
+            }
+
+        private:
+            static void add_segment(std::vector<segment_type>& segments,
+                bfg_iterator bfg, std::size_t first, std::size_t last)
+            {
+                // empty parts of the chunks are skipped
+                if (first == last)
+                    return;
+
+                segment_type seg;
+                seg.bfg_ = bfg;
+                seg.id_ = bfg->second.get();
+                seg.first_ = first;
+                seg.last_ = last;
+                segments.push_back(seg);
+            }
+        };
+    }
+
+    template <>
+    struct segmented_iterator_traits<hpx::const_segmented_vector_iterator>
+      : detail::vector_segmented_iterator_traits<
+            hpx::const_segmented_vector_iterator>
+    {
+        template <typename F>
+        static hpx::lcos::future<void>
+        for_each(segment_type const& seg, F const& f)
+        {
+            return chunk_vector_stubs::chunk_for_each_const_async(
+                seg.id_, seg.first_, seg.last_, f);
+        }
+    };
+
+    template <>
+    struct segmented_iterator_traits<hpx::segmented_vector_iterator>
+      : detail::vector_segmented_iterator_traits<
+            hpx::segmented_vector_iterator>
+    {
+        template <typename F>
+        static hpx::lcos::future<void>
+        for_each(segment_type const& seg, F const& f)
+        {
+            return chunk_vector_stubs::chunk_for_each_async(
+                seg.id_, seg.first_, seg.last_, f);
+        }
+
+        static hpx::lcos::future<void>
+        fill(segment_type const& seg, value_type const& val)
+        {
+            return chunk_vector_stubs::chunk_fill_async(
+                seg.id_, seg.first_, seg.last_, val);
+        }
+
+        static hpx::lcos::future<void>
+        set_values(segment_type const& seg, std::vector<value_type> && values)
+        {
+            HPX_ASSERT(values.size() == size(seg));
+            return chunk_vector_stubs::chunk_set_values_async(
+                seg.id_, seg.first_, values);
+        }
+    };
+}}}
+
 #endif //  SEGMENTED_ITERATOR_HPP
@@ -296,6 +296,14 @@
 #  define HPX_INITIAL_AGAS_MAX_PENDING_REFCNT_REQUESTS 4096
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+/// This defines the number of children of each locality in the tree used to
+/// release the localities from the startup barrier (big_boot_barrier). A value
+/// smaller than 2 makes the AGAS root notify all localities directly.
+#if !defined(HPX_INITIAL_AGAS_BOOT_BARRIER_ARITY)
+#  define HPX_INITIAL_AGAS_BOOT_BARRIER_ARITY 8
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 /// This defines the initial global reference count associated with any created
 /// object.
@@ -512,6 +520,27 @@
 #  endif
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+// Resolution (in nanoseconds) of the timer wheels used for timed suspension
+// of HPX threads
+#if !defined(HPX_THREAD_TIMER_WHEEL_RESOLUTION)
+#  define HPX_THREAD_TIMER_WHEEL_RESOLUTION 50000
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Default parameters of the idle backoff of the worker threads: the number of
+// idle loop iterations spent spinning and yielding before a worker thread
+// gets parked and the maximal time (in microseconds) it stays parked
+#if !defined(HPX_IDLE_BACKOFF_SPIN_COUNT)
+#  define HPX_IDLE_BACKOFF_SPIN_COUNT 2000
+#endif
+#if !defined(HPX_IDLE_BACKOFF_YIELD_COUNT)
+#  define HPX_IDLE_BACKOFF_YIELD_COUNT 2000
+#endif
+#if !defined(HPX_IDLE_BACKOFF_MAX_PARK_TIME)
+#  define HPX_IDLE_BACKOFF_MAX_PARK_TIME 1000
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // Count number of empty (no HPX thread available) thread manager loop executions
 #if !defined(HPX_IDLE_LOOP_COUNT_MAX)
@@ -120,6 +120,7 @@ namespace hpx
             connection_portals4 = 2,
             connection_ibverbs = 3,
             connection_mpi = 4,
+            connection_shmem = 5,
             connection_last
         };
 
@@ -213,6 +214,15 @@ namespace hpx
             class HPX_EXPORT periodic_priority_queue_scheduler;
 #endif
 
+#if defined(HPX_DEADLINE_SCHEDULER)
+            template <typename Mutex = boost::mutex
+                    , typename PendingQueuing = lockfree_fifo
+                    , typename StagedQueuing = lockfree_fifo
+                    , typename TerminatedQueuing = lockfree_lifo
+                     >
+            class HPX_EXPORT deadline_queue_scheduler;
+#endif
+
 #if defined(HPX_STATIC_PRIORITY_SCHEDULER)
             template <typename Mutex = boost::mutex
                     , typename PendingQueuing = lockfree_fifo
@@ -767,10 +777,13 @@ namespace hpx
         task = 0x04,        // see N3632
         sync = 0x08,
         fork = 0x10,        // same as async, but forces continuation stealing
+        stackless = 0x20,   // same as async, but runs to completion on the
+                            // stack of the worker thread (must not suspend)
 
         sync_policies = 0x0a,       // sync | deferred
-        async_policies = 0x15,      // async | task | fork
-        all = 0x1f                  // async | deferred | task | sync | fork
+        async_policies = 0x35,      // async | task | fork | stackless
+        all = 0x3f                  // async | deferred | task | sync | fork |
+                                    // stackless
     };
     BOOST_SCOPED_ENUM_END
 
@@ -7,9 +7,12 @@
 #define HPX_COMPRESSION_FEB_26_2013_0415AM
 
 #include <hpx/hpx_fwd.hpp>
+#include <hpx/plugins/binary_filter/adaptive_serialization_filter.hpp>
 #include <hpx/plugins/binary_filter/bzip2_serialization_filter.hpp>
+#include <hpx/plugins/binary_filter/lz4_serialization_filter.hpp>
 #include <hpx/plugins/binary_filter/snappy_serialization_filter.hpp>
 #include <hpx/plugins/binary_filter/zlib_serialization_filter.hpp>
+#include <hpx/plugins/binary_filter/zstd_serialization_filter.hpp>
 
 #endif
 
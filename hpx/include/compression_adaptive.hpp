@@ -0,0 +1,13 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_COMPRESSION_ADAPTIVE_OCT_19_2014_0903PM)
+#define HPX_COMPRESSION_ADAPTIVE_OCT_19_2014_0903PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/plugins/binary_filter/adaptive_serialization_filter.hpp>
+
+#endif
+
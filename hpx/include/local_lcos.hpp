@@ -9,10 +9,13 @@
 
 #include <hpx/hpx_fwd.hpp>
 #include <hpx/lcos/local/barrier.hpp>
+#include <hpx/lcos/local/bounded_channel.hpp>
 #include <hpx/lcos/local/condition_variable.hpp>
 #include <hpx/lcos/local/counting_semaphore.hpp>
 #include <hpx/lcos/local/dataflow.hpp>
 #include <hpx/lcos/local/event.hpp>
+#include <hpx/lcos/local/fair_mutex.hpp>
+#include <hpx/lcos/local/fair_shared_mutex.hpp>
 #include <hpx/lcos/local/mutex.hpp>
 #include <hpx/lcos/local/shared_mutex.hpp>
 #include <hpx/lcos/local/recursive_mutex.hpp>
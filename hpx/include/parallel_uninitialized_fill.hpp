@@ -0,0 +1,11 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_PARALLEL_UNINITIALIZED_FILL_OCT_19_2014_0942PM)
+#define HPX_PARALLEL_UNINITIALIZED_FILL_OCT_19_2014_0942PM
+
+#include <hpx/parallel/detail/uninitialized_fill.hpp>
+
+#endif
@@ -624,6 +624,13 @@ namespace detail
                     threads::thread_priority_boost, get_worker_thread_num(),
                     stacksize, ec);
             }
+            else if (policy == launch::stackless) {
+                threads::register_thread_plain(
+                    util::bind(&task_base::run_impl, this_),
+                    desc ? desc : "task_base::apply", threads::pending, false,
+                    priority, std::size_t(-1), threads::thread_stacksize_nostack,
+                    ec);
+            }
             else {
                 threads::register_thread_plain(
                     util::bind(&task_base::run_impl, this_),
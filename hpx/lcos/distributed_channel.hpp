@@ -0,0 +1,517 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file distributed_channel.hpp
+
+#if !defined(HPX_LCOS_DISTRIBUTED_CHANNEL_OCT_19_2014_0412PM)
+#define HPX_LCOS_DISTRIBUTED_CHANNEL_OCT_19_2014_0412PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/async.hpp>
+#include <hpx/apply.hpp>
+#include <hpx/include/client.hpp>
+#include <hpx/runtime/naming/id_type.hpp>
+#include <hpx/runtime/components/new.hpp>
+#include <hpx/runtime/components/server/simple_component_base.hpp>
+#include <hpx/lcos/future.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/lcos/local/detail/condition_variable.hpp>
+#include <hpx/util/assert.hpp>
+
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace hpx { namespace lcos
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // The distributed_channel_server is the receiving end of a distributed
+        // channel. It holds at most 'capacity' values at any point in time,
+        // counting both, the values waiting to be received and the values
+        // the senders were granted credit for (values in flight). Senders
+        // have to request credit before sending values, the request is
+        // granted only as free capacity becomes available, which bounds the
+        // amount of memory needed by the receiving end.
+        template <typename T>
+        class distributed_channel_server
+          : public hpx::components::simple_component_base<
+                distributed_channel_server<T> >
+        {
+            typedef lcos::local::spinlock mutex_type;
+
+            struct sender_data
+            {
+                sender_data()
+                  : next_sequence_(0),
+                    final_sequence_(static_cast<std::size_t>(-1)),
+                    granted_(0), delivered_(0)
+                {}
+
+                bool disconnected() const
+                {
+                    return final_sequence_ != static_cast<std::size_t>(-1);
+                }
+
+                std::size_t next_sequence_;
+                std::size_t final_sequence_;
+                std::size_t granted_;       // credit granted to this sender
+                std::size_t delivered_;     // values delivered by this sender
+
+                // batches which have arrived out of order
+                std::map<std::size_t, std::vector<T> > pending_;
+            };
+
+            typedef std::map<std::size_t, sender_data> senders_type;
+
+        public:
+            distributed_channel_server()
+            {
+                HPX_ASSERT(false);  // shouldn't ever be called
+            }
+
+            explicit distributed_channel_server(std::size_t capacity)
+              : capacity_(capacity), outstanding_(0), next_sender_(0)
+            {
+                HPX_ASSERT(capacity_ != 0);
+            }
+
+            /// Register a new sender, returns the id the sender has to use
+            /// for all subsequent deliveries.
+            std::size_t connect()
+            {
+                typename mutex_type::scoped_lock l(mtx_);
+                std::size_t sender = next_sender_++;
+                senders_[sender] = sender_data();
+                return sender;
+            }
+
+            /// Unregister the given sender, the sender reports the total
+            /// number of batches and values sent. All credit granted to the
+            /// sender which was not used is released, pending credit
+            /// requests of this sender are answered with no credit.
+            void disconnect(std::size_t sender, std::size_t num_batches,
+                std::size_t num_values)
+            {
+                typename mutex_type::scoped_lock l(mtx_);
+
+                typename senders_type::iterator it = senders_.find(sender);
+                HPX_ASSERT(it != senders_.end());
+
+                // the credit for values which are still in flight is
+                // released as soon as they are delivered
+                sender_data& data = it->second;
+                HPX_ASSERT(num_values >= data.delivered_);
+
+                std::size_t in_flight = num_values - data.delivered_;
+                HPX_ASSERT(data.granted_ >= in_flight);
+
+                std::size_t unused_credit = data.granted_ - in_flight;
+                data.granted_ = in_flight;
+                data.final_sequence_ = num_batches;
+
+                if (data.next_sequence_ == num_batches)
+                    senders_.erase(it);
+
+                HPX_ASSERT(outstanding_ >= unused_credit);
+                outstanding_ -= unused_credit;
+
+                // resume all pending credit requests, this includes the
+                // ones of the disconnected sender
+                credit_cond_.notify_all(l);
+            }
+
+            /// Request credit for sending up to 'requested' values. Suspends
+            /// until at least one value can be accepted or the sender has
+            /// disconnected, in which case no credit is granted.
+            std::size_t request_credit(std::size_t sender,
+                std::size_t requested)
+            {
+                typename mutex_type::scoped_lock l(mtx_);
+
+                while (true)
+                {
+                    typename senders_type::iterator it = senders_.find(sender);
+                    if (it == senders_.end() || it->second.disconnected())
+                        return 0;
+
+                    std::size_t free_capacity = free_capacity_locked();
+                    if (free_capacity != 0)
+                    {
+                        std::size_t granted = (std::min)(requested, free_capacity);
+                        outstanding_ += granted;
+                        it->second.granted_ += granted;
+                        return granted;
+                    }
+
+                    credit_cond_.wait(l,
+                        "distributed_channel_server::request_credit");
+                }
+            }
+
+            /// Deliver a batch of values the sender has been granted credit
+            /// for. Batches are appended in the order they were sent.
+            void deliver(std::size_t sender, std::size_t sequence,
+                std::vector<T> const& values)
+            {
+                typename mutex_type::scoped_lock l(mtx_);
+
+                typename senders_type::iterator it = senders_.find(sender);
+                HPX_ASSERT(it != senders_.end());
+
+                sender_data& data = it->second;
+                if (sequence != data.next_sequence_)
+                {
+                    // keep this batch until all preceding batches have arrived
+                    data.pending_[sequence] = values;
+                    return;
+                }
+
+                std::size_t count = append_locked(data, values);
+                ++data.next_sequence_;
+
+                // append all batches which were waiting for this one
+                typename std::map<std::size_t, std::vector<T> >::iterator
+                    pending = data.pending_.begin();
+                while (pending != data.pending_.end() &&
+                       pending->first == data.next_sequence_)
+                {
+                    count += append_locked(data, pending->second);
+                    data.pending_.erase(pending++);
+                    ++data.next_sequence_;
+                }
+
+                if (data.next_sequence_ == data.final_sequence_)
+                    senders_.erase(it);
+
+                // resume receivers waiting for values
+                for (std::size_t i = 0; i != count; ++i)
+                {
+                    if (!value_cond_.notify_one(l))
+                        break;
+                }
+            }
+
+            /// Retrieve up to max_count values, suspends while no value is
+            /// available.
+            std::vector<T> receive_n(std::size_t max_count)
+            {
+                typename mutex_type::scoped_lock l(mtx_);
+
+                while (values_.empty())
+                {
+                    value_cond_.wait(l,
+                        "distributed_channel_server::receive_n");
+                }
+
+                std::size_t count = (std::min)(max_count, values_.size());
+
+                std::vector<T> result;
+                result.reserve(count);
+                for (std::size_t i = 0; i != count; ++i)
+                {
+                    result.push_back(std::move(values_.front()));
+                    values_.pop_front();
+                }
+
+                // the space is free again, resume senders waiting for credit
+                credit_cond_.notify_all(l);
+
+                return result;
+            }
+
+            T receive()
+            {
+                std::vector<T> result = receive_n(1);
+                HPX_ASSERT(result.size() == 1);
+                return std::move(result.front());
+            }
+
+            HPX_DEFINE_COMPONENT_ACTION_TPL(
+                distributed_channel_server, connect, connect_action);
+            HPX_DEFINE_COMPONENT_ACTION_TPL(
+                distributed_channel_server, disconnect, disconnect_action);
+            HPX_DEFINE_COMPONENT_ACTION_TPL(
+                distributed_channel_server, request_credit,
+                request_credit_action);
+            HPX_DEFINE_COMPONENT_ACTION_TPL(
+                distributed_channel_server, deliver, deliver_action);
+            HPX_DEFINE_COMPONENT_ACTION_TPL(
+                distributed_channel_server, receive_n, receive_n_action);
+            HPX_DEFINE_COMPONENT_ACTION_TPL(
+                distributed_channel_server, receive, receive_action);
+
+        protected:
+            std::size_t free_capacity_locked() const
+            {
+                HPX_ASSERT(values_.size() + outstanding_ <= capacity_);
+                return capacity_ - values_.size() - outstanding_;
+            }
+
+            std::size_t append_locked(sender_data& data,
+                std::vector<T> const& values)
+            {
+                HPX_ASSERT(outstanding_ >= values.size());
+                HPX_ASSERT(data.granted_ >= values.size());
+                outstanding_ -= values.size();
+                data.granted_ -= values.size();
+                data.delivered_ += values.size();
+                values_.insert(values_.end(), values.begin(), values.end());
+                return values.size();
+            }
+
+        private:
+            mutex_type mtx_;
+            std::size_t const capacity_;
+            std::size_t outstanding_;       // credit granted to senders
+            std::size_t next_sender_;
+
+            std::deque<T> values_;
+            senders_type senders_;
+
+            local::detail::condition_variable value_cond_;
+            local::detail::condition_variable credit_cond_;
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// A distributed_channel is the receiving end of a stream of values sent
+    /// by any number of \a distributed_channel_sender instances, possibly
+    /// located on other localities. The channel holds at most \a capacity
+    /// values, senders are suspended if they run out of credit. Values sent
+    /// by the same sender are received in the order they were sent.
+    template <typename T>
+    class distributed_channel
+      : public components::client_base<
+            distributed_channel<T>, detail::distributed_channel_server<T> >
+    {
+        typedef components::client_base<
+            distributed_channel, detail::distributed_channel_server<T>
+        > base_type;
+
+        typedef detail::distributed_channel_server<T> server_type;
+
+    public:
+        distributed_channel()
+        {}
+
+        /// Create a new channel on the given locality which buffers at most
+        /// \a capacity values.
+        distributed_channel(naming::id_type const& locality,
+                std::size_t capacity)
+          : base_type(hpx::new_<server_type>(locality, capacity))
+        {}
+
+        /// Refer to an existing channel.
+        explicit distributed_channel(naming::id_type const& id)
+          : base_type(id)
+        {}
+        explicit distributed_channel(hpx::future<naming::id_type> && id)
+          : base_type(std::move(id))
+        {}
+
+        /// Receive the next value, the returned future becomes ready as
+        /// soon as a value is available.
+        hpx::future<T> receive()
+        {
+            typedef typename server_type::receive_action action_type;
+            return hpx::async<action_type>(this->get_gid());
+        }
+
+        /// Receive up to \a max_count values in one operation, the returned
+        /// future becomes ready as soon as at least one value is available.
+        hpx::future<std::vector<T> > receive_n(std::size_t max_count)
+        {
+            typedef typename server_type::receive_n_action action_type;
+            return hpx::async<action_type>(this->get_gid(), max_count);
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// A distributed_channel_sender is the sending end of a distributed
+    /// channel. Values are collected into batches of \a batch_size values,
+    /// each batch is sent as a single message. The sender holds credit for at
+    /// most two batches at a time, it requests more credit from the
+    /// receiving end in advance, so that sending is not interrupted as long
+    /// as the receiver keeps up. If the sender runs out of credit the calling
+    /// HPX thread is suspended until the receiver grants more credit.
+    ///
+    /// A sender is meant to be used by one HPX thread at a time.
+    template <typename T>
+    class distributed_channel_sender
+    {
+        HPX_MOVABLE_BUT_NOT_COPYABLE(distributed_channel_sender);
+
+        typedef detail::distributed_channel_server<T> server_type;
+
+        void request_credit()
+        {
+            typedef typename server_type::request_credit_action action_type;
+            credit_request_ = hpx::async<action_type>(id_, sender_, batch_size_);
+        }
+
+        void acquire_credit()
+        {
+            // make sure all values we have credit for are on their way, as
+            // otherwise the receiver might never grant new credit
+            flush();
+
+            if (!credit_request_.valid())
+                request_credit();
+            credits_ += credit_request_.get();
+        }
+
+    public:
+        /// Connect to the given channel.
+        ///
+        /// \param id         [in] The id of the receiving end.
+        /// \param batch_size [in] The maximal number of values sent in one
+        ///                   message.
+        explicit distributed_channel_sender(naming::id_type const& id,
+                std::size_t batch_size = 64)
+          : id_(id), batch_size_(batch_size), sender_(0), sequence_(0),
+            credits_(0), values_sent_(0)
+        {
+            HPX_ASSERT(batch_size_ != 0);
+
+            typedef typename server_type::connect_action action_type;
+            sender_ = hpx::async<action_type>(id_).get();
+
+            batch_.reserve(batch_size_);
+            request_credit();
+        }
+
+        distributed_channel_sender(distributed_channel_sender && rhs)
+          : id_(std::move(rhs.id_)), batch_size_(rhs.batch_size_),
+            sender_(rhs.sender_), sequence_(rhs.sequence_),
+            credits_(rhs.credits_), values_sent_(rhs.values_sent_),
+            batch_(std::move(rhs.batch_)),
+            credit_request_(std::move(rhs.credit_request_))
+        {
+            rhs.credits_ = 0;
+        }
+
+        ~distributed_channel_sender()
+        {
+            HPX_ASSERT(!id_ || batch_.empty());
+        }
+
+        /// Send the given value, suspends the calling HPX thread if no
+        /// credit is available.
+        void send(T const& value)
+        {
+            if (credits_ == 0)
+                acquire_credit();
+
+            batch_.push_back(value);
+            --credits_;
+
+            if (batch_.size() >= batch_size_)
+                flush();
+        }
+
+        /// Send all collected values.
+        void flush()
+        {
+            if (batch_.empty())
+                return;
+
+            typedef typename server_type::deliver_action action_type;
+            hpx::apply<action_type>(id_, sender_, sequence_++, batch_);
+            values_sent_ += batch_.size();
+            batch_.clear();
+
+            // request more credit ahead of time
+            if (!credit_request_.valid() && credits_ < batch_size_)
+                request_credit();
+        }
+
+        /// Send all collected values and disconnect from the receiving end.
+        /// The sender must not be used afterwards.
+        ///
+        /// This does not wait for pending credit requests, which might
+        /// not be answered before the receiver has consumed values. The
+        /// receiving end releases all credit not used by this sender.
+        hpx::future<void> close()
+        {
+            flush();
+
+            typedef typename server_type::disconnect_action action_type;
+            hpx::future<void> f =
+                hpx::async<action_type>(id_, sender_, sequence_, values_sent_);
+
+            credit_request_ = hpx::future<std::size_t>();
+            credits_ = 0;
+            id_ = naming::invalid_id;
+            return f;
+        }
+
+    private:
+        naming::id_type id_;
+        std::size_t batch_size_;
+        std::size_t sender_;
+        std::size_t sequence_;
+        std::size_t credits_;
+        std::size_t values_sent_;
+        std::vector<T> batch_;
+        hpx::future<std::size_t> credit_request_;
+    };
+}}
+
+///////////////////////////////////////////////////////////////////////////////
+#define HPX_REGISTER_DISTRIBUTED_CHANNEL_DECLARATION(type, name)              \
+    HPX_REGISTER_ACTION_DECLARATION(                                          \
+        hpx::lcos::detail::distributed_channel_server<type>::connect_action,  \
+        BOOST_PP_CAT(distributed_channel_connect_action_, name));             \
+    HPX_REGISTER_ACTION_DECLARATION(                                          \
+        hpx::lcos::detail::distributed_channel_server<type>::disconnect_action,\
+        BOOST_PP_CAT(distributed_channel_disconnect_action_, name));          \
+    HPX_REGISTER_ACTION_DECLARATION(                                          \
+        hpx::lcos::detail::distributed_channel_server<type>::                 \
+            request_credit_action,                                            \
+        BOOST_PP_CAT(distributed_channel_request_credit_action_, name));      \
+    HPX_REGISTER_ACTION_DECLARATION(                                          \
+        hpx::lcos::detail::distributed_channel_server<type>::deliver_action,  \
+        BOOST_PP_CAT(distributed_channel_deliver_action_, name));             \
+    HPX_REGISTER_ACTION_DECLARATION(                                          \
+        hpx::lcos::detail::distributed_channel_server<type>::receive_n_action,\
+        BOOST_PP_CAT(distributed_channel_receive_n_action_, name));           \
+    HPX_REGISTER_ACTION_DECLARATION(                                          \
+        hpx::lcos::detail::distributed_channel_server<type>::receive_action,  \
+        BOOST_PP_CAT(distributed_channel_receive_action_, name))              \
+    /**/
+
+#define HPX_REGISTER_DISTRIBUTED_CHANNEL(type, name)                          \
+    HPX_REGISTER_ACTION(                                                      \
+        hpx::lcos::detail::distributed_channel_server<type>::connect_action,  \
+        BOOST_PP_CAT(distributed_channel_connect_action_, name));             \
+    HPX_REGISTER_ACTION(                                                      \
+        hpx::lcos::detail::distributed_channel_server<type>::disconnect_action,\
+        BOOST_PP_CAT(distributed_channel_disconnect_action_, name));          \
+    HPX_REGISTER_ACTION(                                                      \
+        hpx::lcos::detail::distributed_channel_server<type>::                 \
+            request_credit_action,                                            \
+        BOOST_PP_CAT(distributed_channel_request_credit_action_, name));      \
+    HPX_REGISTER_ACTION(                                                      \
+        hpx::lcos::detail::distributed_channel_server<type>::deliver_action,  \
+        BOOST_PP_CAT(distributed_channel_deliver_action_, name));             \
+    HPX_REGISTER_ACTION(                                                      \
+        hpx::lcos::detail::distributed_channel_server<type>::receive_n_action,\
+        BOOST_PP_CAT(distributed_channel_receive_n_action_, name));           \
+    HPX_REGISTER_ACTION(                                                      \
+        hpx::lcos::detail::distributed_channel_server<type>::receive_action,  \
+        BOOST_PP_CAT(distributed_channel_receive_action_, name));             \
+    typedef hpx::components::simple_component<                                \
+        hpx::lcos::detail::distributed_channel_server<type>                   \
+    > BOOST_PP_CAT(distributed_channel_, name);                               \
+    HPX_REGISTER_MINIMAL_COMPONENT_FACTORY(                                   \
+        BOOST_PP_CAT(distributed_channel_, name))                             \
+    /**/
+
+#endif
@@ -0,0 +1,324 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_LCOS_LOCAL_BOUNDED_CHANNEL_OCT_19_2014_0305PM)
+#define HPX_LCOS_LOCAL_BOUNDED_CHANNEL_OCT_19_2014_0305PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/lcos/local/detail/condition_variable.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/util/assert.hpp>
+#include <hpx/util/lockfree/mpmc_ring_buffer.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <utility>
+
+#if defined(BOOST_MSVC)
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace lcos { namespace local
+{
+    /// A bounded_channel is a queue of values of a fixed capacity which can be
+    /// used by any number of producers and consumers concurrently. The values
+    /// are stored in a lock-free ring buffer, producers and consumers running
+    /// on different cores do not share a lock as long as the channel is
+    /// neither full nor empty.
+    ///
+    /// The blocking operations (\a send, \a send_n, \a receive, \a receive_n)
+    /// suspend the calling HPX thread while the channel is full (empty). The
+    /// suspended HPX-threads are resumed as soon as space (values) become
+    /// available again. The blocking operations must be called from an HPX
+    /// thread, the non-blocking operations (\a try_send, \a try_receive, etc.)
+    /// may be called from any thread.
+    ///
+    /// \note The move constructor and move assignment operator of T should not
+    ///       throw.
+    template <typename T, typename Mutex = lcos::local::spinlock>
+    class bounded_channel : boost::noncopyable
+    {
+    private:
+        typedef Mutex mutex_type;
+        typedef boost::lockfree::mpmc_ring_buffer<T> buffer_type;
+
+        // Resume up to count threads waiting in the given queue. The lock is
+        // acquired only if there are waiting threads.
+        void notify(local::detail::condition_variable& cond,
+            boost::atomic<std::size_t>& waiting, std::size_t count)
+        {
+            // make sure the modification of the buffer is visible before
+            // looking at the number of waiting threads (see wait() below)
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            if (waiting.load(boost::memory_order_relaxed) == 0)
+                return;
+
+            typename mutex_type::scoped_lock l(mtx_);
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                if (!cond.notify_one(l))
+                    break;
+            }
+        }
+
+        // Suspend the calling HPX thread until the given operation succeeds.
+        template <typename F>
+        std::size_t wait(local::detail::condition_variable& cond,
+            boost::atomic<std::size_t>& waiting, F const& f,
+            char const* description)
+        {
+            waiting.fetch_add(1);
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+
+            std::size_t result = 0;
+            {
+                typename mutex_type::scoped_lock l(mtx_);
+                while ((result = f()) == 0)
+                {
+                    cond.wait(l, description);
+                }
+            }
+
+            waiting.fetch_sub(1);
+            return result;
+        }
+
+        struct try_send_one
+        {
+            explicit try_send_one(bounded_channel& ch, T& value)
+              : ch_(ch), value_(value)
+            {}
+
+            std::size_t operator()() const
+            {
+                return ch_.buffer_.push(std::move(value_)) ? 1 : 0;
+            }
+
+            bounded_channel& ch_;
+            T& value_;
+        };
+
+        struct try_receive_one
+        {
+            explicit try_receive_one(bounded_channel& ch, T& value)
+              : ch_(ch), value_(value)
+            {}
+
+            std::size_t operator()() const
+            {
+                return ch_.buffer_.pop(value_) ? 1 : 0;
+            }
+
+            bounded_channel& ch_;
+            T& value_;
+        };
+
+        template <typename Iterator>
+        struct try_send_many
+        {
+            try_send_many(bounded_channel& ch, Iterator& it, std::size_t count)
+              : ch_(ch), it_(it), count_(count)
+            {}
+
+            std::size_t operator()() const
+            {
+                return ch_.buffer_.push_n(it_, count_);
+            }
+
+            bounded_channel& ch_;
+            Iterator& it_;
+            std::size_t count_;
+        };
+
+        template <typename OutIter>
+        struct try_receive_many
+        {
+            try_receive_many(bounded_channel& ch, OutIter& it, std::size_t count)
+              : ch_(ch), it_(it), count_(count)
+            {}
+
+            std::size_t operator()() const
+            {
+                return ch_.buffer_.pop_n(it_, count_);
+            }
+
+            bounded_channel& ch_;
+            OutIter& it_;
+            std::size_t count_;
+        };
+
+    public:
+        typedef T value_type;
+
+        /// \brief Construct a new channel
+        ///
+        /// \param capacity [in] The minimal number of values the channel can
+        ///                 hold. The actual capacity is rounded up to the
+        ///                 next power of two.
+        explicit bounded_channel(std::size_t capacity)
+          : buffer_(capacity), producers_waiting_(0), consumers_waiting_(0)
+        {}
+
+        std::size_t capacity() const
+        {
+            return buffer_.capacity();
+        }
+
+        /// Return an estimate of the number of values currently stored in the
+        /// channel.
+        std::size_t size() const
+        {
+            return buffer_.size();
+        }
+
+        bool empty() const
+        {
+            return buffer_.empty();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        /// \brief Store a value in the channel, if possible
+        ///
+        /// \returns        The function returns true if the value was stored,
+        ///                 false if the channel is full.
+        template <typename U>
+        bool try_send(U && value)
+        {
+            if (!buffer_.push(std::forward<U>(value)))
+                return false;
+
+            notify(not_empty_, consumers_waiting_, 1);
+            return true;
+        }
+
+        /// \brief Store a value in the channel, suspend the calling HPX thread
+        ///        as long as the channel is full.
+        void send(T value)
+        {
+            if (!buffer_.push(std::move(value)))
+            {
+                wait(not_full_, producers_waiting_,
+                    try_send_one(*this, value), "bounded_channel::send");
+            }
+            notify(not_empty_, consumers_waiting_, 1);
+        }
+
+        /// \brief Store up to \a count values from the given sequence using a
+        ///        single operation on the underlying buffer.
+        ///
+        /// \returns        The number of values which were stored, the
+        ///                 values are moved from the given sequence.
+        template <typename Iterator>
+        std::size_t try_send_n(Iterator it, std::size_t count)
+        {
+            std::size_t n = buffer_.push_n(it, count);
+            if (n != 0)
+                notify(not_empty_, consumers_waiting_, n);
+            return n;
+        }
+
+        /// \brief Store \a count values from the given sequence, suspend the
+        ///        calling HPX thread as long as the channel is full. The values
+        ///        are stored in batches of as many values as possible.
+        template <typename Iterator>
+        void send_n(Iterator it, std::size_t count)
+        {
+            while (count != 0)
+            {
+                std::size_t n = buffer_.push_n(it, count);
+                if (n == 0)
+                {
+                    n = wait(not_full_, producers_waiting_,
+                        try_send_many<Iterator>(*this, it, count),
+                        "bounded_channel::send_n");
+                }
+
+                notify(not_empty_, consumers_waiting_, n);
+                count -= n;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        /// \brief Extract a value from the channel, if possible
+        ///
+        /// \returns        The function returns true if a value was extracted,
+        ///                 false if the channel is empty.
+        bool try_receive(T& value)
+        {
+            if (!buffer_.pop(value))
+                return false;
+
+            notify(not_full_, producers_waiting_, 1);
+            return true;
+        }
+
+        /// \brief Extract a value from the channel, suspend the calling HPX
+        ///        thread as long as the channel is empty.
+        T receive()
+        {
+            T value;
+            if (!buffer_.pop(value))
+            {
+                wait(not_empty_, consumers_waiting_,
+                    try_receive_one(*this, value), "bounded_channel::receive");
+            }
+            notify(not_full_, producers_waiting_, 1);
+            return value;
+        }
+
+        /// \brief Extract up to \a count values from the channel using a
+        ///        single operation on the underlying buffer.
+        ///
+        /// \returns        The number of values which were extracted.
+        template <typename OutIter>
+        std::size_t try_receive_n(OutIter it, std::size_t count)
+        {
+            std::size_t n = buffer_.pop_n(it, count);
+            if (n != 0)
+                notify(not_full_, producers_waiting_, n);
+            return n;
+        }
+
+        /// \brief Extract \a count values from the channel, suspend the calling
+        ///        HPX thread as long as the channel is empty. The values are
+        ///        extracted in batches of as many values as possible.
+        template <typename OutIter>
+        void receive_n(OutIter it, std::size_t count)
+        {
+            while (count != 0)
+            {
+                std::size_t n = buffer_.pop_n(it, count);
+                if (n == 0)
+                {
+                    n = wait(not_empty_, consumers_waiting_,
+                        try_receive_many<OutIter>(*this, it, count),
+                        "bounded_channel::receive_n");
+                }
+
+                notify(not_full_, producers_waiting_, n);
+                count -= n;
+            }
+        }
+
+    private:
+        buffer_type buffer_;
+
+        // the lock is used only for suspending and resuming threads
+        mutex_type mtx_;
+        local::detail::condition_variable not_full_;
+        local::detail::condition_variable not_empty_;
+        boost::atomic<std::size_t> producers_waiting_;
+        boost::atomic<std::size_t> consumers_waiting_;
+    };
+}}}
+
+#if defined(BOOST_MSVC)
+#pragma warning(pop)
+#endif
+
+#endif
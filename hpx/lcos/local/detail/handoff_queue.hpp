@@ -0,0 +1,152 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_LCOS_LOCAL_DETAIL_HANDOFF_QUEUE_OCT_19_2014_0418PM)
+#define HPX_LCOS_LOCAL_DETAIL_HANDOFF_QUEUE_OCT_19_2014_0418PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/runtime/threads/thread_helpers.hpp>
+#include <hpx/util/assert.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace lcos { namespace local { namespace detail
+{
+    // A handoff_node represents a thread waiting for a lock. The node lives
+    // on the stack of the waiting thread. The releasing thread transfers the
+    // ownership of the lock directly to the waiting thread by granting the
+    // node, i.e. the lock never becomes free in between and can't be stolen
+    // by a newly arriving thread.
+    //
+    // The waiting thread spins on its own node only (no shared cache lines)
+    // for a short while before it suspends itself.
+    struct handoff_node : boost::noncopyable
+    {
+        enum status
+        {
+            waiting = 0,        // the waiting thread is spinning
+            granted = 1,        // ownership has been handed over
+            sleeping = 2        // the waiting thread is (about to be) suspended
+        };
+
+        handoff_node()
+          : id_(threads::get_self_id()), status_(waiting), next_(0)
+        {}
+
+        // Wait for the ownership to be handed over to this node.
+        void wait(std::size_t spin_count, char const* description)
+        {
+            for (std::size_t k = 0; k != spin_count; ++k)
+            {
+                if (status_.load(boost::memory_order_acquire) == granted)
+                    return;
+#if defined(BOOST_SMT_PAUSE)
+                BOOST_SMT_PAUSE
+#endif
+            }
+
+            // outside of HPX threads we can't suspend, keep yielding instead
+            if (!id_)
+            {
+                for (std::size_t k = 0; status_.load(boost::memory_order_acquire)
+                        != granted; ++k)
+                {
+                    lcos::local::spinlock::yield(k);
+                }
+                return;
+            }
+
+            int expected = waiting;
+            if (!status_.compare_exchange_strong(expected, sleeping,
+                    boost::memory_order_acq_rel))
+            {
+                HPX_ASSERT(expected == granted);
+                return;
+            }
+
+            // the granting thread resumes us, the wakeup may arrive before we
+            // are suspended, in which case the thread manager retries it
+            while (status_.load(boost::memory_order_acquire) != granted)
+            {
+                this_thread::suspend(threads::suspended, description);
+            }
+        }
+
+        // Hand over ownership to the thread waiting on this node. The node
+        // must not be touched afterwards as the waiting thread may have
+        // returned already.
+        void grant()
+        {
+            threads::thread_id_type id = id_;
+            if (status_.exchange(granted, boost::memory_order_acq_rel) == sleeping)
+            {
+                threads::set_thread_state(id, threads::pending,
+                    threads::wait_signaled);
+            }
+        }
+
+        threads::thread_id_type const id_;
+        boost::atomic<int> status_;
+        handoff_node* next_;
+    };
+
+    // Simple intrusive FIFO queue of waiting threads. The queue has to be
+    // protected by an external lock.
+    class handoff_queue : boost::noncopyable
+    {
+    public:
+        handoff_queue()
+          : head_(0), tail_(0), size_(0)
+        {}
+
+        ~handoff_queue()
+        {
+            HPX_ASSERT(empty());
+        }
+
+        bool empty() const
+        {
+            return head_ == 0;
+        }
+
+        std::size_t size() const
+        {
+            return size_;
+        }
+
+        void push_back(handoff_node& node)
+        {
+            node.next_ = 0;
+            if (tail_ != 0)
+                tail_->next_ = &node;
+            else
+                head_ = &node;
+            tail_ = &node;
+            ++size_;
+        }
+
+        handoff_node* pop_front()
+        {
+            handoff_node* node = head_;
+            HPX_ASSERT(node != 0);
+
+            head_ = node->next_;
+            if (head_ == 0)
+                tail_ = 0;
+            --size_;
+            return node;
+        }
+
+    private:
+        handoff_node* head_;
+        handoff_node* tail_;
+        std::size_t size_;
+    };
+}}}}
+
+#endif
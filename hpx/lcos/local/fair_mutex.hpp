@@ -0,0 +1,169 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_LCOS_LOCAL_FAIR_MUTEX_OCT_19_2014_0427PM)
+#define HPX_LCOS_LOCAL_FAIR_MUTEX_OCT_19_2014_0427PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/lcos/local/detail/handoff_queue.hpp>
+#include <hpx/util/assert.hpp>
+#include <hpx/util/itt_notify.hpp>
+#include <hpx/util/register_locks.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
+
+// The fair_mutex is a queue based (MCS-style) mutex:
+//
+// - an uncontended lock()/unlock() pair is a single compare-and-swap each,
+// - contending threads are queued in FIFO order, each of them spins on its
+//   own queue node for a short while before suspending the HPX thread,
+// - unlock() hands the ownership directly to the first queued thread, the
+//   mutex does not become free in between. Newly arriving threads can't
+//   overtake queued threads, which avoids starvation and lock convoys where
+//   woken threads repeatedly lose the race for the lock.
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace lcos { namespace local
+{
+    /// An exclusive-ownership mutex granting ownership in FIFO order, it
+    /// implements Boost.Thread's Lockable concept.
+    class fair_mutex : boost::noncopyable
+    {
+    private:
+        typedef lcos::local::spinlock mutex_type;
+
+        enum state
+        {
+            unlocked = 0,
+            locked = 1,
+            locked_with_waiters = 2
+        };
+
+        bool try_lock_internal()
+        {
+            boost::uint32_t expected = unlocked;
+            return state_.compare_exchange_strong(expected, locked,
+                boost::memory_order_acquire);
+        }
+
+    public:
+        /// \param spin_count [in] The number of times a waiting thread polls
+        ///                   its queue node before it gets suspended.
+        fair_mutex(char const* const description = "",
+                std::size_t spin_count = 128)
+          : state_(unlocked), spin_count_(spin_count)
+        {
+            HPX_ITT_SYNC_CREATE(this, "lcos::fair_mutex", description);
+            HPX_ITT_SYNC_RENAME(this, "lcos::fair_mutex");
+        }
+
+        ~fair_mutex()
+        {
+            HPX_ITT_SYNC_DESTROY(this);
+        }
+
+        /// Attempts to acquire ownership of the \a fair_mutex. Never blocks.
+        ///
+        /// \returns \a true if ownership was acquired; otherwise, \a false.
+        bool try_lock()
+        {
+            HPX_ITT_SYNC_PREPARE(this);
+            if (try_lock_internal())
+            {
+                HPX_ITT_SYNC_ACQUIRED(this);
+                util::register_lock(this);
+                return true;
+            }
+            HPX_ITT_SYNC_CANCEL(this);
+            return false;
+        }
+
+        /// Acquires ownership of the \a fair_mutex. Suspends the current
+        /// HPX-thread if ownership cannot be obtained after spinning for a
+        /// short while.
+        void lock()
+        {
+            HPX_ITT_SYNC_PREPARE(this);
+            if (!try_lock_internal())
+            {
+                detail::handoff_node node;
+                if (enqueue(node))
+                    node.wait(spin_count_, "fair_mutex::lock");
+            }
+            HPX_ITT_SYNC_ACQUIRED(this);
+            util::register_lock(this);
+        }
+
+        /// Release ownership of the \a fair_mutex. If other threads are
+        /// waiting, the ownership is handed to the longest waiting thread.
+        void unlock()
+        {
+            util::unregister_lock(this);
+            HPX_ITT_SYNC_RELEASING(this);
+
+            boost::uint32_t expected = locked;
+            if (!state_.compare_exchange_strong(expected, unlocked,
+                    boost::memory_order_release))
+            {
+                HPX_ASSERT(expected == locked_with_waiters);
+
+                detail::handoff_node* next = 0;
+                {
+                    mutex_type::scoped_lock l(mtx_);
+                    next = queue_.pop_front();
+                    if (queue_.empty())
+                        state_.store(locked, boost::memory_order_relaxed);
+                }
+                next->grant();
+            }
+
+            HPX_ITT_SYNC_RELEASED(this);
+        }
+
+        typedef boost::unique_lock<fair_mutex> scoped_lock;
+        typedef boost::detail::try_lock_wrapper<fair_mutex> scoped_try_lock;
+
+    private:
+        // Append the given node to the queue of waiting threads, returns
+        // false if the mutex was acquired instead.
+        bool enqueue(detail::handoff_node& node)
+        {
+            mutex_type::scoped_lock l(mtx_);
+
+            boost::uint32_t s = state_.load(boost::memory_order_relaxed);
+            while (true)
+            {
+                if (s == unlocked)
+                {
+                    if (state_.compare_exchange_weak(s, locked,
+                            boost::memory_order_acquire))
+                    {
+                        return false;
+                    }
+                }
+                else if (state_.compare_exchange_weak(s, locked_with_waiters,
+                            boost::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+
+            queue_.push_back(node);
+            return true;
+        }
+
+    private:
+        boost::atomic<boost::uint32_t> state_;
+        std::size_t const spin_count_;
+
+        mutex_type mtx_;        // protects the queue of waiting threads
+        detail::handoff_queue queue_;
+    };
+}}}
+
+#endif
@@ -0,0 +1,279 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_LCOS_LOCAL_FAIR_SHARED_MUTEX_OCT_19_2014_0512PM)
+#define HPX_LCOS_LOCAL_FAIR_SHARED_MUTEX_OCT_19_2014_0512PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/lcos/local/detail/handoff_queue.hpp>
+#include <hpx/util/assert.hpp>
+#include <hpx/util/itt_notify.hpp>
+#include <hpx/util/register_locks.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <vector>
+
+// The fair_shared_mutex is a writer-preferring reader/writer lock built on
+// the same principles as the fair_mutex:
+//
+// - uncontended lock operations are a single compare-and-swap on the state
+//   word, which holds the number of readers, a writer flag and a flag
+//   telling whether threads are queued,
+// - as soon as a thread is queued, newly arriving readers and writers queue
+//   up as well, this way readers can't starve writers,
+// - a releasing thread hands the lock directly to the queued threads:
+//   writers are served first (one at a time), afterwards all queued readers
+//   are granted at once.
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace lcos { namespace local
+{
+    /// A writer-preferring reader/writer lock granting ownership directly
+    /// to queued threads, it implements Boost.Thread's SharedLockable
+    /// concept.
+    class fair_shared_mutex : boost::noncopyable
+    {
+    private:
+        typedef lcos::local::spinlock mutex_type;
+
+        BOOST_STATIC_CONSTANT(boost::uint32_t, writer_flag = 1u << 31);
+        BOOST_STATIC_CONSTANT(boost::uint32_t, waiters_flag = 1u << 30);
+        BOOST_STATIC_CONSTANT(boost::uint32_t, reader_mask = waiters_flag - 1);
+
+    public:
+        /// \param spin_count [in] The number of times a waiting thread polls
+        ///                   its queue node before it gets suspended.
+        fair_shared_mutex(char const* const description = "",
+                std::size_t spin_count = 128)
+          : state_(0), spin_count_(spin_count)
+        {
+            HPX_ITT_SYNC_CREATE(this, "lcos::fair_shared_mutex", description);
+            HPX_ITT_SYNC_RENAME(this, "lcos::fair_shared_mutex");
+        }
+
+        ~fair_shared_mutex()
+        {
+            HPX_ITT_SYNC_DESTROY(this);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool try_lock()
+        {
+            HPX_ITT_SYNC_PREPARE(this);
+            if (try_lock_internal())
+            {
+                HPX_ITT_SYNC_ACQUIRED(this);
+                util::register_lock(this);
+                return true;
+            }
+            HPX_ITT_SYNC_CANCEL(this);
+            return false;
+        }
+
+        void lock()
+        {
+            HPX_ITT_SYNC_PREPARE(this);
+            if (!try_lock_internal())
+            {
+                detail::handoff_node node;
+                if (enqueue(node, writers_))
+                    node.wait(spin_count_, "fair_shared_mutex::lock");
+            }
+            HPX_ITT_SYNC_ACQUIRED(this);
+            util::register_lock(this);
+        }
+
+        void unlock()
+        {
+            util::unregister_lock(this);
+            HPX_ITT_SYNC_RELEASING(this);
+
+            boost::uint32_t expected = writer_flag;
+            if (!state_.compare_exchange_strong(expected, 0,
+                    boost::memory_order_release))
+            {
+                HPX_ASSERT(expected == (writer_flag | waiters_flag));
+                handoff();
+            }
+
+            HPX_ITT_SYNC_RELEASED(this);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool try_lock_shared()
+        {
+            HPX_ITT_SYNC_PREPARE(this);
+            if (try_lock_shared_internal())
+            {
+                HPX_ITT_SYNC_ACQUIRED(this);
+                util::register_lock(this);
+                return true;
+            }
+            HPX_ITT_SYNC_CANCEL(this);
+            return false;
+        }
+
+        void lock_shared()
+        {
+            HPX_ITT_SYNC_PREPARE(this);
+            if (!try_lock_shared_internal())
+            {
+                detail::handoff_node node;
+                if (enqueue(node, readers_))
+                    node.wait(spin_count_, "fair_shared_mutex::lock_shared");
+            }
+            HPX_ITT_SYNC_ACQUIRED(this);
+            util::register_lock(this);
+        }
+
+        void unlock_shared()
+        {
+            util::unregister_lock(this);
+            HPX_ITT_SYNC_RELEASING(this);
+
+            boost::uint32_t s = state_.load(boost::memory_order_relaxed);
+            while (true)
+            {
+                HPX_ASSERT((s & reader_mask) != 0 && !(s & writer_flag));
+
+                // the last reader has to hand over the lock to the queued
+                // threads
+                if ((s & waiters_flag) && (s & reader_mask) == 1)
+                {
+                    handoff();
+                    break;
+                }
+
+                if (state_.compare_exchange_weak(s, s - 1,
+                        boost::memory_order_release))
+                {
+                    break;
+                }
+            }
+
+            HPX_ITT_SYNC_RELEASED(this);
+        }
+
+        typedef boost::unique_lock<fair_shared_mutex> scoped_lock;
+        typedef boost::detail::try_lock_wrapper<fair_shared_mutex>
+            scoped_try_lock;
+        typedef boost::shared_lock<fair_shared_mutex> shared_lock;
+
+    private:
+        bool try_lock_internal()
+        {
+            boost::uint32_t expected = 0;
+            return state_.compare_exchange_strong(expected, writer_flag,
+                boost::memory_order_acquire);
+        }
+
+        bool try_lock_shared_internal()
+        {
+            boost::uint32_t s = state_.load(boost::memory_order_relaxed);
+            while (!(s & (writer_flag | waiters_flag)))
+            {
+                HPX_ASSERT((s & reader_mask) != reader_mask);
+                if (state_.compare_exchange_weak(s, s + 1,
+                        boost::memory_order_acquire))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Append the given node to the given queue, returns false if the
+        // lock was acquired instead.
+        bool enqueue(detail::handoff_node& node, detail::handoff_queue& queue)
+        {
+            bool const is_writer = &queue == &writers_;
+
+            mutex_type::scoped_lock l(mtx_);
+
+            boost::uint32_t s = state_.load(boost::memory_order_relaxed);
+            while (true)
+            {
+                if (is_writer ? (s == 0) :
+                    !(s & (writer_flag | waiters_flag)))
+                {
+                    boost::uint32_t desired = is_writer ? writer_flag : s + 1;
+                    if (state_.compare_exchange_weak(s, desired,
+                            boost::memory_order_acquire))
+                    {
+                        return false;
+                    }
+                }
+                else if ((s & waiters_flag) ||
+                    state_.compare_exchange_weak(s, s | waiters_flag,
+                        boost::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+
+            queue.push_back(node);
+            return true;
+        }
+
+        // Transfer the ownership of the lock to the queued threads. This is
+        // called by the last thread releasing the lock while the waiters flag
+        // is set. As no other thread can modify the state in this situation
+        // (everybody else has to acquire mtx_ first), the new state is simply
+        // stored.
+        void handoff()
+        {
+            detail::handoff_node* writer = 0;
+            std::vector<detail::handoff_node*> readers;
+
+            {
+                mutex_type::scoped_lock l(mtx_);
+
+                if (!writers_.empty())
+                {
+                    writer = writers_.pop_front();
+
+                    bool waiters = !writers_.empty() || !readers_.empty();
+                    state_.store(writer_flag | (waiters ? waiters_flag : 0),
+                        boost::memory_order_relaxed);
+                }
+                else
+                {
+                    HPX_ASSERT(!readers_.empty());
+
+                    readers.reserve(readers_.size());
+                    while (!readers_.empty())
+                        readers.push_back(readers_.pop_front());
+
+                    state_.store(static_cast<boost::uint32_t>(readers.size()),
+                        boost::memory_order_relaxed);
+                }
+            }
+
+            if (writer != 0)
+            {
+                writer->grant();
+            }
+            else
+            {
+                for (std::size_t i = 0; i != readers.size(); ++i)
+                    readers[i]->grant();
+            }
+        }
+
+    private:
+        boost::atomic<boost::uint32_t> state_;
+        std::size_t const spin_count_;
+
+        mutex_type mtx_;        // protects the queues of waiting threads
+        detail::handoff_queue writers_;
+        detail::handoff_queue readers_;
+    };
+}}}
+
+#endif
@@ -233,6 +233,12 @@ namespace hpx { namespace lcos { namespace detail
 
         void async(typename shared_state_ptr_for<Future>::type const& f,
             error_code& ec)
+        {
+            async(f, threads::thread_stacksize_default, ec);
+        }
+
+        void async(typename shared_state_ptr_for<Future>::type const& f,
+            threads::thread_stacksize stacksize, error_code& ec)
         {
             {
                 typename mutex_type::scoped_lock l(this->mtx_);
@@ -252,7 +258,8 @@ namespace hpx { namespace lcos { namespace detail
 
             applier::register_thread_plain(
                 util::bind(async_impl_ptr, std::move(this_), f),
-                "continuation::async");
+                "continuation::async", threads::pending, true,
+                threads::thread_priority_normal, std::size_t(-1), stacksize);
 
             if (&ec != &throws)
                 ec = make_success_code();
@@ -290,6 +297,12 @@ namespace hpx { namespace lcos { namespace detail
             async(f, throws);
         }
 
+        void async_stackless(
+            typename shared_state_ptr_for<Future>::type const& f)
+        {
+            async(f, threads::thread_stacksize_nostack, throws);
+        }
+
         void async(typename shared_state_ptr_for<Future>::type const& f,
             threads::executor& sched)
         {
@@ -349,6 +362,8 @@ namespace hpx { namespace lcos { namespace detail
             void (continuation::*cb)(shared_state_ptr const&);
             if (policy & launch::sync)
                 cb = &continuation::run;
+            else if (policy == launch::stackless)
+                cb = &continuation::async_stackless;
             else
                 cb = &continuation::async;
 
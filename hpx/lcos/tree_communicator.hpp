@@ -0,0 +1,708 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file tree_communicator.hpp
+
+#if !defined(HPX_LCOS_TREE_COMMUNICATOR_OCT_19_2014_0604PM)
+#define HPX_LCOS_TREE_COMMUNICATOR_OCT_19_2014_0604PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/apply.hpp>
+#include <hpx/async.hpp>
+#include <hpx/runtime/get_ptr.hpp>
+#include <hpx/runtime/naming/id_type.hpp>
+#include <hpx/runtime/components/new.hpp>
+#include <hpx/runtime/components/server/simple_component_base.hpp>
+#include <hpx/lcos/future.hpp>
+#include <hpx/lcos/local/promise.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/util/assert.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hpx { namespace lcos
+{
+    /// The shapes of the communication trees used by the \a tree_communicator
+    enum tree_topology
+    {
+        binomial_tree = 0,  ///< binomial tree (the default)
+        kary_tree = 1,      ///< k-ary tree, k is given by the fanout
+        ring_topology = 2   ///< chain for broadcast, reduce and gather, ring
+                            ///< based reduce-scatter/allgather for all_reduce
+    };
+
+    /// Parameters controlling the collective operations of a
+    /// \a tree_communicator. All sites have to use the same options.
+    struct tree_options
+    {
+        /// \param topology     [in] The shape of the communication tree.
+        /// \param fanout       [in] The number of children of each site (used
+        ///                     for the k-ary tree only).
+        /// \param segment_size [in] The maximal number of elements sent in one
+        ///                     message. Larger payloads are split into
+        ///                     segments which flow through the tree
+        ///                     concurrently. A segment size of zero disables
+        ///                     segmentation.
+        tree_options(tree_topology topology = binomial_tree,
+                std::size_t fanout = 2, std::size_t segment_size = 8192)
+          : topology_(topology),
+            fanout_(fanout == 0 ? 1 : fanout),
+            segment_size_(segment_size)
+        {}
+
+        tree_topology topology_;
+        std::size_t fanout_;
+        std::size_t segment_size_;
+    };
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // All tree functions work on ranks relative to the root of the
+        // operation, i.e. the root always has rank zero.
+        inline std::size_t tree_parent(tree_options const& opts,
+            std::size_t rank)
+        {
+            HPX_ASSERT(rank != 0);
+            switch (opts.topology_)
+            {
+            case kary_tree:
+                return (rank - 1) / opts.fanout_;
+
+            case ring_topology:
+                return rank - 1;
+
+            case binomial_tree:
+            default:
+                break;
+            }
+            return rank & (rank - 1);       // clear lowest set bit
+        }
+
+        // The children are returned such that the child with the largest
+        // subtree comes first.
+        inline std::vector<std::size_t> tree_children(tree_options const& opts,
+            std::size_t num_sites, std::size_t rank)
+        {
+            std::vector<std::size_t> children;
+            switch (opts.topology_)
+            {
+            case kary_tree:
+                for (std::size_t i = 1; i <= opts.fanout_; ++i)
+                {
+                    std::size_t child = rank * opts.fanout_ + i;
+                    if (child >= num_sites)
+                        break;
+                    children.push_back(child);
+                }
+                break;
+
+            case ring_topology:
+                if (rank + 1 < num_sites)
+                    children.push_back(rank + 1);
+                break;
+
+            case binomial_tree:
+            default:
+                {
+                    // the children of rank r are r + 2^i for all 2^i smaller
+                    // than the lowest set bit of r
+                    std::size_t lowest = rank & ~(rank - 1);
+                    if (rank == 0)
+                    {
+                        lowest = 1;
+                        while (lowest < num_sites)
+                            lowest <<= 1;
+                    }
+                    for (std::size_t mask = lowest >> 1; mask != 0; mask >>= 1)
+                    {
+                        if (rank + mask < num_sites)
+                            children.push_back(rank + mask);
+                    }
+                }
+                break;
+            }
+            return children;
+        }
+
+        // Collect the ranks of the subtree rooted at the given rank
+        inline void tree_subtree(tree_options const& opts, std::size_t num_sites,
+            std::size_t rank, std::vector<std::size_t>& ranks)
+        {
+            ranks.push_back(rank);
+
+            std::vector<std::size_t> children =
+                tree_children(opts, num_sites, rank);
+            for (std::size_t i = 0; i != children.size(); ++i)
+                tree_subtree(opts, num_sites, children[i], ranks);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        inline std::size_t num_segments(std::size_t size,
+            std::size_t segment_size)
+        {
+            if (segment_size == 0 || size == 0)
+                return 1;
+            return (size + segment_size - 1) / segment_size;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The tree_communicator_server is the mailbox of one site. Messages
+        // are identified by the generation of the collective operation, the
+        // site the message originates from (or the step of the algorithm)
+        // and the segment number. A message may arrive before or after the
+        // local operation asks for it.
+        template <typename T>
+        class tree_communicator_server
+          : public hpx::components::simple_component_base<
+                tree_communicator_server<T> >
+        {
+            typedef lcos::local::spinlock mutex_type;
+
+        public:
+            typedef std::pair<std::size_t, std::vector<T> > segment_type;
+
+        private:
+            struct key_type
+            {
+                key_type(std::size_t generation, std::size_t origin,
+                        std::size_t segment)
+                  : generation_(generation), origin_(origin), segment_(segment)
+                {}
+
+                friend bool operator<(key_type const& lhs, key_type const& rhs)
+                {
+                    if (lhs.generation_ != rhs.generation_)
+                        return lhs.generation_ < rhs.generation_;
+                    if (lhs.origin_ != rhs.origin_)
+                        return lhs.origin_ < rhs.origin_;
+                    return lhs.segment_ < rhs.segment_;
+                }
+
+                std::size_t generation_;
+                std::size_t origin_;
+                std::size_t segment_;
+            };
+
+            struct entry
+            {
+                entry() : retrieved_(false), set_(false) {}
+
+                lcos::local::promise<segment_type> promise_;
+                bool retrieved_;
+                bool set_;
+            };
+
+            typedef std::map<key_type, entry> mailbox_type;
+
+        public:
+            tree_communicator_server() {}
+
+            /// Deliver a segment of a collective operation to this site, the
+            /// segment carries the overall number of segments.
+            void set_segment(std::size_t generation, std::size_t origin,
+                std::size_t segment, segment_type const& data)
+            {
+                lcos::local::promise<segment_type> p;
+                {
+                    typename mutex_type::scoped_lock l(mtx_);
+
+                    typename mailbox_type::iterator it = mailbox_.insert(
+                        typename mailbox_type::value_type(
+                            key_type(generation, origin, segment), entry())
+                    ).first;
+
+                    HPX_ASSERT(!it->second.set_);
+                    if (!it->second.retrieved_)
+                    {
+                        // nobody waits for the segment yet, the value is
+                        // stored in the promise
+                        it->second.promise_.set_value(data);
+                        it->second.set_ = true;
+                        return;
+                    }
+
+                    p = std::move(it->second.promise_);
+                    mailbox_.erase(it);
+                }
+
+                // make the value available outside of the lock as this
+                // may run continuations
+                p.set_value(data);
+            }
+
+            HPX_DEFINE_COMPONENT_ACTION_TPL(tree_communicator_server,
+                set_segment, set_segment_action);
+
+            /// Retrieve a segment of a collective operation (local only).
+            hpx::future<segment_type> get_segment(std::size_t generation,
+                std::size_t origin, std::size_t segment)
+            {
+                typename mutex_type::scoped_lock l(mtx_);
+
+                typename mailbox_type::iterator it = mailbox_.insert(
+                    typename mailbox_type::value_type(
+                        key_type(generation, origin, segment), entry())
+                ).first;
+
+                HPX_ASSERT(!it->second.retrieved_);
+                hpx::future<segment_type> f = it->second.promise_.get_future();
+                if (it->second.set_)
+                    mailbox_.erase(it);
+                else
+                    it->second.retrieved_ = true;
+                return f;
+            }
+
+        private:
+            mutex_type mtx_;
+            mailbox_type mailbox_;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename T>
+        struct tree_communicator_data : boost::noncopyable
+        {
+            typedef tree_communicator_server<T> server_type;
+            typedef typename server_type::segment_type segment_type;
+            typedef lcos::local::spinlock mutex_type;
+
+            tree_communicator_data(char const* basename, std::size_t num_sites,
+                    std::size_t this_site, tree_options const& options)
+              : basename_(basename), num_sites_(num_sites),
+                this_site_(this_site), options_(options), ids_(num_sites),
+                generation_(0)
+            {
+                ids_[this_site_] =
+                    hpx::new_<server_type>(hpx::find_here()).get();
+                server_ = hpx::get_ptr_sync<server_type>(ids_[this_site_]);
+                hpx::register_id_with_basename(
+                    basename, ids_[this_site_], this_site_).get();
+            }
+
+            // resolve the id of the given site on first use
+            hpx::id_type get_id(std::size_t site)
+            {
+                {
+                    mutex_type::scoped_lock l(mtx_);
+                    if (ids_[site])
+                        return ids_[site];
+                }
+
+                hpx::id_type id = hpx::find_id_from_basename(
+                    basename_.c_str(), site).get();
+
+                mutex_type::scoped_lock l(mtx_);
+                ids_[site] = id;
+                return id;
+            }
+
+            void send(std::size_t site, std::size_t generation,
+                std::size_t origin, std::size_t segment,
+                std::size_t num_segments, std::vector<T> const& data)
+            {
+                typedef typename server_type::set_segment_action action_type;
+                hpx::apply<action_type>(get_id(site), generation, origin,
+                    segment, segment_type(num_segments, data));
+            }
+
+            segment_type receive(std::size_t generation, std::size_t origin,
+                std::size_t segment)
+            {
+                return server_->get_segment(generation, origin, segment).get();
+            }
+
+            std::size_t rank(std::size_t root) const
+            {
+                return (this_site_ + num_sites_ - root) % num_sites_;
+            }
+
+            std::size_t site(std::size_t rank, std::size_t root) const
+            {
+                return (rank + root) % num_sites_;
+            }
+
+            std::vector<T> segment(std::vector<T> const& data, std::size_t i)
+            {
+                std::size_t size = options_.segment_size_;
+                if (size == 0)
+                    return data;
+
+                std::size_t begin = (std::min)(i * size, data.size());
+                std::size_t end = (std::min)(begin + size, data.size());
+                return std::vector<T>(data.begin() + begin, data.begin() + end);
+            }
+
+            std::string const basename_;
+            std::size_t const num_sites_;
+            std::size_t const this_site_;
+            tree_options const options_;
+
+            mutex_type mtx_;
+            std::vector<hpx::id_type> ids_;
+            boost::shared_ptr<server_type> server_;
+
+            boost::atomic<std::size_t> generation_;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // Every site forwards each segment to its children as soon as it has
+        // arrived, the segments flow down the tree concurrently.
+        template <typename T>
+        std::vector<T> tree_broadcast(
+            boost::shared_ptr<tree_communicator_data<T> > const& comm,
+            std::vector<T> data, std::size_t root, std::size_t generation)
+        {
+            std::size_t rank = comm->rank(root);
+            std::vector<std::size_t> children =
+                tree_children(comm->options_, comm->num_sites_, rank);
+
+            if (rank == 0)
+            {
+                std::size_t num_segments =
+                    detail::num_segments(data.size(), comm->options_.segment_size_);
+                for (std::size_t s = 0; s != num_segments; ++s)
+                {
+                    std::vector<T> segment = comm->segment(data, s);
+                    for (std::size_t i = 0; i != children.size(); ++i)
+                    {
+                        comm->send(comm->site(children[i], root), generation,
+                            root, s, num_segments, segment);
+                    }
+                }
+                return data;
+            }
+
+            std::vector<T> result;
+            std::size_t num_segments = 1;
+            for (std::size_t s = 0; s != num_segments; ++s)
+            {
+                typename tree_communicator_data<T>::segment_type segment =
+                    comm->receive(generation, root, s);
+                num_segments = segment.first;
+
+                for (std::size_t i = 0; i != children.size(); ++i)
+                {
+                    comm->send(comm->site(children[i], root), generation,
+                        root, s, num_segments, segment.second);
+                }
+                result.insert(result.end(), segment.second.begin(),
+                    segment.second.end());
+            }
+            return result;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Every site combines a segment with the corresponding segments of
+        // its children and sends it on to its parent as soon as possible,
+        // the segments flow up the tree concurrently.
+        template <typename T, typename ReduceOp>
+        std::vector<T> tree_reduce(
+            boost::shared_ptr<tree_communicator_data<T> > const& comm,
+            std::vector<T> data, ReduceOp const& op, std::size_t root,
+            std::size_t generation)
+        {
+            std::size_t rank = comm->rank(root);
+            std::vector<std::size_t> children =
+                tree_children(comm->options_, comm->num_sites_, rank);
+
+            std::size_t segment_size = comm->options_.segment_size_;
+            std::size_t num_segments =
+                detail::num_segments(data.size(), segment_size);
+
+            for (std::size_t s = 0; s != num_segments; ++s)
+            {
+                std::size_t begin = segment_size == 0 ? 0 : s * segment_size;
+
+                for (std::size_t i = 0; i != children.size(); ++i)
+                {
+                    std::size_t child = comm->site(children[i], root);
+                    typename tree_communicator_data<T>::segment_type segment =
+                        comm->receive(generation, child, s);
+
+                    HPX_ASSERT(begin + segment.second.size() <= data.size());
+                    for (std::size_t j = 0; j != segment.second.size(); ++j)
+                        data[begin + j] = op(data[begin + j], segment.second[j]);
+                }
+
+                if (rank != 0)
+                {
+                    comm->send(comm->site(tree_parent(comm->options_, rank), root),
+                        generation, comm->this_site_, s, num_segments,
+                        comm->segment(data, s));
+                }
+            }
+
+            if (rank != 0)
+                return std::vector<T>();
+            return data;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Every site forwards the segments of all sites in its subtree to its
+        // parent as they arrive.
+        template <typename T>
+        std::vector<std::vector<T> > tree_gather(
+            boost::shared_ptr<tree_communicator_data<T> > const& comm,
+            std::vector<T> data, std::size_t root, std::size_t generation)
+        {
+            typedef typename tree_communicator_data<T>::segment_type
+                segment_type;
+
+            std::size_t rank = comm->rank(root);
+            std::vector<std::size_t> children =
+                tree_children(comm->options_, comm->num_sites_, rank);
+
+            std::vector<std::vector<T> > result;
+            std::size_t parent = 0;
+            if (rank == 0)
+            {
+                result.resize(comm->num_sites_);
+                result[comm->this_site_] = std::move(data);
+            }
+            else
+            {
+                parent = comm->site(tree_parent(comm->options_, rank), root);
+
+                std::size_t num_segments = detail::num_segments(
+                    data.size(), comm->options_.segment_size_);
+                for (std::size_t s = 0; s != num_segments; ++s)
+                {
+                    comm->send(parent, generation, comm->this_site_, s,
+                        num_segments, comm->segment(data, s));
+                }
+            }
+
+            std::vector<std::size_t> subtree;
+            for (std::size_t i = 0; i != children.size(); ++i)
+                tree_subtree(comm->options_, comm->num_sites_, children[i], subtree);
+
+            for (std::size_t i = 0; i != subtree.size(); ++i)
+            {
+                std::size_t origin = comm->site(subtree[i], root);
+
+                std::size_t num_segments = 1;
+                for (std::size_t s = 0; s != num_segments; ++s)
+                {
+                    segment_type segment = comm->receive(generation, origin, s);
+                    num_segments = segment.first;
+
+                    if (rank == 0)
+                    {
+                        result[origin].insert(result[origin].end(),
+                            segment.second.begin(), segment.second.end());
+                    }
+                    else
+                    {
+                        comm->send(parent, generation, origin, s,
+                            num_segments, segment.second);
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Ring based all-reduce: a reduce-scatter phase followed by an
+        // allgather phase, each of them taking num_sites-1 steps. Every site
+        // sends and receives one block per step, which keeps all links busy.
+        template <typename T, typename ReduceOp>
+        std::vector<T> ring_all_reduce(
+            boost::shared_ptr<tree_communicator_data<T> > const& comm,
+            std::vector<T>& data, ReduceOp const& op, std::size_t generation)
+        {
+            typedef typename tree_communicator_data<T>::segment_type
+                segment_type;
+
+            std::size_t const n = comm->num_sites_;
+            std::size_t const rank = comm->this_site_;
+            std::size_t const right = (rank + 1) % n;
+
+            // block b covers [size*b/n, size*(b+1)/n)
+            std::size_t const size = data.size();
+
+            // reduce-scatter
+            for (std::size_t step = 0; step != n - 1; ++step)
+            {
+                std::size_t send_block = (rank + n - step) % n;
+                comm->send(right, generation, step, send_block, 1,
+                    std::vector<T>(data.begin() + size * send_block / n,
+                        data.begin() + size * (send_block + 1) / n));
+
+                std::size_t recv_block = (rank + 2 * n - step - 1) % n;
+                segment_type segment =
+                    comm->receive(generation, step, recv_block);
+
+                std::size_t begin = size * recv_block / n;
+                HPX_ASSERT(begin + segment.second.size() <= size);
+                for (std::size_t j = 0; j != segment.second.size(); ++j)
+                    data[begin + j] = op(data[begin + j], segment.second[j]);
+            }
+
+            // allgather, every site now holds the fully reduced block rank+1
+            for (std::size_t step = 0; step != n - 1; ++step)
+            {
+                std::size_t send_block = (rank + 1 + n - step) % n;
+                comm->send(right, generation, n - 1 + step, send_block, 1,
+                    std::vector<T>(data.begin() + size * send_block / n,
+                        data.begin() + size * (send_block + 1) / n));
+
+                std::size_t recv_block = (rank + n - step) % n;
+                segment_type segment =
+                    comm->receive(generation, n - 1 + step, recv_block);
+
+                std::copy(segment.second.begin(), segment.second.end(),
+                    data.begin() + size * recv_block / n);
+            }
+
+            return std::move(data);
+        }
+
+        template <typename T, typename ReduceOp>
+        std::vector<T> tree_all_reduce(
+            boost::shared_ptr<tree_communicator_data<T> > const& comm,
+            std::vector<T> data, ReduceOp const& op, std::size_t generation)
+        {
+            if (comm->num_sites_ == 1)
+                return data;
+
+            if (comm->options_.topology_ == ring_topology)
+                return ring_all_reduce(comm, data, op, generation);
+
+            // reduce to site 0 and broadcast the result from there, this uses
+            // two consecutive generations
+            return tree_broadcast(comm,
+                tree_reduce(comm, std::move(data), op, 0, generation),
+                0, generation + 1);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// A tree_communicator connects a fixed number of sites (usually one per
+    /// locality) and provides collective operations on vectors of values of
+    /// type T. The operations use a communication tree of the configured
+    /// shape, large payloads are split into segments which are pipelined
+    /// through the tree.
+    ///
+    /// Like for MPI collectives, all sites have to invoke the same sequence of
+    /// collective operations with matching parameters. The returned futures
+    /// become ready once the operation has finished on the local site.
+    ///
+    /// The type T has to be registered using
+    /// \a HPX_REGISTER_TREE_COMMUNICATOR_DECLARATION and
+    /// \a HPX_REGISTER_TREE_COMMUNICATOR.
+    template <typename T>
+    class tree_communicator
+    {
+    private:
+        typedef detail::tree_communicator_data<T> data_type;
+
+        std::size_t next_generation(std::size_t count = 1)
+        {
+            return data_->generation_.fetch_add(count);
+        }
+
+    public:
+        /// \brief Create the local site of the communicator
+        ///
+        /// \param basename  [in] The name used to connect all sites.
+        /// \param num_sites [in] The number of participating sites, defaults
+        ///                  to the number of localities.
+        /// \param this_site [in] The index of this site, defaults to the
+        ///                  locality id.
+        /// \param options   [in] The topology and segmentation to use.
+        explicit tree_communicator(char const* basename,
+            std::size_t num_sites = ~0U, std::size_t this_site = ~0U,
+            tree_options const& options = tree_options())
+        {
+            if (num_sites == ~0U)
+                num_sites = hpx::get_num_localities_sync();
+            if (this_site == ~0U)
+                this_site = hpx::get_locality_id();
+
+            HPX_ASSERT(this_site < num_sites);
+            data_.reset(new data_type(basename, num_sites, this_site, options));
+        }
+
+        std::size_t num_sites() const { return data_->num_sites_; }
+        std::size_t this_site() const { return data_->this_site_; }
+        tree_options const& options() const { return data_->options_; }
+
+        /// Distribute the data given on the root site to all sites. The
+        /// argument is ignored on all other sites.
+        hpx::future<std::vector<T> >
+        broadcast(std::vector<T> data, std::size_t root = 0)
+        {
+            return hpx::async(&detail::tree_broadcast<T>, data_,
+                std::move(data), root, next_generation());
+        }
+
+        /// Combine the data given on all sites element-wise using the given
+        /// reduction operation, the result is available on the root site
+        /// (the future returned on all other sites refers to an empty
+        /// vector). The reduction operation has to be associative and
+        /// commutative, all sites have to pass vectors of the same size.
+        template <typename ReduceOp>
+        hpx::future<std::vector<T> >
+        reduce(std::vector<T> data, ReduceOp const& op, std::size_t root = 0)
+        {
+            return hpx::async(&detail::tree_reduce<T, ReduceOp>, data_,
+                std::move(data), op, root, next_generation());
+        }
+
+        /// Collect the data given on all sites on the root site (the future
+        /// returned on all other sites refers to an empty vector). The data
+        /// given by the sites may differ in size.
+        hpx::future<std::vector<std::vector<T> > >
+        gather(std::vector<T> data, std::size_t root = 0)
+        {
+            return hpx::async(&detail::tree_gather<T>, data_,
+                std::move(data), root, next_generation());
+        }
+
+        /// Combine the data given on all sites element-wise using the given
+        /// reduction operation and make the result available on all sites.
+        template <typename ReduceOp>
+        hpx::future<std::vector<T> >
+        all_reduce(std::vector<T> data, ReduceOp const& op)
+        {
+            return hpx::async(&detail::tree_all_reduce<T, ReduceOp>, data_,
+                std::move(data), op, next_generation(2));
+        }
+
+    private:
+        boost::shared_ptr<data_type> data_;
+    };
+}}
+
+///////////////////////////////////////////////////////////////////////////////
+#define HPX_REGISTER_TREE_COMMUNICATOR_DECLARATION(type, name)                \
+    HPX_REGISTER_ACTION_DECLARATION(                                          \
+        hpx::lcos::detail::tree_communicator_server<type>::set_segment_action,\
+        BOOST_PP_CAT(tree_communicator_set_segment_action_, name))            \
+    /**/
+
+#define HPX_REGISTER_TREE_COMMUNICATOR(type, name)                            \
+    HPX_REGISTER_ACTION(                                                      \
+        hpx::lcos::detail::tree_communicator_server<type>::set_segment_action,\
+        BOOST_PP_CAT(tree_communicator_set_segment_action_, name));           \
+    typedef hpx::components::simple_component<                                \
+        hpx::lcos::detail::tree_communicator_server<type>                     \
+    > BOOST_PP_CAT(tree_communicator_, name);                                 \
+    HPX_REGISTER_MINIMAL_COMPONENT_FACTORY(BOOST_PP_CAT(tree_communicator_, name)) \
+    /**/
+
+#endif
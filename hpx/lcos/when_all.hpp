@@ -18,6 +18,8 @@
 #include <hpx/util/tuple.hpp>
 #include <hpx/util/detail/pp_strip_parens.hpp>
 
+#include <boost/atomic.hpp>
+#include <boost/intrusive_ptr.hpp>
 #include <boost/preprocessor/cat.hpp>
 #include <boost/preprocessor/enum.hpp>
 #include <boost/preprocessor/iterate.hpp>
@@ -29,6 +31,102 @@
 ///////////////////////////////////////////////////////////////////////////////
 namespace hpx { namespace lcos
 {
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // The when_all_countdown is the shared state of the future returned
+        // from when_all for a std::vector of futures. Instead of spawning a
+        // helper thread which waits for all input futures, it counts down an
+        // atomic counter from each of the attached callbacks. The last
+        // callback to run makes the shared state ready. The callbacks do not
+        // hold a reference to the shared state each, all of them share a
+        // single reference which is released by the last of them.
+        template <typename Sequence>
+        struct when_all_countdown : lcos::detail::future_data<Sequence> //-V690
+        {
+        private:
+            struct on_future_ready_callback
+            {
+                explicit on_future_ready_callback(when_all_countdown* when)
+                  : when_(when)
+                {}
+
+                typedef void result_type;
+
+                void operator()() const
+                {
+                    when_->on_future_ready(1);
+                }
+
+                when_all_countdown* when_;
+            };
+
+            void on_future_ready(std::size_t count)
+            {
+                if (count_.fetch_sub(count) == count)
+                {
+                    // all futures are ready now
+                    this->set_data(std::move(lazy_values_));
+
+                    // release the reference held on behalf of the callbacks
+                    intrusive_ptr_release(this);
+                }
+            }
+
+            // workaround gcc regression wrongly instantiating constructors
+            when_all_countdown();
+            when_all_countdown(when_all_countdown const&);
+
+        public:
+            typedef Sequence argument_type;
+            typedef Sequence result_type;
+
+            explicit when_all_countdown(argument_type && lazy_values)
+              : lazy_values_(std::move(lazy_values))
+              , count_(lazy_values_.size() + 1)
+            {}
+
+            void attach()
+            {
+                typedef typename Sequence::value_type future_type;
+                typedef
+                    typename lcos::detail::shared_state_ptr_for<future_type>::type
+                    shared_state_ptr;
+
+                // the callbacks and this function share a single reference
+                // to this shared state
+                intrusive_ptr_add_ref(this);
+
+                // do not touch the futures which are ready already, just
+                // account for them once all callbacks have been attached
+                std::size_t ready = 0;
+                for (typename Sequence::iterator it = lazy_values_.begin();
+                     it != lazy_values_.end(); ++it)
+                {
+                    shared_state_ptr const& shared_state =
+                        lcos::detail::get_shared_state(*it);
+
+                    if (shared_state->is_ready())
+                    {
+                        ++ready;
+                    }
+                    else
+                    {
+                        shared_state->set_on_completed(
+                            on_future_ready_callback(this));
+                    }
+                }
+
+                // account for all ready futures and for this function
+                on_future_ready(ready + 1);
+            }
+
+        private:
+            result_type lazy_values_;
+            boost::atomic<std::size_t> count_;
+        };
+    }
+
     /// The function \a when_all is a operator allowing to join on the result
     /// of all given futures. It AND-composes all future objects given and
     /// returns a new future object representing the same list of futures
@@ -51,14 +149,28 @@ namespace hpx { namespace lcos
     template <typename Future>
     lcos::future<std::vector<Future> >
     when_all(std::vector<Future>& lazy_values,
-        error_code& ec = throws)
+        error_code& /*ec*/ = throws)
     {
         typedef std::vector<Future> result_type;
 
         if (lazy_values.empty())
             return lcos::make_ready_future(result_type());
 
-        return lcos::when_some(lazy_values.size(), lazy_values, ec);
+        result_type lazy_values_;
+        lazy_values_.reserve(lazy_values.size());
+        std::transform(lazy_values.begin(), lazy_values.end(),
+            std::back_inserter(lazy_values_),
+            detail::when_acquire_future<Future>());
+
+        // the returned future is made ready directly by the last of the
+        // input futures becoming ready, no thread is needed for waiting
+        boost::intrusive_ptr<detail::when_all_countdown<result_type> > p(
+            new detail::when_all_countdown<result_type>(
+                std::move(lazy_values_)));
+        p->attach();
+
+        using traits::future_access;
+        return future_access<lcos::future<result_type> >::create(std::move(p));
     }
 
     template <typename Future>
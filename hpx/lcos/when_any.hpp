@@ -22,6 +22,8 @@
 #include <hpx/util/tuple.hpp>
 #include <hpx/util/detail/pp_strip_parens.hpp>
 
+#include <boost/atomic.hpp>
+#include <boost/intrusive_ptr.hpp>
 #include <boost/preprocessor/cat.hpp>
 #include <boost/preprocessor/enum.hpp>
 #include <boost/preprocessor/iterate.hpp>
@@ -34,8 +36,159 @@
 ///////////////////////////////////////////////////////////////////////////////
 namespace hpx { namespace lcos
 {
+    /// The result type of \a when_any_index: holds the list of futures passed
+    /// to \a when_any_index and the position of the future which was first
+    /// detected as being ready.
+    template <typename Sequence>
+    struct when_any_result
+    {
+        HPX_MOVABLE_BUT_NOT_COPYABLE(when_any_result);
+
+    public:
+        static std::size_t index_error()
+        {
+            return static_cast<std::size_t>(-1);
+        }
+
+        when_any_result()
+          : index(index_error())
+        {}
+
+        when_any_result(std::size_t idx, Sequence && lazy_values)
+          : index(idx)
+          , futures(std::move(lazy_values))
+        {}
+
+        when_any_result(when_any_result && rhs)
+          : index(rhs.index)
+          , futures(std::move(rhs.futures))
+        {
+            rhs.index = index_error();
+        }
+
+        when_any_result& operator=(when_any_result && rhs)
+        {
+            if (this != &rhs)
+            {
+                index = rhs.index;
+                futures = std::move(rhs.futures);
+                rhs.index = index_error();
+            }
+            return *this;
+        }
+
+        std::size_t index;
+        Sequence futures;
+    };
+
     namespace detail
     {
+        ///////////////////////////////////////////////////////////////////////
+        // The when_any_index_frame is the shared state of the future returned
+        // from when_any_index. The first of the attached callbacks to run
+        // records its index using a single compare-and-swap operation, all
+        // other callbacks just drop their reference. The shared state is made
+        // ready as soon as both, the index has been recorded and all callbacks
+        // have been attached, as only then the futures can be moved into the
+        // result.
+        template <typename Sequence>
+        struct when_any_index_frame //-V690
+          : lcos::detail::future_data<when_any_result<Sequence> >
+        {
+        private:
+            typedef when_any_result<Sequence> when_any_result_type;
+
+            struct on_future_ready_callback
+            {
+                on_future_ready_callback(when_any_index_frame* when,
+                        std::size_t idx)
+                  : when_(when), idx_(idx)
+                {}
+
+                typedef void result_type;
+
+                void operator()() const
+                {
+                    when_->on_future_ready(idx_);
+                }
+
+                boost::intrusive_ptr<when_any_index_frame> when_;
+                std::size_t idx_;
+            };
+
+            void on_future_ready(std::size_t idx)
+            {
+                std::size_t index_not_initialized =
+                    when_any_result_type::index_error();
+                if (index_.compare_exchange_strong(index_not_initialized, idx))
+                    publish();
+            }
+
+            void publish()
+            {
+                // the last of the winning callback and attach() makes the
+                // shared state ready
+                if (publish_count_.fetch_sub(1) == 1)
+                {
+                    this->set_data(when_any_result_type(
+                        index_.load(), std::move(lazy_values_)));
+                }
+            }
+
+            // workaround gcc regression wrongly instantiating constructors
+            when_any_index_frame();
+            when_any_index_frame(when_any_index_frame const&);
+
+        public:
+            typedef Sequence argument_type;
+            typedef when_any_result_type result_type;
+
+            explicit when_any_index_frame(argument_type && lazy_values)
+              : lazy_values_(std::move(lazy_values))
+              , index_(when_any_result_type::index_error())
+              , publish_count_(2)
+            {}
+
+            void attach()
+            {
+                typedef typename Sequence::value_type future_type;
+                typedef
+                    typename lcos::detail::shared_state_ptr_for<future_type>::type
+                    shared_state_ptr;
+
+                std::size_t size = lazy_values_.size();
+                for (std::size_t i = 0; i != size; ++i)
+                {
+                    // stop attaching callbacks as soon as any of the futures
+                    // has become ready
+                    if (index_.load(boost::memory_order_relaxed) !=
+                        when_any_result_type::index_error())
+                    {
+                        break;
+                    }
+
+                    shared_state_ptr const& shared_state =
+                        lcos::detail::get_shared_state(lazy_values_[i]);
+
+                    if (shared_state->is_ready())
+                    {
+                        on_future_ready(i);
+                        break;
+                    }
+
+                    shared_state->set_on_completed(
+                        on_future_ready_callback(this, i));
+                }
+
+                publish();
+            }
+
+        private:
+            Sequence lazy_values_;
+            boost::atomic<std::size_t> index_;
+            boost::atomic<std::size_t> publish_count_;
+        };
+
         ///////////////////////////////////////////////////////////////////////
         template <typename Future>
         struct when_any_swapped //-V690
@@ -198,6 +351,76 @@ namespace hpx { namespace lcos
     ///           detected as being ready has swapped position with the last
     ///           element in the list.
 
+    /// The function \a when_any_index is a non-deterministic choice
+    /// operator. It OR-composes all future objects given and returns the same
+    /// list of futures together with the index of the future which was first
+    /// detected as being ready. The returned future is made ready directly
+    /// from the callback of that future, no additional thread is created.
+    /// Every future which becomes ready adds only constant overhead,
+    /// independently of the number of futures passed.
+    ///
+    /// \note There are two variations of when_any_index. The first takes
+    ///       a pair of InputIterators. The second takes an std::vector of
+    ///       future<R>.
+    ///
+    /// \return   Returns a future holding a \a when_any_result, which holds
+    ///           the list of futures as has been passed to when_any_index and
+    ///           the index of the future object which was first detected as
+    ///           being ready. For an empty list of futures the index is
+    ///           \a when_any_result::index_error().
+
+    template <typename Future>
+    lcos::future<when_any_result<std::vector<Future> > >
+    when_any_index(std::vector<Future>& lazy_values,
+        error_code& /*ec*/ = throws)
+    {
+        typedef std::vector<Future> argument_type;
+        typedef when_any_result<argument_type> result_type;
+
+        if (lazy_values.empty())
+            return lcos::make_ready_future(result_type());
+
+        argument_type lazy_values_;
+        lazy_values_.reserve(lazy_values.size());
+        std::transform(lazy_values.begin(), lazy_values.end(),
+            std::back_inserter(lazy_values_),
+            detail::when_acquire_future<Future>());
+
+        boost::intrusive_ptr<detail::when_any_index_frame<argument_type> > p(
+            new detail::when_any_index_frame<argument_type>(
+                std::move(lazy_values_)));
+        p->attach();
+
+        using traits::future_access;
+        return future_access<lcos::future<result_type> >::create(std::move(p));
+    }
+
+    template <typename Future>
+    lcos::future<when_any_result<std::vector<Future> > > //-V659
+    when_any_index(std::vector<Future> && lazy_values,
+        error_code& ec = throws)
+    {
+        return lcos::when_any_index(lazy_values, ec);
+    }
+
+    template <typename Iterator>
+    lcos::future<when_any_result<std::vector<
+        typename lcos::detail::future_iterator_traits<Iterator>::type
+    > > >
+    when_any_index(Iterator begin, Iterator end, error_code& ec = throws)
+    {
+        typedef
+            typename lcos::detail::future_iterator_traits<Iterator>::type
+            future_type;
+        typedef std::vector<future_type> argument_type;
+
+        argument_type lazy_values_;
+        std::transform(begin, end, std::back_inserter(lazy_values_),
+            detail::when_acquire_future<future_type>());
+        return lcos::when_any_index(lazy_values_, ec);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
     template <typename Future>
     lcos::future<std::vector<Future> >
     when_any_swapped(std::vector<Future>& lazy_values,
@@ -293,6 +516,8 @@ namespace hpx
 {
     using lcos::when_any;
     using lcos::when_any_swapped;
+    using lcos::when_any_index;
+    using lcos::when_any_result;
     using lcos::when_any_n;
     using lcos::when_any_swapped_n;
 }
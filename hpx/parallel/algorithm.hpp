@@ -26,5 +26,6 @@
 #include <hpx/parallel/detail/rotate.hpp>
 #include <hpx/parallel/detail/swap_ranges.hpp>
 #include <hpx/parallel/detail/transform.hpp>
+#include <hpx/parallel/detail/uninitialized_fill.hpp>
 
 #endif
@@ -13,8 +13,10 @@
 
 #include <hpx/parallel/config/inline_namespace.hpp>
 #include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/segmented_iterator_traits.hpp>
 #include <hpx/parallel/detail/algorithm_result.hpp>
 #include <hpx/parallel/detail/dispatch.hpp>
+#include <hpx/parallel/detail/segmented.hpp>
 #include <hpx/parallel/detail/for_each.hpp>
 #include <hpx/parallel/detail/is_negative.hpp>
 #include <hpx/parallel/util/zip_iterator.hpp>
@@ -68,6 +70,28 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
                         boost::mpl::false_()));
             }
         };
+
+        template <typename ExPolicy, typename InIter, typename OutIter,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, OutIter>::type
+        copy_(ExPolicy && policy, InIter first, InIter last, OutIter dest,
+            IsSeq is_seq, boost::mpl::false_)
+        {
+            return detail::copy<OutIter>().call(
+                std::forward<ExPolicy>(policy),
+                first, last, dest, is_seq);
+        }
+
+        // segmented source and destination iterators: the values are read
+        // from every source segment and stored into the destination segments
+        template <typename ExPolicy, typename InIter, typename OutIter,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, OutIter>::type
+        copy_(ExPolicy &&, InIter first, InIter last, OutIter dest,
+            IsSeq, boost::mpl::true_)
+        {
+            return detail::segmented_copy<ExPolicy>(first, last, dest);
+        }
         /// \endcond
     }
 
@@ -145,9 +169,16 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
             boost::is_same<std::output_iterator_tag, output_iterator_category>
         >::type is_seq;
 
-        return detail::copy<OutIter>().call(
+        typedef typename boost::mpl::and_<
+            typename traits::segmented_iterator_traits<InIter>
+                ::is_segmented_iterator,
+            typename traits::segmented_iterator_traits<OutIter>
+                ::is_segmented_iterator
+        >::type is_segmented;
+
+        return detail::copy_(
             std::forward<ExPolicy>(policy),
-            first, last, dest, is_seq());
+            first, last, dest, is_seq(), is_segmented());
     }
 
     /////////////////////////////////////////////////////////////////////////////
@@ -14,8 +14,10 @@
 
 #include <hpx/parallel/config/inline_namespace.hpp>
 #include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/segmented_iterator_traits.hpp>
 #include <hpx/parallel/detail/algorithm_result.hpp>
 #include <hpx/parallel/detail/dispatch.hpp>
+#include <hpx/parallel/detail/segmented.hpp>
 #include <hpx/parallel/util/partitioner.hpp>
 #include <hpx/parallel/util/loop.hpp>
 
@@ -87,6 +89,31 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
                         }));
             }
         };
+
+        template <typename ExPolicy, typename InIter, typename T,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy,
+            typename std::iterator_traits<InIter>::difference_type
+        >::type
+        count_(ExPolicy && policy, InIter first, InIter last, T const& value,
+            IsSeq is_seq, boost::mpl::false_)
+        {
+            return detail::count<InIter>().call(
+                std::forward<ExPolicy>(policy),
+                first, last, value, is_seq);
+        }
+
+        // segmented iterators: the counts of all segments are summed up
+        template <typename ExPolicy, typename InIter, typename T,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy,
+            typename std::iterator_traits<InIter>::difference_type
+        >::type
+        count_(ExPolicy &&, InIter first, InIter last, T const& value,
+            IsSeq, boost::mpl::true_)
+        {
+            return detail::segmented_count<ExPolicy>(first, last, value);
+        }
         /// \endcond
     }
 
@@ -152,9 +179,11 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
             boost::is_same<std::input_iterator_tag, category>
         >::type is_seq;
 
-        return detail::count<InIter>().call(
+        return detail::count_(
             std::forward<ExPolicy>(policy),
-            first, last, value, is_seq());
+            first, last, value, is_seq(),
+            typename traits::segmented_iterator_traits<InIter>
+                ::is_segmented_iterator());
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -215,6 +244,32 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
                         }));
             }
         };
+
+        template <typename ExPolicy, typename InIter, typename F,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy,
+            typename std::iterator_traits<InIter>::difference_type
+        >::type
+        count_if_(ExPolicy && policy, InIter first, InIter last, F && f,
+            IsSeq is_seq, boost::mpl::false_)
+        {
+            return detail::count_if<InIter>().call(
+                std::forward<ExPolicy>(policy),
+                first, last, std::forward<F>(f), is_seq);
+        }
+
+        // segmented iterators: the counts of all segments are summed up
+        template <typename ExPolicy, typename InIter, typename F,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy,
+            typename std::iterator_traits<InIter>::difference_type
+        >::type
+        count_if_(ExPolicy &&, InIter first, InIter last, F && f,
+            IsSeq, boost::mpl::true_)
+        {
+            return detail::segmented_count_if<ExPolicy>(
+                first, last, std::forward<F>(f));
+        }
         /// \endcond
     }
 
@@ -296,9 +351,11 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
             boost::is_same<std::input_iterator_tag, category>
         >::type is_seq;
 
-        return detail::count_if<InIter>().call(
+        return detail::count_if_(
             std::forward<ExPolicy>(policy),
-            first, last, std::forward<F>(f), is_seq());
+            first, last, std::forward<F>(f), is_seq(),
+            typename traits::segmented_iterator_traits<InIter>
+                ::is_segmented_iterator());
     }
 }}}
 
@@ -14,8 +14,10 @@
 
 #include <hpx/parallel/config/inline_namespace.hpp>
 #include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/segmented_iterator_traits.hpp>
 #include <hpx/parallel/detail/algorithm_result.hpp>
 #include <hpx/parallel/detail/dispatch.hpp>
+#include <hpx/parallel/detail/segmented.hpp>
 #include <hpx/parallel/detail/for_each.hpp>
 #include <hpx/parallel/detail/is_negative.hpp>
 
@@ -64,6 +66,27 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
                         boost::mpl::false_());
             }
         };
+
+        template <typename ExPolicy, typename InIter, typename T,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, void>::type
+        fill_(ExPolicy && policy, InIter first, InIter last, T const& value,
+            IsSeq is_seq, boost::mpl::false_)
+        {
+            return detail::fill().call(
+                std::forward<ExPolicy>(policy),
+                first, last, value, is_seq);
+        }
+
+        // segmented iterators: fill every segment on its locality
+        template <typename ExPolicy, typename InIter, typename T,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, void>::type
+        fill_(ExPolicy &&, InIter first, InIter last, T const& value,
+            IsSeq, boost::mpl::true_)
+        {
+            return detail::segmented_fill<ExPolicy>(first, last, value);
+        }
         /// \endcond
     }
 
@@ -120,9 +143,11 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
 
         typedef typename is_sequential_execution_policy<ExPolicy>::type is_seq;
 
-        return detail::fill().call(
+        return detail::fill_(
             std::forward<ExPolicy>(policy),
-            first, last, value, is_seq());
+            first, last, value, is_seq(),
+            typename traits::segmented_iterator_traits<InIter>
+                ::is_segmented_iterator());
     }
     ///////////////////////////////////////////////////////////////////////////
     // fill_n
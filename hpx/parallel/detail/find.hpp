@@ -10,9 +10,11 @@
 
 #include <hpx/hpx_fwd.hpp>
 #include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/segmented_iterator_traits.hpp>
 #include <hpx/parallel/detail/algorithm_result.hpp>
 #include <hpx/parallel/detail/predicates.hpp>
 #include <hpx/parallel/detail/dispatch.hpp>
+#include <hpx/parallel/detail/segmented.hpp>
 #include <hpx/parallel/util/partitioner.hpp>
 #include <hpx/parallel/util/loop.hpp>
 
@@ -63,7 +65,7 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
                     {
                         util::loop_idx_n(
                             base_idx, it, part_size, tok,
-                            [&val, &tok](type& v, std::size_t i)
+                            [&val, &tok](type const& v, std::size_t i)
                             {
                                 if (v == val)
                                     tok.cancel(i);
@@ -81,6 +83,27 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
                     });
             }
         };
+
+        template <typename ExPolicy, typename InIter, typename T,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, InIter>::type
+        find_(ExPolicy && policy, InIter first, InIter last, T const& val,
+            IsSeq is_seq, boost::mpl::false_)
+        {
+            return detail::find<InIter>().call(
+                std::forward<ExPolicy>(policy),
+                first, last, val, is_seq);
+        }
+
+        // segmented iterators: all segments are searched concurrently
+        template <typename ExPolicy, typename InIter, typename T,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, InIter>::type
+        find_(ExPolicy &&, InIter first, InIter last, T const& val,
+            IsSeq, boost::mpl::true_)
+        {
+            return detail::segmented_find<ExPolicy>(first, last, val);
+        }
         /// \endcond
     }
 
@@ -147,9 +170,11 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
             boost::is_same<std::input_iterator_tag, iterator_category>
         >::type is_seq;
 
-        return detail::find<InIter>().call(
+        return detail::find_(
             std::forward<ExPolicy>(policy),
-            first, last, val, is_seq());
+            first, last, val, is_seq(),
+            typename traits::segmented_iterator_traits<InIter>
+                ::is_segmented_iterator());
     }
 
     ///////////////////////////////////////////////////////////////////////////
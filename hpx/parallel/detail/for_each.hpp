@@ -14,8 +14,10 @@
 
 #include <hpx/parallel/config/inline_namespace.hpp>
 #include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/segmented_iterator_traits.hpp>
 #include <hpx/parallel/detail/algorithm_result.hpp>
 #include <hpx/parallel/detail/dispatch.hpp>
+#include <hpx/parallel/detail/segmented.hpp>
 #include <hpx/parallel/detail/is_negative.hpp>
 #include <hpx/parallel/util/partitioner.hpp>
 #include <hpx/parallel/util/loop.hpp>
@@ -202,6 +204,28 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
                         std::forward<F>(f), boost::mpl::false_());
             }
         };
+
+        template <typename ExPolicy, typename InIter, typename F,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, void>::type
+        for_each_(ExPolicy && policy, InIter first, InIter last, F && f,
+            IsSeq is_seq, boost::mpl::false_)
+        {
+            return detail::for_each().call(
+                std::forward<ExPolicy>(policy),
+                first, last, std::forward<F>(f), is_seq);
+        }
+
+        // segmented iterators: invoke for_each on every segment
+        template <typename ExPolicy, typename InIter, typename F,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, void>::type
+        for_each_(ExPolicy &&, InIter first, InIter last, F && f,
+            IsSeq, boost::mpl::true_)
+        {
+            return detail::segmented_for_each<ExPolicy>(
+                first, last, std::forward<F>(f));
+        }
         /// \endcond
     }
 
@@ -286,9 +310,11 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
             boost::is_same<std::input_iterator_tag, iterator_category>
         >::type is_seq;
 
-        return detail::for_each().call(
+        return detail::for_each_(
             std::forward<ExPolicy>(policy),
-            first, last, std::forward<F>(f), is_seq());
+            first, last, std::forward<F>(f), is_seq(),
+            typename traits::segmented_iterator_traits<InIter>
+                ::is_segmented_iterator());
     }
 }}}
 
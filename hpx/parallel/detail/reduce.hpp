@@ -14,8 +14,10 @@
 
 #include <hpx/parallel/config/inline_namespace.hpp>
 #include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/segmented_iterator_traits.hpp>
 #include <hpx/parallel/detail/algorithm_result.hpp>
 #include <hpx/parallel/detail/dispatch.hpp>
+#include <hpx/parallel/detail/segmented.hpp>
 #include <hpx/parallel/util/partitioner.hpp>
 #include <hpx/parallel/util/loop.hpp>
 
@@ -76,6 +78,28 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
                     }));
             }
         };
+
+        template <typename ExPolicy, typename InIter, typename T, typename F,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, T>::type
+        reduce_(ExPolicy && policy, InIter first, InIter last, T && init,
+            F && f, IsSeq is_seq, boost::mpl::false_)
+        {
+            return detail::reduce<T>().call(
+                std::forward<ExPolicy>(policy),
+                first, last, std::move(init), std::forward<F>(f), is_seq);
+        }
+
+        // segmented iterators: every segment is reduced on its locality
+        template <typename ExPolicy, typename InIter, typename T, typename F,
+            typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, T>::type
+        reduce_(ExPolicy &&, InIter first, InIter last, T && init,
+            F && f, IsSeq, boost::mpl::true_)
+        {
+            return detail::segmented_reduce<ExPolicy>(
+                first, last, std::move(init), std::forward<F>(f));
+        }
         /// \endcond
     }
 
@@ -166,9 +190,11 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
             boost::is_same<std::input_iterator_tag, iterator_category>
         >::type is_seq;
 
-        return detail::reduce<T>().call(
+        return detail::reduce_(
             std::forward<ExPolicy>(policy),
-            first, last, std::move(init), std::forward<F>(f), is_seq());
+            first, last, std::move(init), std::forward<F>(f), is_seq(),
+            typename traits::segmented_iterator_traits<InIter>
+                ::is_segmented_iterator());
     }
 
     /// Returns GENERALIZED_SUM(+, init, *first, ..., *(first + (last - first) - 1)).
@@ -241,9 +267,11 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
             boost::is_same<std::input_iterator_tag, iterator_category>
         >::type is_seq;
 
-        return detail::reduce<T>().call(
+        return detail::reduce_(
             std::forward<ExPolicy>(policy),
-            first, last, std::move(init), std::plus<T>(), is_seq());
+            first, last, std::move(init), std::plus<T>(), is_seq(),
+            typename traits::segmented_iterator_traits<InIter>
+                ::is_segmented_iterator());
     }
 
     /// Returns GENERALIZED_SUM(+, T(), *first, ..., *(first + (last - first) - 1)).
@@ -319,9 +347,11 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
             boost::is_same<std::input_iterator_tag, iterator_category>
         >::type is_seq;
 
-        return detail::reduce<value_type>().call(
+        return detail::reduce_(
             std::forward<ExPolicy>(policy),
-            first, last, value_type(), std::plus<value_type>(), is_seq());
+            first, last, value_type(), std::plus<value_type>(), is_seq(),
+            typename traits::segmented_iterator_traits<InIter>
+                ::is_segmented_iterator());
     }
 }}}
 
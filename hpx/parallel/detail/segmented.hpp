@@ -0,0 +1,471 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file parallel/detail/segmented.hpp
+
+#if !defined(HPX_PARALLEL_DETAIL_SEGMENTED_OCT_19_2014_1010PM)
+#define HPX_PARALLEL_DETAIL_SEGMENTED_OCT_19_2014_1010PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/exception_list.hpp>
+#include <hpx/lcos/future.hpp>
+#include <hpx/lcos/wait_all.hpp>
+#include <hpx/lcos/local/dataflow.hpp>
+#include <hpx/util/decay.hpp>
+#include <hpx/util/move.hpp>
+#include <hpx/util/result_of.hpp>
+
+#include <hpx/parallel/config/inline_namespace.hpp>
+#include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/exception_list.hpp>
+#include <hpx/parallel/segmented_iterator_traits.hpp>
+#include <hpx/parallel/detail/algorithm_result.hpp>
+#include <hpx/parallel/util/partitioner.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <vector>
+
+// The segmented algorithms invoke one operation per segment of the input
+// range on the locality owning the segment (see
+// traits::segmented_iterator_traits). The per-segment operations run
+// concurrently, their results are combined on the calling locality once all
+// of them have finished. Sequential execution policies process the segments
+// one after the other.
+
+namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1) { namespace detail
+{
+    /// \cond NOINTERNAL
+
+    ///////////////////////////////////////////////////////////////////////////
+    // The result of a segmented algorithm is always computed asynchronously,
+    // convert it to what the execution policy requires.
+    template <typename ExPolicy, typename T>
+    struct segmented_result_impl
+    {
+        typedef T type;
+
+        static type get(hpx::future<T> && f)
+        {
+            return f.get();
+        }
+
+        HPX_ATTRIBUTE_NORETURN static type error()
+        {
+            detail::handle_exception<ExPolicy, T>::call();
+        }
+    };
+
+    template <typename ExPolicy>
+    struct segmented_result_impl<ExPolicy, void>
+    {
+        typedef void type;
+
+        static void get(hpx::future<void> && f)
+        {
+            f.get();
+        }
+
+        HPX_ATTRIBUTE_NORETURN static void error()
+        {
+            detail::handle_exception<ExPolicy, void>::call();
+        }
+    };
+
+    template <typename T>
+    struct segmented_result_impl<task_execution_policy, T>
+    {
+        typedef hpx::future<T> type;
+
+        static type get(hpx::future<T> && f)
+        {
+            return std::move(f);
+        }
+
+        static type error()
+        {
+            return detail::handle_exception<task_execution_policy, T>::call();
+        }
+    };
+
+    template <>
+    struct segmented_result_impl<task_execution_policy, void>
+    {
+        typedef hpx::future<void> type;
+
+        static type get(hpx::future<void> && f)
+        {
+            return std::move(f);
+        }
+
+        static type error()
+        {
+            return detail::handle_exception<task_execution_policy, void>::call();
+        }
+    };
+
+    template <typename ExPolicy, typename T = void>
+    struct segmented_result
+      : segmented_result_impl<typename hpx::util::decay<ExPolicy>::type, T>
+    {};
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Invoke the per-segment operation f for all segments.
+    template <typename ExPolicy, typename Segment, typename F>
+    std::vector<typename hpx::util::result_of<F(Segment const&)>::type>
+    segmented_invoke(std::vector<Segment> const& segments, F && f)
+    {
+        typedef typename hpx::util::result_of<F(Segment const&)>::type
+            future_type;
+        typedef typename is_sequential_execution_policy<ExPolicy>::type
+            is_seq;
+
+        std::vector<future_type> workitems;
+        workitems.reserve(segments.size());
+
+        for (Segment const& seg: segments)
+        {
+            workitems.push_back(f(seg));
+            if (is_seq::value)
+                workitems.back().wait();
+        }
+        return workitems;
+    }
+
+    // Combine the results of the per-segment operations using f, all
+    // exceptions thrown by those are reported as an exception_list.
+    template <typename ExPolicy, typename R, typename T, typename F>
+    typename segmented_result<ExPolicy, R>::type
+    segmented_combine(std::vector<hpx::future<T> > && workitems, F && f)
+    {
+        typedef typename hpx::util::decay<ExPolicy>::type policy_type;
+        typedef typename hpx::util::decay<F>::type func_type;
+
+        func_type func(std::forward<F>(f));
+        return segmented_result<ExPolicy, R>::get(
+            hpx::lcos::local::dataflow(
+                [func](std::vector<hpx::future<T> > && r) mutable -> R
+                {
+                    std::list<boost::exception_ptr> errors;
+                    util::detail::handle_local_exceptions<policy_type>::call(
+                        r, errors);
+                    return func(std::move(r));
+                },
+                std::move(workitems)));
+    }
+
+    template <typename R, typename T>
+    struct segmented_sum
+    {
+        R operator()(std::vector<hpx::future<T> > && r) const
+        {
+            R result = R();
+            for (hpx::future<T>& f: r)
+                result += static_cast<R>(f.get());
+            return result;
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename ExPolicy, typename InIter, typename F>
+    typename segmented_result<ExPolicy>::type
+    segmented_for_each(InIter first, InIter last, F && f)
+    {
+        typedef traits::segmented_iterator_traits<InIter> seg_traits;
+        typedef typename seg_traits::segment_type segment_type;
+
+        try {
+            return segmented_combine<ExPolicy, void>(
+                segmented_invoke<ExPolicy>(seg_traits::segments(first, last),
+                    [&f](segment_type const& seg)
+                    {
+                        return seg_traits::for_each(seg, f);
+                    }),
+                [](std::vector<hpx::future<void> > &&) {});
+        }
+        catch (...) {
+            return segmented_result<ExPolicy>::error();
+        }
+    }
+
+    template <typename ExPolicy, typename InIter, typename T>
+    typename segmented_result<ExPolicy>::type
+    segmented_fill(InIter first, InIter last, T const& value)
+    {
+        typedef traits::segmented_iterator_traits<InIter> seg_traits;
+        typedef typename seg_traits::segment_type segment_type;
+
+        try {
+            return segmented_combine<ExPolicy, void>(
+                segmented_invoke<ExPolicy>(seg_traits::segments(first, last),
+                    [&value](segment_type const& seg)
+                    {
+                        return seg_traits::fill(seg, value);
+                    }),
+                [](std::vector<hpx::future<void> > &&) {});
+        }
+        catch (...) {
+            return segmented_result<ExPolicy>::error();
+        }
+    }
+
+    template <typename ExPolicy, typename InIter, typename T>
+    typename segmented_result<ExPolicy,
+        typename std::iterator_traits<InIter>::difference_type
+    >::type
+    segmented_count(InIter first, InIter last, T const& value)
+    {
+        typedef traits::segmented_iterator_traits<InIter> seg_traits;
+        typedef typename seg_traits::segment_type segment_type;
+        typedef typename std::iterator_traits<InIter>::difference_type
+            difference_type;
+
+        try {
+            return segmented_combine<ExPolicy, difference_type>(
+                segmented_invoke<ExPolicy>(seg_traits::segments(first, last),
+                    [&value](segment_type const& seg)
+                    {
+                        return seg_traits::count(seg, value);
+                    }),
+                segmented_sum<difference_type, std::size_t>());
+        }
+        catch (...) {
+            return segmented_result<ExPolicy, difference_type>::error();
+        }
+    }
+
+    template <typename ExPolicy, typename InIter, typename F>
+    typename segmented_result<ExPolicy,
+        typename std::iterator_traits<InIter>::difference_type
+    >::type
+    segmented_count_if(InIter first, InIter last, F && f)
+    {
+        typedef traits::segmented_iterator_traits<InIter> seg_traits;
+        typedef typename seg_traits::segment_type segment_type;
+        typedef typename std::iterator_traits<InIter>::difference_type
+            difference_type;
+
+        try {
+            return segmented_combine<ExPolicy, difference_type>(
+                segmented_invoke<ExPolicy>(seg_traits::segments(first, last),
+                    [&f](segment_type const& seg)
+                    {
+                        return seg_traits::count_if(seg, f);
+                    }),
+                segmented_sum<difference_type, std::size_t>());
+        }
+        catch (...) {
+            return segmented_result<ExPolicy, difference_type>::error();
+        }
+    }
+
+    // Every segment is reduced on its own, the results of the segments are
+    // reduced in order on the calling locality.
+    template <typename ExPolicy, typename InIter, typename T, typename F>
+    typename segmented_result<ExPolicy, T>::type
+    segmented_reduce(InIter first, InIter last, T && init, F && f)
+    {
+        typedef traits::segmented_iterator_traits<InIter> seg_traits;
+        typedef typename seg_traits::segment_type segment_type;
+        typedef typename seg_traits::value_type value_type;
+        typedef typename hpx::util::decay<F>::type func_type;
+
+        try {
+            func_type func(std::forward<F>(f));
+            return segmented_combine<ExPolicy, T>(
+                segmented_invoke<ExPolicy>(seg_traits::segments(first, last),
+                    [&func](segment_type const& seg)
+                    {
+                        return seg_traits::reduce(seg, func);
+                    }),
+                [init, func](std::vector<hpx::future<value_type> > && r)
+                    -> T
+                {
+                    T result = init;
+                    for (hpx::future<value_type>& f: r)
+                        result = func(result, f.get());
+                    return result;
+                });
+        }
+        catch (...) {
+            return segmented_result<ExPolicy, T>::error();
+        }
+    }
+
+    // All segments are searched concurrently, the first match in the order
+    // of the segments is returned.
+    template <typename ExPolicy, typename InIter, typename T>
+    typename segmented_result<ExPolicy, InIter>::type
+    segmented_find(InIter first, InIter last, T const& value)
+    {
+        typedef traits::segmented_iterator_traits<InIter> seg_traits;
+        typedef typename seg_traits::segment_type segment_type;
+
+        try {
+            std::vector<segment_type> segments =
+                seg_traits::segments(first, last);
+
+            std::vector<hpx::future<std::size_t> > workitems =
+                segmented_invoke<ExPolicy>(segments,
+                    [&value](segment_type const& seg)
+                    {
+                        return seg_traits::find(seg, value);
+                    });
+
+            return segmented_combine<ExPolicy, InIter>(std::move(workitems),
+                [segments, last](std::vector<hpx::future<std::size_t> > && r)
+                    -> InIter
+                {
+                    for (std::size_t i = 0; i != r.size(); ++i)
+                    {
+                        std::size_t const offset = r[i].get();
+                        if (offset != seg_traits::size(segments[i]))
+                            return seg_traits::compose(segments[i], offset);
+                    }
+                    return last;
+                });
+        }
+        catch (...) {
+            return segmented_result<ExPolicy, InIter>::error();
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Store the values produced for one source segment into the parts of the
+    // destination segments [offset, offset + values.size()) refers to.
+    template <typename OutIter, typename Segment, typename T>
+    void segmented_scatter(std::vector<Segment> const& dest_segments,
+        std::size_t offset, std::vector<T> && values)
+    {
+        typedef traits::segmented_iterator_traits<OutIter> seg_traits;
+
+        std::vector<hpx::future<void> > workitems;
+
+        std::size_t dest_offset = 0;
+        std::size_t pos = 0;
+        for (Segment const& seg: dest_segments)
+        {
+            std::size_t const size = seg_traits::size(seg);
+            if (pos == values.size())
+                break;
+
+            if (offset + pos < dest_offset + size)
+            {
+                // this destination segment receives some of the values
+                std::size_t const begin = offset + pos - dest_offset;
+                std::size_t const count =
+                    (std::min)(size - begin, values.size() - pos);
+
+                std::vector<T> part(values.begin() + pos,
+                    values.begin() + pos + count);
+                workitems.push_back(seg_traits::set_values(
+                    seg_traits::subrange(seg, begin, count), std::move(part)));
+
+                pos += count;
+            }
+            dest_offset += size;
+        }
+
+        hpx::wait_all(workitems);
+        for (hpx::future<void>& f: workitems)
+            f.get();
+    }
+
+    // The values of every source segment are produced on the locality
+    // owning the segment (using get_values or transform), the calling
+    // locality forwards them to the destination segments.
+    template <typename ExPolicy, typename InIter, typename OutIter,
+        typename Produce>
+    typename segmented_result<ExPolicy, OutIter>::type
+    segmented_copy_values(InIter first, InIter last, OutIter dest,
+        Produce && produce)
+    {
+        typedef traits::segmented_iterator_traits<InIter> src_traits;
+        typedef traits::segmented_iterator_traits<OutIter> dest_traits;
+        typedef typename src_traits::segment_type src_segment_type;
+        typedef typename dest_traits::segment_type dest_segment_type;
+        typedef typename src_traits::value_type value_type;
+
+        try {
+            std::vector<src_segment_type> segments =
+                src_traits::segments(first, last);
+
+            std::size_t count = 0;
+            for (src_segment_type const& seg: segments)
+                count += src_traits::size(seg);
+
+            OutIter dest_last = dest + count;
+            boost::shared_ptr<std::vector<dest_segment_type> > dest_segments =
+                boost::make_shared<std::vector<dest_segment_type> >(
+                    dest_traits::segments(dest, dest_last));
+
+            std::vector<hpx::future<void> > workitems;
+            workitems.reserve(segments.size());
+
+            std::size_t offset = 0;
+            for (src_segment_type const& seg: segments)
+            {
+                workitems.push_back(hpx::lcos::local::dataflow(
+                    [dest_segments, offset](
+                        hpx::future<std::vector<value_type> > && values)
+                    {
+                        segmented_scatter<OutIter>(*dest_segments, offset,
+                            values.get());
+                    },
+                    produce(seg)));
+
+                if (is_sequential_execution_policy<ExPolicy>::value)
+                    workitems.back().wait();
+
+                offset += src_traits::size(seg);
+            }
+
+            return segmented_combine<ExPolicy, OutIter>(std::move(workitems),
+                [dest_last](std::vector<hpx::future<void> > &&)
+                {
+                    return dest_last;
+                });
+        }
+        catch (...) {
+            return segmented_result<ExPolicy, OutIter>::error();
+        }
+    }
+
+    template <typename ExPolicy, typename InIter, typename OutIter>
+    typename segmented_result<ExPolicy, OutIter>::type
+    segmented_copy(InIter first, InIter last, OutIter dest)
+    {
+        typedef traits::segmented_iterator_traits<InIter> seg_traits;
+        typedef typename seg_traits::segment_type segment_type;
+
+        return segmented_copy_values<ExPolicy>(first, last, dest,
+            [](segment_type const& seg)
+            {
+                return seg_traits::get_values(seg);
+            });
+    }
+
+    template <typename ExPolicy, typename InIter, typename OutIter,
+        typename F>
+    typename segmented_result<ExPolicy, OutIter>::type
+    segmented_transform(InIter first, InIter last, OutIter dest, F && f)
+    {
+        typedef traits::segmented_iterator_traits<InIter> seg_traits;
+        typedef typename seg_traits::segment_type segment_type;
+
+        return segmented_copy_values<ExPolicy>(first, last, dest,
+            [&f](segment_type const& seg)
+            {
+                return seg_traits::transform(seg, f);
+            });
+    }
+    /// \endcond
+}}}}
+
+#endif
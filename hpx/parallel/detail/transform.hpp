@@ -13,8 +13,10 @@
 
 #include <hpx/parallel/config/inline_namespace.hpp>
 #include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/segmented_iterator_traits.hpp>
 #include <hpx/parallel/detail/algorithm_result.hpp>
 #include <hpx/parallel/detail/dispatch.hpp>
+#include <hpx/parallel/detail/segmented.hpp>
 #include <hpx/parallel/detail/for_each.hpp>
 #include <hpx/parallel/util/zip_iterator.hpp>
 
@@ -68,6 +70,30 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
                         boost::mpl::false_()));
             }
         };
+
+        template <typename ExPolicy, typename InIter, typename OutIter,
+            typename F, typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, OutIter>::type
+        transform_(ExPolicy && policy, InIter first, InIter last,
+            OutIter dest, F && f, IsSeq is_seq, boost::mpl::false_)
+        {
+            return detail::transform<OutIter>().call(
+                std::forward<ExPolicy>(policy),
+                first, last, dest, std::forward<F>(f), is_seq);
+        }
+
+        // segmented source and destination iterators: every source segment
+        // is transformed on its locality, the results are stored into the
+        // destination segments
+        template <typename ExPolicy, typename InIter, typename OutIter,
+            typename F, typename IsSeq>
+        typename detail::algorithm_result<ExPolicy, OutIter>::type
+        transform_(ExPolicy &&, InIter first, InIter last,
+            OutIter dest, F && f, IsSeq, boost::mpl::true_)
+        {
+            return detail::segmented_transform<ExPolicy>(
+                first, last, dest, std::forward<F>(f));
+        }
         /// \endcond
     }
 
@@ -151,9 +177,16 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
             boost::is_same<std::input_iterator_tag, iterator_category>
         >::type is_seq;
 
-        return detail::transform<OutIter>().call(
+        typedef typename boost::mpl::and_<
+            typename traits::segmented_iterator_traits<InIter>
+                ::is_segmented_iterator,
+            typename traits::segmented_iterator_traits<OutIter>
+                ::is_segmented_iterator
+        >::type is_segmented;
+
+        return detail::transform_(
             std::forward<ExPolicy>(policy),
-            first, last, dest, std::forward<F>(f), is_seq());
+            first, last, dest, std::forward<F>(f), is_seq(), is_segmented());
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,358 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file parallel/detail/uninitialized_fill.hpp
+
+#if !defined(HPX_PARALLEL_DETAIL_UNINITIALIZED_FILL_OCT_19_2014_0940PM)
+#define HPX_PARALLEL_DETAIL_UNINITIALIZED_FILL_OCT_19_2014_0940PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/exception_list.hpp>
+#include <hpx/util/void_guard.hpp>
+#include <hpx/util/move.hpp>
+
+#include <hpx/parallel/config/inline_namespace.hpp>
+#include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/detail/algorithm_result.hpp>
+#include <hpx/parallel/detail/dispatch.hpp>
+#include <hpx/parallel/detail/is_negative.hpp>
+#include <hpx/parallel/util/partitioner.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include <boost/exception_ptr.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/utility/addressof.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+
+namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v1)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // uninitialized_fill_n
+    namespace detail
+    {
+        /// \cond NOINTERNAL
+
+        // The outcome of constructing the elements of one chunk. A chunk
+        // whose construction has failed has destroyed its elements already.
+        template <typename FwdIter>
+        struct uninitialized_fill_chunk
+        {
+            FwdIter first_;
+            std::size_t count_;
+            boost::exception_ptr error_;
+        };
+
+        template <typename FwdIter>
+        void destroy_n(FwdIter first, std::size_t count)
+        {
+            typedef typename std::iterator_traits<FwdIter>::value_type
+                value_type;
+
+            for (/**/; count != 0; --count, ++first)
+                boost::addressof(*first)->~value_type();
+        }
+
+        // The elements are constructed using the affinity partitioner: the
+        // worker thread constructing an element is the first one touching its
+        // memory, which makes the operating system allocate the memory in
+        // the NUMA domain of this worker thread. Later parallel algorithms
+        // using the affinity partitioner on the same range run each chunk on
+        // the worker which has constructed it.
+        template <typename ExPolicy, typename FwdIter, typename T>
+        typename detail::algorithm_result<ExPolicy, FwdIter>::type
+        parallel_uninitialized_fill_n(ExPolicy const& policy, FwdIter first,
+            std::size_t count, T const& val)
+        {
+            typedef typename std::iterator_traits<FwdIter>::value_type
+                value_type;
+            typedef uninitialized_fill_chunk<FwdIter> chunk_type;
+
+            if (count == 0)
+            {
+                return detail::algorithm_result<ExPolicy, FwdIter>::get(
+                    std::move(first));
+            }
+
+            FwdIter last = first;
+            std::advance(last, count);
+
+            return util::partitioner<
+                    ExPolicy, FwdIter, chunk_type, util::affinity_partitioner_tag
+                >::call(
+                    policy, first, count,
+                    [val](FwdIter part_begin, std::size_t part_size)
+                        -> chunk_type
+                    {
+                        chunk_type chunk = { part_begin, part_size };
+
+                        FwdIter it = part_begin;
+                        std::size_t constructed = 0;
+                        try {
+                            for (/**/; constructed != part_size;
+                                 ++constructed, ++it)
+                            {
+                                ::new (static_cast<void*>(
+                                    boost::addressof(*it))) value_type(val);
+                            }
+                        }
+                        catch (...) {
+                            destroy_n(part_begin, constructed);
+                            chunk.error_ = boost::current_exception();
+                        }
+                        return chunk;
+                    },
+                    [last](std::vector<hpx::future<chunk_type> > && r)
+                        -> FwdIter
+                    {
+                        std::vector<chunk_type> chunks;
+                        chunks.reserve(r.size());
+
+                        std::list<boost::exception_ptr> errors;
+                        for (hpx::future<chunk_type>& f: r)
+                        {
+                            chunks.push_back(f.get());
+                            if (chunks.back().error_)
+                            {
+                                util::detail::handle_local_exceptions<
+                                        ExPolicy
+                                    >::call(chunks.back().error_, errors);
+                            }
+                        }
+
+                        if (!errors.empty())
+                        {
+                            // no element is left constructed on failure
+                            for (chunk_type const& c: chunks)
+                            {
+                                if (!c.error_)
+                                    destroy_n(c.first_, c.count_);
+                            }
+                            boost::throw_exception(
+                                exception_list(std::move(errors)));
+                        }
+                        return last;
+                    });
+        }
+
+        template <typename FwdIter>
+        struct uninitialized_fill_n
+          : public detail::algorithm<uninitialized_fill_n<FwdIter>, FwdIter>
+        {
+            uninitialized_fill_n()
+              : uninitialized_fill_n::algorithm("uninitialized_fill_n")
+            {}
+
+            template <typename ExPolicy, typename T>
+            static FwdIter
+            sequential(ExPolicy const&, FwdIter first, std::size_t count,
+                T const& val)
+            {
+                FwdIter last = first;
+                std::advance(last, count);
+
+                std::uninitialized_fill(first, last, val);
+                return last;
+            }
+
+            template <typename ExPolicy, typename T>
+            static typename detail::algorithm_result<ExPolicy, FwdIter>::type
+            parallel(ExPolicy const& policy, FwdIter first, std::size_t count,
+                T const& val)
+            {
+                return parallel_uninitialized_fill_n(policy, first, count, val);
+            }
+        };
+        /// \endcond
+    }
+
+    /// Copies the given \a value to the first count elements in an
+    /// uninitialized memory area beginning at first. If an exception is thrown
+    /// during the initialization, the function has no effects.
+    ///
+    /// \note   Complexity: Performs exactly \a count assignments, if
+    ///         count > 0, no assignments otherwise.
+    ///
+    /// The parallel overloads construct the elements using the affinity
+    /// partitioner (see \a util::affinity_partitioner_tag). The memory of
+    /// each chunk of elements is touched first by the worker thread which
+    /// later parallel algorithms using the affinity partitioner on the same
+    /// range will run this chunk on.
+    ///
+    /// \tparam ExPolicy    The type of the execution policy to use (deduced).
+    ///                     It describes the manner in which the execution
+    ///                     of the algorithm may be parallelized and the manner
+    ///                     in which it executes the assignments.
+    /// \tparam FwdIter     The type of the source iterators used (deduced).
+    ///                     This iterator type must meet the requirements of an
+    ///                     forward iterator.
+    /// \tparam Size        The type of the argument specifying the number of
+    ///                     elements to apply \a f to.
+    /// \tparam T           The type of the value to be assigned (deduced).
+    ///
+    /// \param policy       The execution policy to use for the scheduling of
+    ///                     the iterations.
+    /// \param first        Refers to the beginning of the sequence of elements
+    ///                     the algorithm will be applied to.
+    /// \param count        Refers to the number of elements starting at
+    ///                     \a first the algorithm will be applied to.
+    /// \param value        The value to be assigned.
+    ///
+    /// The initializations in the parallel \a uninitialized_fill_n algorithm
+    /// invoked with an execution policy object of type
+    /// \a sequential_execution_policy execute in sequential order in the
+    /// calling thread.
+    ///
+    /// The initializations in the parallel \a uninitialized_fill_n algorithm
+    /// invoked with an execution policy object of type
+    /// \a parallel_execution_policy or \a task_execution_policy are permitted
+    /// to execute in an unordered fashion in unspecified threads, and
+    /// indeterminately sequenced within each thread.
+    ///
+    /// \returns  The \a uninitialized_fill_n algorithm returns a
+    ///           \a hpx::future<FwdIter> if the execution policy is of type
+    ///           \a task_execution_policy and returns FwdIter otherwise.
+    ///           The \a uninitialized_fill_n algorithm returns the iterator
+    ///           to the element in the source range, one past the last
+    ///           element constructed.
+    ///
+    template <typename ExPolicy, typename FwdIter, typename Size, typename T>
+    inline typename boost::enable_if<
+        is_execution_policy<ExPolicy>,
+        typename detail::algorithm_result<ExPolicy, FwdIter>::type
+    >::type
+    uninitialized_fill_n(ExPolicy && policy, FwdIter first, Size count,
+        T const& value)
+    {
+        typedef typename std::iterator_traits<FwdIter>::iterator_category
+            iterator_category;
+
+        BOOST_STATIC_ASSERT_MSG(
+            (boost::is_base_of<
+                std::forward_iterator_tag, iterator_category>::value),
+            "Required at least forward iterator.");
+
+        // if count is representing a negative value, we do nothing
+        if (detail::is_negative<Size>::call(count))
+        {
+            return detail::algorithm_result<ExPolicy, FwdIter>::get(
+                std::move(first));
+        }
+
+        typedef typename is_sequential_execution_policy<ExPolicy>::type is_seq;
+
+        return detail::uninitialized_fill_n<FwdIter>().call(
+            std::forward<ExPolicy>(policy),
+            first, std::size_t(count), value, is_seq());
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // uninitialized_fill
+    namespace detail
+    {
+        /// \cond NOINTERNAL
+        struct uninitialized_fill
+          : public detail::algorithm<uninitialized_fill>
+        {
+            uninitialized_fill()
+              : uninitialized_fill::algorithm("uninitialized_fill")
+            {}
+
+            template <typename ExPolicy, typename FwdIter, typename T>
+            static hpx::util::unused_type
+            sequential(ExPolicy const&, FwdIter first, FwdIter last,
+                T const& val)
+            {
+                std::uninitialized_fill(first, last, val);
+                return hpx::util::unused;
+            }
+
+            template <typename ExPolicy, typename FwdIter, typename T>
+            static typename detail::algorithm_result<ExPolicy>::type
+            parallel(ExPolicy const& policy, FwdIter first, FwdIter last,
+                T const& val)
+            {
+                typedef typename detail::algorithm_result<ExPolicy>::type
+                    result_type;
+
+                return hpx::util::void_guard<result_type>(),
+                    parallel_uninitialized_fill_n(policy, first,
+                        std::distance(first, last), val);
+            }
+        };
+        /// \endcond
+    }
+
+    /// Copies the given \a value to an uninitialized memory area, defined by
+    /// the range [first, last). If an exception is thrown during the
+    /// initialization, the function has no effects.
+    ///
+    /// \note   Complexity: Linear in the distance between \a first and \a last
+    ///
+    /// The parallel overloads construct the elements using the affinity
+    /// partitioner, see \a uninitialized_fill_n.
+    ///
+    /// \tparam ExPolicy    The type of the execution policy to use (deduced).
+    ///                     It describes the manner in which the execution
+    ///                     of the algorithm may be parallelized and the manner
+    ///                     in which it executes the assignments.
+    /// \tparam FwdIter     The type of the source iterators used (deduced).
+    ///                     This iterator type must meet the requirements of an
+    ///                     forward iterator.
+    /// \tparam T           The type of the value to be assigned (deduced).
+    ///
+    /// \param policy       The execution policy to use for the scheduling of
+    ///                     the iterations.
+    /// \param first        Refers to the beginning of the sequence of elements
+    ///                     the algorithm will be applied to.
+    /// \param last         Refers to the end of the sequence of elements the
+    ///                     algorithm will be applied to.
+    /// \param value        The value to be assigned.
+    ///
+    /// The initializations in the parallel \a uninitialized_fill algorithm
+    /// invoked with an execution policy object of type
+    /// \a sequential_execution_policy execute in sequential order in the
+    /// calling thread.
+    ///
+    /// The initializations in the parallel \a uninitialized_fill algorithm
+    /// invoked with an execution policy object of type
+    /// \a parallel_execution_policy or \a task_execution_policy are permitted
+    /// to execute in an unordered fashion in unspecified threads, and
+    /// indeterminately sequenced within each thread.
+    ///
+    /// \returns  The \a uninitialized_fill algorithm returns a
+    ///           \a hpx::future<void>, if the execution policy is of type
+    ///           \a task_execution_policy and returns nothing otherwise.
+    ///
+    template <typename ExPolicy, typename FwdIter, typename T>
+    inline typename boost::enable_if<
+        is_execution_policy<ExPolicy>,
+        typename detail::algorithm_result<ExPolicy>::type
+    >::type
+    uninitialized_fill(ExPolicy && policy, FwdIter first, FwdIter last,
+        T const& value)
+    {
+        typedef typename std::iterator_traits<FwdIter>::iterator_category
+            iterator_category;
+
+        BOOST_STATIC_ASSERT_MSG(
+            (boost::is_base_of<
+                std::forward_iterator_tag, iterator_category>::value),
+            "Required at least forward iterator.");
+
+        typedef typename is_sequential_execution_policy<ExPolicy>::type is_seq;
+
+        return detail::uninitialized_fill().call(
+            std::forward<ExPolicy>(policy),
+            first, last, value, is_seq());
+    }
+}}}
+
+#endif
@@ -0,0 +1,71 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file parallel/segmented_iterator_traits.hpp
+
+#if !defined(HPX_PARALLEL_SEGMENTED_ITERATOR_TRAITS_OCT_19_2014_1005PM)
+#define HPX_PARALLEL_SEGMENTED_ITERATOR_TRAITS_OCT_19_2014_1005PM
+
+#include <hpx/hpx_fwd.hpp>
+
+#include <boost/mpl/bool.hpp>
+
+namespace hpx { namespace parallel { namespace traits
+{
+    ///////////////////////////////////////////////////////////////////////////
+    /// A segmented iterator refers to a sequence of elements which is split
+    /// into segments, where each segment may live on a different locality
+    /// (see http://lafstern.org/matt/segmented.pdf). The parallel algorithms
+    /// for_each, fill, count, count_if, find, reduce, copy, and transform
+    /// recognize segmented iterators and invoke one operation per segment
+    /// on the locality owning the segment, all of those concurrently. Every
+    /// segment is processed in parallel on its locality.
+    ///
+    /// Containers exposing segmented iterators specialize this template. The
+    /// specialization has to provide:
+    ///
+    /// \code
+    ///     typedef boost::mpl::true_ is_segmented_iterator;
+    ///     typedef ... value_type;       // type of the elements
+    ///     typedef ... segment_type;     // non-empty part of one segment
+    ///
+    ///     // split [first, last) into the parts of the touched segments
+    ///     static std::vector<segment_type> segments(Iterator first,
+    ///         Iterator last);
+    ///     static std::size_t size(segment_type const& seg);
+    ///     static segment_type subrange(segment_type const& seg,
+    ///         std::size_t offset, std::size_t count);
+    ///
+    ///     // the iterator referring to element 'offset' of the segment part
+    ///     static Iterator compose(segment_type const& seg,
+    ///         std::size_t offset);
+    ///
+    ///     // operations executed on the locality owning the segment
+    ///     static future<void> for_each(segment_type const& seg, F f);
+    ///     static future<void> fill(segment_type const& seg, value_type v);
+    ///     static future<std::size_t> count(segment_type const& seg,
+    ///         value_type v);
+    ///     static future<std::size_t> count_if(segment_type const& seg, F f);
+    ///     static future<value_type> reduce(segment_type const& seg, F f);
+    ///     static future<std::size_t> find(segment_type const& seg,
+    ///         value_type v);    // offset of the element or size(seg)
+    ///     static future<std::vector<value_type> > transform(
+    ///         segment_type const& seg, F f);
+    ///     static future<std::vector<value_type> > get_values(
+    ///         segment_type const& seg);
+    ///     static future<void> set_values(segment_type const& seg,
+    ///         std::vector<value_type> && values);
+    /// \endcode
+    ///
+    /// The function objects passed to the per-segment operations are sent
+    /// to the owning localities, they have to be serializable.
+    template <typename Iterator, typename Enable = void>
+    struct segmented_iterator_traits
+    {
+        typedef boost::mpl::false_ is_segmented_iterator;
+    };
+}}}
+
+#endif
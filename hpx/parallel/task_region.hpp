@@ -16,11 +16,20 @@
 #include <hpx/lcos/future.hpp>
 #include <hpx/lcos/when_all.hpp>
 #include <hpx/async.hpp>
+#include <hpx/lcos/local/packaged_task.hpp>
+#include <hpx/runtime/threads/thread_helpers.hpp>
+#include <hpx/util/decay.hpp>
+#include <hpx/util/deferred_call.hpp>
+#include <hpx/util/unique_function.hpp>
 
 #include <hpx/parallel/config/inline_namespace.hpp>
 #include <hpx/parallel/exception_list.hpp>
 #include <hpx/parallel/execution_policy.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 #if !defined(BOOST_NO_CXX11_DELETED_FUNCTIONS)
 #include <memory>                           // std::addressof
 #include <boost/utility/addressof.hpp>      // boost::addressof
@@ -202,7 +211,7 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v2)
             if (id_ != threads::get_self_id())
             {
                 HPX_THROW_EXCEPTION(task_region_not_active,
-                    "task_region_hanlde::run",
+                    "task_region_handle::run",
                     "the task_region_handle is not active");
             }
 
@@ -212,6 +221,56 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v2)
             tasks_.push_back(std::move(result));
         }
 
+        /// Causes the expressions f(0), f(1), ..., f(count-1) to be invoked
+        /// asynchronously. This is equivalent to calling
+        /// run([=]{ f(i); }) for every i in [0, count), except that all
+        /// of the new tasks are handed to the scheduler at once, which is
+        /// considerably cheaper than creating them one by one.
+        ///
+        /// Requires: F shall be CopyConstructible. The expression,
+        ///           (void)f(i), shall be well-formed for an argument i
+        ///           of type std::size_t.
+        ///
+        /// Precondition: this shall be the active task_region_handle.
+        ///
+        /// \throws \a task_canceled_exception, as described in Exception
+        ///         Handling.
+        ///
+        template <typename F>
+        void run_n(std::size_t count, F && f)
+        {
+            // The proposal requires that the task_region_handle should be
+            // 'active' to be usable.
+            if (id_ != threads::get_self_id())
+            {
+                HPX_THROW_EXCEPTION(task_region_not_active,
+                    "task_region_handle::run_n",
+                    "the task_region_handle is not active");
+            }
+
+            typedef typename hpx::util::decay<F>::type func_type;
+            func_type func(std::forward<F>(f));
+
+            std::vector<hpx::future<void> > results;
+            std::vector<hpx::util::unique_function_nonser<void()> > tasks;
+            results.reserve(count);
+            tasks.reserve(count);
+
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                lcos::local::packaged_task<void()> task(
+                    hpx::util::deferred_call(func, i));
+                results.push_back(task.get_future());
+                tasks.push_back(std::move(task));
+            }
+            threads::register_work_nullary_bulk(std::move(tasks),
+                "task_region_handle::run_n");
+
+            mutex_type::scoped_lock l(mtx_);
+            std::move(results.begin(), results.end(),
+                std::back_inserter(tasks_));
+        }
+
         /// Blocks until the tasks spawned using this task_region_handle have
         /// finished.
         ///
@@ -243,7 +302,7 @@ namespace hpx { namespace parallel { HPX_INLINE_NAMESPACE(v2)
             if (id_ != threads::get_self_id())
             {
                 HPX_THROW_EXCEPTION(task_region_not_active,
-                    "task_region_hanlde::run",
+                    "task_region_handle::run",
                     "the task_region_handle is not active");
             }
 
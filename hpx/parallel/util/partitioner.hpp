@@ -11,17 +11,80 @@
 #include <hpx/exception_list.hpp>
 #include <hpx/lcos/wait_all.hpp>
 #include <hpx/lcos/local/dataflow.hpp>
+#include <hpx/lcos/local/packaged_task.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/runtime/threads/thread_helpers.hpp>
 #include <hpx/util/bind.hpp>
 #include <hpx/parallel/execution_policy.hpp>
 #include <hpx/parallel/detail/algorithm_result.hpp>
 #include <hpx/util/decay.hpp>
+#include <hpx/util/deferred_call.hpp>
+#include <hpx/util/function.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/utility/addressof.hpp>
+#include <boost/type_traits/is_reference.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
 namespace hpx { namespace parallel { namespace util
 {
     struct static_partitioner_tag {};
     struct auto_partitioner_tag {};
+    struct recursive_partitioner_tag {};
+    struct guided_partitioner_tag {};
+    struct affinity_partitioner_tag {};
     struct default_partitioner_tag {};
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Timing information about a single chunk of iterations executed by a
+    /// partitioner.
+    struct chunk_info
+    {
+        std::size_t base_idx_;      ///< index of the first element
+        std::size_t count_;         ///< number of elements
+        std::size_t worker_;        ///< worker thread executing the chunk
+        boost::uint64_t start_;     ///< start time [ns]
+        boost::uint64_t elapsed_;   ///< execution time [ns]
+    };
+
+    typedef hpx::util::function_nonser<void(chunk_info const&)>
+        chunk_timing_hook_type;
+
+    namespace detail
+    {
+        inline chunk_timing_hook_type& chunk_timing_hook()
+        {
+            static chunk_timing_hook_type hook;
+            return hook;
+        }
+    }
+
+    /// Install a function which is called for every chunk executed by the
+    /// guided partitioner, returns the previously installed function. The
+    /// function is invoked concurrently from the worker threads executing
+    /// the chunks. It must not be changed while a parallel algorithm is
+    /// running.
+    inline chunk_timing_hook_type
+    set_chunk_timing_hook(chunk_timing_hook_type const& f)
+    {
+        chunk_timing_hook_type prev = detail::chunk_timing_hook();
+        detail::chunk_timing_hook() = f;
+        return prev;
+    }
 }}}
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -154,6 +217,37 @@ namespace hpx { namespace parallel { namespace util
             return chunk_size;
         }
 
+        ///////////////////////////////////////////////////////////////////////
+        // Collects the chunks of iterations to be run on new threads. All of
+        // those threads are created by spawn() using a single call into the
+        // scheduler.
+        template <typename Result>
+        class bulk_spawner
+        {
+        public:
+            template <typename F>
+            hpx::future<Result> add(F && f)
+            {
+                lcos::local::packaged_task<Result()> task(std::forward<F>(f));
+                hpx::future<Result> result = task.get_future();
+                tasks_.push_back(std::move(task));
+                return result;
+            }
+
+            void spawn()
+            {
+                if (!tasks_.empty())
+                {
+                    threads::register_work_nullary_bulk(std::move(tasks_),
+                        "partitioner::bulk_spawner");
+                    tasks_.clear();
+                }
+            }
+
+        private:
+            std::vector<hpx::util::unique_function_nonser<void()> > tasks_;
+        };
+
         ///////////////////////////////////////////////////////////////////////
         // The static partitioner simply spawns one chunk of iterations for
         // each available core.
@@ -168,6 +262,10 @@ namespace hpx { namespace parallel { namespace util
                 std::list<boost::exception_ptr> errors;
 
                 try {
+                    // chunks which were not spawned yet are abandoned if an
+                    // exception is thrown
+                    detail::bulk_spawner<Result> spawner;
+
                     // estimate a chunk size based on number of cores used
                     chunk_size = get_static_chunk_size(policy, workitems, f1,
                         first, count, chunk_size);
@@ -185,13 +283,17 @@ namespace hpx { namespace parallel { namespace util
                         }
                         else
                         {
-                            workitems.push_back(hpx::async(hpx::launch::fork,
-                                f1, first, chunk_size));
+                            workitems.push_back(spawner.add(
+                                hpx::util::deferred_call(
+                                    f1, first, chunk_size)));
                         }
                         count -= chunk_size;
                         std::advance(first, chunk_size);
                     }
 
+                    // create the threads for all chunks at once
+                    spawner.spawn();
+
                     // execute last chunk directly
                     if (count != 0)
                     {
@@ -227,6 +329,8 @@ namespace hpx { namespace parallel { namespace util
                 std::list<boost::exception_ptr> errors;
 
                 try {
+                    detail::bulk_spawner<Result> spawner;
+
                     // estimate a chunk size based on number of cores used
                     chunk_size = get_static_chunk_size(policy, workitems, f1,
                         first, count, chunk_size);
@@ -244,8 +348,9 @@ namespace hpx { namespace parallel { namespace util
                         }
                         else
                         {
-                            workitems.push_back(hpx::async(hpx::launch::fork, f1,
-                                first, chunk_size));
+                            workitems.push_back(spawner.add(
+                                hpx::util::deferred_call(
+                                    f1, first, chunk_size)));
                         }
                         count -= chunk_size;
                         std::advance(first, chunk_size);
@@ -260,11 +365,14 @@ namespace hpx { namespace parallel { namespace util
                         }
                         else
                         {
-                            workitems.push_back(hpx::async(hpx::launch::fork, f1,
-                                first, count));
+                            workitems.push_back(spawner.add(
+                                hpx::util::deferred_call(f1, first, count)));
                         }
                         std::advance(first, count);
                     }
+
+                    // create the threads for all chunks at once
+                    spawner.spawn();
                 }
                 catch (std::bad_alloc const&) {
                     return hpx::make_error_future<FwdIter>(
@@ -418,6 +526,8 @@ namespace hpx { namespace parallel { namespace util
                 std::list<boost::exception_ptr> errors;
 
                 try {
+                    detail::bulk_spawner<Result> spawner;
+
                     // estimate a chunk size based on number of cores used
                     chunk_size = get_static_chunk_size(policy, workitems, f1,
                         first, count, chunk_size);
@@ -435,13 +545,17 @@ namespace hpx { namespace parallel { namespace util
                         }
                         else
                         {
-                            workitems.push_back(hpx::async(hpx::launch::fork, f1,
-                                first, chunk_size));
+                            workitems.push_back(spawner.add(
+                                hpx::util::deferred_call(
+                                    f1, first, chunk_size)));
                         }
                         count -= chunk_size;
                         std::advance(first, chunk_size);
                     }
 
+                    // create the threads for all chunks at once
+                    spawner.spawn();
+
                     // execute last chunk directly
                     if (count != 0)
                     {
@@ -471,6 +585,8 @@ namespace hpx { namespace parallel { namespace util
                 std::list<boost::exception_ptr> errors;
 
                 try {
+                    detail::bulk_spawner<Result> spawner;
+
                     // estimate a chunk size based on number of cores used
                     std::size_t base_idx = 0;
                     chunk_size = get_static_chunk_size_idx(policy, workitems,
@@ -489,14 +605,18 @@ namespace hpx { namespace parallel { namespace util
                         }
                         else
                         {
-                            workitems.push_back(hpx::async(hpx::launch::fork,
-                                f1, base_idx, first, chunk_size));
+                            workitems.push_back(spawner.add(
+                                hpx::util::deferred_call(
+                                    f1, base_idx, first, chunk_size)));
                         }
                         count -= chunk_size;
                         std::advance(first, chunk_size);
                         base_idx += chunk_size;
                     }
 
+                    // create the threads for all chunks at once
+                    spawner.spawn();
+
                     // execute last chunk directly
                     if (count != 0)
                     {
@@ -531,6 +651,8 @@ namespace hpx { namespace parallel { namespace util
                 std::list<boost::exception_ptr> errors;
 
                 try {
+                    detail::bulk_spawner<Result> spawner;
+
                     // estimate a chunk size based on number of cores used
                     chunk_size = get_static_chunk_size(policy, workitems, f1,
                         first, count, chunk_size);
@@ -548,8 +670,9 @@ namespace hpx { namespace parallel { namespace util
                         }
                         else
                         {
-                            workitems.push_back(hpx::async(hpx::launch::fork,
-                                f1, first, chunk_size));
+                            workitems.push_back(spawner.add(
+                                hpx::util::deferred_call(
+                                    f1, first, chunk_size)));
                         }
                         count -= chunk_size;
                         std::advance(first, chunk_size);
@@ -564,11 +687,14 @@ namespace hpx { namespace parallel { namespace util
                         }
                         else
                         {
-                            workitems.push_back(hpx::async(hpx::launch::fork,
-                                f1, first, count));
+                            workitems.push_back(spawner.add(
+                                hpx::util::deferred_call(f1, first, count)));
                         }
                         std::advance(first, count);
                     }
+
+                    // create the threads for all chunks at once
+                    spawner.spawn();
                 }
                 catch (std::bad_alloc const&) {
                     return hpx::make_error_future<R>(
@@ -599,6 +725,8 @@ namespace hpx { namespace parallel { namespace util
                 std::list<boost::exception_ptr> errors;
 
                 try {
+                    detail::bulk_spawner<Result> spawner;
+
                     // estimate a chunk size based on number of cores used
                     std::size_t base_idx = 0;
                     chunk_size = get_static_chunk_size_idx(policy, workitems,
@@ -617,8 +745,9 @@ namespace hpx { namespace parallel { namespace util
                         }
                         else
                         {
-                            workitems.push_back(hpx::async(hpx::launch::fork,
-                                f1, base_idx, first, chunk_size));
+                            workitems.push_back(spawner.add(
+                                hpx::util::deferred_call(
+                                    f1, base_idx, first, chunk_size)));
                         }
                         count -= chunk_size;
                         std::advance(first, chunk_size);
@@ -635,11 +764,15 @@ namespace hpx { namespace parallel { namespace util
                         }
                         else
                         {
-                            workitems.push_back(hpx::async(hpx::launch::fork,
-                                f1, base_idx, first, count));
+                            workitems.push_back(spawner.add(
+                                hpx::util::deferred_call(
+                                    f1, base_idx, first, count)));
                         }
                         std::advance(first, count);
                     }
+
+                    // create the threads for all chunks at once
+                    spawner.spawn();
                 }
                 catch (std::bad_alloc const&) {
                     return hpx::make_error_future<R>(
@@ -662,58 +795,1253 @@ namespace hpx { namespace parallel { namespace util
         };
 
         ///////////////////////////////////////////////////////////////////////
-        // ExPolicy: execution policy
-        // R:        overall result type
-        // Result:   intermediate result type of first step
-        // PartTag:  select appropriate partitioner
-        template <typename ExPolicy, typename R, typename Result, typename PartTag>
-        struct partitioner;
+        // estimate a chunk size for the recursive partitioner, the chunks are
+        // smaller than for the static partitioner as the load is balanced by
+        // splitting the range recursively
+        template <typename Result, typename F1, typename FwdIter>
+        std::size_t estimate_chunk_size(
+            std::vector<hpx::future<Result> >& workitems, F1 && f1,
+            std::size_t& base_idx, FwdIter& first, std::size_t& count,
+            boost::mpl::false_)
+        {
+            std::size_t const n = count;
+            std::size_t chunk_size = auto_chunk_size(workitems, f1, first, count);
+            base_idx += n - count;
+            return chunk_size;
+        }
+
+        template <typename Result, typename F1, typename FwdIter>
+        std::size_t estimate_chunk_size(
+            std::vector<hpx::future<Result> >& workitems, F1 && f1,
+            std::size_t& base_idx, FwdIter& first, std::size_t& count,
+            boost::mpl::true_)
+        {
+            return auto_chunk_size_idx(workitems, f1, base_idx, first, count);
+        }
+
+        template <typename ExPolicy, typename Result, typename F1,
+            typename FwdIter, typename WithIndex>
+        std::size_t get_recursive_chunk_size(ExPolicy const& policy,
+            std::vector<hpx::future<Result> >& workitems, F1 && f1,
+            std::size_t& base_idx, FwdIter& first, std::size_t& count,
+            WithIndex with_index)
+        {
+            threads::executor exec = policy.get_executor();
+            std::size_t chunk_size = policy.get_chunk_size();
+            if (chunk_size == 0)
+            {
+                std::size_t const cores = hpx::get_os_thread_count(exec);
+                if (count > 100*cores)
+                {
+                    chunk_size = estimate_chunk_size(workitems, f1, base_idx,
+                        first, count, with_index);
+                }
+
+                // create a couple of chunks per core
+                if (chunk_size == 0)
+                    chunk_size = (count + 4*cores - 1) / (4*cores);
+            }
+            return chunk_size != 0 ? chunk_size : 1;
+        }
 
         ///////////////////////////////////////////////////////////////////////
-        template <typename ExPolicy, typename R, typename Result>
-        struct partitioner<ExPolicy, R, Result, static_partitioner_tag>
+        // Execute a single chunk, any exception is stored in the returned
+        // future.
+        template <typename Result, typename F1, typename FwdIter>
+        hpx::future<Result> invoke_chunk(F1& f1, std::size_t,
+            FwdIter first, std::size_t count, boost::mpl::false_)
         {
-            template <typename FwdIter, typename F1, typename F2>
-            static R call(ExPolicy const& policy, FwdIter first,
-                std::size_t count, F1 && f1, F2 && f2)
+            try {
+                return hpx::async(hpx::launch::sync, f1, first, count);
+            }
+            catch (...) {
+                return hpx::make_error_future<Result>(
+                    boost::current_exception());
+            }
+        }
+
+        template <typename Result, typename F1, typename FwdIter>
+        hpx::future<Result> invoke_chunk(F1& f1, std::size_t base_idx,
+            FwdIter first, std::size_t count, boost::mpl::true_)
+        {
+            try {
+                return hpx::async(hpx::launch::sync, f1, base_idx, first,
+                    count);
+            }
+            catch (...) {
+                return hpx::make_error_future<Result>(
+                    boost::current_exception());
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A contiguous range of chunks handled by one task of the recursive
+        // partitioner.
+        template <typename FwdIter>
+        struct split_range
+        {
+            split_range(std::size_t idx, std::size_t chunks,
+                    std::size_t base_idx, FwdIter first, std::size_t count)
+              : idx_(idx), chunks_(chunks), base_idx_(base_idx),
+                first_(first), count_(count)
+            {}
+
+            std::size_t idx_;       // index of the first chunk in workitems
+            std::size_t chunks_;    // number of chunks in this range
+            std::size_t base_idx_;  // index of the first element
+            FwdIter first_;
+            std::size_t count_;     // number of elements in this range
+        };
+
+        // Every task of the recursive partitioner splits its range in half,
+        // spawns a new task for the second half and continues with the first
+        // half until a single chunk is left, which is executed directly. This
+        // gives a spawn depth of O(log n) and spreads spawning the tasks over
+        // all cores, idle cores steal the (large) ranges spawned first.
+        //
+        // The results of the chunks are stored in order, exceptions thrown by
+        // a chunk are stored in its future.
+        template <typename Result>
+        struct recursive_split
+        {
+            typedef std::vector<hpx::future<Result> > workitems_type;
+
+            template <typename WithIndex, typename F1, typename FwdIter>
+            static void call(threads::executor exec, workitems_type& workitems,
+                split_range<FwdIter> r, std::size_t chunk_size, F1 f1)
             {
-                return static_partitioner<ExPolicy, R, Result>::call(
-                    policy, first, count,
-                    std::forward<F1>(f1), std::forward<F2>(f2), 0);
+                if (r.chunks_ == 0)
+                    return;
+
+                std::vector<hpx::future<void> > spawned;
+                try {
+                    while (r.chunks_ > 1)
+                    {
+                        std::size_t const chunks = r.chunks_ / 2;
+                        std::size_t const count = chunks * chunk_size;
+
+                        FwdIter mid = r.first_;
+                        std::advance(mid, count);
+
+                        split_range<FwdIter> second(r.idx_ + chunks,
+                            r.chunks_ - chunks, r.base_idx_ + count, mid,
+                            r.count_ - count);
+
+                        // spawn the second half, continue with the first
+                        if (exec)
+                        {
+                            spawned.push_back(hpx::async(exec,
+                                &recursive_split::call<WithIndex, F1, FwdIter>,
+                                exec, boost::ref(workitems), second,
+                                chunk_size, f1));
+                        }
+                        else
+                        {
+                            spawned.push_back(hpx::async(hpx::launch::fork,
+                                &recursive_split::call<WithIndex, F1, FwdIter>,
+                                exec, boost::ref(workitems), second,
+                                chunk_size, f1));
+                        }
+
+                        r.chunks_ = chunks;
+                        r.count_ = count;
+                    }
+
+                    workitems[r.idx_] = invoke_chunk<Result>(f1, r.base_idx_,
+                        r.first_, r.count_, WithIndex());
+                }
+                catch (...) {
+                    // the spawned tasks refer to workitems
+                    hpx::wait_all(spawned);
+                    throw;
+                }
+
+                // wait for the spawned tasks, propagate errors from spawning
+                hpx::wait_all(spawned);
+                for (hpx::future<void>& f: spawned)
+                    f.get();
             }
+        };
 
-            template <typename FwdIter, typename F1, typename F2>
-            static R call_with_index(ExPolicy const& policy, FwdIter first,
+        ///////////////////////////////////////////////////////////////////////
+        // The recursive partitioner splits the range recursively, see
+        // recursive_split above.
+        template <typename ExPolicy, typename R, typename Result = void>
+        struct recursive_partitioner
+        {
+            template <typename WithIndex, typename FwdIter, typename F1,
+                typename F2>
+            static R call(ExPolicy const& policy, FwdIter first,
                 std::size_t count, F1 && f1, F2 && f2)
             {
-                return static_partitioner<ExPolicy, R, Result>::call_with_index(
-                    policy, first, count,
-                    std::forward<F1>(f1), std::forward<F2>(f2), 0);
+                typedef typename hpx::util::decay<F1>::type func_type;
+
+                std::vector<hpx::future<Result> > workitems;
+                std::list<boost::exception_ptr> errors;
+
+                try {
+                    std::size_t base_idx = 0;
+                    std::size_t const chunk_size = get_recursive_chunk_size(
+                        policy, workitems, f1, base_idx, first, count,
+                        WithIndex());
+
+                    std::size_t const idx = workitems.size();
+                    std::size_t const chunks =
+                        (count + chunk_size - 1) / chunk_size;
+                    workitems.resize(idx + chunks);
+
+                    // the calling thread executes the first chunk
+                    recursive_split<Result>::template
+                        call<WithIndex, func_type, FwdIter>(
+                            policy.get_executor(), workitems,
+                            split_range<FwdIter>(idx, chunks, base_idx, first,
+                                count),
+                            chunk_size, f1);
+                }
+                catch (...) {
+                    detail::handle_local_exceptions<ExPolicy>::call(
+                        boost::current_exception(), errors);
+                }
+
+                // not all chunks have been executed
+                if (!errors.empty())
+                    boost::throw_exception(exception_list(std::move(errors)));
+
+                detail::handle_local_exceptions<ExPolicy>::call(
+                    workitems, errors);
+
+                return f2(std::move(workitems));
             }
         };
 
         template <typename R, typename Result>
-        struct partitioner<task_execution_policy, R, Result, static_partitioner_tag>
+        struct recursive_partitioner<task_execution_policy, R, Result>
         {
-            template <typename FwdIter, typename F1, typename F2>
+            template <typename WithIndex, typename FwdIter, typename F1,
+                typename F2>
             static hpx::future<R> call(task_execution_policy const& policy,
                 FwdIter first, std::size_t count, F1 && f1, F2 && f2)
             {
-                return static_partitioner<
-                        task_execution_policy, R, Result
-                    >::call(policy, first, count,
-                        std::forward<F1>(f1), std::forward<F2>(f2), 0);
+                typedef typename hpx::util::decay<F1>::type func_type;
+                typedef std::vector<hpx::future<Result> > workitems_type;
+
+                boost::shared_ptr<workitems_type> workitems =
+                    boost::make_shared<workitems_type>();
+                std::list<boost::exception_ptr> errors;
+                hpx::future<void> split;
+
+                try {
+                    std::size_t base_idx = 0;
+                    std::size_t const chunk_size = get_recursive_chunk_size(
+                        policy, *workitems, f1, base_idx, first, count,
+                        WithIndex());
+
+                    std::size_t const idx = workitems->size();
+                    std::size_t const chunks =
+                        (count + chunk_size - 1) / chunk_size;
+                    workitems->resize(idx + chunks);
+
+                    threads::executor exec = policy.get_executor();
+                    split_range<FwdIter> r(idx, chunks, base_idx, first, count);
+                    if (exec)
+                    {
+                        split = hpx::async(exec,
+                            &recursive_split<Result>::template
+                                call<WithIndex, func_type, FwdIter>,
+                            exec, boost::ref(*workitems), r, chunk_size, f1);
+                    }
+                    else
+                    {
+                        split = hpx::async(hpx::launch::fork,
+                            &recursive_split<Result>::template
+                                call<WithIndex, func_type, FwdIter>,
+                            exec, boost::ref(*workitems), r, chunk_size, f1);
+                    }
+                }
+                catch (std::bad_alloc const&) {
+                    return hpx::make_error_future<R>(
+                        boost::current_exception());
+                }
+                catch (...) {
+                    errors.push_back(boost::current_exception());
+                    split = hpx::make_ready_future();
+                }
+
+                // wait for all tasks to finish
+                return hpx::lcos::local::dataflow(
+                    [workitems, f2, errors](hpx::future<void> && s) mutable
+                    {
+                        if (s.has_exception())
+                        {
+                            detail::handle_local_exceptions<
+                                    task_execution_policy
+                                >::call(s.get_exception_ptr(), errors);
+                        }
+
+                        // not all chunks have been executed
+                        if (!errors.empty())
+                        {
+                            boost::throw_exception(
+                                exception_list(std::move(errors)));
+                        }
+
+                        detail::handle_local_exceptions<task_execution_policy>
+                            ::call(*workitems, errors);
+                        return f2(std::move(*workitems));
+                    },
+                    std::move(split));
             }
+        };
 
-            template <typename FwdIter, typename F1, typename F2>
-            static hpx::future<R> call_with_index(
+        ///////////////////////////////////////////////////////////////////////
+        template <typename ExPolicy, typename Result>
+        struct foreach_n_partitioner<ExPolicy, Result, recursive_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1>
+            static FwdIter call(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1)
+            {
+                FwdIter last = first;
+                std::advance(last, count);
+
+                return recursive_partitioner<ExPolicy, FwdIter, Result>::
+                    template call<boost::mpl::false_>(
+                        policy, first, count, std::forward<F1>(f1),
+                        [last](std::vector<hpx::future<Result> > &&)
+                        {
+                            return last;
+                        });
+            }
+        };
+
+        template <typename Result>
+        struct foreach_n_partitioner<
+            task_execution_policy, Result, recursive_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1>
+            static hpx::future<FwdIter> call(
                 task_execution_policy const& policy,
-                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+                FwdIter first, std::size_t count, F1 && f1)
             {
-                return static_partitioner<
-                        task_execution_policy, R, Result
-                    >::call_with_index(policy, first, count,
-                        std::forward<F1>(f1), std::forward<F2>(f2), 0);
+                FwdIter last = first;
+                std::advance(last, count);
+
+                return recursive_partitioner<
+                        task_execution_policy, FwdIter, Result
+                    >::template call<boost::mpl::false_>(
+                        policy, first, count, std::forward<F1>(f1),
+                        [last](std::vector<hpx::future<Result> > &&)
+                        {
+                            return last;
+                        });
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // Every task of the guided partitioner repeatedly grabs the next
+        // chunk from a shared cursor until the range is exhausted. The chunks
+        // shrink with the number of remaining elements (remaining / (2 *
+        // cores), but not less than the minimal chunk size), this way cores
+        // finishing early pick up the small chunks at the end of the range
+        // instead of idling.
+        template <typename FwdIter>
+        struct guided_range
+        {
+            guided_range(FwdIter first, std::size_t count,
+                    std::size_t min_chunk, std::size_t divisor)
+              : cursor_(boost::make_shared<boost::atomic<std::size_t> >(0)),
+                first_(first), count_(count),
+                min_chunk_(min_chunk), divisor_(divisor)
+            {}
+
+            // position of the next chunk to grab, shared by all tasks
+            boost::shared_ptr<boost::atomic<std::size_t> > cursor_;
+            FwdIter first_;
+            std::size_t count_;
+            std::size_t min_chunk_;
+            std::size_t divisor_;
+        };
+
+        template <typename Result>
+        struct guided_worker
+        {
+            // the results of the executed chunks tagged with their position
+            typedef std::vector<std::pair<std::size_t, hpx::future<Result> > >
+                results_type;
+
+            template <typename WithIndex, typename F1, typename FwdIter>
+            static results_type call(guided_range<FwdIter> r, F1 f1)
+            {
+                chunk_timing_hook_type const& hook = chunk_timing_hook();
+
+                boost::atomic<std::size_t>& cursor = *r.cursor_;
+                std::size_t const count = r.count_;
+
+                results_type results;
+                FwdIter first = r.first_;
+                std::size_t current = 0;        // position of first
+
+                std::size_t pos = cursor.load(boost::memory_order_relaxed);
+                while (pos < count)
+                {
+                    std::size_t chunk = (std::max)(r.min_chunk_,
+                        (count - pos) / r.divisor_);
+                    chunk = (std::min)(chunk, count - pos);
+
+                    if (!cursor.compare_exchange_weak(pos, pos + chunk))
+                        continue;
+
+                    // chunks grabbed by one task are strictly increasing
+                    std::advance(first, pos - current);
+                    current = pos;
+
+                    if (hook.empty())
+                    {
+                        results.push_back(std::make_pair(pos,
+                            invoke_chunk<Result>(f1, pos, first, chunk,
+                                WithIndex())));
+                    }
+                    else
+                    {
+                        chunk_info info;
+                        info.base_idx_ = pos;
+                        info.count_ = chunk;
+                        info.worker_ = hpx::get_worker_thread_num();
+                        info.start_ = hpx::util::high_resolution_clock::now();
+
+                        results.push_back(std::make_pair(pos,
+                            invoke_chunk<Result>(f1, pos, first, chunk,
+                                WithIndex())));
+
+                        info.elapsed_ =
+                            hpx::util::high_resolution_clock::now() -
+                                info.start_;
+                        hook(info);
+                    }
+
+                    pos = cursor.load(boost::memory_order_relaxed);
+                }
+                return results;
+            }
+
+            static bool less(typename results_type::value_type const& lhs,
+                typename results_type::value_type const& rhs)
+            {
+                return lhs.first < rhs.first;
+            }
+
+            // merge the results of all tasks in the order of the chunks
+            static std::vector<hpx::future<Result> >
+            collect(std::vector<results_type>& all_results)
+            {
+                results_type merged;
+                for (results_type& results: all_results)
+                {
+                    std::move(results.begin(), results.end(),
+                        std::back_inserter(merged));
+                }
+                std::sort(merged.begin(), merged.end(), &guided_worker::less);
+
+                std::vector<hpx::future<Result> > workitems;
+                workitems.reserve(merged.size());
+                for (typename results_type::value_type& r: merged)
+                    workitems.push_back(std::move(r.second));
+                return workitems;
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // The guided partitioner runs one task per core, see guided_worker
+        // above. If no chunk size is given, the minimal chunk size is one
+        // element.
+        template <typename ExPolicy, typename R, typename Result = void>
+        struct guided_partitioner
+        {
+            template <typename WithIndex, typename FwdIter, typename F1,
+                typename F2>
+            static R call(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1, F2 && f2)
+            {
+                typedef typename hpx::util::decay<F1>::type func_type;
+                typedef guided_worker<Result> worker_type;
+                typedef typename worker_type::results_type results_type;
+
+                std::vector<hpx::future<results_type> > workers;
+                std::vector<results_type> results;
+                std::list<boost::exception_ptr> errors;
+
+                try {
+                    threads::executor exec = policy.get_executor();
+                    std::size_t const cores = hpx::get_os_thread_count(exec);
+
+                    std::size_t min_chunk = policy.get_chunk_size();
+                    if (min_chunk == 0)
+                        min_chunk = 1;
+
+                    guided_range<FwdIter> r(first, count, min_chunk, 2*cores);
+
+                    // the calling thread acts as one of the workers
+                    workers.reserve(cores - 1);
+                    for (std::size_t i = 1; i < cores; ++i)
+                    {
+                        if (exec)
+                        {
+                            workers.push_back(hpx::async(exec,
+                                &worker_type::template
+                                    call<WithIndex, func_type, FwdIter>,
+                                r, f1));
+                        }
+                        else
+                        {
+                            workers.push_back(hpx::async(hpx::launch::fork,
+                                &worker_type::template
+                                    call<WithIndex, func_type, FwdIter>,
+                                r, f1));
+                        }
+                    }
+
+                    results.push_back(worker_type::template
+                        call<WithIndex, func_type, FwdIter>(r, f1));
+                }
+                catch (...) {
+                    detail::handle_local_exceptions<ExPolicy>::call(
+                        boost::current_exception(), errors);
+                }
+
+                // wait for all tasks to finish
+                hpx::wait_all(workers);
+                for (hpx::future<results_type>& f: workers)
+                {
+                    if (f.has_exception())
+                    {
+                        detail::handle_local_exceptions<ExPolicy>::call(
+                            f.get_exception_ptr(), errors);
+                    }
+                    else
+                    {
+                        results.push_back(f.get());
+                    }
+                }
+
+                // not all chunks have been executed
+                if (!errors.empty())
+                    boost::throw_exception(exception_list(std::move(errors)));
+
+                std::vector<hpx::future<Result> > workitems =
+                    worker_type::collect(results);
+                detail::handle_local_exceptions<ExPolicy>::call(
+                    workitems, errors);
+
+                return f2(std::move(workitems));
+            }
+        };
+
+        template <typename R, typename Result>
+        struct guided_partitioner<task_execution_policy, R, Result>
+        {
+            template <typename WithIndex, typename FwdIter, typename F1,
+                typename F2>
+            static hpx::future<R> call(task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+            {
+                typedef typename hpx::util::decay<F1>::type func_type;
+                typedef guided_worker<Result> worker_type;
+                typedef typename worker_type::results_type results_type;
+
+                std::vector<hpx::future<results_type> > workers;
+                std::list<boost::exception_ptr> errors;
+
+                try {
+                    threads::executor exec = policy.get_executor();
+                    std::size_t const cores = hpx::get_os_thread_count(exec);
+
+                    std::size_t min_chunk = policy.get_chunk_size();
+                    if (min_chunk == 0)
+                        min_chunk = 1;
+
+                    guided_range<FwdIter> r(first, count, min_chunk, 2*cores);
+
+                    workers.reserve(cores);
+                    for (std::size_t i = 0; i != cores; ++i)
+                    {
+                        if (exec)
+                        {
+                            workers.push_back(hpx::async(exec,
+                                &worker_type::template
+                                    call<WithIndex, func_type, FwdIter>,
+                                r, f1));
+                        }
+                        else
+                        {
+                            workers.push_back(hpx::async(hpx::launch::fork,
+                                &worker_type::template
+                                    call<WithIndex, func_type, FwdIter>,
+                                r, f1));
+                        }
+                    }
+                }
+                catch (std::bad_alloc const&) {
+                    return hpx::make_error_future<R>(
+                        boost::current_exception());
+                }
+                catch (...) {
+                    errors.push_back(boost::current_exception());
+                }
+
+                // wait for all tasks to finish
+                return hpx::lcos::local::dataflow(
+                    [f2, errors](std::vector<hpx::future<results_type> > && r)
+                        mutable
+                    {
+                        std::vector<results_type> results;
+                        results.reserve(r.size());
+                        for (hpx::future<results_type>& f: r)
+                        {
+                            if (f.has_exception())
+                            {
+                                detail::handle_local_exceptions<
+                                        task_execution_policy
+                                    >::call(f.get_exception_ptr(), errors);
+                            }
+                            else
+                            {
+                                results.push_back(f.get());
+                            }
+                        }
+
+                        // not all chunks have been executed
+                        if (!errors.empty())
+                        {
+                            boost::throw_exception(
+                                exception_list(std::move(errors)));
+                        }
+
+                        std::vector<hpx::future<Result> > workitems =
+                            worker_type::collect(results);
+                        detail::handle_local_exceptions<task_execution_policy>
+                            ::call(workitems, errors);
+                        return f2(std::move(workitems));
+                    },
+                    std::move(workers));
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename ExPolicy, typename Result>
+        struct foreach_n_partitioner<ExPolicy, Result, guided_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1>
+            static FwdIter call(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1)
+            {
+                FwdIter last = first;
+                std::advance(last, count);
+
+                return guided_partitioner<ExPolicy, FwdIter, Result>::
+                    template call<boost::mpl::false_>(
+                        policy, first, count, std::forward<F1>(f1),
+                        [last](std::vector<hpx::future<Result> > &&)
+                        {
+                            return last;
+                        });
+            }
+        };
+
+        template <typename Result>
+        struct foreach_n_partitioner<
+            task_execution_policy, Result, guided_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1>
+            static hpx::future<FwdIter> call(
+                task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1)
+            {
+                FwdIter last = first;
+                std::advance(last, count);
+
+                return guided_partitioner<
+                        task_execution_policy, FwdIter, Result
+                    >::template call<boost::mpl::false_>(
+                        policy, first, count, std::forward<F1>(f1),
+                        [last](std::vector<hpx::future<Result> > &&)
+                        {
+                            return last;
+                        });
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // The affinity partitioner remembers which worker thread has executed
+        // which chunk of a range. Subsequent calls for the same range (same
+        // address of the first element, same number of elements and same
+        // chunk size) schedule every chunk onto the worker thread which has
+        // executed it before. Repeated passes over the same data this way
+        // touch the memory from the same cores (and NUMA domains) as the pass
+        // which has initialized it, see uninitialized_fill.
+        //
+        // The chunks are scheduled using hinted thread creation; work
+        // stealing may still move a chunk to a different worker thread, in
+        // which case the new placement is remembered. No placement is applied
+        // if the execution policy refers to an executor.
+        class affinity_map : boost::noncopyable
+        {
+            typedef lcos::local::spinlock mutex_type;
+
+            struct key_type
+            {
+                void const* addr_;
+                std::size_t count_;
+                std::size_t chunk_size_;
+
+                friend bool operator<(key_type const& lhs, key_type const& rhs)
+                {
+                    if (lhs.addr_ != rhs.addr_)
+                        return std::less<void const*>()(lhs.addr_, rhs.addr_);
+                    if (lhs.count_ != rhs.count_)
+                        return lhs.count_ < rhs.count_;
+                    return lhs.chunk_size_ < rhs.chunk_size_;
+                }
+            };
+
+            typedef std::map<key_type, std::vector<std::size_t> > map_type;
+
+        public:
+            // the number of ranges remembered, the oldest range is forgotten
+            // if a new range is added to a full map
+            enum { max_ranges = 64 };
+
+            static affinity_map& get()
+            {
+                static affinity_map map;
+                return map;
+            }
+
+            // returns the workers which have executed the chunks of the given
+            // range, or an empty vector if the range is not known
+            std::vector<std::size_t> find(void const* addr,
+                std::size_t count, std::size_t chunk_size) const
+            {
+                key_type const key = { addr, count, chunk_size };
+
+                boost::lock_guard<mutex_type> l(mtx_);
+                map_type::const_iterator it = placement_.find(key);
+                if (it == placement_.end())
+                    return std::vector<std::size_t>();
+                return it->second;
+            }
+
+            void store(void const* addr, std::size_t count,
+                std::size_t chunk_size, std::vector<std::size_t> const& workers)
+            {
+                key_type const key = { addr, count, chunk_size };
+
+                boost::lock_guard<mutex_type> l(mtx_);
+                std::pair<map_type::iterator, bool> p =
+                    placement_.insert(map_type::value_type(key, workers));
+                if (!p.second)
+                {
+                    p.first->second = workers;
+                    return;
+                }
+
+                order_.push_back(key);
+                if (order_.size() > max_ranges)
+                {
+                    placement_.erase(order_.front());
+                    order_.pop_front();
+                }
+            }
+
+            void clear()
+            {
+                boost::lock_guard<mutex_type> l(mtx_);
+                placement_.clear();
+                order_.clear();
+            }
+
+        private:
+            mutable mutex_type mtx_;
+            map_type placement_;
+            std::deque<key_type> order_;    // insertion order of the ranges
+        };
+
+        // Only ranges of lvalues can be identified by their address.
+        template <typename FwdIter>
+        void const* lvalue_address(FwdIter const& first, boost::mpl::true_)
+        {
+            return boost::addressof(*first);
+        }
+
+        template <typename FwdIter>
+        void const* lvalue_address(FwdIter const&, boost::mpl::false_)
+        {
+            return 0;
+        }
+
+        template <typename FwdIter>
+        void const* range_address(FwdIter const& first, std::size_t count)
+        {
+            if (count == 0)
+                return 0;
+
+            typedef typename std::iterator_traits<FwdIter>::reference reference;
+            return lvalue_address(first,
+                typename boost::is_reference<reference>::type());
+        }
+
+        // The placement of the chunks of one invocation, the workers are
+        // filled in by the chunks while they are being executed.
+        struct affinity_placement
+        {
+            affinity_placement()
+              : addr_(0), count_(0), chunk_size_(0)
+            {}
+
+            affinity_placement(void const* addr, std::size_t count,
+                    std::size_t chunk_size, std::size_t chunks)
+              : addr_(addr), count_(count), chunk_size_(chunk_size),
+                workers_(boost::make_shared<std::vector<std::size_t> >(
+                    chunks, std::size_t(-1)))
+            {}
+
+            // remember the placement once all chunks have been executed
+            void store() const
+            {
+                if (addr_ == 0 || !workers_)
+                    return;
+
+                if (std::find(workers_->begin(), workers_->end(),
+                        std::size_t(-1)) != workers_->end())
+                {
+                    return;     // not all chunks have been executed
+                }
+
+                affinity_map::get().store(addr_, count_, chunk_size_,
+                    *workers_);
+            }
+
+            void const* addr_;
+            std::size_t count_;
+            std::size_t chunk_size_;
+            boost::shared_ptr<std::vector<std::size_t> > workers_;
+        };
+
+        template <typename Result, typename WithIndex, typename F1,
+            typename FwdIter>
+        struct affinity_chunk
+        {
+            typedef Result result_type;
+
+            affinity_chunk(F1 const& f1, std::size_t base_idx, FwdIter first,
+                    std::size_t count, affinity_placement const& placement,
+                    std::size_t idx)
+              : f1_(f1), base_idx_(base_idx), first_(first), count_(count),
+                workers_(placement.workers_), idx_(idx)
+            {}
+
+            Result operator()()
+            {
+                (*workers_)[idx_] = hpx::get_worker_thread_num();
+                return invoke(WithIndex());
+            }
+
+        private:
+            Result invoke(boost::mpl::false_)
+            {
+                return f1_(first_, count_);
+            }
+
+            Result invoke(boost::mpl::true_)
+            {
+                return f1_(base_idx_, first_, count_);
+            }
+
+            F1 f1_;
+            std::size_t base_idx_;
+            FwdIter first_;
+            std::size_t count_;
+            boost::shared_ptr<std::vector<std::size_t> > workers_;
+            std::size_t idx_;
+        };
+
+        // Without an explicit chunk size every core gets exactly one chunk.
+        // The chunk size does not depend on any measurements, this way
+        // repeated invocations for the same range produce the same chunks.
+        template <typename Result, typename WithIndex, typename ExPolicy,
+            typename FwdIter, typename F1>
+        void spawn_affinity_chunks(ExPolicy const& policy, FwdIter first,
+            std::size_t count, F1 && f1, affinity_placement& placement,
+            std::vector<hpx::future<Result> >& workitems)
+        {
+            typedef typename hpx::util::decay<F1>::type func_type;
+            typedef affinity_chunk<Result, WithIndex, func_type, FwdIter>
+                chunk_type;
+
+            threads::executor exec = policy.get_executor();
+            std::size_t const cores = hpx::get_os_thread_count(exec);
+
+            std::size_t chunk_size = policy.get_chunk_size();
+            if (chunk_size == 0)
+                chunk_size = (count + cores - 1) / cores;
+            if (chunk_size == 0)
+                chunk_size = 1;
+
+            std::size_t const chunks = (count + chunk_size - 1) / chunk_size;
+
+            void const* addr = range_address(first, count);
+            placement = affinity_placement(addr, count, chunk_size, chunks);
+
+            std::vector<std::size_t> workers;
+            if (addr != 0)
+                workers = affinity_map::get().find(addr, count, chunk_size);
+
+            workitems.reserve(chunks);
+
+            std::size_t base_idx = 0;
+            for (std::size_t i = 0; i != chunks; ++i)
+            {
+                std::size_t const n = (std::min)(chunk_size, count - base_idx);
+                chunk_type chunk(f1, base_idx, first, n, placement, i);
+
+                if (exec)
+                {
+                    workitems.push_back(hpx::async(exec, std::move(chunk)));
+                }
+                else
+                {
+                    // place the chunk on the worker which has executed it
+                    // before, or distribute the chunks round robin
+                    std::size_t const worker =
+                        workers.size() == chunks ? workers[i] : i % cores;
+
+                    lcos::local::packaged_task<Result()> task(std::move(chunk));
+                    workitems.push_back(task.get_future());
+
+                    threads::register_work_nullary(std::move(task),
+                        "affinity_partitioner", threads::pending,
+                        threads::thread_priority_normal, worker);
+                }
+
+                base_idx += n;
+                std::advance(first, n);
+            }
+        }
+
+        template <typename ExPolicy, typename R, typename Result = void>
+        struct affinity_partitioner
+        {
+            template <typename WithIndex, typename FwdIter, typename F1,
+                typename F2>
+            static R call(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1, F2 && f2)
+            {
+                std::vector<hpx::future<Result> > workitems;
+                affinity_placement placement;
+                std::list<boost::exception_ptr> errors;
+
+                try {
+                    spawn_affinity_chunks<Result, WithIndex>(policy, first,
+                        count, std::forward<F1>(f1), placement, workitems);
+                }
+                catch (...) {
+                    detail::handle_local_exceptions<ExPolicy>::call(
+                        boost::current_exception(), errors);
+                }
+
+                // wait for all tasks to finish
+                hpx::wait_all(workitems);
+                placement.store();
+
+                detail::handle_local_exceptions<ExPolicy>::call(
+                    workitems, errors);
+
+                return f2(std::move(workitems));
+            }
+        };
+
+        template <typename R, typename Result>
+        struct affinity_partitioner<task_execution_policy, R, Result>
+        {
+            template <typename WithIndex, typename FwdIter, typename F1,
+                typename F2>
+            static hpx::future<R> call(task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+            {
+                std::vector<hpx::future<Result> > workitems;
+                affinity_placement placement;
+                std::list<boost::exception_ptr> errors;
+
+                try {
+                    spawn_affinity_chunks<Result, WithIndex>(policy, first,
+                        count, std::forward<F1>(f1), placement, workitems);
+                }
+                catch (std::bad_alloc const&) {
+                    return hpx::make_error_future<R>(
+                        boost::current_exception());
+                }
+                catch (...) {
+                    errors.push_back(boost::current_exception());
+                }
+
+                // wait for all tasks to finish
+                return hpx::lcos::local::dataflow(
+                    [f2, errors, placement](
+                        std::vector<hpx::future<Result> > && r) mutable
+                    {
+                        placement.store();
+
+                        detail::handle_local_exceptions<task_execution_policy>
+                            ::call(r, errors);
+                        return f2(std::move(r));
+                    },
+                    std::move(workitems));
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename ExPolicy, typename Result>
+        struct foreach_n_partitioner<ExPolicy, Result, affinity_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1>
+            static FwdIter call(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1)
+            {
+                FwdIter last = first;
+                std::advance(last, count);
+
+                return affinity_partitioner<ExPolicy, FwdIter, Result>::
+                    template call<boost::mpl::false_>(
+                        policy, first, count, std::forward<F1>(f1),
+                        [last](std::vector<hpx::future<Result> > &&)
+                        {
+                            return last;
+                        });
+            }
+        };
+
+        template <typename Result>
+        struct foreach_n_partitioner<
+            task_execution_policy, Result, affinity_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1>
+            static hpx::future<FwdIter> call(
+                task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1)
+            {
+                FwdIter last = first;
+                std::advance(last, count);
+
+                return affinity_partitioner<
+                        task_execution_policy, FwdIter, Result
+                    >::template call<boost::mpl::false_>(
+                        policy, first, count, std::forward<F1>(f1),
+                        [last](std::vector<hpx::future<Result> > &&)
+                        {
+                            return last;
+                        });
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // ExPolicy: execution policy
+        // R:        overall result type
+        // Result:   intermediate result type of first step
+        // PartTag:  select appropriate partitioner
+        template <typename ExPolicy, typename R, typename Result, typename PartTag>
+        struct partitioner;
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename ExPolicy, typename R, typename Result>
+        struct partitioner<ExPolicy, R, Result, static_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1, typename F2>
+            static R call(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1, F2 && f2)
+            {
+                return static_partitioner<ExPolicy, R, Result>::call(
+                    policy, first, count,
+                    std::forward<F1>(f1), std::forward<F2>(f2), 0);
+            }
+
+            template <typename FwdIter, typename F1, typename F2>
+            static R call_with_index(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1, F2 && f2)
+            {
+                return static_partitioner<ExPolicy, R, Result>::call_with_index(
+                    policy, first, count,
+                    std::forward<F1>(f1), std::forward<F2>(f2), 0);
+            }
+        };
+
+        template <typename R, typename Result>
+        struct partitioner<task_execution_policy, R, Result, static_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1, typename F2>
+            static hpx::future<R> call(task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+            {
+                return static_partitioner<
+                        task_execution_policy, R, Result
+                    >::call(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2), 0);
+            }
+
+            template <typename FwdIter, typename F1, typename F2>
+            static hpx::future<R> call_with_index(
+                task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+            {
+                return static_partitioner<
+                        task_execution_policy, R, Result
+                    >::call_with_index(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2), 0);
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename ExPolicy, typename R, typename Result>
+        struct partitioner<ExPolicy, R, Result, recursive_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1, typename F2>
+            static R call(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1, F2 && f2)
+            {
+                return recursive_partitioner<ExPolicy, R, Result>::
+                    template call<boost::mpl::false_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+
+            template <typename FwdIter, typename F1, typename F2>
+            static R call_with_index(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1, F2 && f2)
+            {
+                return recursive_partitioner<ExPolicy, R, Result>::
+                    template call<boost::mpl::true_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+        };
+
+        template <typename R, typename Result>
+        struct partitioner<
+            task_execution_policy, R, Result, recursive_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1, typename F2>
+            static hpx::future<R> call(task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+            {
+                return recursive_partitioner<
+                        task_execution_policy, R, Result
+                    >::template call<boost::mpl::false_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+
+            template <typename FwdIter, typename F1, typename F2>
+            static hpx::future<R> call_with_index(
+                task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+            {
+                return recursive_partitioner<
+                        task_execution_policy, R, Result
+                    >::template call<boost::mpl::true_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename ExPolicy, typename R, typename Result>
+        struct partitioner<ExPolicy, R, Result, guided_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1, typename F2>
+            static R call(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1, F2 && f2)
+            {
+                return guided_partitioner<ExPolicy, R, Result>::
+                    template call<boost::mpl::false_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+
+            template <typename FwdIter, typename F1, typename F2>
+            static R call_with_index(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1, F2 && f2)
+            {
+                return guided_partitioner<ExPolicy, R, Result>::
+                    template call<boost::mpl::true_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+        };
+
+        template <typename R, typename Result>
+        struct partitioner<
+            task_execution_policy, R, Result, guided_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1, typename F2>
+            static hpx::future<R> call(task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+            {
+                return guided_partitioner<
+                        task_execution_policy, R, Result
+                    >::template call<boost::mpl::false_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+
+            template <typename FwdIter, typename F1, typename F2>
+            static hpx::future<R> call_with_index(
+                task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+            {
+                return guided_partitioner<
+                        task_execution_policy, R, Result
+                    >::template call<boost::mpl::true_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename ExPolicy, typename R, typename Result>
+        struct partitioner<ExPolicy, R, Result, affinity_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1, typename F2>
+            static R call(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1, F2 && f2)
+            {
+                return affinity_partitioner<ExPolicy, R, Result>::
+                    template call<boost::mpl::false_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+
+            template <typename FwdIter, typename F1, typename F2>
+            static R call_with_index(ExPolicy const& policy, FwdIter first,
+                std::size_t count, F1 && f1, F2 && f2)
+            {
+                return affinity_partitioner<ExPolicy, R, Result>::
+                    template call<boost::mpl::true_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+        };
+
+        template <typename R, typename Result>
+        struct partitioner<
+            task_execution_policy, R, Result, affinity_partitioner_tag>
+        {
+            template <typename FwdIter, typename F1, typename F2>
+            static hpx::future<R> call(task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+            {
+                return affinity_partitioner<
+                        task_execution_policy, R, Result
+                    >::template call<boost::mpl::false_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
+            }
+
+            template <typename FwdIter, typename F1, typename F2>
+            static hpx::future<R> call_with_index(
+                task_execution_policy const& policy,
+                FwdIter first, std::size_t count, F1 && f1, F2 && f2)
+            {
+                return affinity_partitioner<
+                        task_execution_policy, R, Result
+                    >::template call<boost::mpl::true_>(policy, first, count,
+                        std::forward<F1>(f1), std::forward<F2>(f2));
             }
         };
 
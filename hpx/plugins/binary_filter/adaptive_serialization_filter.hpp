@@ -0,0 +1,139 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_ACTION_ADAPTIVE_SERIALIZATION_FILTER_OCT_19_2014_0845PM)
+#define HPX_ACTION_ADAPTIVE_SERIALIZATION_FILTER_OCT_19_2014_0845PM
+
+#include <hpx/hpx_fwd.hpp>
+
+#if defined(HPX_HAVE_COMPRESSION_ADAPTIVE)
+#include <hpx/config/forceinline.hpp>
+#include <hpx/traits/action_serialization_filter.hpp>
+#include <hpx/runtime/actions/guid_initialization.hpp>
+#include <hpx/runtime/parcelset/parcel.hpp>
+#include <hpx/util/binary_filter.hpp>
+#include <hpx/util/detail/serialization_registration.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/export.hpp>
+
+#include <vector>
+
+#include <hpx/config/warnings_prefix.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace plugins { namespace compression
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The adaptive filter compresses only if it pays off. Messages smaller
+    // than a configurable threshold are sent as is. For larger messages the
+    // filter keeps track of the compression ratio and speed each of the
+    // configured codecs (other binary filter plugins) achieves for the
+    // action and destination locality, and selects the codec minimizing the
+    // estimated time needed for compressing and sending the data over a link
+    // with the configured bandwidth. The codecs are sampled regularly to keep
+    // those statistics current. The settings are read from the
+    // [hpx.plugins.adaptive_serialization_filter] section:
+    //
+    //      threshold = 4096        # minimal message size (bytes)
+    //      codecs = lz4,zstd       # codecs to choose from
+    //      bandwidth = 1000        # link bandwidth (MB/s)
+    //      sample_interval = 16    # sample a codec every n-th message
+    //
+    // The first byte of the data written identifies the codec used.
+    struct HPX_LIBRARY_EXPORT adaptive_serialization_filter
+      : public util::binary_filter
+    {
+        adaptive_serialization_filter(bool compress = false,
+                util::binary_filter* next_filter = 0)
+          : action_name_(""), destination_(naming::invalid_locality_id),
+            codec_(0), codec_selected_(false), elapsed_(0),
+            compressed_size_(0), current_(0), compress_(compress)
+        {}
+        ~adaptive_serialization_filter();
+
+        // statistics are gathered for each action and destination locality
+        void set_destination(char const* action_name,
+            boost::uint32_t locality_id)
+        {
+            action_name_ = action_name;
+            destination_ = locality_id;
+        }
+
+        void load(void* dst, std::size_t dst_count);
+        void save(void const* src, std::size_t src_count);
+        bool flush(void* dst, std::size_t dst_count, std::size_t& written);
+
+        void set_max_length(std::size_t size);
+        std::size_t init_data(char const* buffer,
+            std::size_t size, std::size_t buffer_size);
+
+        /// serialization support
+        static void register_base();
+
+    private:
+        void select_codec();
+
+        // serialization support
+        friend class boost::serialization::access;
+
+        template <typename Archive>
+        BOOST_FORCEINLINE void serialize(Archive& ar, const unsigned int) {}
+
+        std::vector<char> buffer_;
+        boost::scoped_ptr<util::binary_filter> codec_filter_;
+        char const* action_name_;
+        boost::uint32_t destination_;
+        boost::uint8_t codec_;
+        bool codec_selected_;
+        boost::uint64_t elapsed_;
+        std::size_t compressed_size_;
+        std::size_t current_;
+        bool compress_;
+    };
+}}}
+
+#include <hpx/config/warnings_suffix.hpp>
+
+HPX_SERIALIZATION_REGISTER_TYPE_DECLARATION(
+    hpx::plugins::compression::adaptive_serialization_filter);
+
+///////////////////////////////////////////////////////////////////////////////
+#define HPX_ACTION_USES_ADAPTIVE_COMPRESSION(action)                          \
+    namespace hpx { namespace traits                                          \
+    {                                                                         \
+        template <>                                                           \
+        struct action_serialization_filter<action>                            \
+        {                                                                     \
+            /* Note that the caller is responsible for deleting the filter */ \
+            /* instance returned from this function */                        \
+            static util::binary_filter* call(parcelset::parcel const& p)      \
+            {                                                                 \
+                /* the data is sent uncompressed if the plugin is missing */  \
+                hpx::error_code ec(hpx::lightweight);                         \
+                util::binary_filter* filter = hpx::create_binary_filter(      \
+                    "adaptive_serialization_filter", true, 0, ec);            \
+                if (ec || 0 == filter)                                        \
+                    return 0;                                                 \
+                static_cast<                                                  \
+                    plugins::compression::adaptive_serialization_filter*      \
+                >(filter)->set_destination(                                   \
+                    p.get_action()->get_action_name(),                        \
+                    p.get_destination_locality_id());                         \
+                return filter;                                                \
+            }                                                                 \
+        };                                                                    \
+    }}                                                                        \
+/**/
+
+#else
+
+#define HPX_ACTION_USES_ADAPTIVE_COMPRESSION(action)
+
+#endif
+
+#endif
@@ -0,0 +1,226 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_FRAMED_SERIALIZATION_FILTER_OCT_19_2014_0930PM)
+#define HPX_FRAMED_SERIALIZATION_FILTER_OCT_19_2014_0930PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/exception.hpp>
+#include <hpx/util/binary_filter.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// size of the frames the data is compressed in
+#if !defined(HPX_SERIALIZATION_FILTER_FRAME_SIZE)
+#  define HPX_SERIALIZATION_FILTER_FRAME_SIZE 65536
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace plugins { namespace compression
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Base class for filters based on block compression codecs. The data is
+    // compressed in frames of HPX_SERIALIZATION_FILTER_FRAME_SIZE bytes while
+    // it is being saved, the compressed frames are handed to the archive
+    // right away (see binary_filter::get_frames). Thus neither side has to
+    // hold the uncompressed message as a whole. Each frame is prefixed by its
+    // original and its compressed size.
+    //
+    // The Derived type has to expose:
+    //
+    //      std::size_t max_compressed_length(std::size_t size);
+    //      std::size_t compress(char const* src, std::size_t size,
+    //          char* dst, std::size_t dst_size);
+    //      void uncompress(char const* src, std::size_t size,
+    //          char* dst, std::size_t dst_size);
+    //
+    template <typename Derived>
+    struct framed_serialization_filter : public util::binary_filter
+    {
+    protected:
+        static std::size_t const header_size = 2 * sizeof(boost::uint32_t);
+
+        framed_serialization_filter()
+          : frames_pos_(0), src_(0), src_end_(0), current_(0)
+        {}
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        void set_max_length(std::size_t size)
+        {
+            frame_.reserve((std::min)(size,
+                std::size_t(HPX_SERIALIZATION_FILTER_FRAME_SIZE)));
+        }
+
+        void save(void const* src, std::size_t src_count)
+        {
+            char const* src_begin = static_cast<char const*>(src);
+            while (src_count != 0)
+            {
+                std::size_t count = (std::min)(src_count,
+                    HPX_SERIALIZATION_FILTER_FRAME_SIZE - frame_.size());
+                frame_.insert(frame_.end(), src_begin, src_begin + count);
+
+                src_begin += count;
+                src_count -= count;
+
+                if (frame_.size() == HPX_SERIALIZATION_FILTER_FRAME_SIZE)
+                    compress_frame();
+            }
+        }
+
+        std::size_t frames_available() const
+        {
+            return frames_.size() - frames_pos_;
+        }
+
+        std::size_t get_frames(void* dst, std::size_t dst_count)
+        {
+            std::size_t count = (std::min)(dst_count, frames_available());
+            if (count != 0)
+                std::memcpy(dst, &frames_[frames_pos_], count);
+
+            frames_pos_ += count;
+            if (frames_pos_ == frames_.size())
+            {
+                frames_.clear();
+                frames_pos_ = 0;
+            }
+            return count;
+        }
+
+        bool flush(void* dst, std::size_t dst_count, std::size_t& written)
+        {
+            if (!frame_.empty())
+                compress_frame();
+
+            written = get_frames(dst, dst_count);
+            return frames_available() == 0;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::size_t init_data(char const* buffer, std::size_t size,
+            std::size_t buffer_size)
+        {
+            // the frames are uncompressed on demand
+            src_ = buffer;
+            src_end_ = buffer + size;
+            frame_.clear();
+            current_ = 0;
+            return buffer_size;
+        }
+
+        void load(void* dst, std::size_t dst_count)
+        {
+            char* dst_begin = static_cast<char*>(dst);
+            while (dst_count != 0)
+            {
+                if (current_ == frame_.size())
+                    uncompress_frame();
+
+                std::size_t count = (std::min)(dst_count,
+                    frame_.size() - current_);
+                std::memcpy(dst_begin, &frame_[current_], count);
+
+                current_ += count;
+                dst_begin += count;
+                dst_count -= count;
+            }
+        }
+
+    private:
+        Derived& derived()
+        {
+            return static_cast<Derived&>(*this);
+        }
+
+        static void write_size(char* dst, std::size_t size)
+        {
+            boost::uint32_t value = static_cast<boost::uint32_t>(size);
+            std::memcpy(dst, &value, sizeof(value));
+        }
+
+        static std::size_t read_size(char const* src)
+        {
+            boost::uint32_t value = 0;
+            std::memcpy(&value, src, sizeof(value));
+            return value;
+        }
+
+        void compress_frame()
+        {
+            std::size_t pos = frames_.size();
+            frames_.resize(pos + header_size +
+                derived().max_compressed_length(frame_.size()));
+
+            std::size_t compressed = derived().compress(
+                frame_.data(), frame_.size(), &frames_[pos + header_size],
+                frames_.size() - pos - header_size);
+
+            write_size(&frames_[pos], frame_.size());
+            write_size(&frames_[pos + sizeof(boost::uint32_t)], compressed);
+
+            frames_.resize(pos + header_size + compressed);
+            frame_.clear();
+        }
+
+        void uncompress_frame()
+        {
+            if (std::size_t(src_end_ - src_) < header_size)
+            {
+                HPX_THROW_EXCEPTION(serialization_error,
+                    "framed_serialization_filter::uncompress_frame",
+                    "archive data bstream is too short");
+                return;
+            }
+
+            std::size_t size = read_size(src_);
+            std::size_t compressed = read_size(src_ + sizeof(boost::uint32_t));
+            src_ += header_size;
+
+            // empty frames are never written, accepting them would make load()
+            // spin on corrupted data
+            if (0 == size || size > HPX_SERIALIZATION_FILTER_FRAME_SIZE)
+            {
+                HPX_THROW_EXCEPTION(serialization_error,
+                    "framed_serialization_filter::uncompress_frame",
+                    boost::str(boost::format("invalid frame size: %d") % size));
+                return;
+            }
+
+            if (std::size_t(src_end_ - src_) < compressed)
+            {
+                HPX_THROW_EXCEPTION(serialization_error,
+                    "framed_serialization_filter::uncompress_frame",
+                    boost::str(boost::format("archive data bstream is too "
+                        "short, compressed frame size: %d, remaining: %d") %
+                            compressed % std::size_t(src_end_ - src_)));
+                return;
+            }
+
+            frame_.resize(size);
+            derived().uncompress(src_, compressed, frame_.data(), size);
+
+            src_ += compressed;
+            current_ = 0;
+        }
+
+    private:
+        std::vector<char> frame_;       // current uncompressed frame
+        std::vector<char> frames_;      // compressed frames not handed out yet
+        std::size_t frames_pos_;
+
+        char const* src_;               // compressed data to load from
+        char const* src_end_;
+        std::size_t current_;           // position in current frame
+    };
+}}}
+
+#endif
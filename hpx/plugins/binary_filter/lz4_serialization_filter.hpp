@@ -0,0 +1,88 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_ACTION_LZ4_SERIALIZATION_FILTER_OCT_19_2014_0822PM)
+#define HPX_ACTION_LZ4_SERIALIZATION_FILTER_OCT_19_2014_0822PM
+
+#include <hpx/hpx_fwd.hpp>
+
+#if defined(HPX_HAVE_COMPRESSION_LZ4)
+#include <hpx/config/forceinline.hpp>
+#include <hpx/traits/action_serialization_filter.hpp>
+#include <hpx/runtime/actions/guid_initialization.hpp>
+#include <hpx/plugins/binary_filter/framed_serialization_filter.hpp>
+#include <hpx/util/detail/serialization_registration.hpp>
+
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/export.hpp>
+
+#include <memory>
+#include <vector>
+
+#include <hpx/config/warnings_prefix.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace plugins { namespace compression
+{
+    struct HPX_LIBRARY_EXPORT lz4_serialization_filter
+      : public framed_serialization_filter<lz4_serialization_filter>
+    {
+        lz4_serialization_filter(bool compress = false,
+                util::binary_filter* next_filter = 0)
+          : compress_(compress)
+        {}
+        ~lz4_serialization_filter();
+
+        // compression of a single frame
+        std::size_t max_compressed_length(std::size_t size) const;
+        std::size_t compress(char const* src, std::size_t size,
+            char* dst, std::size_t dst_size) const;
+        void uncompress(char const* src, std::size_t size,
+            char* dst, std::size_t dst_size) const;
+
+        /// serialization support
+        static void register_base();
+
+    private:
+        // serialization support
+        friend class boost::serialization::access;
+
+        template <typename Archive>
+        BOOST_FORCEINLINE void serialize(Archive& ar, const unsigned int) {}
+
+        bool compress_;
+    };
+}}}
+
+#include <hpx/config/warnings_suffix.hpp>
+
+HPX_SERIALIZATION_REGISTER_TYPE_DECLARATION(
+    hpx::plugins::compression::lz4_serialization_filter);
+
+///////////////////////////////////////////////////////////////////////////////
+#define HPX_ACTION_USES_LZ4_COMPRESSION(action)                            \
+    namespace hpx { namespace traits                                          \
+    {                                                                         \
+        template <>                                                           \
+        struct action_serialization_filter<action>                            \
+        {                                                                     \
+            /* Note that the caller is responsible for deleting the filter */ \
+            /* instance returned from this function */                        \
+            static util::binary_filter* call(parcelset::parcel const& p)      \
+            {                                                                 \
+                return hpx::create_binary_filter(                             \
+                    "lz4_serialization_filter", true);                     \
+            }                                                                 \
+        };                                                                    \
+    }}                                                                        \
+/**/
+
+#else
+
+#define HPX_ACTION_USES_LZ4_COMPRESSION(action)
+
+#endif
+
+#endif
@@ -12,7 +12,7 @@
 #include <hpx/config/forceinline.hpp>
 #include <hpx/traits/action_serialization_filter.hpp>
 #include <hpx/runtime/actions/guid_initialization.hpp>
-#include <hpx/util/binary_filter.hpp>
+#include <hpx/plugins/binary_filter/framed_serialization_filter.hpp>
 #include <hpx/util/detail/serialization_registration.hpp>
 
 #include <boost/serialization/serialization.hpp>
@@ -27,21 +27,20 @@
 namespace hpx { namespace plugins { namespace compression
 {
     struct HPX_LIBRARY_EXPORT snappy_serialization_filter
-      : public util::binary_filter
+      : public framed_serialization_filter<snappy_serialization_filter>
     {
         snappy_serialization_filter(bool compress = false,
                 util::binary_filter* next_filter = 0)
-          : current_(0), compress_(compress)
+          : compress_(compress)
         {}
         ~snappy_serialization_filter();
 
-        void load(void* dst, std::size_t dst_count);
-        void save(void const* src, std::size_t src_count);
-        bool flush(void* dst, std::size_t dst_count, std::size_t& written);
-
-        void set_max_length(std::size_t size);
-        std::size_t init_data(char const* buffer,
-            std::size_t size, std::size_t buffer_size);
+        // compression of a single frame
+        std::size_t max_compressed_length(std::size_t size) const;
+        std::size_t compress(char const* src, std::size_t size,
+            char* dst, std::size_t dst_size) const;
+        void uncompress(char const* src, std::size_t size,
+            char* dst, std::size_t dst_size) const;
 
         /// serialization support
         static void register_base();
@@ -53,8 +52,6 @@ namespace hpx { namespace plugins { namespace compression
         template <typename Archive>
         BOOST_FORCEINLINE void serialize(Archive& ar, const unsigned int) {}
 
-        std::vector<char> buffer_;
-        std::size_t current_;
         bool compress_;
     };
 }}}
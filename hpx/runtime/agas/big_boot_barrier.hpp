@@ -14,6 +14,8 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/condition_variable.hpp>
 
+#include <vector>
+
 #include <hpx/hpx_fwd.hpp>
 #include <hpx/util/io_service_pool.hpp>
 #include <hpx/util/connection_cache.hpp>
@@ -26,6 +28,38 @@
 namespace hpx { namespace agas
 {
 
+struct notification_header;
+
+// This structure describes a locality which has registered with node zero
+// while AGAS was starting up. The notifications for those localities are sent
+// out along a tree of localities (see big_boot_barrier::trigger).
+struct boot_tree_entry
+{
+    boot_tree_entry() : used_cores(0) {}
+
+    boot_tree_entry(
+        naming::gid_type const& prefix_
+      , naming::locality const& locality_
+      , boost::uint32_t used_cores_
+    ) :
+        prefix(prefix_)
+      , locality(locality_)
+      , used_cores(used_cores_)
+    {}
+
+    naming::gid_type prefix;        // assigned prefix
+    naming::locality locality;
+    boost::uint32_t used_cores;     // first core assigned to the locality
+
+    template <typename Archive>
+    void serialize(Archive & ar, const unsigned int)
+    {
+        ar & prefix;
+        ar & locality;
+        ar & used_cores;
+    }
+};
+
 struct HPX_EXPORT big_boot_barrier : boost::noncopyable
 {
   private:
@@ -40,6 +74,12 @@ struct HPX_EXPORT big_boot_barrier : boost::noncopyable
 
     boost::lockfree::queue<HPX_STD_FUNCTION<void()>* > thunks;
 
+    // maximal number of localities notified directly by this locality
+    std::size_t const arity;
+
+    // localities waiting for their notification (bootstrap locality only)
+    std::vector<boot_tree_entry> notifications;
+
     void spin();
 
     void notify();
@@ -104,6 +144,25 @@ struct HPX_EXPORT big_boot_barrier : boost::noncopyable
     {
         thunks.push(f);
     }
+
+    // has to be called while holding the lock (see scoped_lock)
+    void add_notification(
+        boot_tree_entry const& entry
+        )
+    {
+        notifications.push_back(entry);
+    }
+
+    // Send the notifications for the given (sorted) range of localities. The
+    // range is split into at most 'arity' sub-ranges, the first locality of
+    // each is notified and is responsible for forwarding the notifications
+    // to the remaining localities of its sub-range.
+    void notify_subtree(
+        boost::uint32_t source_locality_id
+      , notification_header const& header
+      , std::vector<boot_tree_entry>::const_iterator first
+      , std::vector<boot_tree_entry>::const_iterator last
+        );
 };
 
 HPX_EXPORT void create_big_boot_barrier(
@@ -22,6 +22,7 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/thread.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/iterator/filter_iterator.hpp>
 #include <boost/serialization/split_member.hpp>
@@ -205,6 +206,44 @@ namespace hpx { namespace naming
 #endif
     };
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// Hash and equality used for keying tables by locality (for instance the
+    /// connection pools of the parcelports). operator== compares either the
+    /// ranks or, if one of them is unknown, the addresses, which cannot be
+    /// hashed consistently. The key of a locality is its rank if MPI is
+    /// enabled and the rank is known, and its address and port otherwise. A
+    /// locality with a known rank and the same locality without one are
+    /// different keys.
+    struct locality_key_hash
+    {
+        std::size_t operator()(locality const& l) const
+        {
+#if defined(HPX_HAVE_PARCELPORT_MPI)
+            if (util::mpi_environment::enabled() && l.get_rank() != -1)
+                return boost::hash<boost::int16_t>()(l.get_rank());
+#endif
+            std::size_t seed = boost::hash<std::string>()(l.get_address());
+            boost::hash_combine(seed, l.get_port());
+            return seed;
+        }
+    };
+
+    struct locality_key_equal
+    {
+        bool operator()(locality const& lhs, locality const& rhs) const
+        {
+#if defined(HPX_HAVE_PARCELPORT_MPI)
+            if (util::mpi_environment::enabled() &&
+                (lhs.get_rank() != -1 || rhs.get_rank() != -1))
+            {
+                return lhs.get_rank() == rhs.get_rank();
+            }
+#endif
+            return lhs.get_port() == rhs.get_port() &&
+                lhs.get_address() == rhs.get_address();
+        }
+    };
+
     inline std::ostream& operator<< (std::ostream& os, locality const& l)
     {
         boost::io::ios_flags_saver ifs(os);
@@ -454,6 +454,11 @@ namespace hpx { namespace parcelset
         boost::int64_t get_connection_cache_statistics(connection_type pp_type,
             parcelport::connection_cache_statistics_type stat_type, bool) const;
 
+        std::size_t get_pending_parcels_count(connection_type pp_type,
+            parcelport::parcel_lane lane, bool) const;
+        boost::int64_t get_pending_parcels_time(connection_type pp_type,
+            parcelport::parcel_lane lane, bool) const;
+
         static void list_parcelports(util::osstream& strm);
         static void list_parcelport(util::osstream& strm, connection_type t,
             bool available = true);
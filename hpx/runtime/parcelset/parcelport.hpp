@@ -142,9 +142,40 @@ namespace hpx { namespace parcelset
             connection_cache_evictions = 1,
             connection_cache_hits = 2,
             connection_cache_misses = 3,
-            connection_cache_reclaims = 4
+            connection_cache_reclaims = 4,
+            connection_cache_wait_time = 5
         };
 
+        /// Outgoing parcels are queued in separate lanes for each destination,
+        /// depending on their priority. Parcels in the high priority lane are
+        /// always sent before any parcel in the normal lane and are never
+        /// batched together with those.
+        enum parcel_lane
+        {
+            parcel_lane_normal = 0,
+            parcel_lane_high = 1,
+            parcel_lane_count = 2
+        };
+
+        /// Return the lane the given parcel has to be queued in. Parcels for
+        /// actions which are executed with critical or boosted thread
+        /// priority (see HPX_ACTION_HAS_CRITICAL_PRIORITY) are placed into
+        /// the high priority lane.
+        static parcel_lane get_parcel_lane(parcel const& p)
+        {
+            actions::action_type act = p.get_action();
+            if (!act)
+                return parcel_lane_normal;
+
+            threads::thread_priority priority = act->get_thread_priority();
+            if (priority == threads::thread_priority_critical ||
+                priority == threads::thread_priority_boost)
+            {
+                return parcel_lane_high;
+            }
+            return parcel_lane_normal;
+        }
+
         // invoke pending background work
         virtual void do_background_work() = 0;
 
@@ -294,7 +325,36 @@ namespace hpx { namespace parcelset
         std::size_t get_pending_parcels_count(bool /*reset*/)
         {
             lcos::local::spinlock::scoped_lock l(mtx_);
-            return pending_parcels_.size();
+
+            std::size_t count = 0;
+            for (std::size_t i = 0; i != parcel_lane_count; ++i)
+                count += num_pending_parcels_[i];
+            return count;
+        }
+
+        /// number of parcels currently waiting in the given lane
+        std::size_t get_pending_parcels_count(parcel_lane lane, bool /*reset*/)
+        {
+            lcos::local::spinlock::scoped_lock l(mtx_);
+            return num_pending_parcels_[lane];
+        }
+
+        /// the average time parcels were waiting in the given lane before
+        /// being handed to a connection (nanoseconds)
+        boost::int64_t get_pending_parcels_time(parcel_lane lane, bool reset)
+        {
+            lcos::local::spinlock::scoped_lock l(mtx_);
+
+            boost::int64_t result = 0;
+            if (num_dequeued_parcels_[lane] != 0)
+                result = queue_time_[lane] / num_dequeued_parcels_[lane];
+
+            if (reset)
+            {
+                queue_time_[lane] = 0;
+                num_dequeued_parcels_[lane] = 0;
+            }
+            return result;
         }
 
         void add_received_parcel(parcel const& p)
@@ -363,11 +423,25 @@ namespace hpx { namespace parcelset
         /// The handler for all incoming requests.
         server::parcelport_queue parcels_;
 
-        /// The cache for pending parcels
-        typedef std::pair<std::vector<parcel>, std::vector<write_handler_type> >
-            map_second_type;
-        typedef std::map<naming::locality, map_second_type> pending_parcels_map;
-        pending_parcels_map pending_parcels_;
+        /// The cache for pending parcels, one for each lane
+        struct pending_parcels
+        {
+            pending_parcels() : enqueue_time_(0) {}
+
+            std::vector<parcel> parcels_;
+            std::vector<write_handler_type> handlers_;
+
+            // sum of the times all of the parcels were enqueued at
+            boost::uint64_t enqueue_time_;
+        };
+
+        typedef std::map<naming::locality, pending_parcels> pending_parcels_map;
+        pending_parcels_map pending_parcels_[parcel_lane_count];
+
+        /// Statistics for each of the lanes
+        std::size_t num_pending_parcels_[parcel_lane_count];
+        boost::int64_t queue_time_[parcel_lane_count];
+        boost::int64_t num_dequeued_parcels_[parcel_lane_count];
 
         typedef std::set<naming::locality> pending_parcels_destinations;
         pending_parcels_destinations parcel_destinations_;
@@ -15,7 +15,8 @@
 #include <hpx/runtime/parcelset/detail/call_for_each.hpp>
 #include <hpx/runtime/threads/thread.hpp>
 #include <hpx/util/io_service_pool.hpp>
-#include <hpx/util/connection_cache.hpp>
+#include <hpx/util/connection_pool.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
 #include <hpx/util/runtime_configuration.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -152,13 +153,25 @@ namespace hpx { namespace parcelset
         void put_parcel(parcel p, write_handler_type f)
         {
             naming::locality const& locality_id = p.get_destination_locality();
+            parcel_lane lane = get_parcel_lane(p);
 
             // enqueue the outgoing parcel ...
-            enqueue_parcel(locality_id, std::move(p), std::move(f));
+            enqueue_parcel(locality_id, lane, std::move(p), std::move(f));
 
             if (enable_parcel_handling_)
             {
-                if (hpx::is_running() && async_serialization())
+                bool async = hpx::is_running() && async_serialization();
+
+                // high priority parcels are sent right away instead of
+                // waiting for more parcels to be batched, the normal
+                // parcels pending for this destination are left to the
+                // threads already scheduled for them
+                if (lane == parcel_lane_high)
+                {
+                    get_connection_and_send_parcels(locality_id, false,
+                        async ? parcel_lane_high : parcel_lane_normal);
+                }
+                else if (async)
                 {
                     trigger_sending_parcels(locality_id);
                 }
@@ -192,15 +205,36 @@ namespace hpx { namespace parcelset
 
             // enqueue the outgoing parcels ...
             HPX_ASSERT(parcels.size() == handlers.size());
-            enqueue_parcels(locality_id, std::move(parcels), std::move(handlers));
+            bool high_priority = enqueue_parcels(locality_id,
+                std::move(parcels), std::move(handlers));
 
             if (enable_parcel_handling_)
             {
-                if (hpx::is_running() && async_serialization())
+                bool async = hpx::is_running() && async_serialization();
+
+                // high priority parcels are sent right away instead of
+                // waiting for more parcels to be batched
+                if (high_priority)
                 {
-                    trigger_sending_parcels(locality_id);
+                    get_connection_and_send_parcels(locality_id, false,
+                        async ? parcel_lane_high : parcel_lane_normal);
                 }
-                else
+
+                // normal parcels enqueued together with high priority ones
+                // are left to a separate thread as well
+                if (async)
+                {
+                    bool pending = true;
+                    if (high_priority)
+                    {
+                        lcos::local::spinlock::scoped_lock l(mtx_);
+                        pending = has_pending_parcels(locality_id);
+                    }
+
+                    if (pending)
+                        trigger_sending_parcels(locality_id);
+                }
+                else if (!high_priority)
                 {
                     get_connection_and_send_parcels(locality_id);
                 }
@@ -280,6 +314,9 @@ namespace hpx { namespace parcelset
                 case connection_cache_reclaims:
                     return connection_cache_.get_cache_reclaims(reset);
 
+                case connection_cache_wait_time:
+                    return connection_cache_.get_cache_wait_time(reset);
+
                 default:
                     break;
             }
@@ -426,61 +463,137 @@ namespace hpx { namespace parcelset
 
         ///////////////////////////////////////////////////////////////////////
         void enqueue_parcel(naming::locality const& locality_id,
-            parcel&& p, write_handler_type&& f)
+            parcel_lane lane, parcel&& p, write_handler_type&& f)
         {
-            typedef pending_parcels_map::mapped_type mapped_type;
+            boost::uint64_t now = util::high_resolution_clock::now();
 
             lcos::local::spinlock::scoped_lock l(mtx_);
 
-            mapped_type& e = pending_parcels_[locality_id];
-            e.first.push_back(std::move(p));
-            e.second.push_back(std::move(f));
+            pending_parcels& e = pending_parcels_[lane][locality_id];
+            e.parcels_.push_back(std::move(p));
+            e.handlers_.push_back(std::move(f));
+            e.enqueue_time_ += now;
 
+            ++num_pending_parcels_[lane];
             parcel_destinations_.insert(locality_id);
         }
 
-        void enqueue_parcels(naming::locality const& locality_id,
+        // Enqueue the given parcels into the lanes matching their priority,
+        // returns whether any of the parcels has high priority.
+        bool enqueue_parcels(naming::locality const& locality_id,
             std::vector<parcel>&& parcels,
             std::vector<write_handler_type>&& handlers)
         {
-            typedef pending_parcels_map::mapped_type mapped_type;
+            HPX_ASSERT(parcels.size() == handlers.size());
+
+            std::size_t num_high_priority = 0;
+            BOOST_FOREACH(parcel const& p, parcels)
+            {
+                if (get_parcel_lane(p) == parcel_lane_high)
+                    ++num_high_priority;
+            }
+
+            boost::uint64_t now = util::high_resolution_clock::now();
 
+            // usually all parcels have the same priority
+            if (num_high_priority == 0 || num_high_priority == parcels.size())
+            {
+                parcel_lane lane = num_high_priority == 0 ?
+                    parcel_lane_normal : parcel_lane_high;
+                boost::uint64_t enqueue_time = now * parcels.size();
+
+                enqueue_parcels(locality_id, lane, std::move(parcels),
+                    std::move(handlers), enqueue_time);
+                return num_high_priority != 0;
+            }
+
+            std::vector<parcel> lane_parcels[parcel_lane_count];
+            std::vector<write_handler_type> lane_handlers[parcel_lane_count];
+
+            for (std::size_t i = 0; i != parcels.size(); ++i)
+            {
+                parcel_lane lane = get_parcel_lane(parcels[i]);
+                lane_parcels[lane].push_back(std::move(parcels[i]));
+                lane_handlers[lane].push_back(std::move(handlers[i]));
+            }
+
+            for (std::size_t i = 0; i != parcel_lane_count; ++i)
+            {
+                boost::uint64_t enqueue_time = now * lane_parcels[i].size();
+                enqueue_parcels(locality_id, static_cast<parcel_lane>(i),
+                    std::move(lane_parcels[i]), std::move(lane_handlers[i]),
+                    enqueue_time);
+            }
+            return true;
+        }
+
+        void enqueue_parcels(naming::locality const& locality_id,
+            parcel_lane lane, std::vector<parcel>&& parcels,
+            std::vector<write_handler_type>&& handlers,
+            boost::uint64_t enqueue_time)
+        {
             lcos::local::spinlock::scoped_lock l(mtx_);
 
             HPX_ASSERT(parcels.size() == handlers.size());
 
-            mapped_type& e = pending_parcels_[locality_id];
-            if (e.first.empty())
+            std::size_t num_parcels = parcels.size();
+
+            pending_parcels& e = pending_parcels_[lane][locality_id];
+            if (e.parcels_.empty())
             {
-                HPX_ASSERT(e.second.empty());
+                HPX_ASSERT(e.handlers_.empty());
 #if HPX_GCC_VERSION >= 40600 && HPX_GCC_VERSION < 40700
                 // GCC4.6 gets incredibly confused
-                std::swap(e.first, static_cast<std::vector<parcel>&>(parcels));
-                std::swap(e.second, static_cast<std::vector<write_handler_type>&>(handlers));
+                std::swap(e.parcels_, static_cast<std::vector<parcel>&>(parcels));
+                std::swap(e.handlers_, static_cast<std::vector<write_handler_type>&>(handlers));
 #else
-                std::swap(e.first, parcels);
-                std::swap(e.second, handlers);
+                std::swap(e.parcels_, parcels);
+                std::swap(e.handlers_, handlers);
 #endif
             }
             else
             {
-                HPX_ASSERT(e.first.size() == e.second.size());
-                std::size_t new_size = e.first.size() + parcels.size();
-                e.first.reserve(new_size);
-                e.second.reserve(new_size);
+                HPX_ASSERT(e.parcels_.size() == e.handlers_.size());
+                std::size_t new_size = e.parcels_.size() + parcels.size();
+                e.parcels_.reserve(new_size);
+                e.handlers_.reserve(new_size);
 
                 std::move(parcels.begin(), parcels.end(),
-                    std::back_inserter(e.first));
+                    std::back_inserter(e.parcels_));
                 std::move(handlers.begin(), handlers.end(),
-                    std::back_inserter(e.second));
+                    std::back_inserter(e.handlers_));
             }
+            e.enqueue_time_ += enqueue_time;
 
+            num_pending_parcels_[lane] += num_parcels;
             parcel_destinations_.insert(locality_id);
         }
 
+        // return whether any parcels are pending for the given destination,
+        // expects mtx_ to be locked
+        bool has_pending_parcels(naming::locality const& locality_id) const
+        {
+            for (std::size_t i = 0; i != parcel_lane_count; ++i)
+            {
+                pending_parcels_map::const_iterator it =
+                    pending_parcels_[i].find(locality_id);
+                if (it != pending_parcels_[i].end() &&
+                    !it->second.parcels_.empty())
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Dequeue all parcels pending in one of the lanes for the given
+        // destination. The high priority lane is always served first, lanes
+        // below min_lane are not looked at.
         bool dequeue_parcels(naming::locality const& locality_id,
             std::vector<parcel>& parcels,
-            std::vector<write_handler_type>& handlers)
+            std::vector<write_handler_type>& handlers,
+            parcel_lane& lane, boost::uint64_t& enqueue_time,
+            parcel_lane min_lane)
         {
             typedef pending_parcels_map::iterator iterator;
 
@@ -490,29 +603,55 @@ namespace hpx { namespace parcelset
             {
                 lcos::local::spinlock::scoped_lock l(mtx_);
 
-                iterator it = pending_parcels_.find(locality_id);
-
-                // do nothing if parcels have already been picked up by
-                // another thread
-                if (it != pending_parcels_.end() && !it->second.first.empty())
+                for (std::size_t i = parcel_lane_count;
+                     i != static_cast<std::size_t>(min_lane); --i)
                 {
+                    iterator it = pending_parcels_[i-1].find(locality_id);
+
+                    // do nothing if parcels have already been picked up by
+                    // another thread
+                    if (it == pending_parcels_[i-1].end() ||
+                        it->second.parcels_.empty())
+                    {
+                        HPX_ASSERT(it == pending_parcels_[i-1].end() ||
+                            it->second.handlers_.empty());
+                        continue;
+                    }
+
                     HPX_ASSERT(it->first == locality_id);
                     HPX_ASSERT(handlers.size() == parcels.size());
-                    std::swap(parcels, it->second.first);
-                    std::swap(handlers, it->second.second);
+                    std::swap(parcels, it->second.parcels_);
+                    std::swap(handlers, it->second.handlers_);
 
                     HPX_ASSERT(!handlers.empty());
-                }
-                else
-                {
-                    HPX_ASSERT(it->second.second.empty());
-                    return false;
-                }
 
-                parcel_destinations_.erase(locality_id);
+                    lane = static_cast<parcel_lane>(i-1);
+                    enqueue_time = it->second.enqueue_time_;
+                    it->second.enqueue_time_ = 0;
+                    num_pending_parcels_[i-1] -= parcels.size();
 
-                return true;
+                    // other lanes might still hold parcels for this
+                    // destination
+                    if (!has_pending_parcels(locality_id))
+                        parcel_destinations_.erase(locality_id);
+
+                    return true;
+                }
             }
+            return false;
+        }
+
+        // account for the time the given parcels were waiting in their lane
+        void add_queue_time(parcel_lane lane, std::size_t num_parcels,
+            boost::uint64_t enqueue_time)
+        {
+            boost::uint64_t now = util::high_resolution_clock::now();
+
+            lcos::local::spinlock::scoped_lock l(mtx_);
+            queue_time_[lane] +=
+                static_cast<boost::int64_t>(now * num_parcels - enqueue_time);
+            num_dequeued_parcels_[lane] +=
+                static_cast<boost::int64_t>(num_parcels);
         }
 
         ///////////////////////////////////////////////////////////////////////
@@ -526,7 +665,7 @@ namespace hpx { namespace parcelset
             hpx::applier::register_thread_nullary(
                 util::bind(
                     &parcelport_impl::get_connection_and_send_parcels,
-                    this, loc, background),
+                    this, loc, background, parcel_lane_normal),
                 "get_connection_and_send_parcels",
                 threads::pending, true, threads::thread_priority_boost,
                 std::size_t(-1), threads::thread_stacksize_default, ec);
@@ -562,17 +701,26 @@ namespace hpx { namespace parcelset
         }
 
         ///////////////////////////////////////////////////////////////////////
+        // Send all parcels pending for the given destination, starting with
+        // the high priority ones. Passing parcel_lane_high as min_lane sends
+        // the high priority parcels only.
         void get_connection_and_send_parcels(
-            naming::locality const& locality_id, bool background = false)
+            naming::locality const& locality_id, bool background = false,
+            parcel_lane min_lane = parcel_lane_normal)
         {
             // repeat until no more parcels are to be sent
             while (true)
             {
                 std::vector<parcel> parcels;
                 std::vector<write_handler_type> handlers;
+                parcel_lane lane = parcel_lane_normal;
+                boost::uint64_t enqueue_time = 0;
 
-                if (!dequeue_parcels(locality_id, parcels, handlers))
+                if (!dequeue_parcels(locality_id, parcels, handlers, lane,
+                        enqueue_time, min_lane))
+                {
                     break;
+                }
 
                 HPX_ASSERT(!parcels.empty() && !handlers.empty());
                 HPX_ASSERT(parcels.size() == handlers.size());
@@ -595,7 +743,10 @@ namespace hpx { namespace parcelset
 
                 if (!sender_connection)
                 {
-                    if (!force_connection && background)
+                    // high priority parcels don't wait for a connection
+                    // used by bulk traffic to become available
+                    if (!force_connection &&
+                        (background || lane == parcel_lane_high))
                     {
                         // retry getting a connection, this time enforcing a
                         // new connection to be created (if needed)
@@ -605,8 +756,8 @@ namespace hpx { namespace parcelset
                     if (!sender_connection)
                     {
                         // give the parcels back to the queues for later
-                        enqueue_parcels(locality_id, std::move(parcels),
-                            std::move(handlers));
+                        enqueue_parcels(locality_id, lane, std::move(parcels),
+                            std::move(handlers), enqueue_time);
 
                         // We can safely return if no connection is available
                         // at this point. As soon as a connection becomes
@@ -616,6 +767,8 @@ namespace hpx { namespace parcelset
                     }
                 }
 
+                add_queue_time(lane, parcels.size(), enqueue_time);
+
                 // send parcels if they didn't get sent by another connection
                 if (!hpx::is_starting() && threads::get_self_ptr() == 0)
                 {
@@ -642,8 +795,9 @@ namespace hpx { namespace parcelset
 
                 // We yield here for a short amount of time to give another
                 // HPX thread the chance to put a subsequent parcel which
-                // leads to a more effective parcel buffering
-                if (hpx::threads::get_self_ptr())
+                // leads to a more effective parcel buffering. High priority
+                // parcels are not buffered.
+                if (lane != parcel_lane_high && hpx::threads::get_self_ptr())
                     hpx::this_thread::yield();
             }
         }
@@ -656,24 +810,22 @@ namespace hpx { namespace parcelset
 #if defined(HPX_TRACK_STATE_OF_OUTGOING_TCP_CONNECTION)
             client_connection->set_state(parcelport_connection::state_scheduled_thread);
 #endif
+            HPX_ASSERT(locality_id == sender_connection->destination());
+            if (!ec)
             {
-                lcos::local::spinlock::scoped_lock l(mtx_);
-
-                HPX_ASSERT(locality_id == sender_connection->destination());
-                if (!ec)
-                {
-                    // Give this connection back to the cache as it's not
-                    // needed anymore.
-                    connection_cache_.reclaim(locality_id, sender_connection);
-                }
-                else
-                {
-                    // remove this connection from cache
-                    connection_cache_.clear(locality_id, sender_connection);
-                }
+                // Give this connection back to the cache as it's not
+                // needed anymore.
+                connection_cache_.reclaim(locality_id, sender_connection);
+            }
+            else
+            {
+                // remove this connection from cache
+                connection_cache_.clear(locality_id, sender_connection);
+            }
 
-                pending_parcels_map::iterator it = pending_parcels_.find(locality_id);
-                if (it == pending_parcels_.end() || it->second.first.empty())
+            {
+                lcos::local::spinlock::scoped_lock l(mtx_);
+                if (!has_pending_parcels(locality_id))
                     return;
             }
 
@@ -720,7 +872,10 @@ namespace hpx { namespace parcelset
         util::io_service_pool io_service_pool_;
 
         /// The connection cache for sending connections
-        util::connection_cache<connection, naming::locality> connection_cache_;
+        util::connection_pool<
+            connection, naming::locality,
+            naming::locality_key_hash, naming::locality_key_equal
+        > connection_cache_;
 
         int archive_flags_;
     };
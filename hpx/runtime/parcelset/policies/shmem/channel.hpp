@@ -0,0 +1,156 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_PARCELSET_SHMEM_CHANNEL_OCT_19_2014_1045PM)
+#define HPX_PARCELSET_SHMEM_CHANNEL_OCT_19_2014_1045PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/ring_buffer.hpp>
+
+#include <boost/asio/error.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace hpx { namespace parcelset { namespace policies { namespace shmem
+{
+    typedef boost::interprocess::managed_shared_memory segment_type;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // The sending end of the connection to another locality on the same
+    // node. The channel maps the segment of the destination locality and
+    // creates a ring buffer there. All senders connected to the same
+    // destination share one channel, the spinlock turns them into the single
+    // producer the ring buffer expects.
+    class channel : boost::noncopyable
+    {
+    public:
+        channel(std::size_t ring_size, std::size_t inline_size)
+          : mailbox_(0), ring_(0), ring_size_(ring_size),
+            inline_size_(inline_size)
+        {}
+
+        ~channel()
+        {
+            // the receiver releases the ring buffer once it is drained
+            if (ring_)
+                ring_->close();
+        }
+
+        void connect(std::string const& name, boost::system::error_code& ec)
+        {
+            try {
+                segment_.reset(new segment_type(
+                    boost::interprocess::open_only, name.c_str()));
+            }
+            catch (boost::interprocess::interprocess_exception const&) {
+                // the destination has not created its segment yet
+                ec = boost::asio::error::connection_refused;
+                return;
+            }
+
+            mailbox_ = segment_->find<mailbox>(mailbox::name()).first;
+            if (0 == mailbox_ || mailbox_->stopped())
+            {
+                segment_.reset();
+                ec = boost::asio::error::connection_refused;
+                return;
+            }
+
+            void* p = segment_->allocate(
+                ring_buffer::allocation_size(ring_size_), std::nothrow);
+            if (0 == p)
+            {
+                segment_.reset();
+                ec = boost::asio::error::no_buffer_space;
+                return;
+            }
+
+            ring_ = new (p) ring_buffer(ring_size_);
+            if (mailbox_->attach(segment_->get_handle_from_address(p)) ==
+                std::size_t(-1))
+            {
+                segment_->deallocate(p);
+                segment_.reset();
+                ring_ = 0;
+                ec = boost::asio::error::no_buffer_space;
+                return;
+            }
+
+            ec = boost::system::error_code();
+        }
+
+        // Returns false if there is no space for the message right now, the
+        // caller has to retry later.
+        bool send(std::vector<char> const& data, boost::system::error_code& ec)
+        {
+            lcos::local::spinlock::scoped_lock l(mtx_);
+
+            if (mailbox_->stopped())
+            {
+                ec = boost::asio::error::connection_aborted;
+                return true;
+            }
+
+            ring_buffer::message_header h;
+            h.reserved_ = 0;
+            h.size_ = data.size();
+            h.handle_ = 0;
+
+            if (data.size() <= inline_size_ && ring_->fits(data.size()))
+            {
+                h.type_ = ring_buffer::message_inline;
+                return ring_->push(h, data.data());
+            }
+
+            // Large messages are placed onto the heap of the destination's
+            // segment, only their handle is passed through the ring buffer.
+            // The space in the ring buffer can only grow while we hold the
+            // lock, so check it first to avoid having to undo the allocation.
+            if (!ring_->has_space(0))
+                return false;
+
+            void* p = segment_->allocate(data.size(), std::nothrow);
+            if (0 == p)
+            {
+                // wait for the receiver to release memory, unless the
+                // message will never fit
+                if (data.size() >= segment_->get_size())
+                    ec = boost::asio::error::message_size;
+                return ec ? true : false;
+            }
+
+            std::memcpy(p, data.data(), data.size());
+
+            h.type_ = ring_buffer::message_heap;
+            h.handle_ = segment_->get_handle_from_address(p);
+
+            bool pushed = ring_->push(h, 0);
+            HPX_ASSERT(pushed);
+            HPX_UNUSED(pushed);
+
+            return true;
+        }
+
+    private:
+        lcos::local::spinlock mtx_;
+
+        boost::scoped_ptr<segment_type> segment_;   // segment of destination
+        mailbox* mailbox_;
+        ring_buffer* ring_;
+
+        std::size_t ring_size_;
+        std::size_t inline_size_;
+    };
+}}}}
+
+#endif
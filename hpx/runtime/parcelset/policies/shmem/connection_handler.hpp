@@ -0,0 +1,144 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef HPX_PARCELSET_POLICIES_SHMEM_CONNECTION_HANDLER_HPP
+#define HPX_PARCELSET_POLICIES_SHMEM_CONNECTION_HANDLER_HPP
+
+#include <hpx/config/warnings_prefix.hpp>
+
+#include <hpx/runtime/naming/locality.hpp>
+#include <hpx/runtime/parcelset/parcelport_impl.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/channel.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/ring_buffer.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace hpx { namespace parcelset {
+    namespace policies { namespace shmem
+    {
+        class receiver;
+        class sender;
+        class HPX_EXPORT connection_handler;
+    }}
+
+    template <>
+    struct connection_handler_traits<policies::shmem::connection_handler>
+    {
+        typedef policies::shmem::sender connection_type;
+        typedef boost::mpl::false_ send_early_parcel;
+        typedef boost::mpl::true_ do_background_work;
+        typedef boost::mpl::true_ do_enable_parcel_handling;
+
+        static const char * name()
+        {
+            return "shmem";
+        }
+
+        static const char * pool_name()
+        {
+            return "parcel_pool_shmem";
+        }
+
+        static const char * pool_name_postfix()
+        {
+            return "-shmem";
+        }
+    };
+
+    namespace policies { namespace shmem
+    {
+        // The shared memory parcelport connects localities running on the
+        // same node. Every locality owns a shared memory segment. Each other
+        // locality sending to it creates a lock-free single producer, single
+        // consumer ring buffer in this segment, which gives a pair of ring
+        // buffers for each pair of localities. Small messages are copied into
+        // the ring buffer, larger messages are allocated on the heap of the
+        // segment and only their offset is passed through the ring buffer.
+        class HPX_EXPORT connection_handler
+          : public parcelport_impl<connection_handler>
+        {
+            typedef parcelport_impl<connection_handler> base_type;
+
+        public:
+            static std::vector<std::string> runtime_configuration();
+
+            connection_handler(util::runtime_configuration const& ini,
+                HPX_STD_FUNCTION<void(std::size_t, char const*)> const& on_start_thread,
+                HPX_STD_FUNCTION<void()> const& on_stop_thread);
+
+            ~connection_handler();
+
+            /// Start the handling of connections.
+            bool do_run();
+
+            /// Stop the handling of connections.
+            void do_stop();
+
+            void background_work();
+
+            /// Retrieve the type of the locality represented by this parcelport
+            connection_type get_type() const
+            {
+                return connection_shmem;
+            }
+
+            /// Return the name of this locality
+            std::string get_locality_name() const;
+
+            boost::shared_ptr<sender> create_connection(
+                naming::locality const& l, error_code& ec);
+
+            void enable_parcel_handling(bool new_state);
+
+            void add_sender(boost::shared_ptr<sender> const& sender_connection);
+
+        private:
+            boost::shared_ptr<channel> get_channel(
+                naming::locality const& l, error_code& ec);
+
+            void accept_channels();
+            void handle_messages();
+
+            // the segment owned by this locality
+            std::string segment_name_;
+            boost::scoped_ptr<segment_type> segment_;
+            mailbox* mailbox_;
+
+            std::size_t segment_size_;
+            std::size_t ring_buffer_size_;
+            std::size_t inline_message_size_;
+
+            // outgoing channels, one for each destination
+            hpx::lcos::local::spinlock channels_mtx_;
+            typedef std::map<naming::locality, boost::shared_ptr<channel> >
+                channels_type;
+            channels_type channels_;
+
+            // senders waiting for space in the ring buffer of the destination
+            hpx::lcos::local::spinlock senders_mtx_;
+            typedef std::list<boost::shared_ptr<sender> > senders_type;
+            senders_type senders_;
+
+            // receivers for each of the mailbox slots, accessed by the
+            // message handling loop only
+            std::vector<boost::shared_ptr<receiver> > receivers_;
+            boost::uint32_t mailbox_generation_;
+
+            boost::atomic<bool> stopped_;
+            boost::atomic<bool> handling_messages_;
+        };
+    }}
+}}
+
+#include <hpx/config/warnings_suffix.hpp>
+
+#endif
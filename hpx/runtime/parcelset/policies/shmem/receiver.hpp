@@ -0,0 +1,65 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef HPX_PARCELSET_POLICIES_SHMEM_RECEIVER_HPP
+#define HPX_PARCELSET_POLICIES_SHMEM_RECEIVER_HPP
+
+#include <hpx/util/high_resolution_timer.hpp>
+#include <hpx/runtime/parcelset/parcelport_connection.hpp>
+#include <hpx/runtime/parcelset/decode_parcels.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/channel.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/ring_buffer.hpp>
+#include <hpx/performance_counters/parcels/data_point.hpp>
+
+#include <vector>
+
+namespace hpx { namespace parcelset { namespace policies { namespace shmem
+{
+    class connection_handler;
+
+    // The receiving end of a ring buffer created by another locality in the
+    // segment of this locality. All receivers are driven by the message
+    // handling loop of the connection handler, which makes it the single
+    // consumer of the ring buffers.
+    class receiver
+      : public parcelport_connection<receiver, std::vector<char>, std::vector<char> >
+    {
+    public:
+        receiver(segment_type& segment, ring_buffer* ring,
+                boost::uint64_t max_inbound_size,
+                connection_handler& parcelport)
+          : segment_(segment), ring_(ring),
+            max_inbound_size_(max_inbound_size), parcelport_(parcelport)
+        {}
+
+        // Decode the messages available in the ring buffer, returns whether
+        // there were any.
+        bool receive(std::size_t max_messages);
+
+        // The sender has gone away and all of its messages were received.
+        bool done() const
+        {
+            return ring_->closed() && ring_->empty();
+        }
+
+        ring_buffer* ring() const
+        {
+            return ring_;
+        }
+
+    private:
+        segment_type& segment_;
+        ring_buffer* ring_;
+        boost::uint64_t max_inbound_size_;
+
+        /// The handler used to process the incoming request.
+        connection_handler& parcelport_;
+
+        /// Counters and timers for parcels received.
+        util::high_resolution_timer timer_;
+    };
+}}}}
+
+#endif
@@ -0,0 +1,295 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_PARCELSET_SHMEM_RING_BUFFER_OCT_19_2014_1015PM)
+#define HPX_PARCELSET_SHMEM_RING_BUFFER_OCT_19_2014_1015PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/util/assert.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+// maximal number of localities sending to the same locality
+#if !defined(HPX_PARCELPORT_SHMEM_MAX_CHANNELS)
+#  define HPX_PARCELPORT_SHMEM_MAX_CHANNELS 256
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// All of the data structures below live in a shared memory segment which is
+// mapped at different addresses by the processes involved. They must not
+// hold any pointers, all addressing is done relative to 'this' or by using
+// the handles of the segment manager. The atomics used are lock-free and
+// therefore address free.
+namespace hpx { namespace parcelset { namespace policies { namespace shmem
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Single producer, single consumer queue of messages. The ring buffer is
+    // created by the sending locality in the segment of the receiving
+    // locality. The data area directly follows the ring buffer object.
+    class ring_buffer : boost::noncopyable
+    {
+    public:
+        enum message_type
+        {
+            message_inline = 0,     // message data follows the header
+            message_heap = 1        // message data was allocated separately
+        };
+
+        struct message_header
+        {
+            boost::uint32_t type_;
+            boost::uint32_t reserved_;
+            boost::uint64_t size_;      // size of the message data
+            boost::int64_t handle_;     // segment handle of the heap data
+        };
+
+        // number of bytes to allocate for a ring buffer of the given capacity
+        static std::size_t allocation_size(std::size_t capacity)
+        {
+            return sizeof(ring_buffer) + capacity;
+        }
+
+        explicit ring_buffer(std::size_t capacity)
+          : head_(0), tail_(0), capacity_(capacity), closed_(false)
+        {
+            HPX_ASSERT(capacity != 0 && (capacity & (capacity - 1)) == 0);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // producer side
+
+        // return whether a message of the given size can be stored inline
+        bool fits(std::size_t size) const
+        {
+            return record_size(size) <= capacity_;
+        }
+
+        // return whether a message of the given size can be stored right now
+        bool has_space(std::size_t size) const
+        {
+            boost::uint64_t used = head_.load(boost::memory_order_relaxed) -
+                tail_.load(boost::memory_order_acquire);
+            return capacity_ - used >= record_size(size);
+        }
+
+        bool push(message_header const& h, char const* data)
+        {
+            std::size_t size = (h.type_ == message_inline) ?
+                static_cast<std::size_t>(h.size_) : 0;
+            if (!has_space(size))
+                return false;
+
+            boost::uint64_t head = head_.load(boost::memory_order_relaxed);
+            write(head, &h, sizeof(h));
+            if (size != 0)
+                write(head + sizeof(h), data, size);
+
+            head_.store(head + record_size(size), boost::memory_order_release);
+            return true;
+        }
+
+        // the producer has gone away, no more messages will be pushed
+        void close()
+        {
+            closed_.store(true, boost::memory_order_release);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // consumer side
+        bool front(message_header& h) const
+        {
+            boost::uint64_t tail = tail_.load(boost::memory_order_relaxed);
+            if (tail == head_.load(boost::memory_order_acquire))
+                return false;
+
+            read(tail, &h, sizeof(h));
+            return true;
+        }
+
+        // copy the data of the inline message returned by front
+        void read_data(char* dst, std::size_t size) const
+        {
+            read(tail_.load(boost::memory_order_relaxed) + sizeof(message_header),
+                dst, size);
+        }
+
+        void pop(message_header const& h)
+        {
+            std::size_t size = (h.type_ == message_inline) ?
+                static_cast<std::size_t>(h.size_) : 0;
+            boost::uint64_t tail = tail_.load(boost::memory_order_relaxed);
+            tail_.store(tail + record_size(size), boost::memory_order_release);
+        }
+
+        bool empty() const
+        {
+            return head_.load(boost::memory_order_acquire) ==
+                tail_.load(boost::memory_order_acquire);
+        }
+
+        bool closed() const
+        {
+            return closed_.load(boost::memory_order_acquire);
+        }
+
+    private:
+        static std::size_t record_size(std::size_t size)
+        {
+            return (sizeof(message_header) + size + 7) & ~std::size_t(7);
+        }
+
+        char* data()
+        {
+            return reinterpret_cast<char*>(this + 1);
+        }
+        char const* data() const
+        {
+            return reinterpret_cast<char const*>(this + 1);
+        }
+
+        // the records wrap around at the end of the data area
+        void write(boost::uint64_t pos, void const* src, std::size_t size)
+        {
+            std::size_t offset = static_cast<std::size_t>(pos & (capacity_ - 1));
+            std::size_t count = (std::min)(size, capacity_ - offset);
+
+            std::memcpy(data() + offset, src, count);
+            if (count != size)
+            {
+                std::memcpy(data(), static_cast<char const*>(src) + count,
+                    size - count);
+            }
+        }
+
+        void read(boost::uint64_t pos, void* dst, std::size_t size) const
+        {
+            std::size_t offset = static_cast<std::size_t>(pos & (capacity_ - 1));
+            std::size_t count = (std::min)(size, capacity_ - offset);
+
+            std::memcpy(dst, data() + offset, count);
+            if (count != size)
+            {
+                std::memcpy(static_cast<char*>(dst) + count, data(),
+                    size - count);
+            }
+        }
+
+        // head_ and tail_ are written by different processes, keep them on
+        // separate cache lines
+        static std::size_t const cache_line_size = 64;
+
+        boost::atomic<boost::uint64_t> head_;   // written by the producer
+        char pad0_[cache_line_size - sizeof(boost::atomic<boost::uint64_t>)];
+        boost::atomic<boost::uint64_t> tail_;   // written by the consumer
+        char pad1_[cache_line_size - sizeof(boost::atomic<boost::uint64_t>)];
+
+        std::size_t const capacity_;
+        boost::atomic<bool> closed_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // The mailbox is created by each locality in its own segment. Sending
+    // localities announce the ring buffers they created in the segment by
+    // claiming one of the slots.
+    class mailbox : boost::noncopyable
+    {
+    public:
+        enum slot_state
+        {
+            slot_free = 0,
+            slot_claimed = 1,
+            slot_ready = 2
+        };
+
+        static std::size_t const max_channels = HPX_PARCELPORT_SHMEM_MAX_CHANNELS;
+
+        static char const* name()
+        {
+            return "hpx.parcelport.shmem.mailbox";
+        }
+
+        mailbox()
+          : generation_(0), stopped_(false)
+        {
+            for (std::size_t i = 0; i != max_channels; ++i)
+            {
+                slots_[i].state_.store(slot_free);
+                slots_[i].handle_ = 0;
+            }
+        }
+
+        // sender: announce a new ring buffer, returns the slot used or -1
+        std::size_t attach(boost::int64_t handle)
+        {
+            for (std::size_t i = 0; i != max_channels; ++i)
+            {
+                boost::uint32_t expected = slot_free;
+                if (slots_[i].state_.compare_exchange_strong(expected,
+                        slot_claimed))
+                {
+                    slots_[i].handle_ = handle;
+                    slots_[i].state_.store(slot_ready,
+                        boost::memory_order_release);
+                    ++generation_;
+                    return i;
+                }
+            }
+            return std::size_t(-1);
+        }
+
+        // receiver: changes whenever a new ring buffer was attached
+        boost::uint32_t generation() const
+        {
+            return generation_.load(boost::memory_order_acquire);
+        }
+
+        bool ready(std::size_t slot) const
+        {
+            return slots_[slot].state_.load(boost::memory_order_acquire) ==
+                slot_ready;
+        }
+
+        boost::int64_t handle(std::size_t slot) const
+        {
+            return slots_[slot].handle_;
+        }
+
+        // receiver: the ring buffer in this slot has been released
+        void release(std::size_t slot)
+        {
+            slots_[slot].handle_ = 0;
+            slots_[slot].state_.store(slot_free, boost::memory_order_release);
+        }
+
+        // receiver: the owning locality does not accept messages anymore
+        void stop()
+        {
+            stopped_.store(true, boost::memory_order_release);
+        }
+
+        bool stopped() const
+        {
+            return stopped_.load(boost::memory_order_acquire);
+        }
+
+    private:
+        struct slot
+        {
+            boost::atomic<boost::uint32_t> state_;
+            boost::int64_t handle_;
+        };
+
+        boost::atomic<boost::uint32_t> generation_;
+        boost::atomic<bool> stopped_;
+        slot slots_[max_channels];
+    };
+}}}}
+
+#endif
@@ -0,0 +1,124 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef HPX_PARCELSET_POLICIES_SHMEM_SENDER_HPP
+#define HPX_PARCELSET_POLICIES_SHMEM_SENDER_HPP
+
+#include <hpx/runtime/naming/locality.hpp>
+#include <hpx/runtime/parcelset/parcelport_connection.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/channel.hpp>
+#include <hpx/performance_counters/parcels/data_point.hpp>
+#include <hpx/performance_counters/parcels/gatherer.hpp>
+#include <hpx/util/high_resolution_timer.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace hpx { namespace parcelset { namespace policies { namespace shmem
+{
+    class connection_handler;
+    class sender;
+
+    void add_sender(connection_handler & handler,
+        boost::shared_ptr<sender> const& sender_connection);
+
+    class sender
+      : public parcelset::parcelport_connection<sender, std::vector<char> >
+    {
+    public:
+        typedef
+            HPX_STD_FUNCTION<void(boost::system::error_code const &, std::size_t)>
+            handler_function_type;
+        typedef
+            HPX_STD_FUNCTION<
+                void(
+                    boost::system::error_code const &
+                  , naming::locality const&
+                  , boost::shared_ptr<sender>
+                )
+            >
+            postprocess_function_type;
+
+        sender(boost::shared_ptr<channel> const& ch,
+            naming::locality const& locality_id,
+            connection_handler & handler,
+            performance_counters::parcels::gatherer& parcels_sent)
+          : channel_(ch)
+          , parcelport_(handler)
+          , there_(locality_id), parcels_sent_(parcels_sent)
+        {}
+
+        naming::locality const& destination() const
+        {
+            return there_;
+        }
+
+        void verify(naming::locality const & parcel_locality_id) const
+        {
+            HPX_ASSERT(parcel_locality_id == there_);
+        }
+
+        template <typename Handler, typename ParcelPostprocess>
+        void async_write(Handler handler, ParcelPostprocess parcel_postprocess)
+        {
+            HPX_ASSERT(buffer_);
+            HPX_ASSERT(!handler_);
+            HPX_ASSERT(!postprocess_);
+
+            /// Increment sends and begin timer.
+            buffer_->data_point_.time_ = timer_.elapsed_nanoseconds();
+
+            handler_ = handler;
+            postprocess_ = parcel_postprocess;
+
+            // If the message doesn't fit into the ring buffer right now, the
+            // connection handler retries sending it.
+            if (!done())
+                add_sender(parcelport_, shared_from_this());
+        }
+
+        // try to send the data, returns true if the operation completed
+        bool done()
+        {
+            boost::system::error_code ec;
+            if (!channel_->send(buffer_->data_, ec))
+                return false;
+
+            std::size_t size = buffer_->data_.size();
+            handler_(ec, size);
+
+            buffer_->data_point_.time_ = timer_.elapsed_nanoseconds()
+                - buffer_->data_point_.time_;
+            parcels_sent_.add_data(buffer_->data_point_);
+
+            // clear our state
+            buffer_.reset();
+            handler_.reset();
+
+            postprocess_function_type pp;
+            std::swap(pp, postprocess_);
+            pp(ec, there_, shared_from_this());
+            return true;
+        }
+
+    private:
+        boost::shared_ptr<channel> channel_;
+
+        handler_function_type handler_;
+        postprocess_function_type postprocess_;
+
+        connection_handler & parcelport_;
+
+        /// the other (receiving) end of this connection
+        naming::locality there_;
+
+        /// Counters and their data containers.
+        util::high_resolution_timer timer_;
+        performance_counters::parcels::gatherer& parcels_sent_;
+    };
+}}}}
+
+#endif
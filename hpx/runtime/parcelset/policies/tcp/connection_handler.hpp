@@ -17,6 +17,9 @@
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ip/host_name.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <map>
 
 namespace hpx { namespace parcelset
 {
@@ -63,6 +66,13 @@ namespace hpx { namespace parcelset
             {
                 std::vector<std::string> lines;
 
+                // number of connections used in parallel to send large
+                // messages to the same destination, and the minimal size
+                // of messages which are striped across those
+                lines.push_back("rails = ${HPX_PARCEL_TCP_RAILS:1}");
+                lines.push_back(
+                    "rail_threshold = ${HPX_PARCEL_TCP_RAIL_THRESHOLD:1048576}");
+
                 return lines;
             }
 
@@ -96,9 +106,21 @@ namespace hpx { namespace parcelset
         private:
             void handle_accept(boost::system::error_code const & e,
                 boost::shared_ptr<receiver> receiver_conn);
+            void handle_read_connection_header(
+                boost::system::error_code const& e,
+                boost::shared_ptr<receiver> receiver_conn);
+            void handle_write_rail_id(boost::system::error_code const& e,
+                boost::shared_ptr<receiver> receiver_conn);
             void handle_read_completion(boost::system::error_code const& e,
                 boost::shared_ptr<receiver> receiver_conn);
 
+            void connect(boost::asio::io_service& io_service,
+                boost::asio::ip::tcp::socket& s, naming::locality const& l,
+                boost::system::error_code& error);
+            void connect_rails(boost::asio::io_service& io_service,
+                boost::shared_ptr<sender> const& sender_connection,
+                naming::locality const& l, boost::system::error_code& error);
+
             /// Acceptor used to listen for incoming connections.
             boost::asio::ip::tcp::acceptor* acceptor_;
 
@@ -108,6 +130,16 @@ namespace hpx { namespace parcelset
             typedef std::set<boost::shared_ptr<receiver> > accepted_connections_set;
             accepted_connections_set accepted_connections_;
 
+            /// Primary connections waiting for their rails to be attached
+            typedef std::map<boost::uint64_t, boost::weak_ptr<receiver> >
+                rail_owners_map;
+            rail_owners_map rail_owners_;
+            boost::uint64_t next_rail_id_;
+
+            /// Number of connections used for sending large messages
+            std::size_t rails_;
+            std::size_t rail_threshold_;
+
 #if defined(HPX_HOLDON_TO_OUTGOING_CONNECTIONS)
             typedef std::set<boost::weak_ptr<sender> > write_connections_set;
             write_connections_set write_connections_;
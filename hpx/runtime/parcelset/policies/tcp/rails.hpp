@@ -0,0 +1,95 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef HPX_PARCELSET_POLICIES_TCP_RAILS_HPP
+#define HPX_PARCELSET_POLICIES_TCP_RAILS_HPP
+
+#include <hpx/config.hpp>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/integer/endian.hpp>
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// Large messages can be striped across several TCP connections (rails) to
+// the same destination. A connection which has rails attached is announced
+// by the sending side with a connection header sent right after connecting:
+//
+// - a primary connection without rails (the default) does not expect any
+//   response,
+// - a primary connection with rails gets a unique id assigned by the
+//   receiving side, which is sent back,
+// - each rail refers to the id of its primary connection and its index,
+//   the receiving side acknowledges its attachment to the primary.
+//
+// All messages sent over a primary connection with rails carry the number
+// of stripes as an additional header field. The payload of a striped message
+// (the main buffer followed by all zero-copy chunks) is split into as many
+// contiguous byte ranges as there are stripes, the first one is sent over
+// the primary connection, the others over the rails.
+namespace hpx { namespace parcelset { namespace policies { namespace tcp
+{
+    struct connection_header
+    {
+        enum connection_kind
+        {
+            primary = 0,
+            primary_with_rails = 1,
+            rail = 2
+        };
+
+        connection_header()
+          : kind_(primary), index_(0), id_(0)
+        {}
+
+        connection_header(connection_kind kind, boost::uint32_t index,
+                boost::uint64_t id)
+          : kind_(kind), index_(index), id_(id)
+        {}
+
+        boost::integer::ulittle32_t kind_;
+        boost::integer::ulittle32_t index_;     // index of rail (starting at 1)
+        boost::integer::ulittle64_t id_;        // id of primary connection
+    };
+
+    // Return the buffers holding the given stripe of the payload.
+    template <typename Buffer>
+    std::vector<Buffer> get_stripe(std::vector<Buffer> const& payload,
+        std::size_t stripe, std::size_t num_stripes)
+    {
+        std::size_t total_size = 0;
+        for (std::size_t i = 0; i != payload.size(); ++i)
+            total_size += boost::asio::buffer_size(payload[i]);
+
+        boost::uint64_t begin =
+            boost::uint64_t(total_size) * stripe / num_stripes;
+        boost::uint64_t end =
+            boost::uint64_t(total_size) * (stripe + 1) / num_stripes;
+
+        std::vector<Buffer> result;
+
+        boost::uint64_t offset = 0;
+        for (std::size_t i = 0; i != payload.size() && offset < end; ++i)
+        {
+            std::size_t size = boost::asio::buffer_size(payload[i]);
+            if (offset + size > begin)
+            {
+                std::size_t first = begin > offset ?
+                    static_cast<std::size_t>(begin - offset) : 0;
+                std::size_t last = offset + size > end ?
+                    static_cast<std::size_t>(end - offset) : size;
+
+                result.push_back(
+                    boost::asio::buffer(payload[i] + first, last - first));
+            }
+            offset += size;
+        }
+        return result;
+    }
+}}}}
+
+#endif
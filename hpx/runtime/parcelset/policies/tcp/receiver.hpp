@@ -15,6 +15,8 @@
 #include <hpx/util/high_resolution_timer.hpp>
 #include <hpx/runtime/parcelset/parcelport_connection.hpp>
 #include <hpx/runtime/parcelset/decode_parcels.hpp>
+#include <hpx/runtime/parcelset/policies/tcp/rails.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
 #include <hpx/performance_counters/parcels/data_point.hpp>
 #include <hpx/performance_counters/parcels/gatherer.hpp>
 
@@ -47,6 +49,10 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
           : socket_(io_service)
           , max_inbound_size_(hpx::parcelset::get_max_inbound_size(parcelport))
           , ack_(0)
+          , stripes_(1)
+          , rail_id_(0)
+          , pending_reads_(0)
+          , stripe_failed_(false)
           , parcelport_(parcelport)
         {}
 
@@ -64,6 +70,51 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
         /// Get the socket associated with the parcelport_connection.
         boost::asio::ip::tcp::socket& socket() { return socket_; }
 
+        /// Asynchronously read the header sent by the other end right after
+        /// the connection was established.
+        template <typename Handler>
+        void async_read_connection_header(Handler handler)
+        {
+            boost::asio::async_read(socket_,
+                boost::asio::buffer(&header_, sizeof(header_)), handler);
+        }
+
+        connection_header const& get_connection_header() const
+        {
+            return header_;
+        }
+
+        /// Send the id assigned to this primary connection back to the
+        /// other end.
+        template <typename Handler>
+        void async_write_rail_id(boost::uint64_t id, Handler handler)
+        {
+            rail_id_ = id;
+            boost::asio::async_write(socket_,
+                boost::asio::buffer(&rail_id_, sizeof(rail_id_)), handler);
+        }
+
+        /// Acknowledge the attachment of this rail to its primary connection.
+        template <typename Handler>
+        void async_write_rail_ack(Handler handler)
+        {
+            ack_ = true;
+            boost::asio::async_write(socket_,
+                boost::asio::buffer(&ack_, sizeof(ack_)), handler);
+        }
+
+        /// Attach a rail to this primary connection
+        void attach_rail(boost::shared_ptr<receiver> const& r)
+        {
+            std::size_t index = r->get_connection_header().index_;
+            HPX_ASSERT(index != 0);
+
+            lcos::local::spinlock::scoped_lock l(rails_mtx_);
+            if (rails_.size() < index)
+                rails_.resize(index);
+            rails_[index-1] = r;
+        }
+
         /// Asynchronously read a data structure from the socket.
         template <typename Handler>
         void async_read(Handler handler)
@@ -89,6 +140,12 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
             buffers.push_back(buffer(&buffer_->num_chunks_,
                 sizeof(buffer_->num_chunks_)));
 
+            // connections with rails announce the number of stripes used
+            // for each message
+            stripes_ = 1;
+            if (header_.kind_ == connection_header::primary_with_rails)
+                buffers.push_back(buffer(&stripes_, sizeof(stripes_)));
+
 #if defined(__linux) || defined(linux) || defined(__linux__)
             boost::asio::detail::socket_option::boolean<
                 IPPROTO_TCP, TCP_QUICKACK> quickack(true);
@@ -136,6 +193,13 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
 
                 buffer_->data_point_.bytes_ = static_cast<std::size_t>(inbound_size);
 
+                // large messages are striped across the rails
+                if (static_cast<boost::uint32_t>(stripes_) > 1)
+                {
+                    read_striped_message(handler);
+                    return;
+                }
+
                 // receive buffers
                 std::vector<boost::asio::mutable_buffer> buffers;
 
@@ -191,6 +255,145 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
             }
         }
 
+        /// Start reading a message which was striped across the rails.
+        template <typename Handler>
+        void read_striped_message(boost::tuple<Handler> handler)
+        {
+            // all rails needed for this message have to be attached
+            std::size_t num_stripes = stripes_;
+            {
+                lcos::local::spinlock::scoped_lock l(rails_mtx_);
+                bool attached = rails_.size() >= num_stripes - 1;
+                for (std::size_t i = 0; attached && i != num_stripes - 1; ++i)
+                    attached = rails_[i] ? true : false;
+
+                if (!attached)
+                {
+                    // report this problem back to the handler
+                    boost::get<0>(handler)(boost::asio::error::make_error_code(
+                        boost::asio::error::operation_not_supported));
+                    return;
+                }
+            }
+
+            buffer_->data_.resize(static_cast<std::size_t>(buffer_->size_));
+
+            std::size_t num_zero_copy_chunks =
+                static_cast<std::size_t>(
+                    static_cast<boost::uint32_t>(buffer_->num_chunks_.first));
+            if (num_zero_copy_chunks == 0)
+            {
+                read_stripes(handler);
+                return;
+            }
+
+            // the sizes of the zero-copy chunks are needed to reassemble
+            // the stripes
+            typedef parcel_buffer_type::transmission_chunk_type
+                transmission_chunk_type;
+
+            std::vector<transmission_chunk_type>& chunks =
+                buffer_->transmission_chunks_;
+
+            std::size_t num_non_zero_copy_chunks =
+                static_cast<std::size_t>(
+                    static_cast<boost::uint32_t>(buffer_->num_chunks_.second));
+            chunks.resize(num_zero_copy_chunks + num_non_zero_copy_chunks);
+
+            void (receiver::*f)(boost::system::error_code const&,
+                    boost::tuple<Handler>)
+                = &receiver::handle_read_stripe_layout<Handler>;
+
+            boost::asio::async_read(socket_,
+                boost::asio::buffer(chunks.data(), chunks.size() *
+                    sizeof(transmission_chunk_type)),
+                boost::bind(f, shared_from_this(),
+                    boost::asio::placeholders::error, handler));
+        }
+
+        template <typename Handler>
+        void handle_read_stripe_layout(boost::system::error_code const& e,
+            boost::tuple<Handler> handler)
+        {
+            if (e) {
+                boost::get<0>(handler)(e);
+                return;
+            }
+
+            std::size_t num_zero_copy_chunks =
+                static_cast<std::size_t>(
+                    static_cast<boost::uint32_t>(buffer_->num_chunks_.first));
+
+            buffer_->chunks_.resize(num_zero_copy_chunks);
+            for (std::size_t i = 0; i != num_zero_copy_chunks; ++i)
+            {
+                std::size_t chunk_size = static_cast<std::size_t>(
+                    buffer_->transmission_chunks_[i].second);
+                buffer_->chunks_[i].resize(chunk_size);
+            }
+
+            read_stripes(handler);
+        }
+
+        /// Receive the stripes of a message over this connection and the
+        /// rails in parallel.
+        template <typename Handler>
+        void read_stripes(boost::tuple<Handler> handler)
+        {
+            std::vector<boost::asio::mutable_buffer> payload;
+            payload.push_back(boost::asio::buffer(buffer_->data_));
+            for (std::size_t i = 0; i != buffer_->chunks_.size(); ++i)
+            {
+                payload.push_back(boost::asio::buffer(buffer_->chunks_[i].data(),
+                    buffer_->chunks_[i].size()));
+            }
+
+            std::vector<boost::shared_ptr<receiver> > rails;
+            {
+                lcos::local::spinlock::scoped_lock l(rails_mtx_);
+                rails = rails_;
+            }
+
+            std::size_t num_stripes = stripes_;
+            pending_reads_ = num_stripes;
+            stripe_failed_ = false;
+            stripe_error_ = boost::system::error_code();
+
+            void (receiver::*f)(boost::system::error_code const&,
+                    boost::tuple<Handler>)
+                = &receiver::handle_read_stripe<Handler>;
+
+#if defined(__linux) || defined(linux) || defined(__linux__)
+            boost::asio::detail::socket_option::boolean<
+                IPPROTO_TCP, TCP_QUICKACK> quickack(true);
+            socket_.set_option(quickack);
+#endif
+            boost::asio::async_read(socket_,
+                get_stripe(payload, 0, num_stripes),
+                boost::bind(f, shared_from_this(),
+                    boost::asio::placeholders::error, handler));
+
+            for (std::size_t i = 1; i != num_stripes; ++i)
+            {
+                boost::asio::async_read(rails[i-1]->socket(),
+                    get_stripe(payload, i, num_stripes),
+                    boost::bind(f, shared_from_this(),
+                        boost::asio::placeholders::error, handler));
+            }
+        }
+
+        template <typename Handler>
+        void handle_read_stripe(boost::system::error_code const& e,
+            boost::tuple<Handler> handler)
+        {
+            if (e && !stripe_failed_.exchange(true))
+                stripe_error_ = e;
+
+            // the last completed read finishes the operation
+            if (--pending_reads_ == 0)
+                handle_read_data(stripe_error_, handler);
+        }
+
         /// Handle a completed read of message data.
         template <typename Handler>
         void handle_read_chunk_data(boost::system::error_code const& e,
@@ -288,6 +491,19 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
 
         bool ack_;
 
+        /// Rails attached to this connection
+        connection_header header_;
+        boost::integer::ulittle32_t stripes_;
+        boost::integer::ulittle64_t rail_id_;
+
+        lcos::local::spinlock rails_mtx_;
+        std::vector<boost::shared_ptr<receiver> > rails_;
+
+        /// State of striped read operations
+        boost::atomic<std::size_t> pending_reads_;
+        boost::atomic<bool> stripe_failed_;
+        boost::system::error_code stripe_error_;
+
         /// The handler used to process the incoming request.
         connection_handler& parcelport_;
 
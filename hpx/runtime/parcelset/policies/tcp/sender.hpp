@@ -11,6 +11,7 @@
 
 #include <hpx/runtime/naming/locality.hpp>
 #include <hpx/runtime/parcelset/parcelport_connection.hpp>
+#include <hpx/runtime/parcelset/policies/tcp/rails.hpp>
 #include <hpx/performance_counters/parcels/data_point.hpp>
 #include <hpx/performance_counters/parcels/gatherer.hpp>
 #include <hpx/util/high_resolution_timer.hpp>
@@ -39,29 +40,44 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
       : public parcelset::parcelport_connection<sender, std::vector<char> >
     {
     public:
+        typedef boost::shared_ptr<boost::asio::ip::tcp::socket> rail_type;
+
         /// Construct a sending parcelport_connection with the given io_service.
         sender(boost::asio::io_service& io_service,
             naming::locality const& locality_id,
-            performance_counters::parcels::gatherer& parcels_sent)
+            performance_counters::parcels::gatherer& parcels_sent,
+            std::size_t rail_threshold = std::size_t(-1))
           : socket_(io_service)
           , ack_(0)
+          , stripes_(1)
+          , rail_threshold_(rail_threshold)
+          , pending_writes_(0)
+          , bytes_written_(0)
+          , stripe_failed_(false)
           , there_(locality_id), parcels_sent_(parcels_sent)
         {
         }
 
         ~sender()
         {
-            // gracefully and portably shutdown the socket
-            if (socket_.is_open()) {
-                boost::system::error_code ec;
-                socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
-                socket_.close(ec);    // close the socket to give it back to the OS
+            // gracefully and portably shutdown the sockets
+            close_socket(socket_);
+            BOOST_FOREACH(rail_type const& r, rails_)
+            {
+                close_socket(*r);
             }
         }
 
         /// Get the socket associated with the parcelport_connection.
         boost::asio::ip::tcp::socket& socket() { return socket_; }
 
+        /// Attach an additional connection to the same destination, large
+        /// messages are striped across all of them.
+        void add_rail(rail_type const& r)
+        {
+            rails_.push_back(r);
+        }
+
         naming::locality const& destination() const
         {
             return there_;
@@ -98,42 +114,113 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
             buffers.push_back(boost::asio::buffer(&buffer_->num_chunks_,
                 sizeof(buffer_->num_chunks_)));
 
+            // the payload consists of the main buffer holding data which was
+            // serialized normally and the zero-copy serialized chunks
+            std::vector<boost::asio::const_buffer> payload;
+            payload.push_back(boost::asio::buffer(buffer_->data_));
+
             std::vector<parcel_buffer_type::transmission_chunk_type>& chunks =
                 buffer_->transmission_chunks_;
             if (!chunks.empty()) {
-                buffers.push_back(
-                    boost::asio::buffer(chunks.data(), chunks.size() *
-                        sizeof(parcel_buffer_type::transmission_chunk_type)));
-
-                // add main buffer holding data which was serialized normally
-                buffers.push_back(boost::asio::buffer(buffer_->data_));
-
-                // now add chunks themselves, those hold zero-copy serialized chunks
                 BOOST_FOREACH(util::serialization_chunk& c, buffer_->chunks_)
                 {
                     if (c.type_ == util::chunk_type_pointer)
-                        buffers.push_back(boost::asio::buffer(c.data_.cpos_, c.size_));
+                        payload.push_back(boost::asio::buffer(c.data_.cpos_, c.size_));
                 }
             }
-            else {
-                // add main buffer holding data which was serialized normally
-                buffers.push_back(boost::asio::buffer(buffer_->data_));
+
+            // connections with rails announce the number of stripes used
+            // for each message
+            std::size_t num_stripes = 1;
+            if (!rails_.empty())
+            {
+                if (boost::asio::buffer_size(payload) >= rail_threshold_)
+                    num_stripes = rails_.size() + 1;
+
+                stripes_ = static_cast<boost::uint32_t>(num_stripes);
+                buffers.push_back(boost::asio::buffer(&stripes_,
+                    sizeof(stripes_)));
+            }
+
+            if (!chunks.empty()) {
+                buffers.push_back(
+                    boost::asio::buffer(chunks.data(), chunks.size() *
+                        sizeof(parcel_buffer_type::transmission_chunk_type)));
+            }
+
+            if (num_stripes == 1)
+            {
+                buffers.insert(buffers.end(), payload.begin(), payload.end());
+
+                // this additional wrapping of the handler into a bind object is
+                // needed to keep  this parcelport_connection object alive for the whole
+                // write operation
+                void (sender::*f)(boost::system::error_code const&, std::size_t,
+                        boost::tuple<Handler, ParcelPostprocess>)
+                    = &sender::handle_write<Handler, ParcelPostprocess>;
+
+                boost::asio::async_write(socket_, buffers,
+                    boost::bind(f, shared_from_this(),
+                        boost::asio::placeholders::error, ::_2,
+                        boost::make_tuple(handler, parcel_postprocess)));
+                return;
             }
 
-            // this additional wrapping of the handler into a bind object is
-            // needed to keep  this parcelport_connection object alive for the whole
-            // write operation
+            // The first stripe is sent along with the header, all others
+            // are sent over the rails.
+            std::vector<boost::asio::const_buffer> stripe =
+                get_stripe(payload, 0, num_stripes);
+            buffers.insert(buffers.end(), stripe.begin(), stripe.end());
+
+            pending_writes_ = num_stripes;
+            bytes_written_ = 0;
+            stripe_failed_ = false;
+            stripe_error_ = boost::system::error_code();
+
             void (sender::*f)(boost::system::error_code const&, std::size_t,
                     boost::tuple<Handler, ParcelPostprocess>)
-                = &sender::handle_write<Handler, ParcelPostprocess>;
+                = &sender::handle_write_stripe<Handler, ParcelPostprocess>;
 
             boost::asio::async_write(socket_, buffers,
                 boost::bind(f, shared_from_this(),
                     boost::asio::placeholders::error, ::_2,
                     boost::make_tuple(handler, parcel_postprocess)));
+
+            for (std::size_t i = 1; i != num_stripes; ++i)
+            {
+                boost::asio::async_write(*rails_[i-1],
+                    get_stripe(payload, i, num_stripes),
+                    boost::bind(f, shared_from_this(),
+                        boost::asio::placeholders::error, ::_2,
+                        boost::make_tuple(handler, parcel_postprocess)));
+            }
         }
 
     private:
+        static void close_socket(boost::asio::ip::tcp::socket& s)
+        {
+            if (s.is_open()) {
+                boost::system::error_code ec;
+                s.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+                s.close(ec);    // close the socket to give it back to the OS
+            }
+        }
+
+        /// handle completed write operation of one of the stripes of a
+        /// message
+        template <typename Handler, typename ParcelPostprocess>
+        void handle_write_stripe(boost::system::error_code const& e,
+            std::size_t bytes, boost::tuple<Handler, ParcelPostprocess> handler)
+        {
+            bytes_written_ += bytes;
+            if (e && !stripe_failed_.exchange(true))
+                stripe_error_ = e;
+
+            // the last completed write finishes the operation
+            if (--pending_writes_ == 0)
+                handle_write(stripe_error_, bytes_written_, handler);
+        }
+
         /// handle completed write operation
         template <typename Handler, typename ParcelPostprocess>
         void handle_write(boost::system::error_code const& e, std::size_t bytes,
@@ -190,6 +277,17 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
 
         bool ack_;
 
+        /// Additional connections to the same destination.
+        std::vector<rail_type> rails_;
+        boost::integer::ulittle32_t stripes_;
+        std::size_t rail_threshold_;
+
+        /// State of striped write operations
+        boost::atomic<std::size_t> pending_writes_;
+        boost::atomic<std::size_t> bytes_written_;
+        boost::atomic<bool> stripe_failed_;
+        boost::system::error_code stripe_error_;
+
         /// the other (receiving) end of this connection
         naming::locality there_;
 
@@ -74,11 +74,14 @@ namespace hpx { namespace threads { namespace detail
         if (0 == data.scheduler_base)
             data.scheduler_base = scheduler;
 
-        // Pass critical priority from parent to child.
+        // Pass critical priority and the deadline from parent to child.
         if (self)
         {
-            if (thread_priority_critical == threads::get_self_id()->get_priority())
+            thread_data_base* parent = threads::get_self_id().get();
+            if (thread_priority_critical == parent->get_priority())
                 data.priority = thread_priority_critical;
+            if (0 == data.deadline)
+                data.deadline = parent->get_deadline();
         }
 
         // create the new thread
@@ -92,6 +95,117 @@ namespace hpx { namespace threads { namespace detail
             // Create a task description for the new thread.
             scheduler->create_thread(data, initial_state, false, ec, data.num_os_thread);
         }
+
+        // potentially wake up waiting thread
+        scheduler->do_some_work(data.num_os_thread);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Create count work items with a single call into the scheduler. Work
+    // items requiring special treatment (critical priority or a specific
+    // target worker thread) are created one by one.
+    inline void create_work_bulk(policies::scheduler_base* scheduler,
+        thread_init_data* data, std::size_t count,
+        thread_state_enum initial_state = threads::pending,
+        error_code& ec = throws)
+    {
+        // verify parameters
+        switch (initial_state) {
+        case pending:
+        case suspended:
+            break;
+
+        default:
+            {
+                hpx::util::osstream strm;
+                strm << "invalid initial state: "
+                     << get_thread_state_name(initial_state);
+                HPX_THROWS_IF(ec, bad_parameter,
+                    "thread::detail::create_work_bulk",
+                    hpx::util::osstream_get_string(strm));
+                return;
+            }
+        }
+
+        LTM_(info)
+            << "create_work_bulk: initial_state("
+            << get_thread_state_name(initial_state) << "), count("
+            << count << ")";
+
+        thread_self* self = get_self_ptr();
+
+        // Pass critical priority and the deadline from parent to child.
+        bool const critical = self &&
+            thread_priority_critical == threads::get_self_id()->get_priority();
+        boost::uint64_t const deadline =
+            self ? threads::get_self_id()->get_deadline() : 0;
+
+        bool bulk = true;
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            thread_init_data& d = data[i];
+
+#if HPX_THREAD_MAINTAIN_DESCRIPTION
+            if (0 == d.description)
+            {
+                HPX_THROWS_IF(ec, bad_parameter,
+                    "thread::detail::create_work_bulk", "description is NULL");
+                return;
+            }
+#endif
+
+#if HPX_THREAD_MAINTAIN_PARENT_REFERENCE
+            if (0 == d.parent_id) {
+
+                if (self)
+                {
+                    d.parent_id = threads::get_self_id().get();
+                    d.parent_phase = self->get_thread_phase();
+                }
+            }
+            if (0 == d.parent_locality_id)
+                d.parent_locality_id = get_locality_id();
+#endif
+
+            if (0 == d.scheduler_base)
+                d.scheduler_base = scheduler;
+
+            if (critical)
+                d.priority = thread_priority_critical;
+            if (0 == d.deadline)
+                d.deadline = deadline;
+
+            if (thread_priority_critical == d.priority ||
+                thread_priority_boost == d.priority ||
+                std::size_t(-1) != d.num_os_thread)
+            {
+                bulk = false;
+            }
+        }
+
+        if (bulk)
+        {
+            // create task descriptions for all of the new threads
+            scheduler->create_threads(data, count, initial_state, false, ec,
+                std::size_t(-1));
+        }
+        else
+        {
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                // For critical priority threads, create the thread immediately.
+                bool run_now = thread_priority_critical == data[i].priority ||
+                    thread_priority_boost == data[i].priority;
+
+                scheduler->create_thread(data[i], initial_state, run_now, ec,
+                    data[i].num_os_thread);
+                if (&ec != &throws && ec)
+                    return;
+            }
+        }
+
+        // potentially wake up all waiting threads
+        scheduler->do_some_work(std::size_t(-1));
     }
 }}}
 
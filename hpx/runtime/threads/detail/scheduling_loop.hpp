@@ -9,7 +9,9 @@
 #include <hpx/hpx_fwd.hpp>
 #include <hpx/state.hpp>
 #include <hpx/runtime/threads/thread_data.hpp>
+#include <hpx/runtime/threads/detail/set_thread_state.hpp>
 #include <hpx/runtime/agas/interface.hpp>
+#include <hpx/util/binary_log.hpp>
 #include <hpx/util/itt_notify.hpp>
 #include <hpx/util/hardware/timestamp.hpp>
 
@@ -19,6 +21,8 @@
 #include <boost/ref.hpp>
 #include <boost/asio/deadline_timer.hpp>
 
+#include <vector>
+
 namespace hpx { namespace threads { namespace detail
 {
     ///////////////////////////////////////////////////////////////////////
@@ -76,9 +80,19 @@ namespace hpx { namespace threads { namespace detail
     }
 
     ///////////////////////////////////////////////////////////////////////
+    // The debug records are written for each scheduled thread, they go to the
+    // binary log if that is enabled to avoid formatting them in the
+    // scheduling loop.
     inline void write_new_state_log_debug(std::size_t num_thread,
         thread_data_base* thrd, thread_state_enum state, char const* info)
     {
+        if (LBIN_ENABLED(debug))
+        {
+            LTM_BIN_(debug)("tfunc(%1%): thread(%2%), new state(%3%)",
+                num_thread, thrd->get_thread_id().get(), state);
+            return;
+        }
+
         LTM_(debug) << "tfunc(" << num_thread << "): " //-V128
             << "thread(" << thrd->get_thread_id().get() << "), "
             << "description(" << thrd->get_description() << "), "
@@ -98,6 +112,13 @@ namespace hpx { namespace threads { namespace detail
     inline void write_old_state_log(std::size_t num_thread,
         thread_data_base* thrd, thread_state_enum state)
     {
+        if (LBIN_ENABLED(debug))
+        {
+            LTM_BIN_(debug)("tfunc(%1%): thread(%2%), old state(%3%)",
+                num_thread, thrd->get_thread_id().get(), state);
+            return;
+        }
+
         LTM_(debug) << "tfunc(" << num_thread << "): " //-V128
                     << "thread(" << thrd->get_thread_id().get() << "), "
                     << "description(" << thrd->get_description() << "), "
@@ -236,7 +257,8 @@ namespace hpx { namespace threads { namespace detail
         boost::atomic<hpx::state>& global_state, boost::int64_t& executed_threads,
         boost::int64_t& executed_thread_phases, boost::uint64_t& tfunc_time,
         boost::uint64_t& exec_time,
-        util::function_nonser<void()> const& cb = util::function_nonser<void()>())
+        util::function_nonser<void()> const& cb = util::function_nonser<void()>(),
+        bool allow_parking = true)
     {
         util::itt::stack_context ctx;        // helper for itt support
         util::itt::domain domain(get_thread_name().data());
@@ -253,6 +275,9 @@ namespace hpx { namespace threads { namespace detail
         detail::start_periodic_maintenance(scheduler, global_state, pred());
 
         while (true) {
+            // Wake up the threads whose timers have expired
+            detail::expire_timers(scheduler, num_thread, idle_loop_count != 0);
+
             // Get the next HPX thread from the queue
             thread_data_base* thrd = NULL;
             if (scheduler.SchedulingPolicy::get_next_thread(num_thread,
@@ -387,6 +412,11 @@ namespace hpx { namespace threads { namespace detail
                     hpx::parcelset::do_background_work();
                     hpx::agas::garbage_collect_non_blocking();
                 }
+
+                // spin, yield, or park this thread depending on how long it
+                // has been idling already
+                scheduler.SchedulingPolicy::idle_backoff(num_thread,
+                    idle_loop_count, allow_parking);
             }
 
             if (busy_loop_count > HPX_BUSY_LOOP_COUNT_MAX)
@@ -410,6 +440,17 @@ namespace hpx { namespace threads { namespace detail
                 scheduler.SchedulingPolicy::cleanup_terminated(true);
             }
         }
+
+        // The remaining timers belong to terminated threads or to threads
+        // managed by other worker threads which are still running. Fire them
+        // right away as this wheel will not be polled anymore.
+        {
+            policies::timer_wheel& wheel = scheduler.get_timer_wheel(num_thread);
+
+            std::vector<policies::timer_entry> expired;
+            wheel.expire_all(expired);
+            detail::fire_timers(wheel, expired);
+        }
     }
 }}}
 
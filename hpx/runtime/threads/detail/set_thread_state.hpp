@@ -12,11 +12,15 @@
 #include <hpx/runtime/threads/thread_helpers.hpp>
 #include <hpx/runtime/threads/detail/create_work.hpp>
 #include <hpx/runtime/threads/detail/create_thread.hpp>
+#include <hpx/runtime/threads/policies/timer_wheel.hpp>
 #include <hpx/util/logging.hpp>
 #include <hpx/util/io_service_pool.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
 #include <hpx/util/coroutine/coroutine.hpp>
 
-#include <boost/asio/deadline_timer.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <vector>
 
 namespace hpx { namespace threads { namespace detail
 {
@@ -240,94 +244,47 @@ namespace hpx { namespace threads { namespace detail
         error_code& ec = throws);
 
     ///////////////////////////////////////////////////////////////////////////
-    /// This thread function is used by the at_timer thread below to trigger
-    /// the required action.
-    inline thread_state_enum wake_timer_thread(
-        thread_id_type const& thrd, thread_state_enum newstate,
-        thread_state_ex_enum newstate_ex, thread_priority priority,
-        thread_id_type const& timer_id,
-        boost::shared_ptr<boost::atomic<bool> > const& triggered)
+    /// Set a timer to set the state of the given \a thread to the given
+    /// new value after it expired (after the given duration). The timer is
+    /// armed in the timer wheel of the given (or the current) worker thread,
+    /// no helper thread is involved.
+    template <typename SchedulingPolicy>
+    thread_id_type set_thread_state_timed(SchedulingPolicy& scheduler,
+        boost::posix_time::time_duration const& from_now, thread_id_type const& thrd,
+        thread_state_enum newstate, thread_state_ex_enum newstate_ex,
+        thread_priority priority, std::size_t thread_num, error_code& ec)
     {
         if (HPX_UNLIKELY(!thrd)) {
-            HPX_THROW_EXCEPTION(null_thread_id,
-                "threads::detail::wake_timer_thread",
-                "NULL thread id encountered (id)");
-            return terminated;
-        }
-        if (HPX_UNLIKELY(!timer_id)) {
-            HPX_THROW_EXCEPTION(null_thread_id,
-                "threads::detail::wake_timer_thread",
-                "NULL thread id encountered (timer_id)");
-            return terminated;
+            HPX_THROWS_IF(ec, null_thread_id,
+                "threads::detail::set_thread_state",
+                "NULL thread id encountered");
+            return 0;
         }
 
-        bool oldvalue = false;
-        if (triggered->compare_exchange_strong(oldvalue, true)) //-V601
-        {
-            // timer has not been canceled yet, trigger the requested set_state
-            detail::set_thread_state(thrd, newstate, newstate_ex, priority);
-        }
+        boost::uint64_t deadline = util::high_resolution_clock::now();
+        if (!from_now.is_negative())
+            deadline += from_now.total_nanoseconds();
 
-        // then re-activate the thread holding the deadline_timer
-        // REVIEW: Why do we ignore errors here?
-        error_code ec(lightweight);    // do not throw
-        detail::set_thread_state(timer_id, pending, wait_timeout,
-            thread_priority_normal, std::size_t(-1), ec);
-        return terminated;
-    }
+        if (thread_num == std::size_t(-1))
+            thread_num = get_worker_thread_num();
 
-    /// This thread function initiates the required set_state action (on
-    /// behalf of one of the threads#detail#set_thread_state functions).
-    template <typename SchedulingPolicy, typename TimeType>
-    thread_state_enum at_timer(SchedulingPolicy& scheduler,
-        TimeType const& expire, thread_id_type const& thrd, thread_state_enum newstate,
-        thread_state_ex_enum newstate_ex, thread_priority priority)
-    {
-        if (HPX_UNLIKELY(!thrd)) {
-            HPX_THROW_EXCEPTION(null_thread_id,
-                "threads::detail::at_timer",
-                "NULL thread id encountered");
-            return terminated;
-        }
+        scheduler.arm_timer(thread_num, deadline,
+            policies::timer_entry(thrd, thrd->get_thread_phase(),
+                newstate, newstate_ex, priority));
 
-        // create a new thread in suspended state, which will execute the
-        // requested set_state when timer fires and will re-awaken this thread,
-        // allowing the deadline_timer to go out of scope gracefully
-        thread_id_type self_id = get_self_id();
-
-        boost::shared_ptr<boost::atomic<bool> > triggered(
-            boost::make_shared<boost::atomic<bool> >(false));
-
-        thread_init_data data(
-            boost::bind(&wake_timer_thread,
-                thrd, newstate, newstate_ex, priority,
-                self_id, triggered),
-            "wake_timer", 0, priority);
-        thread_id_type wake_id = create_thread(&scheduler, data, suspended);
-
-        // create timer firing in correspondence with given time
-        boost::asio::deadline_timer t (
-            get_thread_pool("timer-pool")->get_io_service(), expire);
-
-        // let the timer invoke the set_state on the new (suspended) thread
-        t.async_wait(boost::bind(&detail::set_thread_state,
-            wake_id, pending, wait_timeout, priority,
-            std::size_t(-1), boost::ref(throws)));
-
-        // this waits for the thread to be reactivated when the timer fired
-        // if it returns signaled the timer has been canceled, otherwise
-        // the timer fired and the wake_timer_thread above has been executed
-        bool oldvalue = false;
-        thread_state_ex_enum statex = get_self().yield(suspended);
-
-        if (wait_timeout != statex &&
-            triggered->compare_exchange_strong(oldvalue, true)) //-V601
-        {
-            // wake_timer_thread has not been executed yet, cancel timer
-            t.cancel();
-        }
+        if (&ec != &throws)
+            ec = make_success_code();
 
-        return terminated;
+        return thrd;
+    }
+
+    template <typename SchedulingPolicy>
+    thread_id_type set_thread_state_timed(SchedulingPolicy& scheduler,
+        boost::posix_time::time_duration const& from_now, thread_id_type const& thrd,
+        error_code& ec)
+    {
+        return set_thread_state_timed(scheduler, from_now, thrd, pending,
+            wait_timeout, thread_priority_normal, std::size_t(-1), ec);
     }
 
     /// Set a timer to set the state of the given \a thread to the given
@@ -338,23 +295,10 @@ namespace hpx { namespace threads { namespace detail
         thread_state_enum newstate, thread_state_ex_enum newstate_ex,
         thread_priority priority, std::size_t thread_num, error_code& ec)
     {
-        if (HPX_UNLIKELY(!thrd)) {
-            HPX_THROWS_IF(ec, null_thread_id,
-                "threads::detail::set_thread_state",
-                "NULL thread id encountered");
-            return 0;
-        }
-
-        // this creates a new thread which creates the timer and handles the
-        // requested actions
-        typedef boost::posix_time::ptime time_type;
-        thread_init_data data(
-            boost::bind(&at_timer<SchedulingPolicy, time_type>,
-                boost::ref(scheduler), expire_at, thrd, newstate, newstate_ex,
-                priority),
-            "at_timer (expire at)", 0, priority, thread_num);
-
-        return create_thread(&scheduler, data, pending, true, ec); //-V601
+        // absolute times are given in universal time (see util::to_ptime)
+        return set_thread_state_timed(scheduler,
+            expire_at - boost::posix_time::microsec_clock::universal_time(),
+            thrd, newstate, newstate_ex, priority, thread_num, ec);
     }
 
     template <typename SchedulingPolicy>
@@ -366,40 +310,64 @@ namespace hpx { namespace threads { namespace detail
             wait_timeout, thread_priority_normal, std::size_t(-1), ec);
     }
 
-    /// Set a timer to set the state of the given \a thread to the given
-    /// new value after it expired (after the given duration)
-    template <typename SchedulingPolicy>
-    thread_id_type set_thread_state_timed(SchedulingPolicy& scheduler,
-        boost::posix_time::time_duration const& from_now, thread_id_type const& thrd,
-        thread_state_enum newstate, thread_state_ex_enum newstate_ex,
-        thread_priority priority, std::size_t thread_num, error_code& ec)
+    ///////////////////////////////////////////////////////////////////////////
+    /// Apply the requested state changes for the given expired timers. Timers
+    /// for threads which have terminated or which have been resumed by other
+    /// means in the meantime (i.e. whose phase has changed) are cancelled.
+    inline void fire_timers(policies::timer_wheel& wheel,
+        std::vector<policies::timer_entry> const& expired)
     {
-        if (HPX_UNLIKELY(!thrd)) {
-            HPX_THROWS_IF(ec, null_thread_id,
-                "threads::detail::set_thread_state",
-                "NULL thread id encountered");
-            return 0;
+        for (std::size_t i = 0; i != expired.size(); ++i)
+        {
+            policies::timer_entry const& e = expired[i];
+
+#if HPX_THREAD_MAINTAIN_PHASE_INFORMATION
+            if (e.thrd_->get_thread_phase() != e.phase_)
+            {
+                wheel.count_cancelled();
+                continue;
+            }
+#endif
+
+            error_code ec(lightweight);    // do not throw
+            thread_state previous_state = detail::set_thread_state(e.thrd_,
+                e.newstate_, e.newstate_ex_, e.priority_, std::size_t(-1), ec);
+
+            if (ec || thread_state_enum(previous_state) == terminated)
+                wheel.count_cancelled();
+            else
+                wheel.count_fired();
         }
+    }
 
-        // this creates a new thread which creates the timer and handles the
-        // requested actions
-        typedef boost::posix_time::time_duration time_type;
-        thread_init_data data(
-            boost::bind(&at_timer<SchedulingPolicy, time_type>,
-                boost::ref(scheduler), from_now, thrd, newstate, newstate_ex,
-                priority),
-            "at_timer (from now)", 0, priority, thread_num);
+    /// Fire all timers of the given timer wheel which have expired.
+    inline void expire_timers(policies::timer_wheel& wheel, bool try_only)
+    {
+        if (wheel.empty())
+            return;
 
-        return create_thread(&scheduler, data, pending, true, ec); //-V601
+        std::vector<policies::timer_entry> expired;
+        if (wheel.expire(util::high_resolution_clock::now(), expired, try_only))
+            fire_timers(wheel, expired);
     }
 
+    /// Poll the timer wheel of the given worker thread. Idle worker threads
+    /// additionally poll the timer wheels of all other worker threads, this
+    /// way timers armed on a busy worker thread fire in time as well.
     template <typename SchedulingPolicy>
-    thread_id_type set_thread_state_timed(SchedulingPolicy& scheduler,
-        boost::posix_time::time_duration const& from_now, thread_id_type const& thrd,
-        error_code& ec)
+    void expire_timers(SchedulingPolicy& scheduler, std::size_t num_thread,
+        bool idle)
     {
-        return set_thread_state_timed(scheduler, from_now, thrd, pending,
-            wait_timeout, thread_priority_normal, std::size_t(-1), ec);
+        expire_timers(scheduler.get_timer_wheel(num_thread), false);
+
+        if (idle)
+        {
+            std::size_t const num_wheels = scheduler.get_timer_wheel_count();
+            for (std::size_t i = 1; i < num_wheels; ++i)
+            {
+                expire_timers(scheduler.get_timer_wheel(num_thread + i), true);
+            }
+        }
     }
 }}}
 
@@ -0,0 +1,375 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_THREADMANAGER_SCHEDULING_DEADLINE_QUEUE_OCT_19_2014_0412PM)
+#define HPX_THREADMANAGER_SCHEDULING_DEADLINE_QUEUE_OCT_19_2014_0412PM
+
+#include <hpx/config.hpp>
+#include <hpx/runtime/threads/thread_data.hpp>
+#include <hpx/runtime/threads/policies/local_priority_queue_scheduler.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+#include <hpx/util/get_and_reset_value.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/integer_traits.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include <hpx/config/warnings_prefix.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace threads { namespace policies
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // A heap of pending threads ordered by their deadlines, the earliest
+        // deadline is published for other worker threads to look at without
+        // acquiring the lock.
+        template <typename Mutex>
+        class deadline_queue : boost::noncopyable
+        {
+            typedef Mutex mutex_type;
+            typedef std::pair<boost::uint64_t, threads::thread_data_base*>
+                entry_type;
+
+            // std::push_heap and friends maintain a max-heap
+            struct later
+            {
+                bool operator()(entry_type const& lhs,
+                    entry_type const& rhs) const
+                {
+                    return lhs.first > rhs.first;
+                }
+            };
+
+        public:
+            deadline_queue()
+              : earliest_(boost::integer_traits<boost::uint64_t>::const_max),
+                deadline_misses_(0)
+            {}
+
+            void push(threads::thread_data_base* thrd,
+                boost::uint64_t deadline)
+            {
+                typename mutex_type::scoped_lock lk(mtx_);
+                heap_.push_back(entry_type(deadline, thrd));
+                std::push_heap(heap_.begin(), heap_.end(), later());
+                earliest_.store(heap_.front().first);
+            }
+
+            bool pop(threads::thread_data_base*& thrd)
+            {
+                if (empty())
+                    return false;
+
+                typename mutex_type::scoped_lock lk(mtx_);
+                if (heap_.empty())
+                    return false;
+
+                std::pop_heap(heap_.begin(), heap_.end(), later());
+                thrd = heap_.back().second;
+                heap_.pop_back();
+
+                earliest_.store(heap_.empty() ?
+                    boost::integer_traits<boost::uint64_t>::const_max :
+                    heap_.front().first);
+                return true;
+            }
+
+            // the earliest deadline of all threads in this queue, the
+            // maximal value if the queue is empty
+            boost::uint64_t get_earliest_deadline() const
+            {
+                return earliest_.load(boost::memory_order_relaxed);
+            }
+
+            bool empty() const
+            {
+                return get_earliest_deadline() ==
+                    boost::integer_traits<boost::uint64_t>::const_max;
+            }
+
+            boost::int64_t size() const
+            {
+                typename mutex_type::scoped_lock lk(mtx_);
+                return static_cast<boost::int64_t>(heap_.size());
+            }
+
+            void increment_num_deadline_misses()
+            {
+                ++deadline_misses_;
+            }
+
+            boost::int64_t get_num_deadline_misses(bool reset)
+            {
+                return util::get_and_reset_value(deadline_misses_, reset);
+            }
+
+        private:
+            mutable mutex_type mtx_;
+            std::vector<entry_type> heap_;
+            boost::atomic<boost::uint64_t> earliest_;
+            boost::atomic<boost::int64_t> deadline_misses_;
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// The deadline_queue_scheduler extends the local_priority_queue_scheduler
+    /// by earliest deadline first (EDF) scheduling. Every OS thread owns an
+    /// additional queue holding the pending threads which have a deadline
+    /// (see hpx::threads::set_thread_deadline), ordered by their deadlines.
+    /// Threads created by a thread which has a deadline inherit it.
+    ///
+    /// Whenever there are threads with a deadline, each OS thread runs the
+    /// one with the earliest deadline, regardless of the queue it was placed
+    /// in (stealing by deadline), before any other work is executed. All other
+    /// threads are scheduled as by the local_priority_queue_scheduler. Threads
+    /// which finish running after their deadline has passed are counted as
+    /// deadline misses.
+    template <typename Mutex
+            , typename PendingQueuing
+            , typename StagedQueuing
+            , typename TerminatedQueuing
+             >
+    class deadline_queue_scheduler
+        : public local_priority_queue_scheduler<
+            Mutex, PendingQueuing, StagedQueuing, TerminatedQueuing
+          >
+    {
+    public:
+        typedef local_priority_queue_scheduler<
+            Mutex, PendingQueuing, StagedQueuing, TerminatedQueuing
+        > base_type;
+
+        typedef typename base_type::thread_queue_type thread_queue_type;
+
+        typedef typename base_type::init_parameter_type
+            init_parameter_type;
+
+        typedef detail::deadline_queue<Mutex> deadline_queue_type;
+
+        deadline_queue_scheduler(init_parameter_type const& init,
+                bool deferred_initialization = true)
+          : base_type(init, deferred_initialization),
+            deadline_queues_(init.num_queues_),
+            deadline_threads_count_(0)
+        {
+            for (std::size_t i = 0; i != init.num_queues_; ++i)
+                deadline_queues_[i] = new deadline_queue_type;
+        }
+
+        ~deadline_queue_scheduler()
+        {
+            for (std::size_t i = 0; i != deadline_queues_.size(); ++i)
+                delete deadline_queues_[i];
+        }
+
+        boost::int64_t get_num_deadline_misses(std::size_t num_thread,
+            bool reset)
+        {
+            if (num_thread != std::size_t(-1))
+            {
+                HPX_ASSERT(num_thread < deadline_queues_.size());
+                return deadline_queues_[num_thread]->
+                    get_num_deadline_misses(reset);
+            }
+
+            boost::int64_t result = 0;
+            for (std::size_t i = 0; i != deadline_queues_.size(); ++i)
+                result += deadline_queues_[i]->get_num_deadline_misses(reset);
+            return result;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Threads with a deadline are created right away (instead of being
+        // staged) as they have to be placed into the deadline queues.
+        thread_id_type create_thread(thread_init_data& data,
+            thread_state_enum initial_state, bool run_now, error_code& ec,
+            std::size_t num_thread)
+        {
+            if (0 == data.deadline)
+            {
+                return base_type::create_thread(data, initial_state, run_now,
+                    ec, num_thread);
+            }
+
+            std::size_t queue_size = this->queues_.size();
+
+            if (std::size_t(-1) == num_thread)
+                num_thread = ++this->curr_queue_ % queue_size;
+
+            if (num_thread >= queue_size)
+                num_thread %= queue_size;
+
+            thread_id_type id = this->queues_[num_thread]->create_thread(data,
+                suspended, true, ec);
+            if (!id || initial_state != pending)
+                return id;
+
+            id->set_state(pending);
+            schedule_deadline_thread(id.get(), num_thread);
+            return id;
+        }
+
+        void create_threads(thread_init_data* data, std::size_t count,
+            thread_state_enum initial_state, bool run_now, error_code& ec,
+            std::size_t num_thread)
+        {
+            // threads with a deadline are placed individually
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                if (0 != data[i].deadline)
+                {
+                    scheduler_base::create_threads(data, count, initial_state,
+                        run_now, ec, num_thread);
+                    return;
+                }
+            }
+
+            base_type::create_threads(data, count, initial_state, run_now,
+                ec, num_thread);
+        }
+
+        /// Return the next thread to be executed, return false if none is
+        /// available
+        bool get_next_thread(std::size_t num_thread, bool running,
+            boost::int64_t& idle_loop_count, threads::thread_data_base*& thrd)
+        {
+            if (deadline_threads_count_.load(boost::memory_order_relaxed) != 0)
+            {
+                // find the queue holding the thread with the earliest
+                // deadline, prefer the own queue
+                std::size_t queues_size = deadline_queues_.size();
+                std::size_t earliest_queue = std::size_t(-1);
+                boost::uint64_t earliest =
+                    boost::integer_traits<boost::uint64_t>::const_max;
+
+                for (std::size_t i = 0; i != queues_size; ++i)
+                {
+                    std::size_t const idx = (i + num_thread) % queues_size;
+                    boost::uint64_t deadline =
+                        deadline_queues_[idx]->get_earliest_deadline();
+                    if (deadline < earliest)
+                    {
+                        earliest = deadline;
+                        earliest_queue = idx;
+                    }
+                }
+
+                // the thread might have been taken by somebody else in the
+                // meantime, just fall back to the other queues in this case
+                if (earliest_queue != std::size_t(-1) &&
+                    deadline_queues_[earliest_queue]->pop(thrd))
+                {
+                    --deadline_threads_count_;
+                    if (earliest_queue != num_thread)
+                    {
+                        this->queues_[earliest_queue]->
+                            increment_num_stolen_from_pending();
+                        this->queues_[num_thread]->
+                            increment_num_stolen_to_pending();
+                    }
+                    return true;
+                }
+            }
+
+            return base_type::get_next_thread(num_thread, running,
+                idle_loop_count, thrd);
+        }
+
+        /// Schedule the passed thread
+        void schedule_thread(threads::thread_data_base* thrd,
+            std::size_t num_thread,
+            thread_priority priority = thread_priority_normal)
+        {
+            if (0 == thrd->get_deadline())
+            {
+                base_type::schedule_thread(thrd, num_thread, priority);
+                return;
+            }
+
+            if (std::size_t(-1) == num_thread)
+                num_thread = ++this->curr_queue_ % deadline_queues_.size();
+
+            schedule_deadline_thread(thrd, num_thread);
+        }
+
+        // Threads yielding their OS thread are always placed into the normal
+        // queues, otherwise a thread with an early deadline which waits for
+        // other work by yielding would be picked again right away.
+        void schedule_thread_last(threads::thread_data_base* thrd,
+            std::size_t num_thread,
+            thread_priority priority = thread_priority_normal)
+        {
+            base_type::schedule_thread_last(thrd, num_thread, priority);
+        }
+
+        /// Destroy the passed thread as it has been terminated
+        bool destroy_thread(threads::thread_data_base* thrd,
+            boost::int64_t& busy_count)
+        {
+            boost::uint64_t deadline = thrd->get_deadline();
+            if (0 != deadline && util::high_resolution_clock::now() > deadline)
+            {
+                std::size_t num_thread = hpx::get_worker_thread_num();
+                if (num_thread >= deadline_queues_.size())
+                    num_thread = 0;
+                deadline_queues_[num_thread]->increment_num_deadline_misses();
+            }
+
+            return base_type::destroy_thread(thrd, busy_count);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // This returns the current length of the queues (work items and new
+        // items)
+        boost::int64_t get_queue_length(
+            std::size_t num_thread = std::size_t(-1)) const
+        {
+            boost::int64_t count = base_type::get_queue_length(num_thread);
+            if (std::size_t(-1) != num_thread)
+            {
+                HPX_ASSERT(num_thread < deadline_queues_.size());
+                return count + deadline_queues_[num_thread]->size();
+            }
+            return count + deadline_threads_count_.load();
+        }
+
+        /// This is a function which gets called periodically by the thread
+        /// manager to allow for maintenance tasks to be executed in the
+        /// scheduler. Returns true if the OS thread calling this function
+        /// has to be terminated (i.e. no more work has to be done).
+        bool wait_or_add_new(std::size_t num_thread, bool running,
+            boost::int64_t& idle_loop_count)
+        {
+            bool result = base_type::wait_or_add_new(num_thread, running,
+                idle_loop_count);
+            return result &&
+                deadline_threads_count_.load(boost::memory_order_relaxed) == 0;
+        }
+
+    protected:
+        void schedule_deadline_thread(threads::thread_data_base* thrd,
+            std::size_t num_thread)
+        {
+            HPX_ASSERT(num_thread < deadline_queues_.size());
+            ++deadline_threads_count_;
+            deadline_queues_[num_thread]->push(thrd, thrd->get_deadline());
+        }
+
+        std::vector<deadline_queue_type*> deadline_queues_;
+
+        // overall number of threads in the deadline queues, allows to skip
+        // looking at them if there are none
+        boost::atomic<boost::int64_t> deadline_threads_count_;
+    };
+}}}
+
+#include <hpx/config/warnings_suffix.hpp>
+
+#endif
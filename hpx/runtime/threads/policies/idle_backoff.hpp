@@ -0,0 +1,133 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_THREADMANAGER_SCHEDULING_IDLE_BACKOFF_OCT_19_2014_0714PM)
+#define HPX_THREADMANAGER_SCHEDULING_IDLE_BACKOFF_OCT_19_2014_0714PM
+
+#include <hpx/hpx_fwd.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+// A worker thread which does not find any work keeps polling its queues
+// (spinning). With the backoff policy enabled, it escalates after a
+// configurable number of idle loop iterations:
+//
+// - spin: keep polling the queues (this is what the idle_spin policy
+//   does forever),
+// - yield: poll the queues, but yield the core to the operating system
+//   after each unsuccessful iteration,
+// - park: block the worker thread on its parking slot until new work is
+//   made available to it or the maximal park time has elapsed.
+//
+// Parked worker threads are woken up from scheduler_base::do_some_work,
+// which is invoked whenever work is added to any of the queues. A worker
+// re-checks the queues after announcing itself as parked, this way no
+// wake-up can get lost.
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace threads { namespace policies
+{
+    enum idle_policy
+    {
+        idle_spin = 0,      ///< idle worker threads never stop polling
+        idle_backoff = 1    ///< idle worker threads yield and get parked
+    };
+
+    struct idle_backoff_parameters
+    {
+        idle_backoff_parameters()
+          : policy_(idle_spin),
+            spin_count_(HPX_IDLE_BACKOFF_SPIN_COUNT),
+            yield_count_(HPX_IDLE_BACKOFF_YIELD_COUNT),
+            max_park_time_(HPX_IDLE_BACKOFF_MAX_PARK_TIME)
+        {}
+
+        idle_policy policy_;
+        boost::int64_t spin_count_;     // idle loops before starting to yield
+        boost::int64_t yield_count_;    // idle loops yielding before parking
+        boost::int64_t max_park_time_;  // maximal time parked [us]
+    };
+
+    // We globally control the idle behavior of the worker threads using this
+    // global variable. It will be set once by the runtime configuration
+    // startup code.
+    HPX_EXPORT extern idle_backoff_parameters idle_parameters;
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Every worker thread owns one parking slot. The parked_ flag is
+        // cleared by whoever ends the parking, the owning thread if the park
+        // is cancelled or has timed out, or a waking thread otherwise.
+        class parking_slot : boost::noncopyable
+        {
+        public:
+            parking_slot()
+              : parked_(false)
+            {}
+
+            // announce the intent to park, the caller has to re-check for
+            // available work afterwards
+            void prepare()
+            {
+                parked_.store(true);
+            }
+
+            // the caller has found work after having called prepare()
+            void cancel()
+            {
+                parked_.store(false);
+            }
+
+            // block until unpark() is called or the timeout has elapsed,
+            // returns whether the thread was woken up explicitly
+            bool wait(boost::chrono::microseconds timeout)
+            {
+                boost::unique_lock<boost::mutex> l(mtx_);
+                while (parked_.load(boost::memory_order_acquire))
+                {
+                    if (cond_.wait_for(l, timeout) == boost::cv_status::timeout)
+                    {
+                        // the wake-up may have raced with the timeout
+                        return !parked_.exchange(false);
+                    }
+                }
+                return true;
+            }
+
+            // returns whether the slot's thread was parked
+            bool unpark()
+            {
+                if (!parked_.load(boost::memory_order_relaxed) ||
+                    !parked_.exchange(false))
+                {
+                    return false;
+                }
+
+                boost::lock_guard<boost::mutex> l(mtx_);
+                cond_.notify_one();
+                return true;
+            }
+
+            bool is_parked() const
+            {
+                return parked_.load(boost::memory_order_relaxed);
+            }
+
+        private:
+            boost::atomic<bool> parked_;
+            boost::mutex mtx_;
+            boost::condition_variable cond_;
+        };
+    }
+}}}
+
+#endif
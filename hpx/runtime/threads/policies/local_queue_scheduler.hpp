@@ -286,6 +286,29 @@ namespace hpx { namespace threads { namespace policies
                 run_now, ec);
         }
 
+        // create the threads in blocks of consecutive threads, one block for
+        // each of the queues
+        void create_threads(thread_init_data* data, std::size_t count,
+            thread_state_enum initial_state, bool run_now, error_code& ec,
+            std::size_t num_thread)
+        {
+            std::size_t queue_size = queues_.size();
+
+            if (std::size_t(-1) == num_thread)
+                num_thread = ++curr_queue_ % queue_size;
+
+            std::size_t block = (count + queue_size - 1) / queue_size;
+            for (std::size_t first = 0; first < count; first += block)
+            {
+                std::size_t num = (num_thread++) % queue_size;
+                queues_[num]->create_threads(data + first,
+                    (std::min)(block, count - first), initial_state, run_now,
+                    ec);
+                if (&ec != &throws && ec)
+                    return;
+            }
+        }
+
         /// Return the next thread to be executed, return false if none is
         /// available
         virtual bool get_next_thread(std::size_t num_thread, bool running,
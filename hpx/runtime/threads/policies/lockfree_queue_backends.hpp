@@ -21,6 +21,30 @@ namespace hpx { namespace threads { namespace policies
 struct lockfree_fifo;
 struct lockfree_lifo;
 
+namespace detail
+{
+    // boost::lockfree::queue has no bulk push, insert the elements one by one
+    template <typename Queue, typename Iterator>
+    bool push_range(Queue& queue, Iterator begin, Iterator end)
+    {
+        for (/**/; begin != end; ++begin)
+        {
+            if (!queue.push(*begin))
+                return false;
+        }
+        return true;
+    }
+
+    // boost::lockfree::stack links all new nodes up front and publishes them
+    // with a single compare-and-swap
+    template <typename T, typename Iterator>
+    bool push_range(boost::lockfree::stack<T>& stack, Iterator begin,
+        Iterator end)
+    {
+        return stack.push(begin, end) == end;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 template <typename T, typename Queuing>
 struct basic_lockfree_queue_backend
@@ -43,6 +67,12 @@ struct basic_lockfree_queue_backend
         return queue_.push(val);
     }
 
+    template <typename Iterator>
+    bool push(Iterator begin, Iterator end)
+    {
+        return detail::push_range(queue_, begin, end);
+    }
+
     bool pop(reference val, bool /*steal*/ = true)
     {
         return queue_.pop(val);
@@ -106,6 +136,17 @@ struct lockfree_abp_fifo_backend
         return queue_.push_left(val);
     }
 
+    template <typename Iterator>
+    bool push(Iterator begin, Iterator end)
+    {
+        for (/**/; begin != end; ++begin)
+        {
+            if (!queue_.push_left(*begin))
+                return false;
+        }
+        return true;
+    }
+
     bool pop(reference val, bool steal = true)
     {
         if (steal)
@@ -156,6 +197,17 @@ struct lockfree_abp_lifo_backend
         return queue_.push_left(val);
     }
 
+    template <typename Iterator>
+    bool push(Iterator begin, Iterator end)
+    {
+        for (/**/; begin != end; ++begin)
+        {
+            if (!queue_.push_left(*begin))
+                return false;
+        }
+        return true;
+    }
+
     bool pop(reference val, bool steal = true)
     {
         if (steal)
@@ -10,35 +10,21 @@
 #include <hpx/runtime/threads/thread_init_data.hpp>
 #include <hpx/runtime/threads/topology.hpp>
 #include <hpx/runtime/threads/policies/affinity_data.hpp>
+#include <hpx/runtime/threads/policies/timer_wheel.hpp>
+#include <hpx/runtime/threads/policies/idle_backoff.hpp>
 
+#include <boost/atomic.hpp>
 #include <boost/noncopyable.hpp>
-#include <boost/thread/mutex.hpp>
-#include <boost/thread/condition_variable.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <vector>
 
 #include <hpx/config/warnings_prefix.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
 namespace hpx { namespace threads { namespace policies
 {
-#if defined(HPX_THREAD_BACKOFF_ON_IDLE)
-    namespace detail
-    {
-        struct reset_on_exit
-        {
-            reset_on_exit(boost::atomic<bool>& flag)
-              : flag_(flag)
-            {
-                flag_ = true;
-            }
-            ~reset_on_exit()
-            {
-                flag_ = false;
-            }
-            boost::atomic<bool>& flag_;
-        };
-    }
-#endif
-
     ///////////////////////////////////////////////////////////////////////////
     /// The scheduler_base defines the interface to be implemented by all
     /// scheduler policies
@@ -47,13 +33,25 @@ namespace hpx { namespace threads { namespace policies
         scheduler_base(std::size_t num_threads)
           : topology_(get_topology())
           , affinity_data_(num_threads)
-#if defined(HPX_THREAD_BACKOFF_ON_IDLE)
-          , wait_count_(0)
-          , waiting_(false)
-#endif
-        {}
+          , num_parked_(0)
+        {
+            std::size_t const num_wheels = num_threads ? num_threads : 1;
+            timers_.reserve(num_wheels);
+            parking_.reserve(num_wheels);
+            for (std::size_t i = 0; i != num_wheels; ++i)
+            {
+                timers_.push_back(new timer_wheel);
+                parking_.push_back(new detail::parking_slot);
+            }
+        }
 
-        virtual ~scheduler_base() {}
+        virtual ~scheduler_base()
+        {
+            for (std::size_t i = 0; i != timers_.size(); ++i)
+                delete timers_[i];
+            for (std::size_t i = 0; i != parking_.size(); ++i)
+                delete parking_[i];
+        }
 
         threads::mask_cref_type get_pu_mask(topology const& topology,
             std::size_t num_thread) const
@@ -77,31 +75,145 @@ namespace hpx { namespace threads { namespace policies
             return affinity_data_.init(data, topology);
         }
 
-        void idle_callback(std::size_t /*num_thread*/)
+        /// This function gets called by the scheduling loop for each
+        /// iteration which did not find any work. Depending on the configured
+        /// idle policy the calling worker thread keeps spinning, yields its
+        /// core or gets parked until new work arrives. Scheduling loops which
+        /// are nested inside an HPX thread (executors) must not park, as this
+        /// would block the worker thread of the enclosing scheduler.
+        void idle_backoff(std::size_t num_thread, boost::int64_t idle_loop_count,
+            bool allow_parking = true)
         {
-#if defined(HPX_THREAD_BACKOFF_ON_IDLE)
-            // Put this thread to sleep for some time, additionally it gets
-            // woken up on new work.
-            boost::chrono::milliseconds period(++wait_count_);
+            idle_backoff_parameters const& params = policies::idle_parameters;
+            if (params.policy_ == idle_spin ||
+                idle_loop_count <= params.spin_count_)
+            {
+                return;
+            }
 
-            boost::mutex::scoped_lock l(mtx_);
-            policies::detail::reset_on_exit w(waiting_);
-            cond_.wait_for(l, period);
-#endif
+            if (!allow_parking ||
+                idle_loop_count <= params.spin_count_ + params.yield_count_)
+            {
+                boost::this_thread::yield();
+                return;
+            }
+
+            detail::parking_slot& slot = get_parking_slot(num_thread);
+
+            // announce that this thread is about to park before re-checking
+            // the queues, do_some_work will see either the announcement or
+            // we will see the new work
+            slot.prepare();
+            ++num_parked_;
+
+            if (this->get_queue_length() == 0)
+            {
+                boost::int64_t park_time = params.max_park_time_;
+
+                // armed timers are polled from the scheduling loop only, limit
+                // the time spent parked while timers are pending
+                if (park_time > 1000 && has_armed_timers())
+                    park_time = 1000;
+
+                slot.wait(boost::chrono::microseconds(park_time));
+            }
+            else
+            {
+                slot.cancel();
+            }
+
+            --num_parked_;
         }
 
         /// This function gets called by the thread-manager whenever new work
         /// has been added, allowing the scheduler to reactivate one or more of
         /// possibly idling OS threads
-        void do_some_work(std::size_t /*num_thread*/)
+        void do_some_work(std::size_t num_thread)
         {
-#if defined(HPX_THREAD_BACKOFF_ON_IDLE)
-            wait_count_.store(0, boost::memory_order_release);
-            if (waiting_)
+            // make the new work visible before looking for parked threads
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            if (num_parked_.load(boost::memory_order_relaxed) == 0)
+                return;
+
+            if (num_thread == std::size_t(-1))
             {
-                cond_.notify_one();
+                for (std::size_t i = 0; i != parking_.size(); ++i)
+                    parking_[i]->unpark();
+                return;
             }
-#endif
+
+            // wake up the thread the work was given to, if that one is busy
+            // wake up any other parked thread as the work can be stolen
+            if (get_parking_slot(num_thread).unpark())
+                return;
+
+            for (std::size_t i = 0; i != parking_.size(); ++i)
+            {
+                if (parking_[i]->unpark())
+                    return;
+            }
+        }
+
+        boost::int64_t get_num_parked_threads() const
+        {
+            return num_parked_.load(boost::memory_order_relaxed);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Every worker thread owns a timer wheel which is polled from its
+        // scheduling loop, timers may be armed from any thread.
+        timer_wheel& get_timer_wheel(std::size_t num_thread)
+        {
+            return *timers_[num_thread % timers_.size()];
+        }
+
+        std::size_t get_timer_wheel_count() const
+        {
+            return timers_.size();
+        }
+
+        /// Arm a timer in the timer wheel of the given worker thread, the
+        /// deadline is expressed in terms of util::high_resolution_clock.
+        void arm_timer(std::size_t num_thread, boost::uint64_t deadline,
+            timer_entry const& entry)
+        {
+            get_timer_wheel(num_thread).arm(deadline, entry);
+        }
+
+        bool has_armed_timers() const
+        {
+            for (std::size_t i = 0; i != timers_.size(); ++i)
+            {
+                if (!timers_[i]->empty())
+                    return true;
+            }
+            return false;
+        }
+
+        boost::int64_t get_num_timers_armed(std::size_t num_thread, bool reset)
+        {
+            return accumulate_timer_counts(&timer_wheel::get_armed_count,
+                num_thread, reset);
+        }
+        boost::int64_t get_num_timers_fired(std::size_t num_thread, bool reset)
+        {
+            return accumulate_timer_counts(&timer_wheel::get_fired_count,
+                num_thread, reset);
+        }
+        boost::int64_t get_num_timers_cancelled(std::size_t num_thread,
+            bool reset)
+        {
+            return accumulate_timer_counts(&timer_wheel::get_cancelled_count,
+                num_thread, reset);
+        }
+
+        /// Return the number of threads which finished running after their
+        /// deadline had passed, only deadline aware schedulers keep track of
+        /// those.
+        virtual boost::int64_t get_num_deadline_misses(
+            std::size_t /*num_thread*/, bool /*reset*/)
+        {
+            return 0;
         }
 
         ///////////////////////////////////////////////////////////////////////
@@ -143,6 +255,22 @@ namespace hpx { namespace threads { namespace policies
             thread_state_enum initial_state, bool run_now, error_code& ec,
             std::size_t num_thread) = 0;
 
+        /// Create \a count threads with a single call. Schedulers owning one
+        /// queue per worker thread distribute the threads in blocks over
+        /// their queues (starting at \a num_thread), this implementation
+        /// simply creates the threads one by one.
+        virtual void create_threads(thread_init_data* data, std::size_t count,
+            thread_state_enum initial_state, bool run_now, error_code& ec,
+            std::size_t num_thread)
+        {
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                create_thread(data[i], initial_state, run_now, ec, num_thread);
+                if (&ec != &throws && ec)
+                    return;
+            }
+        }
+
         virtual bool get_next_thread(std::size_t num_thread, bool running,
             boost::int64_t& idle_loop_count, threads::thread_data_base*& thrd) = 0;
 
@@ -170,17 +298,33 @@ namespace hpx { namespace threads { namespace policies
             std::size_t num_thread = std::size_t(-1)) const = 0;
 #endif
 
+    private:
+        detail::parking_slot& get_parking_slot(std::size_t num_thread)
+        {
+            return *parking_[num_thread % parking_.size()];
+        }
+
+        boost::int64_t accumulate_timer_counts(
+            boost::int64_t (timer_wheel::*f)(bool), std::size_t num_thread,
+            bool reset)
+        {
+            if (num_thread != std::size_t(-1))
+                return (get_timer_wheel(num_thread).*f)(reset);
+
+            boost::int64_t result = 0;
+            for (std::size_t i = 0; i != timers_.size(); ++i)
+                result += (timers_[i]->*f)(reset);
+            return result;
+        }
+
     protected:
         topology const& topology_;
         detail::affinity_data affinity_data_;
+        std::vector<timer_wheel*> timers_;
 
-#if defined(HPX_THREAD_BACKOFF_ON_IDLE)
-        // support for suspension on idle queues
-        boost::mutex mtx_;
-        boost::condition_variable cond_;
-        boost::atomic<boost::uint32_t> wait_count_;
-        boost::atomic<bool> waiting_;
-#endif
+        // support for parking of idle worker threads
+        std::vector<detail::parking_slot*> parking_;
+        boost::atomic<boost::int64_t> num_parked_;
     };
 }}}
 
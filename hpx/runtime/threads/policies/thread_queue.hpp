@@ -9,10 +9,12 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <hpx/config.hpp>
 #include <hpx/util/move.hpp>
 #include <hpx/util/get_and_reset_value.hpp>
+#include <hpx/util/binary_log.hpp>
 #include <hpx/util/block_profiler.hpp>
 #include <hpx/util/high_resolution_clock.hpp>
 #include <hpx/runtime/threads/thread_data.hpp>
@@ -278,7 +280,12 @@ namespace hpx { namespace threads { namespace policies
             }
 
             if (added) {
-                LTM_(debug) << "add_new: added " << added << " tasks to queues"; //-V128
+                if (LBIN_ENABLED(debug)) {
+                    LTM_BIN_(debug)("add_new: added %1% tasks to queues", added);
+                }
+                else {
+                    LTM_(debug) << "add_new: added " << added << " tasks to queues"; //-V128
+                }
             }
             return added;
         }
@@ -740,6 +747,68 @@ namespace hpx { namespace threads { namespace policies
             return invalid_thread_id;     // thread has not been created yet
         }
 
+        // create count new threads, the mutex is acquired only once for all
+        // of them
+        void create_threads(thread_init_data* data, std::size_t count,
+            thread_state_enum initial_state, bool run_now, error_code& ec)
+        {
+            if (run_now) {
+                typename mutex_type::scoped_lock lk(mtx_);
+
+                for (std::size_t i = 0; i != count; ++i)
+                {
+                    threads::thread_id_type thrd;
+                    create_thread_object(thrd, data[i], initial_state, lk);
+
+                    // add a new entry in the map for this thread
+                    std::pair<thread_map_type::iterator, bool> p =
+                        thread_map_.insert(thrd);
+
+                    if (HPX_UNLIKELY(!p.second)) {
+                        HPX_THROWS_IF(ec, hpx::out_of_memory,
+                            "threadmanager::register_work",
+                            "Couldn't add new thread to the map of threads");
+                        return;
+                    }
+                    ++thread_map_count_;
+
+                    // push the new thread in the pending queue thread
+                    if (initial_state == pending)
+                        schedule_thread(thrd.get());
+
+                    HPX_ASSERT(thrd->is_created_from(&memory_pool_));
+                }
+
+                if (&ec != &throws)
+                    ec = make_success_code();
+                return;
+            }
+
+            // register all task descriptions for later thread creation, the
+            // whole block is handed to the queue in one operation
+            std::vector<task_description*> tasks;
+            tasks.reserve(count);
+
+            for (std::size_t i = 0; i != count; ++i)
+            {
+#if HPX_THREAD_MAINTAIN_QUEUE_WAITTIME
+                tasks.push_back(new task_description(
+                    std::move(data[i]), initial_state,
+                    util::high_resolution_clock::now()
+                ));
+#else
+                tasks.push_back(new task_description(
+                    std::move(data[i]), initial_state));
+#endif
+            }
+
+            new_tasks_count_ += count;
+            new_tasks_.push(tasks.begin(), tasks.end());
+
+            if (&ec != &throws)
+                ec = make_success_code();
+        }
+
         void move_work_items_from(thread_queue *src, boost::int64_t count)
         {
             thread_description* trd;
@@ -0,0 +1,365 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_THREADMANAGER_SCHEDULING_TIMER_WHEEL_OCT_19_2014_0611PM)
+#define HPX_THREADMANAGER_SCHEDULING_TIMER_WHEEL_OCT_19_2014_0611PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/util/assert.hpp>
+#include <hpx/util/spinlock.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+#include <hpx/util/get_and_reset_value.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <vector>
+
+// The timer_wheel is a hierarchical timing wheel (Varghese & Lauck) used to
+// implement timed suspension of HPX threads:
+//
+// - time is divided into ticks of HPX_THREAD_TIMER_WHEEL_RESOLUTION
+//   nanoseconds, a timer fires at the first tick at or after its deadline,
+//   i.e. never early,
+// - the wheel consists of num_levels levels of num_slots slots each, every
+//   level covering num_slots times the range of the level below it,
+// - arming a timer and firing it are O(1), timers on the higher levels are
+//   moved (cascaded) to the next lower level once the lower level wraps
+//   around.
+//
+// Each worker thread owns one wheel which is polled from the scheduling loop.
+// Timers can be armed from any thread, the wheel is protected by a spinlock.
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace threads { namespace policies
+{
+    ///////////////////////////////////////////////////////////////////////////
+    /// A timer_entry describes the state change to apply to a thread once its
+    /// timer expires.
+    struct timer_entry
+    {
+        timer_entry()
+          : phase_(0), newstate_(pending), newstate_ex_(wait_timeout),
+            priority_(thread_priority_normal)
+        {}
+
+        timer_entry(thread_id_type const& thrd, std::size_t phase,
+                thread_state_enum newstate, thread_state_ex_enum newstate_ex,
+                thread_priority priority)
+          : thrd_(thrd), phase_(phase),
+            newstate_(newstate), newstate_ex_(newstate_ex), priority_(priority)
+        {}
+
+        thread_id_type thrd_;
+        std::size_t phase_;         // thread phase at the time the timer was armed
+        thread_state_enum newstate_;
+        thread_state_ex_enum newstate_ex_;
+        thread_priority priority_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    class timer_wheel : boost::noncopyable
+    {
+    private:
+        typedef util::spinlock mutex_type;
+
+        struct node
+        {
+            timer_entry entry_;
+            boost::uint64_t deadline_;      // in ticks
+            node* next_;
+        };
+
+    public:
+        BOOST_STATIC_CONSTANT(std::size_t, slot_bits = 8);
+        BOOST_STATIC_CONSTANT(std::size_t, num_slots = 1 << slot_bits);
+        BOOST_STATIC_CONSTANT(std::size_t, num_levels = 4);
+
+        /// \param resolution [in] The duration of one tick of the wheel (in
+        ///                   nanoseconds).
+        explicit timer_wheel(
+                boost::uint64_t resolution = HPX_THREAD_TIMER_WHEEL_RESOLUTION)
+          : resolution_(resolution),
+            current_(util::high_resolution_clock::now() / resolution),
+            size_(0), free_list_(0), free_count_(0),
+            armed_(0), fired_(0), cancelled_(0)
+        {
+            HPX_ASSERT(resolution_ != 0);
+            for (std::size_t l = 0; l != num_levels; ++l)
+                for (std::size_t s = 0; s != num_slots; ++s)
+                    slots_[l][s] = 0;
+        }
+
+        ~timer_wheel()
+        {
+            clear();
+            while (free_list_ != 0)
+            {
+                node* n = free_list_;
+                free_list_ = n->next_;
+                delete n;
+            }
+        }
+
+        /// Arm a timer expiring at the given point in time (as returned by
+        /// util::high_resolution_clock::now()).
+        void arm(boost::uint64_t deadline, timer_entry const& entry)
+        {
+            boost::uint64_t ticks = (deadline + resolution_ - 1) / resolution_;
+
+            {
+                mutex_type::scoped_lock l(mtx_);
+
+                // an empty wheel is not advanced while polling, catch up
+                boost::uint64_t current = current_.load(boost::memory_order_relaxed);
+                if (size_.load(boost::memory_order_relaxed) == 0)
+                {
+                    boost::uint64_t now =
+                        util::high_resolution_clock::now() / resolution_;
+                    if (now > current)
+                    {
+                        current = now;
+                        current_.store(current, boost::memory_order_relaxed);
+                    }
+                }
+
+                node* n = allocate();
+                n->entry_ = entry;
+                n->deadline_ = (ticks > current) ? ticks : current + 1;
+                insert(n, current);
+
+                size_.fetch_add(1, boost::memory_order_release);
+            }
+
+            ++armed_;
+        }
+
+        /// Advance the wheel to the given point in time and append all
+        /// expired timers to \a expired. If \a try_only is true the function
+        /// returns immediately if the wheel is being accessed concurrently.
+        ///
+        /// \returns true if timers have expired.
+        bool expire(boost::uint64_t now, std::vector<timer_entry>& expired,
+            bool try_only = false)
+        {
+            boost::uint64_t target = now / resolution_;
+            if (size_.load(boost::memory_order_acquire) == 0 ||
+                target <= current_.load(boost::memory_order_relaxed))
+            {
+                return false;
+            }
+
+            boost::unique_lock<mutex_type> l(mtx_, boost::defer_lock);
+            if (try_only)
+            {
+                if (!l.try_lock())
+                    return false;
+            }
+            else
+            {
+                l.lock();
+            }
+
+            std::size_t const old_size = expired.size();
+            advance(target, expired);
+            return expired.size() != old_size;
+        }
+
+        /// Remove all armed timers regardless of their deadline and append
+        /// them to \a expired.
+        void expire_all(std::vector<timer_entry>& expired)
+        {
+            mutex_type::scoped_lock l(mtx_);
+
+            for (std::size_t level = 0; level != num_levels; ++level)
+            {
+                for (std::size_t s = 0; s != num_slots; ++s)
+                {
+                    node* n = slots_[level][s];
+                    slots_[level][s] = 0;
+                    while (n != 0)
+                    {
+                        node* next = n->next_;
+                        expired.push_back(n->entry_);
+                        deallocate(n);
+                        n = next;
+                    }
+                }
+            }
+            size_.store(0, boost::memory_order_relaxed);
+        }
+
+        /// Drop all armed timers, they are counted as cancelled.
+        void clear()
+        {
+            std::vector<timer_entry> expired;
+            expire_all(expired);
+            cancelled_ += static_cast<boost::int64_t>(expired.size());
+        }
+
+        /// Return whether no timers are armed.
+        bool empty() const
+        {
+            return size_.load(boost::memory_order_relaxed) == 0;
+        }
+
+        /// Return the number of armed timers.
+        std::size_t size() const
+        {
+            return size_.load(boost::memory_order_relaxed);
+        }
+
+        /// The poller reports the outcome of every expired timer.
+        void count_fired() { ++fired_; }
+        void count_cancelled() { ++cancelled_; }
+
+        boost::int64_t get_armed_count(bool reset)
+        {
+            return util::get_and_reset_value(armed_, reset);
+        }
+        boost::int64_t get_fired_count(bool reset)
+        {
+            return util::get_and_reset_value(fired_, reset);
+        }
+        boost::int64_t get_cancelled_count(bool reset)
+        {
+            return util::get_and_reset_value(cancelled_, reset);
+        }
+
+    private:
+        // Link the given node into the slot corresponding to its deadline,
+        // relative to the given current tick.
+        void insert(node* n, boost::uint64_t current)
+        {
+            HPX_ASSERT(n->deadline_ >= current);
+
+            boost::uint64_t const delta = n->deadline_ - current;
+            boost::uint64_t deadline = n->deadline_;
+
+            std::size_t level = 0;
+            while (level != num_levels - 1 &&
+                delta >= (boost::uint64_t(1) << (slot_bits * (level + 1))))
+            {
+                ++level;
+            }
+
+            // timers beyond the range of the wheel are parked in the
+            // farthest slot, they are re-inserted whenever cascaded
+            boost::uint64_t const range =
+                boost::uint64_t(1) << (slot_bits * num_levels);
+            if (delta >= range)
+                deadline = current + range - 1;
+
+            std::size_t const slot = static_cast<std::size_t>(
+                (deadline >> (slot_bits * level)) & (num_slots - 1));
+
+            n->next_ = slots_[level][slot];
+            slots_[level][slot] = n;
+        }
+
+        // Step the wheel tick by tick up to the given target tick, this has
+        // to be called with the lock held.
+        void advance(boost::uint64_t target, std::vector<timer_entry>& expired)
+        {
+            boost::uint64_t current = current_.load(boost::memory_order_relaxed);
+            while (current < target)
+            {
+                if (size_.load(boost::memory_order_relaxed) == 0)
+                {
+                    current = target;
+                    break;
+                }
+
+                ++current;
+
+                // move the timers of the next slot of every level which has
+                // just wrapped around down to the lower levels
+                for (std::size_t l = 1; l != num_levels; ++l)
+                {
+                    std::size_t const shift = slot_bits * l;
+                    if ((current & ((boost::uint64_t(1) << shift) - 1)) != 0)
+                        break;
+
+                    std::size_t const slot = static_cast<std::size_t>(
+                        (current >> shift) & (num_slots - 1));
+
+                    node* n = slots_[l][slot];
+                    slots_[l][slot] = 0;
+                    while (n != 0)
+                    {
+                        node* next = n->next_;
+                        insert(n, current);
+                        n = next;
+                    }
+                }
+
+                // all timers in the current slot of the lowest level expire
+                std::size_t const slot =
+                    static_cast<std::size_t>(current & (num_slots - 1));
+
+                node* n = slots_[0][slot];
+                slots_[0][slot] = 0;
+                while (n != 0)
+                {
+                    node* next = n->next_;
+                    HPX_ASSERT(n->deadline_ == current);
+
+                    expired.push_back(n->entry_);
+                    deallocate(n);
+                    size_.fetch_sub(1, boost::memory_order_relaxed);
+                    n = next;
+                }
+            }
+            current_.store(current, boost::memory_order_relaxed);
+        }
+
+        // Nodes are recycled to avoid hitting the allocator for every timer.
+        node* allocate()
+        {
+            if (free_list_ == 0)
+                return new node;
+
+            node* n = free_list_;
+            free_list_ = n->next_;
+            --free_count_;
+            return n;
+        }
+
+        void deallocate(node* n)
+        {
+            n->entry_ = timer_entry();      // release the thread reference
+            if (free_count_ >= max_free_count)
+            {
+                delete n;
+                return;
+            }
+
+            n->next_ = free_list_;
+            free_list_ = n;
+            ++free_count_;
+        }
+
+        BOOST_STATIC_CONSTANT(std::size_t, max_free_count = 1024);
+
+    private:
+        boost::uint64_t const resolution_;
+
+        mutable mutex_type mtx_;
+        boost::atomic<boost::uint64_t> current_;    // current tick
+        boost::atomic<std::size_t> size_;           // number of armed timers
+        node* slots_[num_levels][num_slots];
+
+        node* free_list_;
+        std::size_t free_count_;
+
+        boost::atomic<boost::int64_t> armed_;
+        boost::atomic<boost::int64_t> fired_;
+        boost::atomic<boost::int64_t> cancelled_;
+    };
+}}}
+
+#endif
@@ -35,13 +35,46 @@
 
 #include <hpx/config/warnings_prefix.hpp>
 
+///////////////////////////////////////////////////////////////////////////////
+// The debugging and logging information of threads is kept out of line
+#if HPX_THREAD_MAINTAIN_TARGET_ADDRESS || HPX_THREAD_MAINTAIN_DESCRIPTION ||   \
+    HPX_THREAD_MAINTAIN_PARENT_REFERENCE ||                                   \
+    HPX_THREAD_MINIMAL_DEADLOCK_DETECTION ||                                  \
+    HPX_THREAD_MAINTAIN_BACKTRACE_ON_SUSPENSION
+#  define HPX_THREAD_MAINTAIN_COLD_DATA 1
+#else
+#  define HPX_THREAD_MAINTAIN_COLD_DATA 0
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 namespace hpx { namespace threads
 {
     class thread_data;
+    class thread_data_base;
 
     namespace detail
     {
+        ///////////////////////////////////////////////////////////////////////
+        // Keep track of the stackless thread executed by the calling OS
+        // thread, if any. This is used to report attempts to suspend a
+        // stackless thread.
+        HPX_API_EXPORT thread_data_base* set_running_stackless(
+            thread_data_base* thrd);
+        HPX_API_EXPORT thread_data_base* get_running_stackless();
+
+        struct reset_running_stackless
+        {
+            reset_running_stackless(thread_data_base* thrd)
+              : prev_(set_running_stackless(thrd))
+            {}
+            ~reset_running_stackless()
+            {
+                set_running_stackless(prev_);
+            }
+
+            thread_data_base* prev_;
+        };
+
         ///////////////////////////////////////////////////////////////////////
         // Why do we use std::stack + a lock here?
         template <typename CoroutineImpl>
@@ -103,6 +136,64 @@ namespace hpx { namespace threads
                 f_();
             }
         };
+
+#if HPX_THREAD_MAINTAIN_COLD_DATA != 0
+        ///////////////////////////////////////////////////////////////////////
+        // The debugging and logging information of a thread is rarely
+        // accessed, it is kept separately from the data needed for
+        // scheduling the thread. This block is allocated on first use only.
+        struct thread_data_cold
+        {
+            thread_data_cold()
+            {
+#if HPX_THREAD_MAINTAIN_TARGET_ADDRESS
+                component_id_ = 0;
+#endif
+#if HPX_THREAD_MAINTAIN_DESCRIPTION
+                description_ = "";
+                lco_description_ = "";
+#endif
+#if HPX_THREAD_MAINTAIN_PARENT_REFERENCE
+                parent_locality_id_ = 0;
+                parent_thread_id_ = 0;
+                parent_thread_phase_ = 0;
+#endif
+#if HPX_THREAD_MINIMAL_DEADLOCK_DETECTION
+                marked_state_ = thread_state(unknown);
+#endif
+#if HPX_THREAD_MAINTAIN_BACKTRACE_ON_SUSPENSION
+                backtrace_ = 0;
+#endif
+            }
+
+#if HPX_THREAD_MAINTAIN_TARGET_ADDRESS
+            naming::address::address_type component_id_;
+#endif
+
+#if HPX_THREAD_MAINTAIN_DESCRIPTION
+            char const* description_;
+            char const* lco_description_;
+#endif
+
+#if HPX_THREAD_MAINTAIN_PARENT_REFERENCE
+            boost::uint32_t parent_locality_id_;
+            thread_id_repr_type parent_thread_id_;
+            std::size_t parent_thread_phase_;
+#endif
+
+#if HPX_THREAD_MINIMAL_DEADLOCK_DETECTION
+            thread_state marked_state_;
+#endif
+
+#if HPX_THREAD_MAINTAIN_BACKTRACE_ON_SUSPENSION
+# if HPX_THREAD_MAINTAIN_FULLBACKTRACE_ON_SUSPENSION != 0
+            char const* backtrace_;
+# else
+            util::backtrace const* backtrace_;
+# endif
+#endif
+        };
+#endif
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -134,50 +225,23 @@ namespace hpx { namespace threads
         thread_data_base(thread_init_data& init_data, thread_state_enum newstate)
           : current_state_(thread_state(newstate)),
             current_state_ex_(thread_state_ex(wait_signaled)),
-#if HPX_THREAD_MAINTAIN_TARGET_ADDRESS
-            component_id_(init_data.lva),
-#endif
-#if HPX_THREAD_MAINTAIN_DESCRIPTION
-            description_(init_data.description ? init_data.description : ""),
-            lco_description_(""),
-#endif
-#if HPX_THREAD_MAINTAIN_PARENT_REFERENCE
-            parent_locality_id_(init_data.parent_locality_id),
-            parent_thread_id_(init_data.parent_id),
-            parent_thread_phase_(init_data.parent_phase),
-#endif
-#if HPX_THREAD_MINIMAL_DEADLOCK_DETECTION
-            marked_state_(unknown),
-#endif
-#if HPX_THREAD_MAINTAIN_BACKTRACE_ON_SUSPENSION
-            backtrace_(0),
-#endif
             priority_(init_data.priority),
             requested_interrupt_(false),
             enabled_interrupt_(true),
             ran_exit_funcs_(false),
-            exit_funcs_(0),
-            scheduler_base_(init_data.scheduler_base),
             count_(0),
-            stacksize_(init_data.stacksize)
+            scheduler_base_(init_data.scheduler_base),
+            stacksize_(init_data.stacksize),
+            deadline_(init_data.deadline),
+            exit_funcs_(0)
+#if HPX_THREAD_MAINTAIN_COLD_DATA != 0
+          , cold_(0)
+#endif
         {
+            init_cold_data(init_data);
+
             LTM_(debug) << "thread::thread(" << this << "), description("
                         << get_description() << ")";
-
-#if HPX_THREAD_MAINTAIN_PARENT_REFERENCE
-            // store the thread id of the parent thread, mainly for debugging
-            // purposes
-            if (0 == parent_thread_id_) {
-                thread_self* self = get_self_ptr();
-                if (self)
-                {
-                    parent_thread_id_ = threads::get_self_id().get();
-                    parent_thread_phase_ = self->get_thread_phase();
-                }
-            }
-            if (0 == parent_locality_id_)
-                parent_locality_id_ = get_locality_id();
-#endif
         }
 
         void rebind_base(thread_init_data& init_data, thread_state_enum newstate)
@@ -186,55 +250,35 @@ namespace hpx { namespace threads
 
             current_state_.store(thread_state(newstate));
             current_state_ex_.store(thread_state_ex(wait_signaled));
-#if HPX_THREAD_MAINTAIN_TARGET_ADDRESS
-            component_id_ = init_data.lva;
-#endif
-#if HPX_THREAD_MAINTAIN_DESCRIPTION
-            description_ = (init_data.description ? init_data.description : "");
-            lco_description_ = "";
-#endif
-#if HPX_THREAD_MAINTAIN_PARENT_REFERENCE
-            parent_locality_id_ = init_data.parent_locality_id;
-            parent_thread_id_ = init_data.parent_id;
-            parent_thread_phase_ = init_data.parent_phase;
-#endif
-#if HPX_THREAD_MINIMAL_DEADLOCK_DETECTION
-            set_marked_state(thread_state(unknown));
-#endif
-#if HPX_THREAD_MAINTAIN_BACKTRACE_ON_SUSPENSION
-            backtrace_ = 0;
-#endif
             priority_ = init_data.priority;
             requested_interrupt_ = false;
             enabled_interrupt_ = true;
             ran_exit_funcs_ = false;
             exit_funcs_ = 0;
             scheduler_base_ = init_data.scheduler_base;
+            deadline_ = init_data.deadline;
 
             HPX_ASSERT(init_data.stacksize == get_stack_size());
 
+#if HPX_THREAD_MAINTAIN_COLD_DATA != 0
+            // reuse the block of debugging information, if any
+            detail::thread_data_cold* cold =
+                cold_.load(boost::memory_order_relaxed);
+            if (0 != cold)
+                *cold = detail::thread_data_cold();
+#endif
+            init_cold_data(init_data);
+
             LTM_(debug) << "thread::thread(" << this << "), description("
                         << get_description() << "), rebind";
-
-#if HPX_THREAD_MAINTAIN_PARENT_REFERENCE
-            // store the thread id of the parent thread, mainly for debugging
-            // purposes
-            if (0 == parent_thread_id_) {
-                thread_self* self = get_self_ptr();
-                if (self)
-                {
-                    parent_thread_id_ = threads::get_self_id().get();
-                    parent_thread_phase_ = self->get_thread_phase();
-                }
-            }
-            if (0 == parent_locality_id_)
-                parent_locality_id_ = get_locality_id();
-#endif
         }
 
         virtual ~thread_data_base()
         {
             free_thread_exit_callbacks();
+#if HPX_THREAD_MAINTAIN_COLD_DATA != 0
+            delete cold_.load(boost::memory_order_relaxed);
+#endif
         }
 
         /// The get_state function queries the state of this thread instance.
@@ -368,7 +412,8 @@ namespace hpx { namespace threads
 #if HPX_THREAD_MAINTAIN_TARGET_ADDRESS == 0
             return 0;
 #else
-            return component_id_;
+            detail::thread_data_cold const* cold = try_get_cold();
+            return cold ? cold->component_id_ : 0;
 #endif
         }
 
@@ -394,24 +439,31 @@ namespace hpx { namespace threads
         char const* get_description() const
         {
             mutex_type::scoped_lock l(this);
-            return description_ ? description_ : "<unknown>";
+            detail::thread_data_cold const* cold = try_get_cold();
+            if (0 == cold)
+                return "";
+            return cold->description_ ? cold->description_ : "<unknown>";
         }
         char const* set_description(char const* value)
         {
             mutex_type::scoped_lock l(this);
-            std::swap(description_, value);
+            std::swap(get_cold().description_, value);
             return value;
         }
 
         char const* get_lco_description() const
         {
             mutex_type::scoped_lock l(this);
-            return lco_description_ ? lco_description_ : "<unknown>";
+            detail::thread_data_cold const* cold = try_get_cold();
+            if (0 == cold)
+                return "";
+            return cold->lco_description_ ?
+                cold->lco_description_ : "<unknown>";
         }
         char const* set_lco_description(char const* value)
         {
             mutex_type::scoped_lock l(this);
-            std::swap(lco_description_, value);
+            std::swap(get_cold().lco_description_, value);
             return value;
         }
 #endif
@@ -438,30 +490,35 @@ namespace hpx { namespace threads
         /// Return the locality of the parent thread
         boost::uint32_t get_parent_locality_id() const
         {
-            return parent_locality_id_;
+            detail::thread_data_cold const* cold = try_get_cold();
+            return cold ? cold->parent_locality_id_ : naming::invalid_locality_id;
         }
 
         /// Return the thread id of the parent thread
         thread_id_repr_type get_parent_thread_id() const
         {
-            return parent_thread_id_;
+            detail::thread_data_cold const* cold = try_get_cold();
+            return cold ? cold->parent_thread_id_ :
+                threads::invalid_thread_id_repr;
         }
 
         /// Return the phase of the parent thread
         std::size_t get_parent_thread_phase() const
         {
-            return parent_thread_phase_;
+            detail::thread_data_cold const* cold = try_get_cold();
+            return cold ? cold->parent_thread_phase_ : 0;
         }
 #endif
 
 #if HPX_THREAD_MINIMAL_DEADLOCK_DETECTION
         void set_marked_state(thread_state mark) const
         {
-            marked_state_ = mark;
+            get_cold().marked_state_ = mark;
         }
         thread_state get_marked_state() const
         {
-            return marked_state_;
+            detail::thread_data_cold const* cold = try_get_cold();
+            return cold ? cold->marked_state_ : thread_state(unknown);
         }
 #endif
 
@@ -493,28 +550,32 @@ namespace hpx { namespace threads
         char const* get_backtrace() const
         {
             mutex_type::scoped_lock l(this);
-            return backtrace_;
+            detail::thread_data_cold const* cold = try_get_cold();
+            return cold ? cold->backtrace_ : 0;
         }
         char const* set_backtrace(char const* value)
         {
             mutex_type::scoped_lock l(this);
 
-            char const* bt = backtrace_;
-            backtrace_ = value;
+            detail::thread_data_cold& cold = get_cold();
+            char const* bt = cold.backtrace_;
+            cold.backtrace_ = value;
             return bt;
         }
 # else
         util::backtrace const* get_backtrace() const
         {
             mutex_type::scoped_lock l(this);
-            return backtrace_;
+            detail::thread_data_cold const* cold = try_get_cold();
+            return cold ? cold->backtrace_ : 0;
         }
         util::backtrace const* set_backtrace(util::backtrace const* value)
         {
             mutex_type::scoped_lock l(this);
 
-            util::backtrace const* bt = backtrace_;
-            backtrace_ = value;
+            detail::thread_data_cold& cold = get_cold();
+            util::backtrace const* bt = cold.backtrace_;
+            cold.backtrace_ = value;
             return bt;
         }
 # endif
@@ -524,12 +585,13 @@ namespace hpx { namespace threads
         {
             mutex_type::scoped_lock l(this);
             std::string bt;
-            if (0 != backtrace_)
+            detail::thread_data_cold const* cold = try_get_cold();
+            if (0 != cold && 0 != cold->backtrace_)
             {
 # if HPX_THREAD_MAINTAIN_FULLBACKTRACE_ON_SUSPENSION != 0
-                bt = *backtrace_;
+                bt = *cold->backtrace_;
 #else
-                bt = backtrace_->trace();
+                bt = cold->backtrace_->trace();
 #endif
             }
             return bt;
@@ -545,6 +607,17 @@ namespace hpx { namespace threads
             priority_ = priority;
         }
 
+        // The deadline is an absolute point in time in terms of
+        // util::high_resolution_clock, zero means no deadline.
+        boost::uint64_t get_deadline() const
+        {
+            return deadline_;
+        }
+        void set_deadline(boost::uint64_t deadline)
+        {
+            deadline_ = deadline;
+        }
+
         // handle thread interruption
         bool interruption_requested() const
         {
@@ -611,56 +684,96 @@ namespace hpx { namespace threads
         friend HPX_EXPORT void intrusive_ptr_add_ref(thread_data_base* p);
         friend HPX_EXPORT void intrusive_ptr_release(thread_data_base* p);
 
-    protected:
-        mutable boost::atomic<thread_state> current_state_;
-        mutable boost::atomic<thread_state_ex> current_state_ex_;
+    private:
+#if HPX_THREAD_MAINTAIN_COLD_DATA != 0
+        // Return the block of debugging information, allocate it if needed.
+        detail::thread_data_cold& get_cold() const
+        {
+            detail::thread_data_cold* cold =
+                cold_.load(boost::memory_order_acquire);
+            if (HPX_LIKELY(0 != cold))
+                return *cold;
 
-        ///////////////////////////////////////////////////////////////////////
-        // Debugging/logging information
-#if HPX_THREAD_MAINTAIN_TARGET_ADDRESS
-        naming::address::address_type component_id_;
-#endif
+            detail::thread_data_cold* new_cold = new detail::thread_data_cold;
+            if (!cold_.compare_exchange_strong(cold, new_cold))
+            {
+                // some other thread was faster
+                delete new_cold;
+                return *cold;
+            }
+            return *new_cold;
+        }
 
-#if HPX_THREAD_MAINTAIN_DESCRIPTION
-        char const* description_;
-        char const* lco_description_;
+        // Return the block of debugging information if it was allocated.
+        detail::thread_data_cold const* try_get_cold() const
+        {
+            return cold_.load(boost::memory_order_acquire);
+        }
 #endif
 
-#if HPX_THREAD_MAINTAIN_PARENT_REFERENCE
-        boost::uint32_t parent_locality_id_;
-        thread_id_repr_type parent_thread_id_;
-        std::size_t parent_thread_phase_;
+        void init_cold_data(thread_init_data& init_data)
+        {
+            HPX_UNUSED(init_data);
+#if HPX_THREAD_MAINTAIN_TARGET_ADDRESS
+            if (0 != init_data.lva)
+                get_cold().component_id_ = init_data.lva;
 #endif
-
-#if HPX_THREAD_MINIMAL_DEADLOCK_DETECTION
-        mutable thread_state marked_state_;
+#if HPX_THREAD_MAINTAIN_DESCRIPTION
+            if (0 != init_data.description)
+                get_cold().description_ = init_data.description;
 #endif
+#if HPX_THREAD_MAINTAIN_PARENT_REFERENCE
+            // store the thread id of the parent thread, mainly for debugging
+            // purposes
+            detail::thread_data_cold& cold = get_cold();
+            cold.parent_locality_id_ = init_data.parent_locality_id;
+            cold.parent_thread_id_ = init_data.parent_id;
+            cold.parent_thread_phase_ = init_data.parent_phase;
 
-#if HPX_THREAD_MAINTAIN_BACKTRACE_ON_SUSPENSION
-# if HPX_THREAD_MAINTAIN_FULLBACKTRACE_ON_SUSPENSION != 0
-        char const* backtrace_;
-# else
-        util::backtrace const* backtrace_;
-# endif
+            if (0 == cold.parent_thread_id_) {
+                thread_self* self = get_self_ptr();
+                if (self)
+                {
+                    cold.parent_thread_id_ = threads::get_self_id().get();
+                    cold.parent_thread_phase_ = self->get_thread_phase();
+                }
+            }
+            if (0 == cold.parent_locality_id_)
+                cold.parent_locality_id_ = get_locality_id();
 #endif
+        }
 
+    protected:
         ///////////////////////////////////////////////////////////////////////
+        // Data needed for scheduling the thread, this is kept together at the
+        // beginning of the object.
+        mutable boost::atomic<thread_state> current_state_;
+        mutable boost::atomic<thread_state_ex> current_state_ex_;
+
         thread_priority priority_;
 
         bool requested_interrupt_;
         bool enabled_interrupt_;
         bool ran_exit_funcs_;
 
-        // Singly linked list (heap-allocated)
-        detail::thread_exit_callback_node* exit_funcs_;
+        //reference count
+        boost::detail::atomic_count count_;
 
         // reference to scheduler which created/manages this thread
         policies::scheduler_base* scheduler_base_;
 
-        //reference count
-        boost::detail::atomic_count count_;
-
         std::ptrdiff_t stacksize_;
+
+        // used by deadline aware schedulers, zero if none
+        boost::uint64_t deadline_;
+
+        // Singly linked list (heap-allocated)
+        detail::thread_exit_callback_node* exit_funcs_;
+
+#if HPX_THREAD_MAINTAIN_COLD_DATA != 0
+        // Debugging/logging information (heap-allocated on first use)
+        mutable boost::atomic<detail::thread_data_cold*> cold_;
+#endif
     };
 
     ///////////////////////////////////////////////////////////////////////////
@@ -837,6 +950,9 @@ namespace hpx { namespace threads
             current_state_ex_.store(thread_state_ex(wait_signaled,
                 current_state_ex.get_tag() + 1), boost::memory_order_release);
 
+            // the thread function runs on the stack of the calling worker
+            // thread, it has to run to completion
+            detail::reset_running_stackless r(this);
             return coroutine_(current_state_ex);
         }
 
@@ -19,6 +19,8 @@
 #include <boost/date_time/posix_time/ptime.hpp>
 #include <boost/exception_ptr.hpp>
 
+#include <vector>
+
 ///////////////////////////////////////////////////////////////////////////////
 namespace hpx { namespace threads
 {
@@ -403,6 +405,54 @@ namespace hpx { namespace threads
     HPX_API_EXPORT std::ptrdiff_t get_stack_size(
         thread_id_type const& id, error_code& ec = throws);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// Return the deadline of the given thread
+    ///
+    /// \param id         [in] The thread id of the thread whose deadline
+    ///                   is queried.
+    /// \param ec         [in,out] this represents the error status on exit,
+    ///                   if this is pre-initialized to \a hpx#throws
+    ///                   the function will throw on error instead.
+    ///
+    /// \returns          The deadline is an absolute point in time in
+    ///                   terms of util::high_resolution_clock (in
+    ///                   nanoseconds), zero if the thread has no deadline.
+    ///
+    /// \note             As long as \a ec is not pre-initialized to
+    ///                   \a hpx#throws this function doesn't
+    ///                   throw but returns the result code using the
+    ///                   parameter \a ec. Otherwise it throws an instance
+    ///                   of hpx#exception.
+    HPX_API_EXPORT boost::uint64_t get_thread_deadline(
+        thread_id_type const& id, error_code& ec = throws);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// Set the deadline of the given thread
+    ///
+    /// Deadline aware schedulers (see
+    /// \a hpx::threads::policies::deadline_queue_scheduler) run pending
+    /// threads with the earliest deadline first. Threads created by a thread
+    /// which has a deadline inherit it, unless they were given their own.
+    /// The new deadline is taken into account the next time the thread is
+    /// scheduled.
+    ///
+    /// \param id         [in] The thread id of the thread whose deadline
+    ///                   should be changed.
+    /// \param deadline   [in] The new deadline, an absolute point in time
+    ///                   in terms of util::high_resolution_clock (in
+    ///                   nanoseconds), zero removes the deadline.
+    /// \param ec         [in,out] this represents the error status on exit,
+    ///                   if this is pre-initialized to \a hpx#throws
+    ///                   the function will throw on error instead.
+    ///
+    /// \note             As long as \a ec is not pre-initialized to
+    ///                   \a hpx#throws this function doesn't
+    ///                   throw but returns the result code using the
+    ///                   parameter \a ec. Otherwise it throws an instance
+    ///                   of hpx#exception.
+    HPX_API_EXPORT void set_thread_deadline(thread_id_type const& id,
+        boost::uint64_t deadline, error_code& ec = throws);
+
     ///////////////////////////////////////////////////////////////////////////
     HPX_API_EXPORT void run_thread_exit_callbacks(thread_id_type const& id,
         error_code& ec = throws);
@@ -837,6 +887,27 @@ namespace hpx { namespace applier
         threads::thread_stacksize stacksize = threads::thread_stacksize_default,
         error_code& ec = throws);
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief Create a new work item for each of the given functions using a
+    ///        single call into the scheduler.
+    ///
+    /// \param funcs      [in] The functions to be executed as the
+    ///                   thread-functions. Each of these has to expose the
+    ///                   minimal low level HPX-thread interface, i.e. it takes
+    ///                   no arguments. The threads are distributed in blocks
+    ///                   over the worker threads.
+    ///
+    /// \note All other arguments are equivalent to those of the function
+    ///       \a threads#register_work_plain
+    ///
+    HPX_API_EXPORT void register_work_nullary_bulk(
+        std::vector<util::unique_function_nonser<void()> > && funcs,
+        char const* description = 0,
+        threads::thread_state_enum initial_state = threads::pending,
+        threads::thread_priority priority = threads::thread_priority_normal,
+        threads::thread_stacksize stacksize = threads::thread_stacksize_default,
+        error_code& ec = throws);
+
     ///////////////////////////////////////////////////////////////////////////
     /// \brief Create a new work item using the given function as the
     ///        work to be executed.
@@ -903,6 +974,7 @@ namespace hpx { namespace threads
     using applier::register_work_plain;
     using applier::register_work;
     using applier::register_work_nullary;
+    using applier::register_work_nullary_bulk;
 }}
 
 #endif
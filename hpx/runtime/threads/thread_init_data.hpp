@@ -34,6 +34,7 @@ namespace hpx { namespace threads
             priority(thread_priority_normal),
             num_os_thread(std::size_t(-1)),
             stacksize(get_default_stack_size()),
+            deadline(0),
             scheduler_base(0)
         {}
 
@@ -53,6 +54,7 @@ namespace hpx { namespace threads
             num_os_thread(rhs.num_os_thread),
             stacksize(rhs.stacksize),
             target(std::move(rhs.target)),
+            deadline(rhs.deadline),
             scheduler_base(rhs.scheduler_base)
         {}
 
@@ -78,6 +80,7 @@ namespace hpx { namespace threads
             stacksize(stacksize_ == std::ptrdiff_t(-1) ?
                 get_default_stack_size() : stacksize_),
             target(target_),
+            deadline(0),
             scheduler_base(scheduler_base_)
         {}
 
@@ -101,6 +104,10 @@ namespace hpx { namespace threads
 
         naming::id_type target;
 
+        // absolute point in time (in terms of util::high_resolution_clock)
+        // the thread should have finished running by, zero if none
+        boost::uint64_t deadline;
+
         policies::scheduler_base* scheduler_base;
 
     private:
@@ -266,6 +266,15 @@ namespace hpx { namespace threads
             thread_state_enum initial_state = pending,
             error_code& ec = throws) = 0;
 
+        /// The function \a register_work_bulk adds \a count new work items
+        /// to the thread manager. It is equivalent to calling \a register_work
+        /// for each of the given \a thread_init_data objects, except that the
+        /// work items are handed to the scheduler in one operation.
+        virtual void
+        register_work_bulk(thread_init_data* data, std::size_t count,
+            thread_state_enum initial_state = pending,
+            error_code& ec = throws) = 0;
+
         /// The function \a register_thread adds a new work item to the thread
         /// manager. It creates a new \a thread, adds it to the internal
         /// management data structures, and schedules the new thread, if
@@ -92,6 +92,12 @@ namespace hpx { namespace threads
             thread_state_enum initial_state = pending,
             error_code& ec = throws);
 
+        /// The function \a register_work_bulk adds \a count new work items
+        /// to the thread manager using a single call into the scheduler.
+        void register_work_bulk(thread_init_data* data, std::size_t count,
+            thread_state_enum initial_state = pending,
+            error_code& ec = throws);
+
         /// The function \a register_thread adds a new work item to the thread
         /// manager. It creates a new \a thread, adds it to the internal
         /// management data structures, and schedules the new thread, if
@@ -467,8 +473,6 @@ namespace hpx { namespace threads
         void tfunc(std::size_t num_thread, topology const& topology_);
         void tfunc_impl(std::size_t num_thread);
 
-        void idle_callback(std::size_t num_thread);
-
     public:
         /// this notifies the thread manager that there is some more work
         /// available
@@ -23,6 +23,15 @@ namespace hpx { namespace util
         virtual bool flush(void* dst, std::size_t dst_count, 
             std::size_t& written) = 0;
 
+        // streaming compression API: filters compressing the data in frames
+        // while it is being saved make the compressed frames available before
+        // flush is called, which avoids holding all of the uncompressed data
+        virtual std::size_t frames_available() const { return 0; }
+        virtual std::size_t get_frames(void* dst, std::size_t dst_count)
+        {
+            return 0;
+        }
+
         // decompression API
         virtual std::size_t init_data(char const* buffer,
             std::size_t size, std::size_t buffer_size) = 0;
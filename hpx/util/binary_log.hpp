@@ -0,0 +1,273 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_UTIL_BINARY_LOG_OCT_19_2014_0611PM)
+#define HPX_UTIL_BINARY_LOG_OCT_19_2014_0611PM
+
+#include <hpx/hpx_fwd.hpp>
+
+#include <boost/cstdint.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace util { namespace binary_log
+{
+    // Return the overall number of log records which were dropped because the
+    // buffer of the OS thread trying to log was full.
+    HPX_EXPORT boost::int64_t get_dropped_records(bool reset);
+
+    // Release the buffer associated with the calling OS thread, this is called
+    // whenever an OS thread managed by the runtime exits. The buffers of all
+    // other OS threads are released automatically when those exit.
+    HPX_EXPORT void release_thread_buffer();
+}}}
+
+#if !defined(HPX_NO_LOGGING)
+
+#include <hpx/util/logging/detail/level.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/type_traits/is_enum.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_pointer.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/mpl/and.hpp>
+#include <boost/mpl/or.hpp>
+#include <boost/mpl/not.hpp>
+
+#include <string>
+
+#if !defined(HPX_BINARY_LOG_MAX_ARGUMENTS)
+#  define HPX_BINARY_LOG_MAX_ARGUMENTS 4
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// The binary log is a logging backend meant for logging from performance
+// critical code paths. Instead of formatting the log message right away, the
+// log macros store the format string (which has to be a string literal) and
+// the raw values of the arguments into a buffer owned by the calling OS
+// thread. No locks are acquired while doing so. A dedicated OS thread
+// periodically collects the records from all buffers, formats them and
+// writes them to the destination configured in the [hpx.logging.binary]
+// section. Records are dropped if the buffer of the logging OS thread is
+// full (see get_dropped_records()).
+//
+// The supported argument types are integral types, enumerations, floating
+// point types and pointers, the format string uses the Boost.Format syntax:
+//
+//      LTM_BIN_(debug)("tfunc(%1%): thread(%2%)", num_thread, thrd);
+//
+namespace hpx { namespace util { namespace binary_log
+{
+    enum argument_type
+    {
+        argument_signed = 0,
+        argument_unsigned = 1,
+        argument_floating_point = 2,
+        argument_pointer = 3
+    };
+
+    struct record
+    {
+        char const* format;         // has to refer to a string literal
+        char const* category;       // has to refer to a string literal
+        boost::uint64_t timestamp;  // set while storing the record
+        boost::uint32_t level;
+        boost::uint32_t num_args;
+        boost::uint8_t types[HPX_BINARY_LOG_MAX_ARGUMENTS];
+        boost::uint64_t args[HPX_BINARY_LOG_MAX_ARGUMENTS];
+    };
+
+    // sink for the formatted records
+    typedef void write_function_type(unsigned level, std::string const& msg);
+
+    // Start the OS thread formatting and writing the records, records are
+    // stored for the given level (and above) only. The buffer size applies to
+    // the buffers created afterwards, OS threads which have logged before
+    // keep using their existing buffers.
+    HPX_EXPORT void start(unsigned level, std::size_t buffer_size,
+        write_function_type* write);
+
+    // Disable the binary log, write all remaining records and stop the OS
+    // thread started by start().
+    HPX_EXPORT void stop();
+
+    namespace detail
+    {
+        HPX_EXPORT extern boost::atomic<unsigned> level;
+
+        // store the record into the buffer of the calling OS thread
+        HPX_EXPORT void write(record& r);
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename T>
+        typename boost::enable_if<
+            boost::mpl::or_<
+                boost::mpl::and_<boost::is_integral<T>, boost::is_signed<T> >,
+                boost::is_enum<T>
+            >
+        >::type encode(record& r, T t)
+        {
+            r.types[r.num_args] = argument_signed;
+            r.args[r.num_args++] =
+                static_cast<boost::uint64_t>(static_cast<boost::int64_t>(t));
+        }
+
+        template <typename T>
+        typename boost::enable_if<
+            boost::mpl::and_<
+                boost::is_integral<T>, boost::mpl::not_<boost::is_signed<T> >
+            >
+        >::type encode(record& r, T t)
+        {
+            r.types[r.num_args] = argument_unsigned;
+            r.args[r.num_args++] = static_cast<boost::uint64_t>(t);
+        }
+
+        template <typename T>
+        typename boost::enable_if<boost::is_floating_point<T> >::type
+        encode(record& r, T t)
+        {
+            union { double d; boost::uint64_t u; } value;
+            value.d = static_cast<double>(t);
+
+            r.types[r.num_args] = argument_floating_point;
+            r.args[r.num_args++] = value.u;
+        }
+
+        template <typename T>
+        typename boost::enable_if<boost::is_pointer<T> >::type
+        encode(record& r, T t)
+        {
+            r.types[r.num_args] = argument_pointer;
+            r.args[r.num_args++] = reinterpret_cast<boost::uint64_t>(
+                static_cast<void const volatile*>(t));
+        }
+    }
+
+    inline bool enabled(unsigned level)
+    {
+        return level >= detail::level.load(boost::memory_order_relaxed);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    class recorder
+    {
+    public:
+        recorder(unsigned level, char const* category)
+          : level_(level), category_(category)
+        {}
+
+        void operator()(char const* format) const
+        {
+            record r;
+            init(r, format);
+            detail::write(r);
+        }
+
+        template <typename T1>
+        void operator()(char const* format, T1 t1) const
+        {
+            record r;
+            init(r, format);
+            detail::encode(r, t1);
+            detail::write(r);
+        }
+
+        template <typename T1, typename T2>
+        void operator()(char const* format, T1 t1, T2 t2) const
+        {
+            record r;
+            init(r, format);
+            detail::encode(r, t1);
+            detail::encode(r, t2);
+            detail::write(r);
+        }
+
+        template <typename T1, typename T2, typename T3>
+        void operator()(char const* format, T1 t1, T2 t2, T3 t3) const
+        {
+            record r;
+            init(r, format);
+            detail::encode(r, t1);
+            detail::encode(r, t2);
+            detail::encode(r, t3);
+            detail::write(r);
+        }
+
+        template <typename T1, typename T2, typename T3, typename T4>
+        void operator()(char const* format, T1 t1, T2 t2, T3 t3, T4 t4) const
+        {
+            record r;
+            init(r, format);
+            detail::encode(r, t1);
+            detail::encode(r, t2);
+            detail::encode(r, t3);
+            detail::encode(r, t4);
+            detail::write(r);
+        }
+
+    private:
+        void init(record& r, char const* format) const
+        {
+            r.format = format;
+            r.category = category_;
+            r.level = level_;
+            r.num_args = 0;
+        }
+
+        unsigned level_;
+        char const* category_;
+    };
+}}}
+
+#define LBIN_(lvl, cat)                                                       \
+    if (!hpx::util::binary_log::enabled(::hpx::util::logging::level::lvl)) {} \
+    else hpx::util::binary_log::recorder(                                     \
+        ::hpx::util::logging::level::lvl, cat)                                \
+/**/
+
+#define LBIN_ENABLED(lvl)                                                     \
+    hpx::util::binary_log::enabled(::hpx::util::logging::level::lvl)          \
+/**/
+
+#else
+// logging is disabled all together
+
+namespace hpx { namespace util { namespace binary_log
+{
+    struct dummy_recorder
+    {
+        void operator()(char const*) const {}
+
+        template <typename T1>
+        void operator()(char const*, T1) const {}
+
+        template <typename T1, typename T2>
+        void operator()(char const*, T1, T2) const {}
+
+        template <typename T1, typename T2, typename T3>
+        void operator()(char const*, T1, T2, T3) const {}
+
+        template <typename T1, typename T2, typename T3, typename T4>
+        void operator()(char const*, T1, T2, T3, T4) const {}
+    };
+}}}
+
+#define LBIN_(lvl, cat)                                                       \
+    if(true) {} else hpx::util::binary_log::dummy_recorder()                  \
+/**/
+
+#define LBIN_ENABLED(lvl)     (false)
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// specific binary logging
+#define LTM_BIN_(lvl)   LBIN_(lvl, "  [TM] ")   /* thread manager */
+#define LPT_BIN_(lvl)   LBIN_(lvl, "  [PT] ")   /* parcel transport */
+
+#endif
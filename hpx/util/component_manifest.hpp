@@ -0,0 +1,96 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_UTIL_COMPONENT_MANIFEST_OCT_19_2014_0521PM)
+#define HPX_UTIL_COMPONENT_MANIFEST_OCT_19_2014_0521PM
+
+#include <hpx/hpx_fwd.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace util
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The component manifest caches the information gathered while scanning
+    // the component and ini directories during startup (see
+    // init_ini_data_default and merge_component_inis):
+    //
+    //  - for each shared library found in hpx.component_path the ini data
+    //    exported by its component and plugin registries,
+    //  - for each directory in hpx.ini_path the list of ini files it contains.
+    //
+    // Modules are listed together with their size and last modification
+    // time, directories with their last modification time. Cached entries are
+    // used only as long as those still match, which allows to avoid loading
+    // the shared libraries and listing the directories. The manifest is
+    // stored in a binary file (configured by hpx.component_manifest) which is
+    // rewritten whenever new information has been gathered.
+    class HPX_EXPORT component_manifest : boost::noncopyable
+    {
+    public:
+        // an empty file name disables the manifest
+        explicit component_manifest(std::string const& filename);
+
+        bool enabled() const { return !filename_.empty(); }
+
+        // read the manifest file, all cached information is discarded if the
+        // file is not valid
+        bool load();
+
+        // write the manifest file if any information has changed
+        bool save();
+
+        ///////////////////////////////////////////////////////////////////////
+        // Return the cached ini data for the given module, returns false if
+        // the module is not listed or has been modified.
+        bool find_module(boost::filesystem::path const& module,
+            std::vector<std::string>& ini_data) const;
+
+        void add_module(boost::filesystem::path const& module,
+            std::vector<std::string> const& ini_data);
+
+        // Return the cached list of ini files in the given directory, returns
+        // false if the directory is not listed or has been modified.
+        bool find_directory(boost::filesystem::path const& dir,
+            std::vector<std::string>& files) const;
+
+        void add_directory(boost::filesystem::path const& dir,
+            std::vector<std::string> const& files);
+
+    private:
+        struct entry
+        {
+            entry() : last_write_time(0), file_size(0) {}
+
+            boost::uint64_t last_write_time;
+            boost::uint64_t file_size;
+            std::vector<std::string> data;
+        };
+        typedef std::map<std::string, entry> entries_type;
+
+        static bool get_entry_info(boost::filesystem::path const& p,
+            bool is_directory, entry& e);
+
+        bool find(entries_type const& entries,
+            boost::filesystem::path const& p, bool is_directory,
+            std::vector<std::string>& data) const;
+        void add(entries_type& entries, boost::filesystem::path const& p,
+            bool is_directory, std::vector<std::string> const& data);
+
+        std::string filename_;
+        entries_type modules_;
+        entries_type directories_;
+        bool modified_;
+    };
+}}
+
+#endif
@@ -0,0 +1,596 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if !defined(HPX_UTIL_CONNECTION_POOL_OCT_19_2014_0312PM)
+#define HPX_UTIL_CONNECTION_POOL_OCT_19_2014_0312PM
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/exception.hpp>
+#include <hpx/util/assert.hpp>
+#include <hpx/util/get_and_reset_value.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <boost/lockfree/stack.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <functional>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace util
+{
+    ///////////////////////////////////////////////////////////////////////////
+    /// This class implements a cache holding pools of connections, one pool
+    /// for each destination. It has the same interface as the (LRU based)
+    /// connection_cache, but does not serialize the threads accessing it:
+    ///
+    /// - the pool for a destination is found in a hash table whose buckets
+    ///   are lock-free singly linked lists; pools are never removed from the
+    ///   table before the connection_pool itself is destroyed,
+    /// - the idle connections of each pool are kept in a lock-free queue,
+    ///   which allows for several threads to check out (and return)
+    ///   connections to the same destination concurrently,
+    /// - the limits for the number of connections are enforced lazily: a
+    ///   connection is dropped when it is returned while there are more
+    ///   connections than allowed, and idle connections of other
+    ///   destinations are evicted only when reserving space for a new
+    ///   connection hits the overall limit.
+    ///
+    /// Note that the counts maintained by this class are not updated
+    /// atomically with respect to each other and may temporarily exceed the
+    /// configured limits.
+    template <typename Connection, typename Key,
+        typename Hash = boost::hash<Key>, typename Equal = std::equal_to<Key> >
+    class connection_pool : boost::noncopyable
+    {
+    public:
+        typedef boost::shared_ptr<Connection> connection_type;
+        typedef Key key_type;
+        typedef std::size_t size_type;
+
+    private:
+        // The idle connections are stored in heap allocated holders which
+        // are recycled through a lock-free free list.
+        typedef boost::lockfree::queue<connection_type*> idle_queue_type;
+        typedef boost::lockfree::stack<connection_type*> holder_stack_type;
+
+        static const std::size_t num_buckets = 128;
+
+        struct entry : boost::noncopyable
+        {
+            entry(key_type const& key, std::size_t max_connections)
+              : key_(key), next_(0), idle_(8), num_existing_(0),
+                max_connections_(max_connections), waiting_since_(0)
+            {}
+
+            key_type const key_;
+            entry* next_;                               // immutable once published
+
+            idle_queue_type idle_;                      // available connections
+            boost::atomic<std::size_t> num_existing_;   // number of existing connections
+            boost::atomic<std::size_t> max_connections_;// max number of cached connections
+
+            // time stamp of the first request which could not be satisfied
+            boost::atomic<boost::uint64_t> waiting_since_;
+        };
+
+    public:
+        connection_pool(
+            size_type max_connections
+          , size_type max_connections_per_locality
+        )
+          : max_connections_(max_connections < 2 ? 2 : max_connections)
+          , max_connections_per_locality_(
+                max_connections_per_locality < 2 ? 2 : max_connections_per_locality)
+          , holders_(64)
+          , connections_(0)
+          , eviction_cursor_(0)
+          , shutting_down_(false)
+          , insertions_(0)
+          , evictions_(0)
+          , hits_(0)
+          , misses_(0)
+          , reclaims_(0)
+          , wait_time_(0)
+        {
+            if (max_connections_per_locality_ > max_connections_)
+            {
+                HPX_THROW_EXCEPTION(bad_parameter,
+                    "connection_pool::connection_pool",
+                    "the maximum number of connections per locality cannot "
+                    "excede the overall maximum number of connections");
+            }
+
+            for (std::size_t i = 0; i != num_buckets; ++i)
+                buckets_[i].store(0);
+        }
+
+        ~connection_pool()
+        {
+            for (std::size_t i = 0; i != num_buckets; ++i)
+            {
+                entry* e = buckets_[i].load();
+                while (e != 0)
+                {
+                    connection_type* h = 0;
+                    while (e->idle_.pop(h))
+                        delete h;
+
+                    entry* next = e->next_;
+                    delete e;
+                    e = next;
+                }
+            }
+
+            connection_type* h = 0;
+            while (holders_.pop(h))
+                delete h;
+        }
+
+        void shutdown()
+        {
+            shutting_down_ = true;
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        entry* find_entry(key_type const& l) const
+        {
+            std::size_t bucket = Hash()(l) % num_buckets;
+            for (entry* e = buckets_[bucket].load(boost::memory_order_acquire);
+                 e != 0; e = e->next_)
+            {
+                if (Equal()(e->key_, l))
+                    return e;
+            }
+            return 0;
+        }
+
+        entry& find_or_create_entry(key_type const& l)
+        {
+            std::size_t bucket = Hash()(l) % num_buckets;
+            entry* head = buckets_[bucket].load(boost::memory_order_acquire);
+            for (entry* e = head; e != 0; e = e->next_)
+            {
+                if (Equal()(e->key_, l))
+                    return *e;
+            }
+
+            entry* new_entry = new entry(l, max_connections_per_locality_);
+            while (true)
+            {
+                new_entry->next_ = head;
+                if (buckets_[bucket].compare_exchange_weak(head, new_entry,
+                        boost::memory_order_release, boost::memory_order_acquire))
+                {
+                    return *new_entry;
+                }
+
+                // somebody else has modified this bucket, check whether the
+                // entry was inserted concurrently
+                for (entry* e = head; e != new_entry->next_ && e != 0; e = e->next_)
+                {
+                    if (Equal()(e->key_, l))
+                    {
+                        delete new_entry;
+                        return *e;
+                    }
+                }
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        connection_type* acquire_holder()
+        {
+            connection_type* h = 0;
+            if (!holders_.pop(h))
+                h = new connection_type;
+            return h;
+        }
+
+        void release_holder(connection_type* h)
+        {
+            holders_.push(h);
+        }
+
+        bool pop_idle(entry& e, connection_type& conn)
+        {
+            connection_type* h = 0;
+            if (!e.idle_.pop(h))
+                return false;
+
+            conn.swap(*h);
+            release_holder(h);
+            return true;
+        }
+
+        void push_idle(entry& e, connection_type const& conn)
+        {
+            connection_type* h = acquire_holder();
+            *h = conn;
+            e.idle_.push(h);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Decrease the per-locality and overall connection counts.
+        void decrement_connection_count(entry& e)
+        {
+            std::size_t num_connections = e.num_existing_.load();
+            do {
+                // the counts have been reset by clear()
+                if (num_connections == 0)
+                    return;
+            } while (!e.num_existing_.compare_exchange_weak(
+                num_connections, num_connections - 1));
+
+            --connections_;
+
+            // If appropriate, update the maximum number of allowed
+            // cached connections.
+            std::size_t max_connections = e.max_connections_.load();
+            if (num_connections - 1 < max_connections / 2)
+            {
+                e.max_connections_.compare_exchange_strong(max_connections,
+                    static_cast<std::size_t>(max_connections / 1.5)); //-V113
+            }
+        }
+
+        // Try to reserve space for a new connection to the given entry.
+        bool reserve_connection(entry& e, bool force_insert)
+        {
+            std::size_t num_connections = e.num_existing_.load();
+            do {
+                if (num_connections >= e.max_connections_.load() && !force_insert)
+                    return false;
+            } while (!e.num_existing_.compare_exchange_weak(
+                num_connections, num_connections + 1));
+
+            // Note that if we don't have any space and there are no
+            // outstanding connections for this locality, we grow the cache
+            // size beyond its limit (hoping that it will be reduced in size
+            // next time some connection is handed back to the cache).
+            if (++connections_ > max_connections_ && !free_space(e) &&
+                num_connections != 0 && !force_insert)
+            {
+                --connections_;
+                --e.num_existing_;
+                return false;
+            }
+
+            // If appropriate, update the maximum number of allowed cached
+            // connections.
+            std::size_t max_connections = e.max_connections_.load();
+            if (num_connections + 1 > max_connections * 2)
+            {
+                e.max_connections_.compare_exchange_strong(max_connections,
+                    static_cast<std::size_t>(max_connections * 1.5)); //-V113
+            }
+            return true;
+        }
+
+        // Evict one of the idle connections to any other destination.
+        bool free_space(entry const& except)
+        {
+            std::size_t start = eviction_cursor_++;
+            for (std::size_t i = 0; i != num_buckets; ++i)
+            {
+                std::size_t bucket = (start + i) % num_buckets;
+                for (entry* e = buckets_[bucket].load(boost::memory_order_acquire);
+                     e != 0; e = e->next_)
+                {
+                    connection_type conn;
+                    if (e != &except && pop_idle(*e, conn))
+                    {
+                        decrement_connection_count(*e);
+                        ++evictions_;
+
+#if defined(HPX_TRACK_STATE_OF_OUTGOING_TCP_CONNECTION)
+                        conn->set_state(Connection::state_deleting);
+#endif
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Keep track of the time requests had to wait for a connection to
+        // become available.
+        void begin_waiting(entry& e)
+        {
+            boost::uint64_t expected = 0;
+            e.waiting_since_.compare_exchange_strong(expected,
+                util::high_resolution_clock::now());
+        }
+
+        void end_waiting(entry& e)
+        {
+            if (e.waiting_since_.load(boost::memory_order_relaxed) == 0)
+                return;
+
+            boost::uint64_t since = e.waiting_since_.exchange(0);
+            if (since != 0)
+            {
+                wait_time_ += static_cast<boost::int64_t>(
+                    util::high_resolution_clock::now() - since);
+            }
+        }
+
+    public:
+        /// Try to get a connection to \a l from the cache.
+        ///
+        /// \returns A usable connection to \a l if a connection could be
+        ///          found, otherwise a default constructed connection.
+        ///
+        /// \note    The connection must be returned to the cache by calling
+        ///          \a reclaim().
+        connection_type get(key_type const& l)
+        {
+            connection_type result;
+
+            entry* e = find_entry(l);
+            if (e != 0 && pop_idle(*e, result))
+            {
+                ++hits_;
+                end_waiting(*e);
+                return result;
+            }
+
+            ++misses_;
+            return result;
+        }
+
+        /// Try to get a connection to \a l from the cache, or reserve space for
+        /// a new connection to \a l. This function may evict idle connections
+        /// to other destinations from the cache.
+        ///
+        /// \returns If a connection was found in the cache, its value is
+        ///          assigned to \a conn and this function returns true. If a
+        ///          connection was not found but space was reserved, \a conn is
+        ///          set such that conn.get() == 0, and this function returns
+        ///          true. If a connection could not be found and space could
+        ///          not be returned, \a conn is unmodified and this function
+        ///          returns false.
+        ///          If force_insert is true, a new connection entry will be
+        ///          created even if that means the cache limits will be
+        ///          exceeded.
+        ///
+        /// \note    The connection must be returned to the cache by calling
+        ///          \a reclaim().
+        bool get_or_reserve(key_type const& l, connection_type& conn,
+            bool force_insert = false)
+        {
+            entry& e = find_or_create_entry(l);
+
+            // If connections to the locality are available in the cache,
+            // return one of them.
+            if (pop_idle(e, conn))
+            {
+#if defined(HPX_TRACK_STATE_OF_OUTGOING_TCP_CONNECTION)
+                conn->set_state(Connection::state_reinitialized);
+#endif
+                ++hits_;
+                end_waiting(e);
+                return true;
+            }
+
+            // Otherwise, try to reserve space in the cache for a new
+            // connection.
+            if (!reserve_connection(e, force_insert))
+            {
+                // We've reached the maximum number of connections for this
+                // locality, and none of them are checked into the cache, so
+                // we have to give up.
+                ++misses_;
+                begin_waiting(e);
+                return false;
+            }
+
+            // Make sure the input connection shared_ptr doesn't hold
+            // anything.
+            conn.reset();
+
+            ++insertions_;
+            end_waiting(e);
+            return true;
+        }
+
+        /// Returns a connection for \a l to the cache.
+        ///
+        /// \note The cache must already be aware of the connection, through
+        ///       a prior call to \a get() or \a get_or_reserve().
+        void reclaim(key_type const& l, connection_type const& conn)
+        {
+            entry* e = find_entry(l);
+            if (e == 0)
+            {
+                // Key should already exist in the cache.
+                HPX_ASSERT(shutting_down_);
+                return;
+            }
+
+            // Return the connection back to the cache only if the number
+            // of connections does not need to be shrunk.
+            if (e->num_existing_.load() <= e->max_connections_.load() &&
+                connections_.load() <= max_connections_)
+            {
+                push_idle(*e, conn);
+                ++reclaims_;
+
+#if defined(HPX_TRACK_STATE_OF_OUTGOING_TCP_CONNECTION)
+                conn->set_state(Connection::state_reclaimed);
+#endif
+            }
+            else
+            {
+                // Adjust the number of existing connections for this key.
+                decrement_connection_count(*e);
+
+                // do the accounting
+                ++evictions_;
+
+                // the connection itself will go out of scope on return
+#if defined(HPX_TRACK_STATE_OF_OUTGOING_TCP_CONNECTION)
+                conn->set_state(Connection::state_deleting);
+#endif
+            }
+        }
+
+        /// Returns true if the overall connection count is equal to or larger
+        /// than the maximum number of overall connections, and false otherwise.
+        bool full() const
+        {
+            return connections_.load() >= max_connections_;
+        }
+
+        /// Returns true if the connection count for \a l is equal to or larger
+        /// than the maximum connection count per locality, and false otherwise.
+        bool full(key_type const& l) const
+        {
+            entry const* e = find_entry(l);
+            if (e == 0)
+                return connections_.load() >= max_connections_;
+
+            return (e->num_existing_.load() >= e->max_connections_.load())
+                || (connections_.load() >= max_connections_);
+        }
+
+        /// Destroys all connections in the cache, and resets all counts.
+        ///
+        /// \note Calling this function while connections are still checked out
+        ///       of the cache is a bad idea, and will violate this class'
+        ///       invariants.
+        void clear()
+        {
+            for (std::size_t i = 0; i != num_buckets; ++i)
+            {
+                for (entry* e = buckets_[i].load(boost::memory_order_acquire);
+                     e != 0; e = e->next_)
+                {
+                    connection_type conn;
+                    while (pop_idle(*e, conn))
+                        conn.reset();
+
+                    e->num_existing_.store(0);
+                    e->max_connections_.store(max_connections_per_locality_);
+                    e->waiting_since_.store(0);
+                }
+            }
+            connections_ = 0;
+
+            insertions_ = 0;
+            evictions_ = 0;
+            hits_ = 0;
+            misses_ = 0;
+            reclaims_ = 0;
+            wait_time_ = 0;
+        }
+
+        /// Destroys all connections for the given locality in the cache, reset
+        /// all associated counts.
+        ///
+        /// \note Calling this function while connections are still checked out
+        ///       of the cache is a bad idea, and will violate this classes
+        ///       invariants.
+        void clear(key_type const& l)
+        {
+            entry* e = find_entry(l);
+            if (e == 0)
+                return;
+
+            connection_type conn;
+            while (pop_idle(*e, conn))
+                conn.reset();
+
+            // correct counter to avoid assertions later on
+            std::size_t num_connections = e->num_existing_.exchange(0);
+            connections_ -= num_connections;
+            evictions_ += static_cast<boost::int64_t>(num_connections);
+
+            e->max_connections_.store(max_connections_per_locality_);
+            e->waiting_since_.store(0);
+        }
+
+        /// Removes the given connection for the given locality from the
+        /// cache, adjusting all associated counts.
+        void clear(key_type const& l, connection_type const& conn)
+        {
+            entry* e = find_entry(l);
+            if (e == 0)
+                return;
+
+            // Adjust the number of existing connections for this key.
+            decrement_connection_count(*e);
+
+            // do the accounting
+            ++evictions_;
+
+            // the connection itself will go out of scope on return
+#if defined(HPX_TRACK_STATE_OF_OUTGOING_TCP_CONNECTION)
+            conn->set_state(Connection::state_deleting);
+#endif
+        }
+
+        // access statistics
+        boost::int64_t get_cache_insertions(bool reset)
+        {
+            return util::get_and_reset_value(insertions_, reset);
+        }
+
+        boost::int64_t get_cache_evictions(bool reset)
+        {
+            return util::get_and_reset_value(evictions_, reset);
+        }
+
+        boost::int64_t get_cache_hits(bool reset)
+        {
+            return util::get_and_reset_value(hits_, reset);
+        }
+
+        boost::int64_t get_cache_misses(bool reset)
+        {
+            return util::get_and_reset_value(misses_, reset);
+        }
+
+        boost::int64_t get_cache_reclaims(bool reset)
+        {
+            return util::get_and_reset_value(reclaims_, reset);
+        }
+
+        /// Returns the accumulated time (in nanoseconds) between requests
+        /// for a connection which could not be satisfied and a connection
+        /// becoming available for the same destination.
+        boost::int64_t get_cache_wait_time(bool reset)
+        {
+            return util::get_and_reset_value(wait_time_, reset);
+        }
+
+    private:
+        size_type const max_connections_;
+        size_type const max_connections_per_locality_;
+
+        boost::atomic<entry*> buckets_[num_buckets];
+        holder_stack_type holders_;
+
+        boost::atomic<size_type> connections_;
+        boost::atomic<std::size_t> eviction_cursor_;
+        bool shutting_down_;
+
+        // statistics support
+        boost::atomic<boost::int64_t> insertions_;
+        boost::atomic<boost::int64_t> evictions_;
+        boost::atomic<boost::int64_t> hits_;
+        boost::atomic<boost::int64_t> misses_;
+        boost::atomic<boost::int64_t> reclaims_;
+        boost::atomic<boost::int64_t> wait_time_;
+    };
+}}
+
+#endif
@@ -168,6 +168,7 @@ namespace hpx { namespace util { namespace coroutines
             HPX_ASSERT(exited());
 
             f_ = std::forward<Functor>(f);
+            state_ = ctx_ready;
             id_ = id;
 #if HPX_THREAD_MAINTAIN_PHASE_INFORMATION
             phase_ = 0;
@@ -200,7 +201,7 @@ namespace hpx { namespace util { namespace coroutines
                 this_.state_ = stackless_coroutine::ctx_running;
             }
 
-            reset_on_exit()
+            ~reset_on_exit()
             {
                 this_.state_ = stackless_coroutine::ctx_exited;
             }
@@ -212,10 +213,16 @@ namespace hpx { namespace util { namespace coroutines
     public:
         BOOST_FORCEINLINE result_type operator()(arg0_type arg0 = arg0_type())
         {
-            reset_on_exit on_exit = reset_on_exit(*this);
-            HPX_UNUSED(on_exit);
+            result_type result;
+            {
+                reset_on_exit on_exit(*this);
+                HPX_UNUSED(on_exit);
 
-            result_type result = f_(arg0);   // invoke wrapped function
+                result = f_(arg0);   // invoke wrapped function
+            }
+#if HPX_THREAD_MAINTAIN_PHASE_INFORMATION
+            ++phase_;
+#endif
 
             // we always have to run to completion
             HPX_ASSERT(result == 5);       // threads::terminated == 5
@@ -16,6 +16,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 namespace hpx { namespace util
 {
+    class component_manifest;
+
     ///////////////////////////////////////////////////////////////////////////
     bool handle_ini_file (section& ini, std::string const& loc);
     bool handle_ini_file_env (section& ini, char const* env_var,
@@ -35,15 +37,20 @@ namespace hpx { namespace util
         error_code& ec = throws);
 
     ///////////////////////////////////////////////////////////////////////////
-    // global function to read component ini information
-    void merge_component_inis(section& ini);
+    // global function to read component ini information, the list of ini
+    // files found in each of the directories is cached in the given manifest
+    void merge_component_inis(section& ini,
+        component_manifest* manifest = 0);
 
     ///////////////////////////////////////////////////////////////////////////
     // iterate over all shared libraries in the given directory and construct
-    // default ini settings assuming all of those are components
+    // default ini settings assuming all of those are components, shared
+    // libraries are loaded only if their information is not available from
+    // the given manifest
     void init_ini_data_default(std::string const& libs, section& ini,
         std::map<std::string, boost::filesystem::path>& basenames,
-        std::map<std::string, hpx::util::plugin::dll>& modules);
+        std::map<std::string, hpx::util::plugin::dll>& modules,
+        component_manifest* manifest = 0);
 
 }}
 
@@ -18,6 +18,7 @@ namespace hpx { namespace util { namespace detail
     {
         init_logging(runtime_configuration& ini, bool isconsole,
             naming::resolver_client& agas_client);
+        ~init_logging();
     };
 }}}
 
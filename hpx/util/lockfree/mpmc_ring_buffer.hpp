@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////////////////////
+//  Bounded multi-producer/multi-consumer queue based on the algorithm
+//  described by D. Vyukov
+//  Link: http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+//
+//  C++ implementation - Copyright (C) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+//  Disclaimer: Not a Boost library.
+//
+//  Every cell of the ring buffer carries a sequence number which tells
+//  producers and consumers whether the cell is free or full for a given
+//  position. Producers and consumers each advance their own position with a
+//  single compare-and-swap operation, they never touch the same cache line
+//  unless they access the same cell. Bulk operations claim a whole range of
+//  consecutive cells with one compare-and-swap.
+////////////////////////////////////////////////////////////////////////////////
+
+#if !defined(HPX_UTIL_LOCKFREE_MPMC_RING_BUFFER_OCT_19_2014_0214PM)
+#define HPX_UTIL_LOCKFREE_MPMC_RING_BUFFER_OCT_19_2014_0214PM
+
+#include <boost/config.hpp>
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/lockfree/detail/prefix.hpp>
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace boost { namespace lockfree
+{
+
+template <typename T>
+struct mpmc_ring_buffer : boost::noncopyable
+{
+  private:
+    struct cell
+    {
+        cell() : sequence_(0) {}
+
+        T* get()
+        {
+            return static_cast<T*>(static_cast<void*>(&storage_));
+        }
+
+        boost::atomic<std::size_t> sequence_;
+        typename boost::aligned_storage<
+            sizeof(T), boost::alignment_of<T>::value
+        >::type storage_;
+    };
+
+    static std::size_t round_up_to_power_of_2(std::size_t size)
+    {
+        std::size_t result = 2;
+        while (result < size)
+            result <<= 1;
+        return result;
+    }
+
+    // Find the number of consecutive cells starting at the given position
+    // for which the sequence number is equal to pos + offset, i.e. which are
+    // free (offset == 0) or full (offset == 1) for the respective position.
+    std::size_t available_cells(std::size_t pos, std::size_t count,
+        std::size_t offset) const
+    {
+        std::size_t n = 0;
+        for (/**/; n != count; ++n)
+        {
+            cell const& c = buffer_[(pos + n) & mask_];
+            if (c.sequence_.load(boost::memory_order_acquire) != pos + n + offset)
+                break;
+        }
+        return n;
+    }
+
+    // Claim up to count consecutive cells at the given position using a
+    // single compare-and-swap, returns the number of claimed cells.
+    std::size_t claim(boost::atomic<std::size_t>& position, std::size_t& pos,
+        std::size_t count, std::size_t offset)
+    {
+        pos = position.load(boost::memory_order_relaxed);
+        while (true)
+        {
+            std::size_t n = available_cells(pos, count, offset);
+            if (n == 0)
+            {
+                // the first cell is not available, check whether the position
+                // has moved on in the meantime
+                cell const& c = buffer_[pos & mask_];
+                std::size_t seq = c.sequence_.load(boost::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(seq - (pos + offset)) < 0)
+                    return 0;       // the buffer is full (empty)
+
+                pos = position.load(boost::memory_order_relaxed);
+                continue;
+            }
+
+            if (position.compare_exchange_weak(pos, pos + n,
+                    boost::memory_order_relaxed))
+            {
+                return n;
+            }
+        }
+    }
+
+  public:
+    typedef T value_type;
+
+    /// Construct a ring buffer able to hold at least \a capacity elements.
+    /// The capacity is rounded up to the next power of two.
+    explicit mpmc_ring_buffer(std::size_t capacity)
+      : buffer_(new cell[round_up_to_power_of_2(capacity)]),
+        mask_(round_up_to_power_of_2(capacity) - 1),
+        enqueue_pos_(0),
+        dequeue_pos_(0)
+    {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            buffer_[i].sequence_.store(i, boost::memory_order_relaxed);
+    }
+
+    ~mpmc_ring_buffer()
+    {
+        // destroy all elements which have not been extracted
+        std::size_t pos = dequeue_pos_.load(boost::memory_order_relaxed);
+        std::size_t end = enqueue_pos_.load(boost::memory_order_relaxed);
+        for (/**/; pos != end; ++pos)
+        {
+            cell& c = buffer_[pos & mask_];
+            if (c.sequence_.load(boost::memory_order_relaxed) == pos + 1)
+                c.get()->~T();
+        }
+    }
+
+    std::size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+    /// Insert the given element, returns false if the buffer is full.
+    template <typename U>
+    bool push(U && value)
+    {
+        std::size_t pos = 0;
+        if (claim(enqueue_pos_, pos, 1, 0) == 0)
+            return false;
+
+        cell& c = buffer_[pos & mask_];
+        new (c.get()) T(std::forward<U>(value));
+        c.sequence_.store(pos + 1, boost::memory_order_release);
+        return true;
+    }
+
+    /// Insert up to \a count elements from the given sequence, returns the
+    /// number of inserted elements. The iterator is advanced past the last
+    /// inserted element.
+    template <typename Iterator>
+    std::size_t push_n(Iterator& it, std::size_t count)
+    {
+        std::size_t pos = 0;
+        std::size_t n = claim(enqueue_pos_, pos, count, 0);
+
+        for (std::size_t i = 0; i != n; ++i, ++it)
+        {
+            cell& c = buffer_[(pos + i) & mask_];
+            new (c.get()) T(std::move(*it));
+            c.sequence_.store(pos + i + 1, boost::memory_order_release);
+        }
+        return n;
+    }
+
+    /// Extract one element, returns false if the buffer is empty.
+    bool pop(T& value)
+    {
+        std::size_t pos = 0;
+        if (claim(dequeue_pos_, pos, 1, 1) == 0)
+            return false;
+
+        cell& c = buffer_[pos & mask_];
+        T* p = c.get();
+        value = std::move(*p);
+        p->~T();
+        c.sequence_.store(pos + mask_ + 1, boost::memory_order_release);
+        return true;
+    }
+
+    /// Extract up to \a count elements into the given output iterator,
+    /// returns the number of extracted elements. The iterator is advanced
+    /// past the last extracted element.
+    template <typename OutIter>
+    std::size_t pop_n(OutIter& it, std::size_t count)
+    {
+        std::size_t pos = 0;
+        std::size_t n = claim(dequeue_pos_, pos, count, 1);
+
+        for (std::size_t i = 0; i != n; ++i, ++it)
+        {
+            cell& c = buffer_[(pos + i) & mask_];
+            T* p = c.get();
+            *it = std::move(*p);
+            p->~T();
+            c.sequence_.store(pos + i + mask_ + 1, boost::memory_order_release);
+        }
+        return n;
+    }
+
+    /// Return an estimate of the number of elements stored in the buffer.
+    std::size_t size() const
+    {
+        std::size_t enqueue_pos = enqueue_pos_.load(boost::memory_order_relaxed);
+        std::size_t dequeue_pos = dequeue_pos_.load(boost::memory_order_relaxed);
+        return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+  private:
+    boost::scoped_array<cell> buffer_;
+    std::size_t const mask_;
+
+    // producers and consumers use separate cache lines
+    char pad0_[BOOST_LOCKFREE_CACHELINE_BYTES];
+    boost::atomic<std::size_t> enqueue_pos_;
+    char pad1_[BOOST_LOCKFREE_CACHELINE_BYTES];
+    boost::atomic<std::size_t> dequeue_pos_;
+    char pad2_[BOOST_LOCKFREE_CACHELINE_BYTES];
+};
+
+}}
+
+#endif
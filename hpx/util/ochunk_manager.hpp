@@ -8,6 +8,7 @@
 
 #include <hpx/util/binary_filter.hpp>
 
+#include <algorithm>
 #include <cstddef> // for size_t
 #include <cstring> // for memcpy
 #include <vector>
@@ -54,13 +55,13 @@ namespace hpx { namespace util { namespace detail
 
     public:
         ocontainer_type(Container& cont)
-          : cont_(cont), current_(0), start_compressing_at_(0), filter_(0),
-            chunks_(0), current_chunk_(std::size_t(-1))
+          : cont_(cont), current_(0), start_compressing_at_(0), filtered_(0),
+            filter_(0), chunks_(0), current_chunk_(std::size_t(-1))
         {}
 
         ocontainer_type(Container& cont, std::vector<serialization_chunk>* chunks)
-          : cont_(cont), current_(0), start_compressing_at_(0), filter_(0),
-            chunks_(chunks), current_chunk_(std::size_t(-1))
+          : cont_(cont), current_(0), start_compressing_at_(0), filtered_(0),
+            filter_(0), chunks_(chunks), current_chunk_(std::size_t(-1))
         {
             if (chunks_)
             {
@@ -75,9 +76,15 @@ namespace hpx { namespace util { namespace detail
             if (filter_) {
                 std::size_t written = 0;
 
-                if (cont_.size() < current_)
+                // Streaming filters have written most of the data already,
+                // for all others assume that the data doesn't grow.
+                if (0 == filtered_ && cont_.size() < current_)
                     cont_.resize(current_);
-                current_ = start_compressing_at_;
+                current_ = start_compressing_at_ + filtered_;
+
+                std::size_t const min_space = 1024;
+                if (cont_.size() < current_ + min_space)
+                    cont_.resize(current_ + min_space);
 
                 do {
                     bool flushed = filter_->flush(&cont_[current_],
@@ -87,8 +94,10 @@ namespace hpx { namespace util { namespace detail
                     if (flushed)
                         break;
 
-                    // resize container
-                    cont_.resize(cont_.size()*2);
+                    // resize container, doubling the space left to the filter
+                    std::size_t space = (std::max)(
+                        cont_.size() - current_, min_space);
+                    cont_.resize(current_ + 2 * space);
 
                 } while (true);
 
@@ -128,6 +137,7 @@ namespace hpx { namespace util { namespace detail
             {
                 if (filter_) {
                     filter_->save(address, count);
+                    get_filtered_frames();
                 }
                 else {
                     // make sure there is a current serialization_chunk descriptor available
@@ -151,6 +161,21 @@ namespace hpx { namespace util { namespace detail
             }
         }
 
+        // move the frames compressed so far by a streaming filter to the
+        // container
+        void get_filtered_frames()
+        {
+            std::size_t count = filter_->frames_available();
+            if (count == 0)
+                return;
+
+            std::size_t pos = start_compressing_at_ + filtered_;
+            if (cont_.size() < pos + count)
+                cont_.resize(pos + count);
+
+            filtered_ += filter_->get_frames(&cont_[pos], count);
+        }
+
         void save_binary_chunk(void const* address, std::size_t count)
         {
             if (filter_ || chunks_ == 0 || count < HPX_ZERO_COPY_SERIALIZATION_THRESHOLD) {
@@ -180,6 +205,7 @@ namespace hpx { namespace util { namespace detail
         Container& cont_;
         std::size_t current_;
         std::size_t start_compressing_at_;
+        std::size_t filtered_;      // bytes written by a streaming filter
         binary_filter* filter_;
 
         std::vector<serialization_chunk>* chunks_;
@@ -13,6 +13,7 @@
 #include <hpx/hpx_fwd.hpp>
 #include <hpx/runtime/naming/locality.hpp>
 #include <hpx/runtime/components/static_component_data.hpp>
+#include <hpx/runtime/threads/policies/idle_backoff.hpp>
 #include <hpx/util/ini.hpp>
 #include <hpx/util/plugin/dll.hpp>
 
@@ -104,6 +105,11 @@ namespace hpx { namespace util
         // Enable minimal deadlock detection for HPX threads
         bool enable_minimal_deadlock_detection() const;
 
+        // Return the parameters controlling the behavior of idle worker
+        // threads
+        threads::policies::idle_backoff_parameters
+            get_idle_backoff_parameters() const;
+
         // Returns the number of OS threads this locality is running.
         std::size_t get_os_thread_count() const;
 
@@ -0,0 +1,573 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/runtime/actions/action_support.hpp>
+#include <hpx/runtime/actions/guid_initialization.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+#include <hpx/util/ini.hpp>
+#include <hpx/util/static.hpp>
+#include <hpx/util/void_cast.hpp>
+
+#include <hpx/plugins/plugin_registry.hpp>
+#include <hpx/plugins/binary_filter_factory.hpp>
+#include <hpx/plugins/binary_filter/adaptive_serialization_filter.hpp>
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace plugins { namespace compression { namespace detail
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // The index into this table is stored as the first byte of the written
+    // data, new codecs have to be appended.
+    struct codec_info
+    {
+        char const* name;
+        char const* filter_type;
+    };
+
+    codec_info const codecs[] =
+    {
+        { "none", 0 },
+        { "lz4", "lz4_serialization_filter" },
+        { "zstd", "zstd_serialization_filter" },
+        { "snappy", "snappy_serialization_filter" },
+        { "zlib", "zlib_serialization_filter" },
+        { "bzip2", "bzip2_serialization_filter" }
+    };
+
+    std::size_t const num_codecs = sizeof(codecs) / sizeof(codecs[0]);
+    boost::uint8_t const codec_none = 0;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // overall statistics exposed as performance counters
+    boost::atomic<boost::int64_t> compressed_messages(0);
+    boost::atomic<boost::int64_t> uncompressed_messages(0);
+    boost::atomic<boost::int64_t> original_bytes(0);
+    boost::atomic<boost::int64_t> compressed_bytes(0);
+    boost::atomic<boost::int64_t> compression_time(0);
+
+    inline boost::int64_t get_counter_value(
+        boost::atomic<boost::int64_t>& counter, bool reset)
+    {
+        if (reset)
+            return counter.exchange(0);
+        return counter.load();
+    }
+
+    boost::int64_t get_compressed_messages(bool reset)
+    {
+        return get_counter_value(compressed_messages, reset);
+    }
+
+    boost::int64_t get_uncompressed_messages(bool reset)
+    {
+        return get_counter_value(uncompressed_messages, reset);
+    }
+
+    boost::int64_t get_compression_time(bool reset)
+    {
+        return get_counter_value(compression_time, reset);
+    }
+
+    // size of the compressed data in 0.01% of the original size
+    boost::int64_t get_compression_ratio(bool reset)
+    {
+        boost::int64_t original = get_counter_value(original_bytes, reset);
+        boost::int64_t compressed = get_counter_value(compressed_bytes, reset);
+        if (0 == original)
+            return 0;
+        return (compressed * 10000) / original;
+    }
+
+    void register_counter_types()
+    {
+        HPX_STD_FUNCTION<boost::int64_t(bool)> compressed(
+            &get_compressed_messages);
+        HPX_STD_FUNCTION<boost::int64_t(bool)> uncompressed(
+            &get_uncompressed_messages);
+        HPX_STD_FUNCTION<boost::int64_t(bool)> time(&get_compression_time);
+        HPX_STD_FUNCTION<boost::int64_t(bool)> ratio(&get_compression_ratio);
+
+        performance_counters::generic_counter_type_data const
+            compression_counter_types[] =
+        {
+            { "/compression/count/compressed-messages",
+              performance_counters::counter_raw,
+              "returns the number of messages compressed by the adaptive "
+              "serialization filter",
+              HPX_PERFORMANCE_COUNTER_V1,
+              boost::bind(&performance_counters::locality_raw_counter_creator,
+                  _1, compressed, _2),
+              &performance_counters::locality_counter_discoverer,
+              ""
+            },
+            { "/compression/count/uncompressed-messages",
+              performance_counters::counter_raw,
+              "returns the number of messages the adaptive serialization "
+              "filter decided to send uncompressed",
+              HPX_PERFORMANCE_COUNTER_V1,
+              boost::bind(&performance_counters::locality_raw_counter_creator,
+                  _1, uncompressed, _2),
+              &performance_counters::locality_counter_discoverer,
+              ""
+            },
+            { "/compression/time/compress",
+              performance_counters::counter_raw,
+              "returns the overall time spent compressing messages by the "
+              "adaptive serialization filter",
+              HPX_PERFORMANCE_COUNTER_V1,
+              boost::bind(&performance_counters::locality_raw_counter_creator,
+                  _1, time, _2),
+              &performance_counters::locality_counter_discoverer,
+              "ns"
+            },
+            { "/compression/ratio",
+              performance_counters::counter_raw,
+              "returns the size of the data compressed by the adaptive "
+              "serialization filter relative to its original size (in "
+              "0.01%)",
+              HPX_PERFORMANCE_COUNTER_V1,
+              boost::bind(&performance_counters::locality_raw_counter_creator,
+                  _1, ratio, _2),
+              &performance_counters::locality_counter_discoverer,
+              "0.01%"
+            }
+        };
+
+        performance_counters::install_counter_types(
+            compression_counter_types,
+            sizeof(compression_counter_types) /
+                sizeof(compression_counter_types[0]));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Select the codec for each message based on the statistics gathered for
+    // the action and destination locality.
+    class codec_selector
+    {
+    private:
+        typedef lcos::local::spinlock mutex_type;
+
+        struct codec_statistics
+        {
+            codec_statistics() : ratio(1.0), rate(0.0), samples(0) {}
+
+            double ratio;           // compressed size / original size
+            double rate;            // bytes compressed per ns
+            std::size_t samples;
+        };
+
+        struct destination_statistics
+        {
+            destination_statistics() : messages(0) {}
+
+            std::vector<codec_statistics> codecs;
+            std::size_t messages;
+        };
+
+        typedef std::pair<std::string, boost::uint32_t> key_type;
+        typedef std::map<key_type, destination_statistics> statistics_map;
+
+    public:
+        codec_selector()
+          : threshold_(4096), bandwidth_(1.0), sample_interval_(16)
+        {
+            candidates_.push_back(1);       // lz4
+        }
+
+        void configure(util::section const& settings)
+        {
+            mutex_type::scoped_lock l(mtx_);
+
+            threshold_ = get_value(settings, "threshold", threshold_);
+            sample_interval_ =
+                get_value(settings, "sample_interval", sample_interval_);
+
+            // bandwidth is given in MB/s, convert to bytes per ns
+            std::size_t bandwidth = get_value(settings, "bandwidth", 1000);
+            bandwidth_ = (bandwidth == 0) ? 1.0 : bandwidth / 1000.0;
+
+            std::string names = settings.get_entry("codecs", "lz4,zstd");
+            std::vector<std::string> list;
+            boost::algorithm::split(list, names, boost::algorithm::is_any_of(","));
+
+            candidates_.clear();
+            for (std::size_t i = 0; i != list.size(); ++i)
+            {
+                boost::algorithm::trim(list[i]);
+                for (std::size_t c = 1; c != num_codecs; ++c)
+                {
+                    if (list[i] == codecs[c].name)
+                    {
+                        candidates_.push_back(static_cast<boost::uint8_t>(c));
+                        break;
+                    }
+                }
+            }
+            statistics_.clear();
+        }
+
+        boost::uint8_t select(char const* action_name,
+            boost::uint32_t destination, std::size_t size)
+        {
+            mutex_type::scoped_lock l(mtx_);
+
+            if (size < threshold_ || candidates_.empty())
+                return codec_none;
+
+            destination_statistics& s =
+                statistics_[key_type(action_name, destination)];
+            if (s.codecs.size() != candidates_.size())
+                s.codecs.resize(candidates_.size());
+
+            std::size_t n = s.messages++;
+
+            // try each of the codecs at least once, afterwards sample one of
+            // them every sample_interval_ messages
+            for (std::size_t i = 0; i != s.codecs.size(); ++i)
+            {
+                if (s.codecs[i].samples == 0)
+                    return candidates_[i];
+            }
+            if (sample_interval_ != 0 && (n % sample_interval_) == 0)
+            {
+                return candidates_[
+                    (n / sample_interval_) % candidates_.size()];
+            }
+
+            // estimate the time needed to compress and send the message
+            double best = size / bandwidth_;
+            boost::uint8_t codec = codec_none;
+            for (std::size_t i = 0; i != s.codecs.size(); ++i)
+            {
+                codec_statistics const& cs = s.codecs[i];
+                double estimate = size / cs.rate + (size * cs.ratio) / bandwidth_;
+                if (estimate < best)
+                {
+                    best = estimate;
+                    codec = candidates_[i];
+                }
+            }
+            return codec;
+        }
+
+        void update(char const* action_name, boost::uint32_t destination,
+            boost::uint8_t codec, std::size_t size, std::size_t compressed,
+            boost::uint64_t elapsed)
+        {
+            if (0 == size)
+                return;
+
+            mutex_type::scoped_lock l(mtx_);
+
+            statistics_map::iterator it =
+                statistics_.find(key_type(action_name, destination));
+            if (it == statistics_.end())
+                return;
+
+            std::vector<codec_statistics>& stats = it->second.codecs;
+            for (std::size_t i = 0; i != candidates_.size() && i != stats.size(); ++i)
+            {
+                if (candidates_[i] != codec)
+                    continue;
+
+                double ratio = double(compressed) / size;
+                double rate = double(size) / (elapsed ? elapsed : 1);
+
+                // exponentially weighted moving average
+                codec_statistics& cs = stats[i];
+                if (cs.samples++ == 0)
+                {
+                    cs.ratio = ratio;
+                    cs.rate = rate;
+                }
+                else
+                {
+                    cs.ratio = 0.75 * cs.ratio + 0.25 * ratio;
+                    cs.rate = 0.75 * cs.rate + 0.25 * rate;
+                }
+                break;
+            }
+        }
+
+        // don't use the given codec anymore (the plugin is not available)
+        void disable(boost::uint8_t codec)
+        {
+            mutex_type::scoped_lock l(mtx_);
+
+            std::vector<boost::uint8_t>::iterator it =
+                std::find(candidates_.begin(), candidates_.end(), codec);
+            if (it != candidates_.end())
+            {
+                candidates_.erase(it);
+                statistics_.clear();
+            }
+        }
+
+    private:
+        static std::size_t get_value(util::section const& settings,
+            std::string const& key, std::size_t dflt)
+        {
+            try {
+                return boost::lexical_cast<std::size_t>(
+                    settings.get_entry(key, dflt));
+            }
+            catch (boost::bad_lexical_cast const&) {
+                return dflt;
+            }
+        }
+
+        mutable mutex_type mtx_;
+        statistics_map statistics_;
+        std::vector<boost::uint8_t> candidates_;
+        std::size_t threshold_;
+        double bandwidth_;
+        std::size_t sample_interval_;
+    };
+
+    struct codec_selector_tag {};
+
+    codec_selector& get_codec_selector()
+    {
+        util::static_<codec_selector, codec_selector_tag> selector;
+        return selector.get();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    util::binary_filter* create_codec_filter(boost::uint8_t codec,
+        bool compress, error_code& ec = throws)
+    {
+        if (codec == codec_none || codec >= num_codecs)
+        {
+            HPX_THROWS_IF(ec, serialization_error,
+                "adaptive_serialization_filter::create_codec_filter",
+                boost::str(boost::format("unknown codec: %d") % unsigned(codec)));
+            return 0;
+        }
+        return hpx::create_binary_filter(codecs[codec].filter_type, compress,
+            0, ec);
+    }
+}}}}
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace plugins { namespace compression
+{
+    // The factory configures the codec selection from the plugin's ini
+    // section and registers the performance counters.
+    struct adaptive_serialization_filter_factory
+      : binary_filter_factory<adaptive_serialization_filter>
+    {
+        typedef binary_filter_factory<adaptive_serialization_filter> base_type;
+
+        adaptive_serialization_filter_factory(util::section const* global,
+                util::section const* local, bool isenabled)
+          : base_type(global, local, isenabled)
+        {
+            if (isenabled)
+            {
+                detail::get_codec_selector().configure(this->local_settings_);
+                hpx::register_startup_function(&detail::register_counter_types);
+            }
+        }
+    };
+}}}
+
+///////////////////////////////////////////////////////////////////////////////
+HPX_REGISTER_PLUGIN_MODULE();
+HPX_REGISTER_BINARY_FILTER_FACTORY_BASE(
+    hpx::plugins::compression::adaptive_serialization_filter_factory,
+    adaptive_serialization_filter);
+HPX_DEF_UNIQUE_PLUGIN_NAME(
+    hpx::plugins::compression::adaptive_serialization_filter_factory,
+    adaptive_serialization_filter);
+HPX_REGISTER_PLUGIN_REGISTRY_2(
+    hpx::plugins::compression::adaptive_serialization_filter,
+    adaptive_serialization_filter);
+
+///////////////////////////////////////////////////////////////////////////////
+HPX_SERIALIZATION_REGISTER_TYPE_DEFINITION(
+    hpx::plugins::compression::adaptive_serialization_filter);
+HPX_REGISTER_BASE_HELPER(
+    hpx::plugins::compression::adaptive_serialization_filter,
+    adaptive_serialization_filter);
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace plugins { namespace compression
+{
+    adaptive_serialization_filter::~adaptive_serialization_filter()
+    {
+        hpx::actions::detail::guid_initialization<adaptive_serialization_filter>();
+    }
+
+    void adaptive_serialization_filter::register_base()
+    {
+        util::void_cast_register_nonvirt<
+            adaptive_serialization_filter, util::binary_filter>();
+    }
+
+    void adaptive_serialization_filter::set_max_length(std::size_t size)
+    {
+        buffer_.reserve(size);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t adaptive_serialization_filter::init_data(
+        char const* buffer, std::size_t size, std::size_t buffer_size)
+    {
+        if (0 == size)
+        {
+            BOOST_THROW_EXCEPTION(
+                boost::archive::archive_exception(
+                    boost::archive::archive_exception::input_stream_error,
+                    "archive data bstream is too short"));
+            return 0;
+        }
+
+        codec_ = static_cast<boost::uint8_t>(*buffer);
+        if (codec_ != detail::codec_none)
+        {
+            codec_filter_.reset(detail::create_codec_filter(codec_, false));
+            return codec_filter_->init_data(buffer + 1, size - 1, buffer_size);
+        }
+
+        buffer_.assign(buffer + 1, buffer + size);
+        current_ = 0;
+        return buffer_.size();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void adaptive_serialization_filter::load(void* dst, std::size_t dst_count)
+    {
+        if (codec_filter_)
+        {
+            codec_filter_->load(dst, dst_count);
+            return;
+        }
+
+        if (current_+dst_count > buffer_.size())
+        {
+            BOOST_THROW_EXCEPTION(
+                boost::archive::archive_exception(
+                    boost::archive::archive_exception::input_stream_error,
+                    "archive data bstream is too short"));
+            return;
+        }
+
+        std::memcpy(dst, &buffer_[current_], dst_count);
+        current_ += dst_count;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void adaptive_serialization_filter::save(void const* src,
+        std::size_t src_count)
+    {
+        char const* src_begin = static_cast<char const*>(src);
+        std::copy(src_begin, src_begin+src_count, std::back_inserter(buffer_));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void adaptive_serialization_filter::select_codec()
+    {
+        detail::codec_selector& selector = detail::get_codec_selector();
+
+        codec_ = selector.select(action_name_, destination_, buffer_.size());
+        if (codec_ == detail::codec_none)
+            return;
+
+        boost::uint64_t start = util::high_resolution_clock::now();
+
+        error_code ec(lightweight);
+        codec_filter_.reset(detail::create_codec_filter(codec_, true, ec));
+        if (ec || !codec_filter_)
+        {
+            // the plugin for this codec is not available
+            selector.disable(codec_);
+            codec_filter_.reset();
+            codec_ = detail::codec_none;
+            return;
+        }
+
+        codec_filter_->set_max_length(buffer_.size());
+        if (!buffer_.empty())
+            codec_filter_->save(buffer_.data(), buffer_.size());
+
+        elapsed_ += util::high_resolution_clock::now() - start;
+    }
+
+    bool adaptive_serialization_filter::flush(void* dst, std::size_t dst_count,
+        std::size_t& written)
+    {
+        char* dst_begin = static_cast<char*>(dst);
+        written = 0;
+
+        // the codec is selected once, flush might be called several times
+        // if the destination buffer is too small
+        if (!codec_selected_)
+        {
+            if (0 == dst_count)
+                return false;
+
+            select_codec();
+            codec_selected_ = true;
+
+            *dst_begin++ = static_cast<char>(codec_);
+            --dst_count;
+            written = 1;
+        }
+
+        if (codec_ == detail::codec_none)
+        {
+            std::size_t count = (std::min)(buffer_.size() - current_, dst_count);
+            if (count != 0)
+                std::memcpy(dst_begin, &buffer_[current_], count);
+
+            current_ += count;
+            written += count;
+            if (current_ != buffer_.size())
+                return false;
+
+            ++detail::uncompressed_messages;
+            return true;
+        }
+
+        boost::uint64_t start = util::high_resolution_clock::now();
+
+        std::size_t codec_written = 0;
+        bool flushed = codec_filter_->flush(dst_begin, dst_count, codec_written);
+
+        elapsed_ += util::high_resolution_clock::now() - start;
+        compressed_size_ += codec_written;
+        written += codec_written;
+
+        if (!flushed)
+            return false;
+
+        detail::get_codec_selector().update(action_name_, destination_,
+            codec_, buffer_.size(), compressed_size_, elapsed_);
+
+        ++detail::compressed_messages;
+        detail::original_bytes += buffer_.size();
+        detail::compressed_bytes += compressed_size_;
+        detail::compression_time += elapsed_;
+        return true;
+    }
+}}}
@@ -0,0 +1,85 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/runtime/actions/action_support.hpp>
+#include <hpx/runtime/actions/guid_initialization.hpp>
+#include <hpx/util/void_cast.hpp>
+
+#include <hpx/plugins/plugin_registry.hpp>
+#include <hpx/plugins/binary_filter_factory.hpp>
+#include <hpx/plugins/binary_filter/lz4_serialization_filter.hpp>
+
+#include <boost/format.hpp>
+
+#include <lz4.h>
+
+///////////////////////////////////////////////////////////////////////////////
+HPX_REGISTER_PLUGIN_MODULE();
+HPX_REGISTER_BINARY_FILTER_FACTORY(
+    hpx::plugins::compression::lz4_serialization_filter,
+    lz4_serialization_filter);
+
+///////////////////////////////////////////////////////////////////////////////
+HPX_SERIALIZATION_REGISTER_TYPE_DEFINITION(
+    hpx::plugins::compression::lz4_serialization_filter);
+HPX_REGISTER_BASE_HELPER(
+    hpx::plugins::compression::lz4_serialization_filter,
+    lz4_serialization_filter);
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace plugins { namespace compression
+{
+    lz4_serialization_filter::~lz4_serialization_filter()
+    {
+        hpx::actions::detail::guid_initialization<lz4_serialization_filter>();
+    }
+
+    void lz4_serialization_filter::register_base()
+    {
+        util::void_cast_register_nonvirt<
+            lz4_serialization_filter, util::binary_filter>();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t lz4_serialization_filter::max_compressed_length(
+        std::size_t size) const
+    {
+        return static_cast<std::size_t>(
+            LZ4_compressBound(static_cast<int>(size)));
+    }
+
+    std::size_t lz4_serialization_filter::compress(char const* src,
+        std::size_t size, char* dst, std::size_t dst_size) const
+    {
+        int compressed_length = LZ4_compress_default(src, dst,
+            static_cast<int>(size), static_cast<int>(dst_size));
+
+        if (compressed_length <= 0 && size != 0)
+        {
+            HPX_THROW_EXCEPTION(serialization_error,
+                "lz4_serialization_filter::compress",
+                "compression failure, flushing did not reach end of data");
+            return 0;
+        }
+        return static_cast<std::size_t>(compressed_length);
+    }
+
+    void lz4_serialization_filter::uncompress(char const* src,
+        std::size_t size, char* dst, std::size_t dst_size) const
+    {
+        int decompressed = LZ4_decompress_safe(src, dst,
+            static_cast<int>(size), static_cast<int>(dst_size));
+        if (decompressed < 0 ||
+            static_cast<std::size_t>(decompressed) != dst_size)
+        {
+            HPX_THROW_EXCEPTION(serialization_error,
+                "lz4_serialization_filter::uncompress",
+                boost::str(boost::format("decompression failure, number of "
+                    "bytes expected: %d, number of bytes decoded: %d") %
+                        dst_size % decompressed));
+        }
+    }
+}}}
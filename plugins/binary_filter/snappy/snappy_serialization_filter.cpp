@@ -43,74 +43,42 @@ namespace hpx { namespace plugins { namespace compression
             snappy_serialization_filter, util::binary_filter>();
     }
 
-    void snappy_serialization_filter::set_max_length(std::size_t size)
-    {
-        buffer_.reserve(size);
-    }
-
     ///////////////////////////////////////////////////////////////////////////
-    std::size_t snappy_serialization_filter::init_data(
-        char const* buffer, std::size_t size, std::size_t buffer_size)
+    std::size_t snappy_serialization_filter::max_compressed_length(
+        std::size_t size) const
     {
-        buffer_.resize(buffer_size);
-        snappy::RawUncompress(buffer, size, buffer_.data());
-        current_ = 0;
-        return buffer_.size();
+        return snappy::MaxCompressedLength(size);
     }
 
-    ///////////////////////////////////////////////////////////////////////////
-    void snappy_serialization_filter::load(void* dst, std::size_t dst_count)
+    std::size_t snappy_serialization_filter::compress(char const* src,
+        std::size_t size, char* dst, std::size_t dst_size) const
     {
-        if (current_+dst_count > buffer_.size())
+        size_t compressed_length = 0;
+        snappy::RawCompress(src, size, dst, &compressed_length);
+
+        if (compressed_length > dst_size)
         {
-            BOOST_THROW_EXCEPTION(
-                boost::archive::archive_exception(
-                    boost::archive::archive_exception::input_stream_error,
-                    "archive data bstream is too short"));
-            return;
+            HPX_THROW_EXCEPTION(serialization_error,
+                "snappy_serialization_filter::compress",
+                "compression failure, flushing did not reach end of data");
+            return 0;
         }
-
-        std::memcpy(dst, &buffer_[current_], dst_count);
-        current_ += dst_count;
-    }
-
-    ///////////////////////////////////////////////////////////////////////////
-    void snappy_serialization_filter::save(void const* src,
-        std::size_t src_count)
-    {
-        char const* src_begin = static_cast<char const*>(src);
-        std::copy(src_begin, src_begin+src_count, std::back_inserter(buffer_));
+        return compressed_length;
     }
 
-    ///////////////////////////////////////////////////////////////////////////
-    bool snappy_serialization_filter::flush(void* dst, std::size_t dst_count,
-        std::size_t& written)
+    void snappy_serialization_filter::uncompress(char const* src,
+        std::size_t size, char* dst, std::size_t dst_size) const
     {
-        // make sure we have enough memory
-        std::size_t needed = snappy::MaxCompressedLength(buffer_.size());
-        if (needed > dst_count)
-        {
-            written = 0;
-            return false;
-        }
-
-        // compress everything in one go
-        char* dst_begin = static_cast<char*>(dst);
-        char const* src_begin = buffer_.data();
-        size_t compressed_length = 0;
-        snappy::RawCompress(src_begin, buffer_.size(), dst_begin,
-            &compressed_length);
-
-        if (compressed_length > dst_count)
+        size_t uncompressed_length = 0;
+        if (!snappy::GetUncompressedLength(src, size, &uncompressed_length) ||
+            uncompressed_length != dst_size ||
+            !snappy::RawUncompress(src, size, dst))
         {
             HPX_THROW_EXCEPTION(serialization_error,
-                "snappy_serialization_filter::flush",
-                "compression failure, flushing did not reach end of data");
-            return false;
+                "snappy_serialization_filter::uncompress",
+                boost::str(boost::format("decompression failure, number of "
+                    "bytes expected: %d, number of bytes decoded: %d") %
+                        dst_size % uncompressed_length));
         }
-
-        written = compressed_length;
-        return true;
     }
 }}}
-
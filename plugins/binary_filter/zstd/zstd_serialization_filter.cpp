@@ -0,0 +1,83 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/runtime/actions/action_support.hpp>
+#include <hpx/runtime/actions/guid_initialization.hpp>
+#include <hpx/util/void_cast.hpp>
+
+#include <hpx/plugins/plugin_registry.hpp>
+#include <hpx/plugins/binary_filter_factory.hpp>
+#include <hpx/plugins/binary_filter/zstd_serialization_filter.hpp>
+
+#include <boost/format.hpp>
+
+#include <zstd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+HPX_REGISTER_PLUGIN_MODULE();
+HPX_REGISTER_BINARY_FILTER_FACTORY(
+    hpx::plugins::compression::zstd_serialization_filter,
+    zstd_serialization_filter);
+
+///////////////////////////////////////////////////////////////////////////////
+HPX_SERIALIZATION_REGISTER_TYPE_DEFINITION(
+    hpx::plugins::compression::zstd_serialization_filter);
+HPX_REGISTER_BASE_HELPER(
+    hpx::plugins::compression::zstd_serialization_filter,
+    zstd_serialization_filter);
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace plugins { namespace compression
+{
+    zstd_serialization_filter::~zstd_serialization_filter()
+    {
+        hpx::actions::detail::guid_initialization<zstd_serialization_filter>();
+    }
+
+    void zstd_serialization_filter::register_base()
+    {
+        util::void_cast_register_nonvirt<
+            zstd_serialization_filter, util::binary_filter>();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t zstd_serialization_filter::max_compressed_length(
+        std::size_t size) const
+    {
+        return ZSTD_compressBound(size);
+    }
+
+    std::size_t zstd_serialization_filter::compress(char const* src,
+        std::size_t size, char* dst, std::size_t dst_size) const
+    {
+        std::size_t compressed_length = ZSTD_compress(dst, dst_size,
+            src, size, level_);
+
+        if (ZSTD_isError(compressed_length))
+        {
+            HPX_THROW_EXCEPTION(serialization_error,
+                "zstd_serialization_filter::compress",
+                boost::str(boost::format("compression failure: %s") %
+                    ZSTD_getErrorName(compressed_length)));
+            return 0;
+        }
+        return compressed_length;
+    }
+
+    void zstd_serialization_filter::uncompress(char const* src,
+        std::size_t size, char* dst, std::size_t dst_size) const
+    {
+        std::size_t decompressed = ZSTD_decompress(dst, dst_size, src, size);
+        if (ZSTD_isError(decompressed) || decompressed != dst_size)
+        {
+            HPX_THROW_EXCEPTION(serialization_error,
+                "zstd_serialization_filter::uncompress",
+                boost::str(boost::format("decompression failure, number of "
+                    "bytes expected: %d, number of bytes decoded: %d") %
+                        dst_size % decompressed));
+        }
+    }
+}}}
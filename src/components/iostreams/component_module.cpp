@@ -47,6 +47,8 @@ namespace hpx { namespace iostreams { namespace detail
         hpx::cout.initialize(iostreams::detail::cout_tag());
         hpx::cerr.initialize(iostreams::detail::cerr_tag());
         hpx::consolestream.initialize(iostreams::detail::consolestream_tag());
+
+        register_counter_types();
     }
 
     void unregister_ostreams()
@@ -0,0 +1,238 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/util/bind.hpp>
+#include <hpx/components/iostreams/ostream.hpp>
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace iostreams
+{
+    namespace detail
+    {
+        boost::atomic<boost::int64_t> forwarded_messages(0);
+        boost::atomic<boost::int64_t> forwarded_bytes(0);
+        boost::atomic<boost::int64_t> forwarded_batches(0);
+
+        inline boost::int64_t get_counter_value(
+            boost::atomic<boost::int64_t>& counter, bool reset)
+        {
+            if (reset)
+                return counter.exchange(0);
+            return counter.load();
+        }
+
+        boost::int64_t get_forwarded_messages(bool reset)
+        {
+            return get_counter_value(forwarded_messages, reset);
+        }
+
+        boost::int64_t get_forwarded_bytes(bool reset)
+        {
+            return get_counter_value(forwarded_bytes, reset);
+        }
+
+        boost::int64_t get_forwarded_batches(bool reset)
+        {
+            return get_counter_value(forwarded_batches, reset);
+        }
+
+        std::size_t get_config_value(std::string const& key, std::size_t dflt)
+        {
+            try {
+                return boost::lexical_cast<std::size_t>(
+                    hpx::get_config_entry(key, dflt));
+            }
+            catch (boost::bad_lexical_cast const&) {
+                return dflt;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void register_counter_types()
+        {
+            HPX_STD_FUNCTION<boost::int64_t(bool)> messages(
+                &get_forwarded_messages);
+            HPX_STD_FUNCTION<boost::int64_t(bool)> bytes(
+                &get_forwarded_bytes);
+            HPX_STD_FUNCTION<boost::int64_t(bool)> batches(
+                &get_forwarded_batches);
+
+            performance_counters::generic_counter_type_data const
+                iostreams_counter_types[] =
+            {
+                { "/iostreams/count/forwarded-messages",
+                  performance_counters::counter_raw,
+                  "returns the number of flushed output messages forwarded "
+                  "from this locality to the console",
+                  HPX_PERFORMANCE_COUNTER_V1,
+                  boost::bind(&performance_counters::locality_raw_counter_creator,
+                      _1, messages, _2),
+                  &performance_counters::locality_counter_discoverer,
+                  ""
+                },
+                { "/iostreams/count/forwarded-bytes",
+                  performance_counters::counter_raw,
+                  "returns the number of bytes of output forwarded from this "
+                  "locality to the console",
+                  HPX_PERFORMANCE_COUNTER_V1,
+                  boost::bind(&performance_counters::locality_raw_counter_creator,
+                      _1, bytes, _2),
+                  &performance_counters::locality_counter_discoverer,
+                  "bytes"
+                },
+                { "/iostreams/count/forwarded-batches",
+                  performance_counters::counter_raw,
+                  "returns the number of batches of output sent from this "
+                  "locality to the console",
+                  HPX_PERFORMANCE_COUNTER_V1,
+                  boost::bind(&performance_counters::locality_raw_counter_creator,
+                      _1, batches, _2),
+                  &performance_counters::locality_counter_discoverer,
+                  ""
+                }
+            };
+
+            performance_counters::install_counter_types(
+                iostreams_counter_types,
+                sizeof(iostreams_counter_types) /
+                    sizeof(iostreams_counter_types[0]));
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void ostream::enqueue(detail::buffer& b)
+    {
+        detail::buffer next = b.init();
+        if (next.empty())
+            return;
+
+        boost::shared_ptr<util::interval_timer> timer;
+        {
+            batch_mutex_type::scoped_lock l(batch_mtx_);
+            bool was_empty = batch_.empty();
+            batch_.append(next);
+            ++batch_messages_;
+
+            // the first message of a batch starts the timer sending it
+            if (was_empty)
+                timer = timer_;
+        }
+
+        if (timer && hpx::is_running())
+            timer->start(false);
+
+        // send the batch right away if it has grown large enough, this
+        // sends every flushed message if batching is disabled
+        send_batch(false, batch_size_);
+    }
+
+    void ostream::release_thread_stream(detail::thread_stream* ts)
+    {
+        ts->os_.enqueue(*ts);
+        delete ts;
+    }
+
+    void ostream::send_batch(bool sync, std::size_t min_size)
+    {
+        batch_mutex_type::scoped_lock l(batch_mtx_);
+
+        std::size_t size = batch_.size();
+        if (0 == size || size < min_size)
+            return;
+
+        // Create the next batch, returns the previous one. The generational
+        // count is assigned while holding the lock, which keeps the batches
+        // in order at the destination.
+        detail::buffer next = batch_.init();
+        std::size_t messages = batch_messages_;
+        batch_messages_ = 0;
+        boost::uint64_t count = generational_count_++;
+
+        l.unlock();
+
+        detail::forwarded_messages += messages;
+        detail::forwarded_bytes += size;
+        ++detail::forwarded_batches;
+
+        // Perform the write operation, then destroy the old batch.
+        if (sync)
+        {
+            this->base_type::write_sync(get_gid(), hpx::get_locality_id(),
+                count, next);
+        }
+        else
+        {
+            this->base_type::write_async(get_gid(), hpx::get_locality_id(),
+                count, next);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void ostream::init_batching()
+    {
+        batch_size_ = detail::get_config_value(
+            "hpx.iostreams.batch_size", 4096);
+        std::size_t interval = detail::get_config_value(
+            "hpx.iostreams.batch_interval", 10);
+
+        // a batch size of zero disables the per-thread streams, all output is
+        // sent on every flush
+        if (0 == batch_size_)
+            return;
+
+        // make sure pending output is sent even if no further flushes happen,
+        // the timer is started whenever a batch becomes non-empty
+        if (0 != interval)
+        {
+            boost::shared_ptr<util::interval_timer> timer =
+                boost::make_shared<util::interval_timer>(
+                    util::bind(&ostream::send_pending_batch, this),
+                    boost::int64_t(interval) * 1000,
+                    "hpx::iostreams::ostream::send_pending_batch", true);
+
+            batch_mutex_type::scoped_lock l(batch_mtx_);
+            timer_ = timer;
+        }
+    }
+
+    bool ostream::send_pending_batch()
+    {
+        send_batch(false);
+        return false;       // the next batch will start the timer again
+    }
+
+    void ostream::uninitialize()
+    {
+        boost::shared_ptr<util::interval_timer> timer;
+        {
+            batch_mutex_type::scoped_lock l(batch_mtx_);
+            timer.swap(timer_);
+        }
+        if (timer)
+            timer->stop();
+
+#if HPX_THREAD_MAINTAIN_LOCAL_STORAGE
+        // collect the output of the calling thread, the output of all other
+        // HPX threads has been collected when they exited
+        if (0 != threads::get_self_ptr())
+            thread_stream_.reset();
+#endif
+
+        {
+            mutex_type::scoped_lock l(mtx_, boost::try_to_lock);
+            if (l)
+                static_cast<stream_base_type*>(this)->flush();
+        }
+
+        send_batch(true);
+        this->base_type::free();
+    }
+}}
@@ -133,4 +133,58 @@ HPX_REGISTER_ACTION(
 HPX_REGISTER_ACTION(
     hpx::server::chunk_vector::chunk_for_each_const_action,
     chunk_vector_chunk_for_each_const_action);
+/** @brief Macro to define the boilerplate code for \a chunk_fill component
+ *          action.
+ */
+HPX_REGISTER_ACTION(
+    hpx::server::chunk_vector::chunk_fill_action,
+    chunk_vector_chunk_fill_action);
+/** @brief Macro to define the boilerplate code for \a chunk_count component
+ *          action.
+ */
+HPX_REGISTER_ACTION(
+    hpx::server::chunk_vector::chunk_count_action,
+    chunk_vector_chunk_count_action);
+/** @brief Macro to define the boilerplate code for \a chunk_count_if component
+ *          action.
+ */
+HPX_REGISTER_ACTION(
+    hpx::server::chunk_vector::chunk_count_if_action,
+    chunk_vector_chunk_count_if_action);
+/** @brief Macro to define the boilerplate code for \a chunk_reduce component
+ *          action.
+ */
+HPX_REGISTER_ACTION(
+    hpx::server::chunk_vector::chunk_reduce_action,
+    chunk_vector_chunk_reduce_action);
+/** @brief Macro to define the boilerplate code for \a chunk_sum component
+ *          action.
+ */
+HPX_REGISTER_ACTION(
+    hpx::server::chunk_vector::chunk_sum_action,
+    chunk_vector_chunk_sum_action);
+/** @brief Macro to define the boilerplate code for \a chunk_find component
+ *          action.
+ */
+HPX_REGISTER_ACTION(
+    hpx::server::chunk_vector::chunk_find_action,
+    chunk_vector_chunk_find_action);
+/** @brief Macro to define the boilerplate code for \a chunk_transform component
+ *          action.
+ */
+HPX_REGISTER_ACTION(
+    hpx::server::chunk_vector::chunk_transform_action,
+    chunk_vector_chunk_transform_action);
+/** @brief Macro to define the boilerplate code for \a chunk_get_values component
+ *          action.
+ */
+HPX_REGISTER_ACTION(
+    hpx::server::chunk_vector::chunk_get_values_action,
+    chunk_vector_chunk_get_values_action);
+/** @brief Macro to define the boilerplate code for \a chunk_set_values component
+ *          action.
+ */
+HPX_REGISTER_ACTION(
+    hpx::server::chunk_vector::chunk_set_values_action,
+    chunk_vector_chunk_set_values_action);
 
@@ -983,6 +983,51 @@ namespace hpx
             return 0;
         }
 #endif
+
+#if defined(HPX_DEADLINE_SCHEDULER)
+        ///////////////////////////////////////////////////////////////////////
+        // deadline scheduler: local priority scheduler which additionally
+        // runs threads with a deadline in earliest deadline first order
+        int run_deadline(startup_function_type const& startup,
+            shutdown_function_type const& shutdown,
+            util::command_line_handling& cfg, bool blocking)
+        {
+            ensure_hierarchy_arity_compatibility(cfg.vm_);
+            ensure_hwloc_compatibility(cfg.vm_);
+
+            std::size_t num_high_priority_queues = cfg.num_threads_;
+            if (cfg.vm_.count("hpx:high-priority-threads")) {
+                num_high_priority_queues =
+                    cfg.vm_["hpx:high-priority-threads"].as<std::size_t>();
+            }
+
+            bool numa_sensitive = false;
+            if (cfg.vm_.count("hpx:numa-sensitive"))
+                numa_sensitive = true;
+
+            // scheduling policy
+            typedef hpx::threads::policies::deadline_queue_scheduler<>
+                local_queue_policy;
+            local_queue_policy::init_parameter_type init(cfg.num_threads_,
+                num_high_priority_queues, 1000, numa_sensitive);
+
+            // Build and configure this runtime instance.
+            typedef hpx::runtime_impl<local_queue_policy> runtime_type;
+            HPX_STD_UNIQUE_PTR<hpx::runtime> rt(
+                new runtime_type(cfg.rtcfg_, cfg.mode_, cfg.num_threads_, init));
+
+            if (blocking) {
+                return run(*rt, cfg.hpx_main_f_, cfg.vm_, cfg.mode_, startup,
+                    shutdown);
+            }
+
+            // non-blocking version
+            start(*rt, cfg.hpx_main_f_, cfg.vm_, cfg.mode_, startup, shutdown);
+
+            rt.release();          // pointer to runtime is stored in TLS
+            return 0;
+        }
+#endif
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -1082,6 +1127,15 @@ namespace hpx
                 throw std::logic_error("Command line option --hpx:queuing=periodic "
                     "is not configured in this build. Please rebuild with "
                     "'cmake -DHPX_PERIODIC_PRIORITY_SCHEDULER=ON'.");
+#endif
+            }
+            else if (0 == std::string("deadline").find(cfg.queuing_)) {
+#if defined(HPX_DEADLINE_SCHEDULER)
+                result = detail::run_deadline(startup, shutdown, cfg, blocking);
+#else
+                throw std::logic_error("Command line option --hpx:queuing=deadline "
+                    "is not configured in this build. Please rebuild with "
+                    "'cmake -DHPX_DEADLINE_SCHEDULER=ON'.");
 #endif
             }
             else {
@@ -19,6 +19,7 @@
 #include <hpx/performance_counters/registry.hpp>
 #include <hpx/util/high_resolution_clock.hpp>
 #include <hpx/util/backtrace.hpp>
+#include <hpx/util/binary_log.hpp>
 #include <hpx/util/query_counters.hpp>
 #include <hpx/util/thread_mapper.hpp>
 #include <hpx/util/coroutine/coroutine.hpp>
@@ -489,6 +490,7 @@ namespace hpx
     void runtime::deinit_tss()
     {
         // reset our TSS
+        util::binary_log::release_thread_buffer();
         threads::coroutine_type::impl_type::reset_self();
         runtime::uptime_.reset();
         runtime::runtime_.reset();
@@ -580,6 +582,9 @@ namespace hpx
     ///        instance
     void runtime::register_counter_types()
     {
+        HPX_STD_FUNCTION<boost::int64_t(bool)> dropped_log_records(
+            &util::binary_log::get_dropped_records);
+
         performance_counters::generic_counter_type_data statistic_counter_types[] =
         {
             // averaging counter
@@ -666,6 +671,18 @@ namespace hpx
               &performance_counters::detail::component_instance_counter_creator,
               &performance_counters::locality_counter_discoverer,
               ""
+            },
+
+            // binary log counters
+            { "/runtime/count/dropped-log-records",
+              performance_counters::counter_raw,
+              "returns the number of records of the binary log which were "
+              "dropped because the buffer of the logging OS thread was full",
+              HPX_PERFORMANCE_COUNTER_V1,
+              boost::bind(&performance_counters::locality_raw_counter_creator,
+                  _1, dropped_log_records, _2),
+              &performance_counters::locality_counter_discoverer,
+              ""
             }
         };
         performance_counters::install_counter_types(
@@ -41,6 +41,11 @@
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
 
 namespace hpx { namespace detail
 {
@@ -144,7 +149,9 @@ struct registration_header
 };
 
 // This structure is used in the response from node zero to the locality which
-// is trying to register (first roundtrip).
+// is trying to register (first roundtrip). During startup it additionally
+// lists the localities the receiving locality has to forward the
+// notifications to.
 struct notification_header
 {
     notification_header() {}
@@ -174,6 +181,7 @@ struct notification_header
     naming::address symbol_ns_address;
     boost::uint32_t num_localities;
     boost::uint32_t used_cores;
+    std::vector<boot_tree_entry> subtree;
 
 #if defined(HPX_HAVE_SECURITY)
     components::security::signed_certificate root_certificate;
@@ -189,6 +197,7 @@ struct notification_header
         ar & symbol_ns_address;
         ar & num_localities;
         ar & used_cores;
+        ar & subtree;
 #if defined(HPX_HAVE_SECURITY)
         ar & root_certificate;
 #endif
@@ -311,6 +320,34 @@ HPX_REGISTER_PLAIN_ACTION(notify_worker_security_action,
 namespace hpx { namespace agas
 {
 
+// create the notification for the given locality, this has to be called on
+// the bootstrap locality
+notification_header make_notification_header(
+    runtime& rt
+  , naming::gid_type const& prefix
+  , boost::uint32_t used_cores
+    )
+{
+    naming::resolver_client& agas_client = rt.get_agas_client();
+
+    naming::address locality_addr(rt.here(),
+        server::locality_namespace::get_component_type(),
+            agas_client.get_bootstrap_locality_ns_ptr());
+    naming::address primary_addr(rt.here(),
+        server::primary_namespace::get_component_type(),
+            agas_client.get_bootstrap_primary_ns_ptr());
+    naming::address component_addr(rt.here(),
+        server::component_namespace::get_component_type(),
+            agas_client.get_bootstrap_component_ns_ptr());
+    naming::address symbol_addr(rt.here(),
+        server::symbol_namespace::get_component_type(),
+            agas_client.get_bootstrap_symbol_ns_ptr());
+
+    return notification_header(prefix, locality_addr, primary_addr
+      , component_addr, symbol_addr, rt.get_config().get_num_localities()
+      , used_cores);
+}
+
 // remote call to AGAS
 void register_worker(registration_header const& header)
 {
@@ -373,26 +410,25 @@ void register_worker(registration_header const& header)
       , header.symbol_ns_ptr);
     agas_client.bind_local(symbol_ns_gid, symbol_ns_address);
 
-    naming::address locality_addr(rt.here(),
-        server::locality_namespace::get_component_type(),
-            agas_client.get_bootstrap_locality_ns_ptr());
-    naming::address primary_addr(rt.here(),
-        server::primary_namespace::get_component_type(),
-            agas_client.get_bootstrap_primary_ns_ptr());
-    naming::address component_addr(rt.here(),
-        server::component_namespace::get_component_type(),
-            agas_client.get_bootstrap_component_ns_ptr());
-    naming::address symbol_addr(rt.here(),
-        server::symbol_namespace::get_component_type(),
-            agas_client.get_bootstrap_symbol_ns_ptr());
-
     // assign cores to the new locality
     boost::uint32_t first_core = rt.assign_cores(header.hostname,
         header.cores_needed);
 
-    notification_header hdr (prefix, locality_addr, primary_addr
-      , component_addr, symbol_addr, rt.get_config().get_num_localities()
-      , first_core);
+#if !defined(HPX_HAVE_SECURITY)
+    if (agas_client.get_status() == starting)
+    {
+        // AGAS is starting up; this locality is participating in startup
+        // synchronization. Delay the final response until the runtime system
+        // is up and running, all responses are sent out along a tree of
+        // localities at this point (see big_boot_barrier::trigger).
+        get_big_boot_barrier().add_notification(
+            boot_tree_entry(prefix, header.locality, first_core));
+        return;
+    }
+#endif
+
+    notification_header hdr(
+        make_notification_header(rt, prefix, first_core));
 
 #if defined(HPX_HAVE_SECURITY)
     // wait for the root certificate to be available
@@ -435,29 +471,18 @@ void register_worker(registration_header const& header)
           , naming::address(header.locality), p);
     }
 
+#if defined(HPX_HAVE_SECURITY)
     else
     {
         // AGAS is starting up; this locality is participating in startup
-        // synchronization.
-#if defined(HPX_HAVE_SECURITY)
-        // send response directly to initiate second round trip
+        // synchronization. Send response directly to initiate second round
+        // trip.
         get_big_boot_barrier().apply(
             0
           , naming::get_locality_id_from_gid(prefix)
           , naming::address(header.locality), p);
-#else
-        // delay the final response until the runtime system is up and running
-        HPX_STD_FUNCTION<void()>* thunk = new HPX_STD_FUNCTION<void()>(
-            boost::bind(
-                &big_boot_barrier::apply
-              , boost::ref(get_big_boot_barrier())
-              , 0
-              , naming::get_locality_id_from_gid(prefix)
-              , naming::address(header.locality)
-              , p));
-        get_big_boot_barrier().add_thunk(thunk);
-#endif
     }
+#endif
 }
 
 // AGAS callback to client (first roundtrip response)
@@ -479,6 +504,15 @@ void notify_worker(notification_header const& header)
             hpx::util::osstream_get_string(strm));
     }
 
+    // pass on the notifications to the localities we are responsible for
+    // before doing anything else
+    if (!header.subtree.empty())
+    {
+        get_big_boot_barrier().notify_subtree(
+            naming::get_locality_id_from_gid(header.prefix), header
+          , header.subtree.begin(), header.subtree.end());
+    }
+
     util::runtime_configuration& cfg = rt.get_config();
     cfg.set_agas_locality(header.locality_ns_address.locality_);
 
@@ -704,6 +738,20 @@ inline std::size_t get_number_of_bootstrap_connections(
     return result;
 }
 
+inline std::size_t get_boot_barrier_arity(
+    util::runtime_configuration const& ini)
+{
+    if (ini.has_section("hpx.agas")) {
+        util::section const* sec = ini.get_section("hpx.agas");
+        if (NULL != sec) {
+            return boost::lexical_cast<std::size_t>(
+                sec->get_entry("boot_barrier_arity",
+                    HPX_INITIAL_AGAS_BOOT_BARRIER_ARITY));
+        }
+    }
+    return HPX_INITIAL_AGAS_BOOT_BARRIER_ARITY;
+}
+
 big_boot_barrier::big_boot_barrier(
     parcelset::parcelport& pp_
   , util::runtime_configuration const& ini_
@@ -715,6 +763,7 @@ big_boot_barrier::big_boot_barrier(
   , mtx()
   , connected(get_number_of_bootstrap_connections(ini_))
   , thunks(32)
+  , arity(get_boot_barrier_arity(ini_))
 {
     pp_.register_event_handler(&early_parcel_sink);
 }
@@ -743,6 +792,48 @@ void big_boot_barrier::apply_late(
     get_runtime().get_parcel_handler().put_parcel(p);
 } // }}}
 
+void big_boot_barrier::notify_subtree(
+    boost::uint32_t source_locality_id
+  , notification_header const& header
+  , std::vector<boot_tree_entry>::const_iterator first
+  , std::vector<boot_tree_entry>::const_iterator last
+) { // {{{
+    std::size_t const count = std::distance(first, last);
+    if (0 == count)
+        return;
+
+    // all localities are notified directly if no tree should be used
+    std::size_t const children = (arity < 2) ? count : (std::min)(arity, count);
+
+    notification_header hdr(header.prefix, header.locality_ns_address
+      , header.primary_ns_address, header.component_ns_address
+      , header.symbol_ns_address, header.num_localities, header.used_cores);
+#if defined(HPX_HAVE_SECURITY)
+    hdr.root_certificate = header.root_certificate;
+#endif
+
+    for (std::size_t i = 0; i != children; ++i)
+    {
+        // split the range into (almost) equally sized sub-ranges, the first
+        // locality of each sub-range forwards the notifications to the rest
+        std::vector<boot_tree_entry>::const_iterator begin =
+            first + (i * count) / children;
+        std::vector<boot_tree_entry>::const_iterator end =
+            first + ((i + 1) * count) / children;
+
+        hdr.prefix = begin->prefix;
+        hdr.used_cores = begin->used_cores;
+        hdr.subtree.assign(begin + 1, end);
+
+        apply(
+            source_locality_id
+          , naming::get_locality_id_from_gid(begin->prefix)
+          , naming::address(begin->locality)
+          , new actions::transfer_action<notify_worker_action>(
+                util::forward_as_tuple(hdr)));
+    }
+} // }}}
+
 void big_boot_barrier::wait_bootstrap()
 { // {{{
     HPX_ASSERT(service_mode_bootstrap == service_type);
@@ -821,6 +912,19 @@ void big_boot_barrier::notify()
     cond.notify_all();
 }
 
+namespace detail
+{
+    struct locality_id_less
+    {
+        bool operator()(boot_tree_entry const& lhs,
+            boot_tree_entry const& rhs) const
+        {
+            return naming::get_locality_id_from_gid(lhs.prefix) <
+                naming::get_locality_id_from_gid(rhs.prefix);
+        }
+    };
+}
+
 // This is triggered in runtime_impl::start, after the early action handler
 // has been replaced by the parcelhandler. We have to delay the notifications
 // until this point so that the AGAS locality can come up.
@@ -832,6 +936,24 @@ void big_boot_barrier::trigger()
 
         while (thunks.pop(p))
             (*p)();
+
+        std::vector<boot_tree_entry> entries;
+        {
+            boost::mutex::scoped_lock lk(mtx);
+            entries.swap(notifications);
+        }
+
+        if (!entries.empty())
+        {
+            // assign contiguous ranges of locality ids to the localities
+            // forwarding the notifications
+            std::sort(entries.begin(), entries.end(),
+                detail::locality_id_less());
+
+            notify_subtree(0
+              , make_notification_header(get_runtime(), naming::invalid_gid, 0)
+              , entries.begin(), entries.end());
+        }
     }
 }
 
@@ -187,6 +187,42 @@ namespace hpx { namespace applier
         app->get_thread_manager().register_work(data, state, ec);
     }
 
+    void register_work_nullary_bulk(
+        std::vector<util::unique_function_nonser<void()> > && funcs,
+        char const* desc, threads::thread_state_enum state,
+        threads::thread_priority priority, threads::thread_stacksize stacksize,
+        error_code& ec)
+    {
+        hpx::applier::applier* app = hpx::applier::get_applier_ptr();
+        if (NULL == app)
+        {
+            HPX_THROWS_IF(ec, invalid_status,
+                "hpx::applier::register_work_nullary_bulk",
+                "global applier object is not accessible");
+            return;
+        }
+
+        std::ptrdiff_t const stack_size = threads::get_stack_size(stacksize);
+
+        std::vector<threads::thread_init_data> data;
+        data.reserve(funcs.size());
+        for (util::unique_function_nonser<void()>& func: funcs)
+        {
+            data.push_back(threads::thread_init_data(
+                util::bind(util::one_shot(&thread_function_nullary),
+                    std::move(func)),
+                desc ? desc : "<unknown>", 0, priority, std::size_t(-1),
+                stack_size));
+        }
+        funcs.clear();
+
+        if (!data.empty())
+        {
+            app->get_thread_manager().register_work_bulk(
+                data.data(), data.size(), state, ec);
+        }
+    }
+
     void register_work(
         util::unique_function_nonser<void(threads::thread_state_ex_enum)> && func,
         char const* desc, threads::thread_state_enum state,
@@ -2038,17 +2038,6 @@ namespace hpx { namespace components { namespace server
             return false;
 
         try {
-            // get the handle of the library
-            error_code ec(lightweight);
-            hpx::util::plugin::dll d(lib.string(), HPX_MANGLE_STRING(plugin));
-
-            d.load_library(ec);
-            if (ec) {
-                LRT_(warning) << "dynamic loading failed: " << lib.string()
-                              << ": " << instance << ": " << get_error_what(ec);
-                return false;
-            }
-
             // initialize the factory instance using the preferences from the
             // ini files
             util::section const* glob_ini = NULL;
@@ -2060,12 +2049,24 @@ namespace hpx { namespace components { namespace server
             if (ini.has_section(plugin_section))
                 plugin_ini = ini.get_section(plugin_section);
 
+            // don't load the library if there is nothing to instantiate
             if (0 != plugin_ini &&
                 "0" != plugin_ini->get_entry("no_factory", "0"))
             {
                 return false;
             }
 
+            // get the handle of the library
+            error_code ec(lightweight);
+            hpx::util::plugin::dll d(lib.string(), HPX_MANGLE_STRING(plugin));
+
+            d.load_library(ec);
+            if (ec) {
+                LRT_(warning) << "dynamic loading failed: " << lib.string()
+                              << ": " << instance << ": " << get_error_what(ec);
+                return false;
+            }
+
             // get the factory
             hpx::util::plugin::plugin_factory<plugins::plugin_factory_base>
                 pf (d, "factory");
@@ -66,6 +66,9 @@ namespace hpx { namespace parcelset
         case connection_mpi:
             return "mpi";
 
+        case connection_shmem:
+            return "shmem";
+
         default:
             break;
         }
@@ -89,6 +92,9 @@ namespace hpx { namespace parcelset
         if (!std::strcmp(t.c_str(), "mpi"))
             return connection_mpi;
 
+        if (!std::strcmp(t.c_str(), "shmem"))
+            return connection_shmem;
+
         return connection_unknown;
     }
 
@@ -262,6 +268,17 @@ namespace hpx { namespace parcelset
         HPX_ASSERT(0 != pool);
 
 
+#if defined(HPX_HAVE_PARCELPORT_SHMEM)
+        std::string enable_shmem =
+            get_config_entry("hpx.parcel.shmem.enable", "0");
+
+        if (boost::lexical_cast<int>(enable_shmem))
+        {
+            attach_parcelport(parcelport::create(
+                connection_shmem, hpx::get_config(),
+                pool->get_on_start_thread(), pool->get_on_stop_thread()));
+        }
+#endif
 #if defined(HPX_HAVE_PARCELPORT_IPC)
         std::string enable_ipc =
             get_config_entry("hpx.parcel.ipc.enable", "0");
@@ -352,6 +369,11 @@ namespace hpx { namespace parcelset
         list_parcelport(strm, connection_mpi);
 #else
         list_parcelport(strm, connection_mpi, false);
+#endif
+#if defined(HPX_HAVE_PARCELPORT_SHMEM)
+        list_parcelport(strm, connection_shmem);
+#else
+        list_parcelport(strm, connection_shmem, false);
 #endif
     }
 
@@ -471,6 +493,22 @@ namespace hpx { namespace parcelset
     {
         connection_type dest_type = dest.get_type();
 
+#if defined(HPX_HAVE_PARCELPORT_SHMEM)
+        if (dest_type == connection_tcp || dest_type == connection_mpi) {
+            std::string enable_shmem =
+                get_config_entry("hpx.parcel.shmem.enable", "0");
+
+            // localities running on the same node exchange parcels through
+            // shared memory ring buffers
+            if (use_alternative_parcelports_ &&
+                dest.get_address() == here().get_address() &&
+                boost::lexical_cast<int>(enable_shmem))
+            {
+                if (pports_[connection_shmem])
+                    return connection_shmem;
+            }
+        }
+#endif
 #if defined(HPX_HAVE_PARCELPORT_IPC)
         if (dest_type == connection_tcp || dest_type == connection_mpi) {
             std::string enable_ipc =
@@ -936,6 +974,23 @@ namespace hpx { namespace parcelset
         return pp ? pp->get_connection_cache_statistics(stat_type, reset) : 0;
     }
 
+    // send queue statistics
+    std::size_t parcelhandler::get_pending_parcels_count(
+        connection_type pp_type, parcelport::parcel_lane lane, bool reset) const
+    {
+        error_code ec(lightweight);
+        parcelport* pp = find_parcelport(pp_type, ec);
+        return pp ? pp->get_pending_parcels_count(lane, reset) : 0;
+    }
+
+    boost::int64_t parcelhandler::get_pending_parcels_time(
+        connection_type pp_type, parcelport::parcel_lane lane, bool reset) const
+    {
+        error_code ec(lightweight);
+        parcelport* pp = find_parcelport(pp_type, ec);
+        return pp ? pp->get_pending_parcels_time(lane, reset) : 0;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     void parcelhandler::register_counter_types()
     {
@@ -950,6 +1005,9 @@ namespace hpx { namespace parcelset
 #if defined(HPX_HAVE_PARCELPORT_MPI)
         register_counter_types(connection_mpi);
 #endif
+#if defined(HPX_HAVE_PARCELPORT_SHMEM)
+        register_counter_types(connection_shmem);
+#endif
 
         // register common counters
         HPX_STD_FUNCTION<boost::int64_t(bool)> incoming_queue_length(
@@ -1237,6 +1295,9 @@ namespace hpx { namespace parcelset
         HPX_STD_FUNCTION<boost::int64_t(bool)> cache_reclaims(
             boost::bind(&parcelhandler::get_connection_cache_statistics,
                 this, pp_type, parcelport::connection_cache_reclaims, ::_1));
+        HPX_STD_FUNCTION<boost::int64_t(bool)> cache_wait_time(
+            boost::bind(&parcelhandler::get_connection_cache_statistics,
+                this, pp_type, parcelport::connection_cache_wait_time, ::_1));
 
         performance_counters::generic_counter_type_data const connection_cache_types[] =
         {
@@ -1294,10 +1355,87 @@ namespace hpx { namespace parcelset
                   _1, cache_reclaims, _2),
               &performance_counters::locality_counter_discoverer,
               ""
+            },
+            { boost::str(boost::format("/parcelport/time/%s/cache-wait-time") % connection_type_name),
+              performance_counters::counter_raw,
+              boost::str(boost::format("returns the overall time parcels had to "
+                  "wait for a connection to become available in the connection "
+                  "cache for the %s connection type on the referenced "
+                  "locality") % connection_type_name),
+              HPX_PERFORMANCE_COUNTER_V1,
+              boost::bind(&performance_counters::locality_raw_counter_creator,
+                  _1, cache_wait_time, _2),
+              &performance_counters::locality_counter_discoverer,
+              "ns"
             }
         };
         performance_counters::install_counter_types(connection_cache_types,
             sizeof(connection_cache_types)/sizeof(connection_cache_types[0]));
+
+        // register connection specific performance counters related to the
+        // lanes of the send queues
+        HPX_STD_FUNCTION<boost::int64_t(bool)> send_queue_length_normal(
+            boost::bind(&parcelhandler::get_pending_parcels_count,
+                this, pp_type, parcelport::parcel_lane_normal, ::_1));
+        HPX_STD_FUNCTION<boost::int64_t(bool)> send_queue_length_high(
+            boost::bind(&parcelhandler::get_pending_parcels_count,
+                this, pp_type, parcelport::parcel_lane_high, ::_1));
+        HPX_STD_FUNCTION<boost::int64_t(bool)> send_queue_time_normal(
+            boost::bind(&parcelhandler::get_pending_parcels_time,
+                this, pp_type, parcelport::parcel_lane_normal, ::_1));
+        HPX_STD_FUNCTION<boost::int64_t(bool)> send_queue_time_high(
+            boost::bind(&parcelhandler::get_pending_parcels_time,
+                this, pp_type, parcelport::parcel_lane_high, ::_1));
+
+        performance_counters::generic_counter_type_data const send_queue_types[] =
+        {
+            { boost::str(boost::format("/parcelport/length/%s/send-queue-normal") % connection_type_name),
+              performance_counters::counter_raw,
+              boost::str(boost::format("returns the number of parcels with normal "
+                  "priority waiting to be sent using the %s connection type on "
+                  "the referenced locality") % connection_type_name),
+              HPX_PERFORMANCE_COUNTER_V1,
+              boost::bind(&performance_counters::locality_raw_counter_creator,
+                  _1, send_queue_length_normal, _2),
+              &performance_counters::locality_counter_discoverer,
+              ""
+            },
+            { boost::str(boost::format("/parcelport/length/%s/send-queue-high") % connection_type_name),
+              performance_counters::counter_raw,
+              boost::str(boost::format("returns the number of parcels with high "
+                  "priority waiting to be sent using the %s connection type on "
+                  "the referenced locality") % connection_type_name),
+              HPX_PERFORMANCE_COUNTER_V1,
+              boost::bind(&performance_counters::locality_raw_counter_creator,
+                  _1, send_queue_length_high, _2),
+              &performance_counters::locality_counter_discoverer,
+              ""
+            },
+            { boost::str(boost::format("/parcelport/time/%s/send-queue-normal") % connection_type_name),
+              performance_counters::counter_raw,
+              boost::str(boost::format("returns the average time parcels with "
+                  "normal priority were waiting to be sent using the %s "
+                  "connection type on the referenced locality") % connection_type_name),
+              HPX_PERFORMANCE_COUNTER_V1,
+              boost::bind(&performance_counters::locality_raw_counter_creator,
+                  _1, send_queue_time_normal, _2),
+              &performance_counters::locality_counter_discoverer,
+              "ns"
+            },
+            { boost::str(boost::format("/parcelport/time/%s/send-queue-high") % connection_type_name),
+              performance_counters::counter_raw,
+              boost::str(boost::format("returns the average time parcels with "
+                  "high priority were waiting to be sent using the %s "
+                  "connection type on the referenced locality") % connection_type_name),
+              HPX_PERFORMANCE_COUNTER_V1,
+              boost::bind(&performance_counters::locality_raw_counter_creator,
+                  _1, send_queue_time_high, _2),
+              &performance_counters::locality_counter_discoverer,
+              "ns"
+            }
+        };
+        performance_counters::install_counter_types(send_queue_types,
+            sizeof(send_queue_types)/sizeof(send_queue_types[0]));
     }
 }}
 
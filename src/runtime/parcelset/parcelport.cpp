@@ -32,6 +32,11 @@
 #include <hpx/runtime/parcelset/policies/mpi/receiver.hpp>
 #include <hpx/runtime/parcelset/policies/mpi/sender.hpp>
 #endif
+#if defined(HPX_HAVE_PARCELPORT_SHMEM)
+#include <hpx/runtime/parcelset/policies/shmem/connection_handler.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/receiver.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/sender.hpp>
+#endif
 
 #include <hpx/runtime/parcelset/parcelport_impl.hpp>
 #include <hpx/util/io_service_pool.hpp>
@@ -94,6 +99,14 @@ namespace hpx { namespace parcelset
 #endif
 
             break;
+
+        case connection_shmem:
+#if defined(HPX_HAVE_PARCELPORT_SHMEM)
+            return return_type(
+                policies::shmem::connection_handler::runtime_configuration()
+              , true);
+#endif
+            break;
         default:
             break;
         }
@@ -187,6 +200,25 @@ namespace hpx { namespace parcelset
                 "unsupported connection type 'connection_mpi'");
             break;
 
+        case connection_shmem:
+#if defined(HPX_HAVE_PARCELPORT_SHMEM)
+            {
+                // Create shared memory based parcelport only if allowed by
+                // the configuration info.
+                std::string enable_shmem =
+                    cfg.get_entry("hpx.parcel.shmem.enable", "1");
+
+                if (boost::lexical_cast<int>(enable_shmem))
+                {
+                    return boost::make_shared<policies::shmem::connection_handler>(
+                        cfg, on_start_thread, on_stop_thread);
+                }
+            }
+#endif
+            HPX_THROW_EXCEPTION(bad_parameter, "parcelport::create",
+                "unsupported connection type 'connection_shmem'");
+            break;
+
         default:
             HPX_THROW_EXCEPTION(bad_parameter, "parcelport::create",
                 "unknown connection type");
@@ -208,6 +240,13 @@ namespace hpx { namespace parcelset
         async_serialization_(false),
         enable_parcel_handling_(true)
     {
+        for (std::size_t i = 0; i != parcel_lane_count; ++i)
+        {
+            num_pending_parcels_[i] = 0;
+            queue_time_[i] = 0;
+            num_dequeued_parcels_[i] = 0;
+        }
+
         std::string key("hpx.parcel.");
         key += type;
 
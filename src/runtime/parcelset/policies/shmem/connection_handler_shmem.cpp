@@ -0,0 +1,458 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/config/defines.hpp>
+
+#if defined(HPX_HAVE_PARCELPORT_SHMEM)
+
+#include <hpx/runtime/naming/locality.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/connection_handler.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/sender.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/receiver.hpp>
+#include <hpx/runtime/threads/thread.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/util/high_resolution_timer.hpp>
+#include <hpx/util/runtime_configuration.hpp>
+
+#include <boost/assign/std/vector.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx
+{
+    bool is_starting();
+}
+
+namespace hpx { namespace parcelset { namespace policies { namespace shmem
+{
+    namespace detail
+    {
+        // the name of the segment owned by the given locality
+        std::string segment_name(naming::locality const& l)
+        {
+            return "hpx.parcelport.shmem." + l.get_address() + "." +
+                boost::lexical_cast<std::string>(l.get_port());
+        }
+
+        std::size_t get_config_value(util::runtime_configuration const& ini,
+            char const* key, std::size_t dflt)
+        {
+            try {
+                return boost::lexical_cast<std::size_t>(
+                    ini.get_entry(key, dflt));
+            }
+            catch (boost::bad_lexical_cast const&) {
+                return dflt;
+            }
+        }
+
+        // the capacity of the ring buffers has to be a power of two
+        std::size_t round_to_power_of_two(std::size_t size)
+        {
+            std::size_t result = 1024;
+            while (result < size)
+                result <<= 1;
+            return result;
+        }
+    }
+
+    std::vector<std::string> connection_handler::runtime_configuration()
+    {
+        std::vector<std::string> lines;
+
+        using namespace boost::assign;
+        lines +=
+            "segment_size = ${HPX_PARCEL_SHMEM_SEGMENT_SIZE:268435456}",
+            "ring_buffer_size = ${HPX_PARCEL_SHMEM_RING_BUFFER_SIZE:1048576}",
+            "inline_message_size = ${HPX_PARCEL_SHMEM_INLINE_MESSAGE_SIZE:65536}",
+            "zero_copy_optimization = 0",
+            "io_pool_size = 1",
+            "use_io_pool = 1"
+            ;
+
+        return lines;
+    }
+
+    connection_handler::connection_handler(util::runtime_configuration const& ini,
+            HPX_STD_FUNCTION<void(std::size_t, char const*)> const& on_start_thread,
+            HPX_STD_FUNCTION<void()> const& on_stop_thread)
+      : base_type(ini, on_start_thread, on_stop_thread)
+      , mailbox_(0)
+      , segment_size_(detail::get_config_value(ini,
+            "hpx.parcel.shmem.segment_size", 268435456))
+      , ring_buffer_size_(detail::round_to_power_of_two(
+            detail::get_config_value(ini,
+                "hpx.parcel.shmem.ring_buffer_size", 1048576)))
+      , inline_message_size_(detail::get_config_value(ini,
+            "hpx.parcel.shmem.inline_message_size", 65536))
+      , mailbox_generation_(0)
+      , stopped_(false)
+      , handling_messages_(false)
+    {
+        // all data is copied into the ring buffer or the shared heap anyways
+        allow_zero_copy_optimizations_ = false;
+    }
+
+    connection_handler::~connection_handler()
+    {
+        if (segment_)
+        {
+            segment_.reset();
+            boost::interprocess::shared_memory_object::remove(
+                segment_name_.c_str());
+        }
+    }
+
+    bool connection_handler::do_run()
+    {
+        segment_name_ = detail::segment_name(here_);
+
+        try {
+            // remove a stale segment left behind by a previous run
+            boost::interprocess::shared_memory_object::remove(
+                segment_name_.c_str());
+
+            segment_.reset(new segment_type(boost::interprocess::create_only,
+                segment_name_.c_str(), segment_size_));
+            mailbox_ = segment_->construct<mailbox>(mailbox::name())();
+        }
+        catch (boost::interprocess::interprocess_exception const& e) {
+            HPX_THROW_EXCEPTION(network_error,
+                "shmem::connection_handler::run",
+                "could not create shared memory segment '" + segment_name_ +
+                    "': " + e.what());
+            return false;
+        }
+
+        receivers_.resize(mailbox::max_channels);
+
+        background_work();      // schedule message handler
+        return true;
+    }
+
+    void connection_handler::do_stop()
+    {
+        // Mark stopped state
+        stopped_ = true;
+        if (mailbox_)
+            mailbox_->stop();
+
+        // Wait until message handler returns
+        std::size_t k = 0;
+        while (handling_messages_)
+        {
+            hpx::lcos::local::spinlock::yield(k);
+            ++k;
+        }
+
+        {
+            hpx::lcos::local::spinlock::scoped_lock l(senders_mtx_);
+            senders_.clear();
+        }
+        {
+            hpx::lcos::local::spinlock::scoped_lock l(channels_mtx_);
+            channels_.clear();
+        }
+        receivers_.clear();
+    }
+
+    // Make sure all pending requests are handled
+    void connection_handler::background_work()
+    {
+        if (stopped_ || !segment_)
+            return;
+
+        // Atomically set handling_messages_ to true, if another work item
+        // hasn't started executing before us.
+        bool false_ = false;
+        if (!handling_messages_.compare_exchange_strong(false_, true))
+            return;
+
+        boost::asio::io_service& io_service = io_service_pool_.get_io_service();
+        io_service.post(util::bind(&connection_handler::handle_messages, this));
+    }
+
+    std::string connection_handler::get_locality_name() const
+    {
+        return "shmem";
+    }
+
+    boost::shared_ptr<channel> connection_handler::get_channel(
+        naming::locality const& l, error_code& ec)
+    {
+        {
+            hpx::lcos::local::spinlock::scoped_lock lk(channels_mtx_);
+            channels_type::iterator it = channels_.find(l);
+            if (it != channels_.end())
+                return it->second;
+        }
+
+        boost::shared_ptr<channel> ch = boost::make_shared<channel>(
+            ring_buffer_size_, inline_message_size_);
+
+        // Connect to the target locality, retry if needed as the destination
+        // might not have created its segment yet
+        std::string name(detail::segment_name(l));
+        boost::system::error_code error = boost::asio::error::try_again;
+        for (std::size_t i = 0; i < HPX_MAX_NETWORK_RETRIES; ++i)
+        {
+            ch->connect(name, error);
+            if (!error)
+                break;
+
+            // wait for a really short amount of time
+            if (hpx::threads::get_self_ptr())
+            {
+                this_thread::suspend(hpx::threads::pending,
+                    "connection_handler(shmem)::get_channel");
+            }
+        }
+
+        if (error)
+        {
+            hpx::util::osstream strm;
+            strm << error.message() << " (while trying to connect to: "
+                  << l << ")";
+            HPX_THROWS_IF(ec, network_error,
+                "shmem::connection_handler::get_channel",
+                hpx::util::osstream_get_string(strm));
+            return boost::shared_ptr<channel>();
+        }
+
+        // somebody else might have connected in the meantime
+        hpx::lcos::local::spinlock::scoped_lock lk(channels_mtx_);
+        std::pair<channels_type::iterator, bool> p =
+            channels_.insert(channels_type::value_type(l, ch));
+        return p.first->second;
+    }
+
+    boost::shared_ptr<sender> connection_handler::create_connection(
+        naming::locality const& l, error_code& ec)
+    {
+        boost::shared_ptr<channel> ch = get_channel(l, ec);
+        if (!ch)
+            return boost::shared_ptr<sender>();
+
+        if (&ec != &throws)
+            ec = make_success_code();
+
+        return boost::make_shared<sender>(ch, l, *this, this->parcels_sent_);
+    }
+
+    void connection_handler::enable_parcel_handling(bool new_state)
+    {
+        if (enable_parcel_handling_)
+        {
+            background_work();
+        }
+        else
+        {
+            // Wait until message handler returns
+            std::size_t k = 0;
+            while (handling_messages_)
+            {
+                hpx::lcos::local::spinlock::yield(k);
+                ++k;
+            }
+        }
+    }
+
+    void connection_handler::add_sender(
+        boost::shared_ptr<sender> const& sender_connection)
+    {
+        {
+            hpx::lcos::local::spinlock::scoped_lock l(senders_mtx_);
+            senders_.push_back(sender_connection);
+        }
+        background_work();
+    }
+
+    void add_sender(connection_handler & handler,
+        boost::shared_ptr<sender> const& sender_connection)
+    {
+        handler.add_sender(sender_connection);
+    }
+
+    // create receivers for the ring buffers newly announced in the mailbox
+    void connection_handler::accept_channels()
+    {
+        boost::uint32_t generation = mailbox_->generation();
+        if (generation == mailbox_generation_)
+            return;
+
+        mailbox_generation_ = generation;
+        for (std::size_t i = 0; i != mailbox::max_channels; ++i)
+        {
+            if (!receivers_[i] && mailbox_->ready(i))
+            {
+                ring_buffer* ring = static_cast<ring_buffer*>(
+                    segment_->get_address_from_handle(mailbox_->handle(i)));
+                receivers_[i] = boost::make_shared<receiver>(
+                    boost::ref(*segment_), ring,
+                    this->get_max_message_size(), boost::ref(*this));
+            }
+        }
+    }
+
+    namespace detail
+    {
+        struct handling_messages
+        {
+            handling_messages(boost::atomic<bool>& handling_messages_flag)
+              : handling_messages_(handling_messages_flag)
+            {}
+
+            ~handling_messages()
+            {
+                handling_messages_.store(false);
+            }
+
+            boost::atomic<bool>& handling_messages_;
+        };
+    }
+
+    void connection_handler::handle_messages()
+    {
+        detail::handling_messages hm(handling_messages_);       // reset on exit
+
+        bool bootstrapping = hpx::is_starting();
+        bool has_work = true;
+        std::size_t k = 0;
+
+        hpx::util::high_resolution_timer t;
+
+        // We let the message handling loop spin for another 2 seconds to
+        // avoid the costs involved with posting it to asio
+        while (bootstrapping || (!stopped_ && has_work) ||
+            (!has_work && t.elapsed() < 2.0))
+        {
+            // break the loop if someone requested to pause the parcelport
+            if (!enable_parcel_handling_ || stopped_)
+                break;
+
+            // retry sending the messages which didn't fit before
+            {
+                hpx::lcos::local::spinlock::scoped_lock l(senders_mtx_);
+                for (senders_type::iterator it = senders_.begin();
+                     it != senders_.end(); /**/)
+                {
+                    if ((*it)->done())
+                        it = senders_.erase(it);
+                    else
+                        ++it;
+                }
+                has_work = !senders_.empty();
+            }
+
+            // handle new incoming connections
+            accept_channels();
+
+            // receive messages, release the ring buffers of the localities
+            // which have gone away
+            for (std::size_t i = 0; i != mailbox::max_channels; ++i)
+            {
+                boost::shared_ptr<receiver>& rcv = receivers_[i];
+                if (!rcv)
+                    continue;
+
+                if (rcv->receive(16))
+                {
+                    has_work = true;
+                }
+                else if (rcv->done())
+                {
+                    segment_->deallocate(rcv->ring());
+                    mailbox_->release(i);
+                    rcv.reset();
+                }
+            }
+
+            if (bootstrapping)
+                bootstrapping = hpx::is_starting();
+
+            if (has_work)
+            {
+                t.restart();
+                k = 0;
+            }
+            else
+            {
+                hpx::lcos::local::spinlock::yield(k);
+                ++k;
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool receiver::receive(std::size_t max_messages)
+    {
+        std::size_t count = 0;
+        ring_buffer::message_header h;
+        while (count != max_messages && ring_->front(h))
+        {
+            ++count;
+
+            char* heap_data = 0;
+            if (h.type_ == ring_buffer::message_heap)
+            {
+                heap_data = static_cast<char*>(
+                    segment_.get_address_from_handle(h.handle_));
+            }
+
+            if (h.size_ > max_inbound_size_)
+            {
+                // report this problem and drop the message
+                LPT_(error)
+                    << "shmem receiver: the size of this message exceeds "
+                       "the maximum inbound data size";
+
+                if (heap_data)
+                    segment_.deallocate(heap_data);
+                ring_->pop(h);
+                continue;
+            }
+
+            buffer_ = get_buffer();
+            buffer_->clear();
+
+            // Store the time of the begin of the read operation
+            performance_counters::parcels::data_point& data =
+                buffer_->data_point_;
+            data.time_ = timer_.elapsed_nanoseconds();
+            data.serialization_time_ = 0;
+            data.bytes_ = static_cast<std::size_t>(h.size_);
+            data.num_parcels_ = 0;
+
+            std::size_t size = static_cast<std::size_t>(h.size_);
+            buffer_->data_.resize(size);
+            if (heap_data)
+            {
+                std::memcpy(buffer_->data_.data(), heap_data, size);
+                segment_.deallocate(heap_data);
+            }
+            else if (size != 0)
+            {
+                ring_->read_data(buffer_->data_.data(), size);
+            }
+
+            // make the space available to the sender as early as possible
+            ring_->pop(h);
+
+            buffer_->data_size_ = size;
+            buffer_->size_ = size;
+
+            data.time_ = timer_.elapsed_nanoseconds() - data.time_;
+
+            // decode the received parcels.
+            decode_parcels(parcelport_, *this, buffer_);
+        }
+        return count != 0;
+    }
+}}}}
+
+#endif
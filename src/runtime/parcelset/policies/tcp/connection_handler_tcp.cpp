@@ -12,6 +12,7 @@
 #if defined(HPX_HAVE_PARCELPORT_TCP)
 
 #include <hpx/exception_list.hpp>
+#include <hpx/lcos/local/promise.hpp>
 #include <hpx/runtime/naming/locality.hpp>
 #include <hpx/runtime/parcelset/policies/tcp/connection_handler.hpp>
 #include <hpx/runtime/parcelset/policies/tcp/sender.hpp>
@@ -20,15 +21,74 @@
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ip/host_name.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/shared_ptr.hpp>
 
 namespace hpx { namespace parcelset { namespace policies { namespace tcp
 {
+    namespace detail
+    {
+        std::size_t get_config_value(util::runtime_configuration const& ini,
+            char const* key, std::size_t dflt)
+        {
+            try {
+                return boost::lexical_cast<std::size_t>(
+                    ini.get_entry(key, dflt));
+            }
+            catch (boost::bad_lexical_cast const&) {
+                return dflt;
+            }
+        }
+
+        struct read_handler
+        {
+            explicit read_handler(
+                    lcos::local::promise<boost::system::error_code>& p)
+              : p_(p)
+            {}
+
+            void operator()(boost::system::error_code const& e, std::size_t)
+            {
+                p_.set_value(e);
+            }
+
+            lcos::local::promise<boost::system::error_code>& p_;
+        };
+
+        // Read the whole buffer from the given socket. The read operation is
+        // performed by the io_service, an HPX thread calling this is
+        // suspended while waiting for the data instead of blocking its
+        // worker thread.
+        template <typename Buffer>
+        void read(boost::asio::ip::tcp::socket& s, Buffer const& buffer,
+            boost::system::error_code& error)
+        {
+            if (0 == threads::get_self_ptr())
+            {
+                boost::asio::read(s, buffer, error);
+                return;
+            }
+
+            lcos::local::promise<boost::system::error_code> p;
+            future<boost::system::error_code> f = p.get_future();
+
+            boost::asio::async_read(s, buffer, read_handler(p));
+            error = f.get();
+        }
+    }
+
     connection_handler::connection_handler(util::runtime_configuration const& ini,
             HPX_STD_FUNCTION<void(std::size_t, char const*)> const& on_start_thread,
             HPX_STD_FUNCTION<void()> const& on_stop_thread)
       : base_type(ini, on_start_thread, on_stop_thread)
       , acceptor_(NULL)
+      , next_rail_id_(0)
+      , rails_((std::max)(std::size_t(1),
+            detail::get_config_value(ini, "hpx.parcel.tcp.rails", 1)))
+      , rail_threshold_(detail::get_config_value(ini,
+            "hpx.parcel.tcp.rail_threshold", 1048576))
     {
         /*
         if (here_.get_type() != connection_tcp) {
@@ -110,6 +170,7 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
             }
 
             accepted_connections_.clear();
+            rail_owners_.clear();
 #if defined(HPX_HOLDON_TO_OUTGOING_CONNECTIONS)
             write_connections_.clear();
 #endif
@@ -125,6 +186,99 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
         }
     }
 
+    // Connect the given socket to the target locality, retry if needed
+    void connection_handler::connect(boost::asio::io_service& io_service,
+        boost::asio::ip::tcp::socket& s, naming::locality const& l,
+        boost::system::error_code& error)
+    {
+        error = boost::asio::error::try_again;
+        for (std::size_t i = 0; i < HPX_MAX_NETWORK_RETRIES; ++i)
+        {
+            naming::locality::iterator_type end = connect_end(l);
+            for (naming::locality::iterator_type it =
+                    connect_begin(l, io_service);
+                  it != end; ++it)
+            {
+                s.close();
+                s.connect(*it, error);
+                if (!error)
+                    break;
+            }
+            if (!error)
+                break;
+
+            // wait for a really short amount of time
+            if (hpx::threads::get_self_ptr()) {
+                this_thread::suspend(hpx::threads::pending,
+                    "connection_handler(tcp)::create_connection");
+            }
+            else {
+                boost::this_thread::sleep(boost::get_system_time() +
+                    boost::posix_time::milliseconds(
+                        HPX_NETWORK_RETRIES_SLEEP));
+            }
+        }
+    }
+
+    // Announce the new connection to the target locality and establish
+    // the additional connections used for striping large messages
+    void connection_handler::connect_rails(
+        boost::asio::io_service& io_service,
+        boost::shared_ptr<sender> const& sender_connection,
+        naming::locality const& l, boost::system::error_code& error)
+    {
+        boost::asio::ip::tcp::socket& s = sender_connection->socket();
+
+        if (rails_ <= 1)
+        {
+            connection_header header;
+            boost::asio::write(s,
+                boost::asio::buffer(&header, sizeof(header)), error);
+            return;
+        }
+
+        // the primary connection gets an id assigned by the receiving side
+        connection_header header(connection_header::primary_with_rails, 0, 0);
+        boost::asio::write(s,
+            boost::asio::buffer(&header, sizeof(header)), error);
+        if (error)
+            return;
+
+        boost::integer::ulittle64_t id(0);
+        detail::read(s, boost::asio::buffer(&id, sizeof(id)), error);
+        if (error)
+            return;
+
+        // all rails refer to this id
+        for (std::size_t i = 1; i != rails_; ++i)
+        {
+            sender::rail_type rail(
+                new boost::asio::ip::tcp::socket(io_service));
+
+            connect(io_service, *rail, l, error);
+            if (error)
+                return;
+
+            connection_header rail_header(connection_header::rail,
+                static_cast<boost::uint32_t>(i), id);
+            boost::asio::write(*rail,
+                boost::asio::buffer(&rail_header, sizeof(rail_header)), error);
+            if (error)
+                return;
+
+            bool ack = false;
+            detail::read(*rail,
+                boost::asio::buffer(&ack, sizeof(ack)), error);
+            if (error)
+                return;
+
+            rail->set_option(boost::asio::ip::tcp::no_delay(true));
+            rail->set_option(boost::asio::socket_base::linger(true, 0));
+
+            sender_connection->add_rail(rail);
+        }
+    }
+
     boost::shared_ptr<sender> connection_handler::create_connection(
         naming::locality const& l, error_code& ec)
     {
@@ -133,46 +287,22 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
         // The parcel gets serialized inside the connection constructor, no
         // need to keep the original parcel alive after this call returned.
         boost::shared_ptr<sender> sender_connection(new sender(
-            io_service, l, this->parcels_sent_));
+            io_service, l, this->parcels_sent_, rail_threshold_));
 
         // Connect to the target locality, retry if needed
-        boost::system::error_code error = boost::asio::error::try_again;
-        for (std::size_t i = 0; i < HPX_MAX_NETWORK_RETRIES; ++i)
-        {
-            try {
-                naming::locality::iterator_type end = connect_end(l);
-                for (naming::locality::iterator_type it =
-                        connect_begin(l, io_service);
-                      it != end; ++it)
-                {
-                    boost::asio::ip::tcp::socket& s = sender_connection->socket();
-                    s.close();
-                    s.connect(*it, error);
-                    if (!error)
-                        break;
-                }
-                if (!error)
-                    break;
-
-                // wait for a really short amount of time
-                if (hpx::threads::get_self_ptr()) {
-                    this_thread::suspend(hpx::threads::pending,
-                        "connection_handler(tcp)::create_connection");
-                }
-                else {
-                    boost::this_thread::sleep(boost::get_system_time() +
-                        boost::posix_time::milliseconds(
-                            HPX_NETWORK_RETRIES_SLEEP));
-                }
-            }
-            catch (boost::system::system_error const& e) {
-                sender_connection->socket().close();
-                sender_connection.reset();
+        boost::system::error_code error;
+        try {
+            connect(io_service, sender_connection->socket(), l, error);
+            if (!error)
+                connect_rails(io_service, sender_connection, l, error);
+        }
+        catch (boost::system::system_error const& e) {
+            sender_connection->socket().close();
+            sender_connection.reset();
 
-                HPX_THROWS_IF(ec, network_error,
-                    "tcp::connection_handler::get_connection", e.what());
-                return sender_connection;
-            }
+            HPX_THROWS_IF(ec, network_error,
+                "tcp::connection_handler::get_connection", e.what());
+            return sender_connection;
         }
 
         if (error) {
@@ -244,10 +374,9 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
             s.set_option(boost::asio::ip::tcp::no_delay(true));
             s.set_option(boost::asio::socket_base::linger(true, 0));
 
-            // now accept the incoming connection by starting to read from the
-            // socket
-            c->async_read(
-                boost::bind(&connection_handler::handle_read_completion,
+            // the other end announces the kind of the new connection first
+            c->async_read_connection_header(
+                boost::bind(&connection_handler::handle_read_connection_header,
                     this,
                     boost::asio::placeholders::error, c));
         }
@@ -259,6 +388,113 @@ namespace hpx { namespace parcelset { namespace policies { namespace tcp
         }
     }
 
+    // Handle completion of reading the connection header.
+    void connection_handler::handle_read_connection_header(
+        boost::system::error_code const& e,
+        boost::shared_ptr<receiver> receiver_conn)
+    {
+        if (e) {
+            handle_read_completion(e, receiver_conn);
+            return;
+        }
+
+        connection_header const& header = receiver_conn->get_connection_header();
+        switch (static_cast<boost::uint32_t>(header.kind_))
+        {
+        case connection_header::primary:
+            break;
+
+        case connection_header::primary_with_rails:
+            {
+                // assign a new id to this connection and send it back,
+                // the rails use it to refer to this connection
+                boost::uint64_t id = 0;
+                {
+                    lcos::local::spinlock::scoped_lock l(connections_mtx_);
+
+                    rail_owners_map::iterator it = rail_owners_.begin();
+                    while (it != rail_owners_.end())
+                    {
+                        if (it->second.expired())
+                            rail_owners_.erase(it++);
+                        else
+                            ++it;
+                    }
+
+                    id = ++next_rail_id_;
+                    rail_owners_[id] = receiver_conn;
+                }
+
+                receiver_conn->async_write_rail_id(id,
+                    boost::bind(&connection_handler::handle_write_rail_id,
+                        this,
+                        boost::asio::placeholders::error, receiver_conn));
+            }
+            return;
+
+        case connection_header::rail:
+            {
+                // attach this rail to its primary connection, the data
+                // received over a rail is read by the primary connection
+                boost::shared_ptr<receiver> owner;
+                {
+                    lcos::local::spinlock::scoped_lock l(connections_mtx_);
+                    rail_owners_map::iterator it =
+                        rail_owners_.find(header.id_);
+                    if (it != rail_owners_.end())
+                        owner = it->second.lock();
+                }
+
+                if (!owner) {
+                    handle_read_completion(
+                        boost::asio::error::make_error_code(
+                            boost::asio::error::not_found),
+                        receiver_conn);
+                    return;
+                }
+
+                owner->attach_rail(receiver_conn);
+                receiver_conn->async_write_rail_ack(
+                    boost::bind(&connection_handler::handle_read_completion,
+                        this,
+                        boost::asio::placeholders::error, receiver_conn));
+            }
+            return;
+
+        default:
+            handle_read_completion(
+                boost::asio::error::make_error_code(
+                    boost::asio::error::operation_not_supported),
+                receiver_conn);
+            return;
+        }
+
+        // now accept the incoming connection by starting to read from the
+        // socket
+        receiver_conn->async_read(
+            boost::bind(&connection_handler::handle_read_completion,
+                this,
+                boost::asio::placeholders::error, receiver_conn));
+    }
+
+    // Handle completion of sending the id of a primary connection with rails.
+    void connection_handler::handle_write_rail_id(
+        boost::system::error_code const& e,
+        boost::shared_ptr<receiver> receiver_conn)
+    {
+        if (e) {
+            handle_read_completion(e, receiver_conn);
+            return;
+        }
+
+        // now accept the incoming connection by starting to read from the
+        // socket
+        receiver_conn->async_read(
+            boost::bind(&connection_handler::handle_read_completion,
+                this,
+                boost::asio::placeholders::error, receiver_conn));
+    }
+
     // Handle completion of a read operation.
     void connection_handler::handle_read_completion(
         boost::system::error_code const& e,
@@ -310,9 +310,13 @@ namespace hpx { namespace threads { namespace executors { namespace detail
 
             boost::int64_t executed_threads = 0, executed_thread_phases = 0;
             boost::uint64_t overall_times = 0, thread_times = 0;
+
+            // this scheduling loop runs inside an HPX thread, it must not
+            // park the worker thread it is running on
             threads::detail::scheduling_loop(virt_core, scheduler_,
                 states_[virt_core], executed_threads, executed_thread_phases,
-                overall_times, thread_times, &suspend_back_into_calling_context);
+                overall_times, thread_times, &suspend_back_into_calling_context,
+                false);
 
 #if HPX_DEBUG != 0
             // the scheduling_loop is allowed to exit only if no more HPX
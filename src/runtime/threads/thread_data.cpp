@@ -11,6 +11,7 @@
 #include <hpx/runtime/threads/threadmanager.hpp>
 #include <hpx/runtime/threads/thread_data.hpp>
 #include <hpx/util/assert.hpp>
+#include <hpx/util/thread_specific_ptr.hpp>
 #include <hpx/util/coroutine/detail/coroutine_impl_impl.hpp>
 
 // #if HPX_DEBUG
@@ -154,13 +155,59 @@ namespace hpx { namespace threads
         return false;
     }
 
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        struct running_stackless_tag {};
+
+        // holds the stackless thread currently executed by this OS thread
+        util::thread_specific_ptr<
+            thread_data_base*, running_stackless_tag
+        > running_stackless_;
+
+        thread_data_base* set_running_stackless(thread_data_base* thrd)
+        {
+            thread_data_base** p = running_stackless_.get();
+            if (0 == p)
+            {
+                if (0 == thrd)
+                    return 0;
+
+                running_stackless_.reset(new thread_data_base*(0));
+                p = running_stackless_.get();
+            }
+
+            thread_data_base* prev = *p;
+            *p = thrd;
+            return prev;
+        }
+
+        thread_data_base* get_running_stackless()
+        {
+            thread_data_base** p = running_stackless_.get();
+            return 0 == p ? 0 : *p;
+        }
+
+        char const* get_null_self_message()
+        {
+            if (0 != get_running_stackless())
+            {
+                return "attempting to suspend a stackless thread (created "
+                    "with launch::stackless or thread_stacksize_nostack), "
+                    "stackless threads have to run to completion";
+            }
+            return "NULL thread id encountered (is this executed on a "
+                "HPX-thread?)";
+        }
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     thread_self& get_self()
     {
         thread_self* p = get_self_ptr();
         if (HPX_UNLIKELY(!p)) {
             HPX_THROW_EXCEPTION(null_thread_id, "threads::get_self",
-                "NULL thread id encountered (is this executed on a HPX-thread?)");
+                detail::get_null_self_message());
         }
         return *p;
     }
@@ -182,7 +229,7 @@ namespace hpx { namespace threads
         if (HPX_UNLIKELY(!p))
         {
             HPX_THROWS_IF(ec, null_thread_id, "threads::get_self_ptr_checked",
-                "NULL thread id encountered (is this executed on a HPX-thread?)");
+                detail::get_null_self_message());
             return 0;
         }
 
@@ -153,6 +153,40 @@ namespace hpx { namespace threads
         return app->get_thread_manager().get_stack_size(id);
     }
 
+    boost::uint64_t get_thread_deadline(thread_id_type const& id,
+        error_code& ec)
+    {
+        if (HPX_UNLIKELY(!id))
+        {
+            HPX_THROWS_IF(ec, null_thread_id,
+                "hpx::threads::get_thread_deadline",
+                "NULL thread id encountered");
+            return 0;
+        }
+
+        if (&ec != &throws)
+            ec = make_success_code();
+
+        return id->get_deadline();
+    }
+
+    void set_thread_deadline(thread_id_type const& id,
+        boost::uint64_t deadline, error_code& ec)
+    {
+        if (HPX_UNLIKELY(!id))
+        {
+            HPX_THROWS_IF(ec, null_thread_id,
+                "hpx::threads::set_thread_deadline",
+                "NULL thread id encountered");
+            return;
+        }
+
+        if (&ec != &throws)
+            ec = make_success_code();
+
+        id->set_deadline(deadline);
+    }
+
     void interrupt_thread(thread_id_type const& id, bool flag, error_code& ec)
     {
         hpx::applier::applier* app = hpx::applier::get_applier_ptr();
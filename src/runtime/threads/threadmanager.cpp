@@ -250,6 +250,26 @@ namespace hpx { namespace threads
         detail::create_work(&scheduler_, data, initial_state, ec);
     }
 
+    template <typename SchedulingPolicy, typename NotificationPolicy>
+    void threadmanager_impl<SchedulingPolicy, NotificationPolicy>::
+        register_work_bulk(thread_init_data* data, std::size_t count,
+            thread_state_enum initial_state, error_code& ec)
+    {
+        util::block_profiler_wrapper<register_work_tag> bp(work_logger_);
+
+        // verify state
+        if ((thread_count_ == 0 && state_ != running))
+        {
+            // thread-manager is not currently running
+            HPX_THROWS_IF(ec, invalid_status,
+                "threadmanager_impl::register_work_bulk",
+                "invalid state: thread manager is not running");
+            return;
+        }
+
+        detail::create_work_bulk(&scheduler_, data, count, initial_state, ec);
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     /// The set_state function is part of the thread related API and allows
     /// to change the state of one of the threads managed by this threadmanager_impl
@@ -1191,6 +1211,42 @@ namespace hpx { namespace threads
                   static_cast<std::size_t>(paths.instanceindex_), _1),
               "worker-thread", shepherd_count
             },
+            // /threads{locality#%d/total}/count/timers-armed
+            // /threads{locality#%d/worker-thread%d}/count/timers-armed
+            { "count/timers-armed",
+              util::bind(&spt::get_num_timers_armed, &scheduler_,
+                  std::size_t(-1), _1),
+              util::bind(&spt::get_num_timers_armed, &scheduler_,
+                  static_cast<std::size_t>(paths.instanceindex_), _1),
+              "worker-thread", shepherd_count
+            },
+            // /threads{locality#%d/total}/count/timers-fired
+            // /threads{locality#%d/worker-thread%d}/count/timers-fired
+            { "count/timers-fired",
+              util::bind(&spt::get_num_timers_fired, &scheduler_,
+                  std::size_t(-1), _1),
+              util::bind(&spt::get_num_timers_fired, &scheduler_,
+                  static_cast<std::size_t>(paths.instanceindex_), _1),
+              "worker-thread", shepherd_count
+            },
+            // /threads{locality#%d/total}/count/timers-cancelled
+            // /threads{locality#%d/worker-thread%d}/count/timers-cancelled
+            { "count/timers-cancelled",
+              util::bind(&spt::get_num_timers_cancelled, &scheduler_,
+                  std::size_t(-1), _1),
+              util::bind(&spt::get_num_timers_cancelled, &scheduler_,
+                  static_cast<std::size_t>(paths.instanceindex_), _1),
+              "worker-thread", shepherd_count
+            },
+            // /threads{locality#%d/total}/count/deadline-misses
+            // /threads{locality#%d/worker-thread%d}/count/deadline-misses
+            { "count/deadline-misses",
+              util::bind(&spt::get_num_deadline_misses, &scheduler_,
+                  std::size_t(-1), _1),
+              util::bind(&spt::get_num_deadline_misses, &scheduler_,
+                  static_cast<std::size_t>(paths.instanceindex_), _1),
+              "worker-thread", shepherd_count
+            },
             // /threads{locality#%d/total}/count/stack-recycles
             { "count/stack-recycles",
               util::bind(&coroutine_type::impl_type::get_stack_recycle_count, _1),
@@ -1399,6 +1455,36 @@ namespace hpx { namespace threads
               &performance_counters::locality_thread_counter_discoverer,
               ""
             },
+            { "/threads/count/timers-armed", performance_counters::counter_raw,
+              "returns the overall number of timers armed for timed suspension "
+              "of HPX-threads at the referenced locality",
+              HPX_PERFORMANCE_COUNTER_V1, counts_creator,
+              &performance_counters::locality_thread_counter_discoverer,
+              ""
+            },
+            { "/threads/count/timers-fired", performance_counters::counter_raw,
+              "returns the overall number of expired timers which woke up an "
+              "HPX-thread at the referenced locality",
+              HPX_PERFORMANCE_COUNTER_V1, counts_creator,
+              &performance_counters::locality_thread_counter_discoverer,
+              ""
+            },
+            { "/threads/count/timers-cancelled", performance_counters::counter_raw,
+              "returns the overall number of timers which were cancelled as "
+              "the HPX-thread was resumed or terminated before the timer "
+              "expired at the referenced locality",
+              HPX_PERFORMANCE_COUNTER_V1, counts_creator,
+              &performance_counters::locality_thread_counter_discoverer,
+              ""
+            },
+            { "/threads/count/deadline-misses", performance_counters::counter_raw,
+              "returns the overall number of HPX-threads which finished running "
+              "after their deadline had passed at the referenced locality "
+              "(always zero for schedulers not aware of deadlines)",
+              HPX_PERFORMANCE_COUNTER_V1, counts_creator,
+              &performance_counters::locality_thread_counter_discoverer,
+              ""
+            },
             { "/threads/count/stack-recycles", performance_counters::counter_raw,
               "returns the total number of HPX-thread recycling operations performed "
               "for the referenced locality", HPX_PERFORMANCE_COUNTER_V1,
@@ -1471,13 +1557,6 @@ namespace hpx { namespace threads
             counter_types, sizeof(counter_types)/sizeof(counter_types[0]));
     }
 
-    template <typename SchedulingPolicy, typename NotificationPolicy>
-    void threadmanager_impl<SchedulingPolicy, NotificationPolicy>::
-        idle_callback(std::size_t num_thread)
-    {
-        scheduler_.idle_callback(num_thread);
-    }
-
     ///////////////////////////////////////////////////////////////////////////
     template <typename SchedulingPolicy, typename NotificationPolicy>
     void threadmanager_impl<SchedulingPolicy, NotificationPolicy>::
@@ -1491,8 +1570,7 @@ namespace hpx { namespace threads
         // run main scheduling loop until terminated
         detail::scheduling_loop(num_thread, scheduler_, state_,
             executed_threads_[num_thread], executed_thread_phases_[num_thread],
-            tfunc_times[num_thread], exec_times[num_thread],
-            util::bind(&threadmanager_impl::idle_callback, this, num_thread));
+            tfunc_times[num_thread], exec_times[num_thread]);
 
 #if HPX_DEBUG != 0
         // the OS thread is allowed to exit only if no more HPX threads exist
@@ -1809,3 +1887,10 @@ template class HPX_EXPORT hpx::threads::threadmanager_impl<
     hpx::threads::policies::callback_notifier>;
 #endif
 
+#if defined(HPX_DEADLINE_SCHEDULER)
+#include <hpx/runtime/threads/policies/deadline_queue_scheduler.hpp>
+template class HPX_EXPORT hpx::threads::threadmanager_impl<
+    hpx::threads::policies::deadline_queue_scheduler<>,
+    hpx::threads::policies::callback_notifier>;
+#endif
+
@@ -732,3 +732,10 @@ template class HPX_EXPORT hpx::runtime_impl<
     hpx::threads::policies::callback_notifier>;
 #endif
 
+#if defined(HPX_DEADLINE_SCHEDULER)
+#include <hpx/runtime/threads/policies/deadline_queue_scheduler.hpp>
+template class HPX_EXPORT hpx::runtime_impl<
+    hpx::threads::policies::deadline_queue_scheduler<>,
+    hpx::threads::policies::callback_notifier>;
+#endif
+
@@ -0,0 +1,398 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/util/binary_log.hpp>
+
+#if !defined(HPX_NO_LOGGING)
+
+#include <hpx/runtime.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+#include <hpx/util/logging.hpp>
+#include <hpx/util/static.hpp>
+#include <hpx/util/scoped_unlock.hpp>
+#include <hpx/util/thread_specific_ptr.hpp>
+
+#include <boost/format.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace util { namespace binary_log
+{
+    namespace detail
+    {
+        boost::atomic<unsigned> level(
+            static_cast<unsigned>(logging::level::disable_all));
+
+        ///////////////////////////////////////////////////////////////////////
+        // Single producer, single consumer ring buffer of log records. The
+        // producer is the OS thread owning the buffer, the consumer is the OS
+        // thread writing the records.
+        class ring_buffer : boost::noncopyable
+        {
+        public:
+            ring_buffer(std::size_t size, std::string const& name)
+              : records_(size), mask_(size - 1), head_(0), tail_(0),
+                released_(false), name_(name)
+            {
+                HPX_ASSERT(size != 0 && (size & mask_) == 0);
+            }
+
+            bool push(record const& r)
+            {
+                std::size_t head = head_.load(boost::memory_order_relaxed);
+                if (head - tail_.load(boost::memory_order_acquire) ==
+                    records_.size())
+                {
+                    return false;       // buffer is full
+                }
+
+                records_[head & mask_] = r;
+                head_.store(head + 1, boost::memory_order_release);
+                return true;
+            }
+
+            template <typename F>
+            std::size_t consume(F const& f)
+            {
+                std::size_t tail = tail_.load(boost::memory_order_relaxed);
+                std::size_t head = head_.load(boost::memory_order_acquire);
+
+                for (std::size_t i = tail; i != head; ++i)
+                {
+                    f(records_[i & mask_], name_);
+
+                    // make the slot available as early as possible
+                    tail_.store(i + 1, boost::memory_order_release);
+                }
+                return head - tail;
+            }
+
+            bool empty() const
+            {
+                return head_.load(boost::memory_order_acquire) ==
+                    tail_.load(boost::memory_order_acquire);
+            }
+
+            void release()
+            {
+                released_.store(true, boost::memory_order_release);
+            }
+
+            bool released() const
+            {
+                return released_.load(boost::memory_order_acquire);
+            }
+
+        private:
+            std::vector<record> records_;
+            std::size_t const mask_;
+            boost::atomic<std::size_t> head_;   // next slot to write
+            boost::atomic<std::size_t> tail_;   // next slot to read
+            boost::atomic<bool> released_;
+            std::string const name_;            // name of the owning thread
+        };
+
+        typedef boost::shared_ptr<ring_buffer> ring_buffer_ptr;
+
+        struct ring_buffer_tag {};
+        util::thread_specific_ptr<ring_buffer_ptr, ring_buffer_tag>
+            thread_buffer_;
+
+        // mark the buffer of the calling OS thread as released, it will be
+        // deleted as soon as all of its records have been written
+        void release_buffer()
+        {
+            ring_buffer_ptr* p = thread_buffer_.get();
+            if (0 != p)
+            {
+                (*p)->release();
+                thread_buffer_.reset();
+            }
+        }
+
+        // OS threads which are not managed by the runtime never call
+        // release_thread_buffer(), their buffers are released by the cleanup
+        // function of this (non-owning) pointer when they exit
+        void release_buffer_on_exit(ring_buffer*)
+        {
+            release_buffer();
+        }
+
+        boost::thread_specific_ptr<ring_buffer> thread_exit_hook_(
+            &release_buffer_on_exit);
+
+        ///////////////////////////////////////////////////////////////////////
+        std::string format_record(record const& r,
+            std::string const& thread_name)
+        {
+            boost::format fmt(r.format);
+            fmt.exceptions(boost::io::no_error_bits);
+
+            for (std::size_t i = 0; i != r.num_args; ++i)
+            {
+                switch (r.types[i]) {
+                case argument_signed:
+                    fmt % static_cast<boost::int64_t>(r.args[i]);
+                    break;
+
+                case argument_unsigned:
+                    fmt % r.args[i];
+                    break;
+
+                case argument_floating_point:
+                    {
+                        union { double d; boost::uint64_t u; } value;
+                        value.u = r.args[i];
+                        fmt % value.d;
+                    }
+                    break;
+
+                case argument_pointer:
+                    fmt % reinterpret_cast<void const*>(r.args[i]);
+                    break;
+
+                default:
+                    HPX_ASSERT(false);
+                    break;
+                }
+            }
+
+            return boost::str(boost::format("%1%%2%{%3%} %4% %5%")
+                % levelname(static_cast<int>(r.level)) % r.category
+                % thread_name % r.timestamp % fmt);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        class logger : boost::noncopyable
+        {
+        public:
+            logger()
+              : dropped_(0), buffer_size_(0), write_(0), stopping_(false)
+            {}
+
+            ~logger()
+            {
+                stop();
+            }
+
+            void start(unsigned lvl, std::size_t buffer_size,
+                write_function_type* write)
+            {
+                stop();
+
+                // the buffer size has to be a power of two
+                std::size_t size = 2;
+                while (size < buffer_size)
+                    size <<= 1;
+
+                {
+                    boost::mutex::scoped_lock l(mtx_);
+                    buffer_size_ = size;
+                    write_ = write;
+                    stopping_ = false;
+                }
+
+                flush_thread_ = boost::thread(&logger::run, this);
+                level.store(lvl);
+            }
+
+            void stop()
+            {
+                level.store(static_cast<unsigned>(logging::level::disable_all));
+
+                {
+                    boost::mutex::scoped_lock l(mtx_);
+                    if (!flush_thread_.joinable())
+                        return;
+
+                    stopping_ = true;
+                    cond_.notify_all();
+                }
+
+                flush_thread_.join();
+            }
+
+            void write(record& r)
+            {
+                ring_buffer_ptr* p = thread_buffer_.get();
+                if (0 == p)
+                {
+                    p = new ring_buffer_ptr(create_buffer());
+                    thread_buffer_.reset(p);
+                    thread_exit_hook_.reset(p->get());
+                }
+
+                r.timestamp = util::high_resolution_clock::now();
+                if (!(*p)->push(r))
+                    ++dropped_;
+            }
+
+            void release_thread_buffer()
+            {
+                // the exit hook is not needed anymore
+                thread_exit_hook_.release();
+                release_buffer();
+            }
+
+            boost::int64_t get_dropped_records(bool reset)
+            {
+                if (reset)
+                    return dropped_.exchange(0);
+                return dropped_.load();
+            }
+
+        private:
+            ring_buffer_ptr create_buffer()
+            {
+                boost::mutex::scoped_lock l(mtx_);
+
+                ring_buffer_ptr buffer = boost::make_shared<ring_buffer>(
+                    buffer_size_, runtime::get_thread_name());
+                buffers_.push_back(buffer);
+                return buffer;
+            }
+
+            struct write_record
+            {
+                write_record(write_function_type* write)
+                  : write_(write)
+                {}
+
+                void operator()(record const& r,
+                    std::string const& thread_name) const
+                {
+                    write_(r.level, format_record(r, thread_name));
+                }
+
+                write_function_type* write_;
+            };
+
+            // write all records stored so far, returns the number of records
+            // written
+            std::size_t flush(write_function_type* write)
+            {
+                std::vector<ring_buffer_ptr> buffers;
+
+                {
+                    boost::mutex::scoped_lock l(mtx_);
+
+                    // get rid of the buffers of exited threads which have
+                    // been written completely
+                    std::vector<ring_buffer_ptr>::iterator it = buffers_.begin();
+                    while (it != buffers_.end())
+                    {
+                        if ((*it)->released() && (*it)->empty())
+                            it = buffers_.erase(it);
+                        else
+                            ++it;
+                    }
+                    buffers = buffers_;
+                }
+
+                std::size_t count = 0;
+                for (std::size_t i = 0; i != buffers.size(); ++i)
+                    count += buffers[i]->consume(write_record(write));
+                return count;
+            }
+
+            void run()
+            {
+                boost::mutex::scoped_lock l(mtx_);
+                write_function_type* write = write_;
+
+                while (!stopping_)
+                {
+                    std::size_t count = 0;
+
+                    {
+                        util::scoped_unlock<boost::mutex::scoped_lock> ul(l);
+                        count = flush(write);
+                    }
+
+                    // wait for a while if there was nothing to do
+                    if (0 == count && !stopping_)
+                    {
+                        cond_.timed_wait(l,
+                            boost::posix_time::milliseconds(10));
+                    }
+                }
+
+                // write the remaining records
+                l.unlock();
+                flush(write);
+            }
+
+            boost::mutex mtx_;
+            std::vector<ring_buffer_ptr> buffers_;
+            boost::atomic<boost::int64_t> dropped_;
+
+            std::size_t buffer_size_;
+            write_function_type* write_;
+
+            boost::thread flush_thread_;
+            boost::condition_variable cond_;
+            bool stopping_;
+        };
+
+        struct logger_tag {};
+        logger& get_logger()
+        {
+            util::static_<logger, logger_tag> logger_;
+            return logger_.get();
+        }
+
+        void write(record& r)
+        {
+            get_logger().write(r);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void start(unsigned level, std::size_t buffer_size,
+        write_function_type* write)
+    {
+        detail::get_logger().start(level, buffer_size, write);
+    }
+
+    void stop()
+    {
+        detail::get_logger().stop();
+    }
+
+    boost::int64_t get_dropped_records(bool reset)
+    {
+        return detail::get_logger().get_dropped_records(reset);
+    }
+
+    void release_thread_buffer()
+    {
+        detail::get_logger().release_thread_buffer();
+    }
+}}}
+
+#else  // HPX_NO_LOGGING
+
+namespace hpx { namespace util { namespace binary_log
+{
+    boost::int64_t get_dropped_records(bool)
+    {
+        return 0;
+    }
+
+    void release_thread_buffer()
+    {
+    }
+}}}
+
+#endif // HPX_NO_LOGGING
@@ -0,0 +1,345 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_fwd.hpp>
+#include <hpx/version.hpp>
+#include <hpx/util/component_manifest.hpp>
+#include <hpx/util/filesystem_compatibility.hpp>
+#include <hpx/util/logging.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+
+///////////////////////////////////////////////////////////////////////////////
+namespace hpx { namespace util
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // The manifest file starts with a header identifying the format, the
+        // byte order and the HPX version it was generated by. The manifest is
+        // discarded if any of those does not match.
+        char const manifest_magic[8] = { 'H', 'P', 'X', 'M', 'N', 'F', 'S', 'T' };
+
+        boost::uint64_t const manifest_version =
+            (boost::uint64_t(1) << 56) |
+            (boost::uint64_t(HPX_VERSION_FULL) << 32) |
+            boost::uint64_t(HPX_VERSION_DATE);
+
+        boost::uint64_t const manifest_byte_order = 0x0102030405060708ull;
+
+#if defined(HPX_DEBUG)
+        boost::uint64_t const manifest_build_type = 1;
+#else
+        boost::uint64_t const manifest_build_type = 0;
+#endif
+
+        // protect against reading garbage
+        boost::uint64_t const manifest_max_count = 0x100000;
+
+        ///////////////////////////////////////////////////////////////////////
+        inline void write_value(std::ostream& os, boost::uint64_t value)
+        {
+            os.write(reinterpret_cast<char const*>(&value), sizeof(value));
+        }
+
+        inline void write_string(std::ostream& os, std::string const& s)
+        {
+            write_value(os, s.size());
+            os.write(s.data(), s.size());
+        }
+
+        inline bool read_value(std::istream& is, boost::uint64_t& value)
+        {
+            is.read(reinterpret_cast<char*>(&value), sizeof(value));
+            return is.good();
+        }
+
+        inline bool read_string(std::istream& is, std::string& s)
+        {
+            boost::uint64_t size = 0;
+            if (!read_value(is, size) || size > manifest_max_count)
+                return false;
+
+            s.resize(static_cast<std::size_t>(size));
+            if (size != 0)
+                is.read(&s[0], static_cast<std::streamsize>(size));
+            return is.good();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename Entries>
+        void write_entries(std::ostream& os, Entries const& entries)
+        {
+            write_value(os, entries.size());
+
+            typedef typename Entries::const_iterator iterator;
+            for (iterator it = entries.begin(); it != entries.end(); ++it)
+            {
+                write_string(os, it->first);
+                write_value(os, it->second.last_write_time);
+                write_value(os, it->second.file_size);
+
+                write_value(os, it->second.data.size());
+                for (std::size_t i = 0; i != it->second.data.size(); ++i)
+                    write_string(os, it->second.data[i]);
+            }
+        }
+
+        template <typename Entries>
+        bool read_entries(std::istream& is, Entries& entries)
+        {
+            boost::uint64_t count = 0;
+            if (!read_value(is, count) || count > manifest_max_count)
+                return false;
+
+            for (boost::uint64_t i = 0; i != count; ++i)
+            {
+                std::string name;
+                typename Entries::mapped_type e;
+                if (!read_string(is, name) ||
+                    !read_value(is, e.last_write_time) ||
+                    !read_value(is, e.file_size))
+                {
+                    return false;
+                }
+
+                boost::uint64_t lines = 0;
+                if (!read_value(is, lines) || lines > manifest_max_count)
+                    return false;
+
+                e.data.resize(static_cast<std::size_t>(lines));
+                for (std::size_t j = 0; j != e.data.size(); ++j)
+                {
+                    if (!read_string(is, e.data[j]))
+                        return false;
+                }
+
+                entries[name] = e;
+            }
+            return true;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    component_manifest::component_manifest(std::string const& filename)
+      : filename_(filename), modified_(false)
+    {}
+
+    bool component_manifest::load()
+    {
+        if (!enabled())
+            return false;
+
+        try {
+            namespace fs = boost::filesystem;
+            if (!fs::exists(filename_))
+                return false;       // avoid exception on missing file
+        }
+        catch (boost::filesystem::filesystem_error const&) {
+            return false;
+        }
+
+        std::ifstream is(filename_.c_str(), std::ios::in | std::ios::binary);
+        if (!is.is_open())
+            return false;
+
+        char magic[sizeof(detail::manifest_magic)] = { 0 };
+        is.read(magic, sizeof(magic));
+
+        boost::uint64_t version = 0, byte_order = 0, build_type = 0;
+        if (!is.good() ||
+            !std::equal(magic, magic + sizeof(magic), detail::manifest_magic) ||
+            !detail::read_value(is, version) ||
+            version != detail::manifest_version ||
+            !detail::read_value(is, byte_order) ||
+            byte_order != detail::manifest_byte_order ||
+            !detail::read_value(is, build_type) ||
+            build_type != detail::manifest_build_type)
+        {
+            LBT_(warning) << "component manifest: ignoring incompatible file: "
+                          << filename_;
+            return false;
+        }
+
+        entries_type modules, directories;
+        if (!detail::read_entries(is, modules) ||
+            !detail::read_entries(is, directories))
+        {
+            LBT_(warning) << "component manifest: ignoring corrupted file: "
+                          << filename_;
+            return false;
+        }
+
+        modules_.swap(modules);
+        directories_.swap(directories);
+        modified_ = false;
+
+        LBT_(info) << "component manifest: loaded " << filename_ << " ("
+                   << modules_.size() << " modules, " << directories_.size()
+                   << " directories)";
+        return true;
+    }
+
+    bool component_manifest::save()
+    {
+        if (!enabled() || !modified_)
+            return true;
+
+        namespace fs = boost::filesystem;
+
+        // Write to a temporary file first, replacing the manifest by renaming
+        // it is atomic. This allows for several processes (localities) to
+        // update the same manifest concurrently. The name of the temporary
+        // file is randomized as process ids are not unique for localities
+        // sharing a file system.
+        std::string tmpname;
+
+        try {
+            fs::path p = hpx::util::create_path(filename_);
+            if (p.has_parent_path() && !fs::exists(p.parent_path()))
+                fs::create_directories(p.parent_path());
+
+            tmpname = fs::unique_path(
+                p.string() + ".%%%%-%%%%-%%%%-%%%%").string();
+
+            {
+                std::ofstream os(tmpname.c_str(),
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!os.is_open())
+                {
+                    LBT_(warning) << "component manifest: couldn't create: "
+                                  << tmpname;
+                    return false;
+                }
+
+                os.write(detail::manifest_magic,
+                    sizeof(detail::manifest_magic));
+                detail::write_value(os, detail::manifest_version);
+                detail::write_value(os, detail::manifest_byte_order);
+                detail::write_value(os, detail::manifest_build_type);
+
+                detail::write_entries(os, modules_);
+                detail::write_entries(os, directories_);
+
+                if (!os.good())
+                {
+                    os.close();
+                    std::remove(tmpname.c_str());
+                    LBT_(warning) << "component manifest: couldn't write: "
+                                  << tmpname;
+                    return false;
+                }
+            }
+
+            fs::rename(hpx::util::create_path(tmpname), p);
+        }
+        catch (fs::filesystem_error const& e) {
+            if (!tmpname.empty())
+                std::remove(tmpname.c_str());
+            LBT_(warning) << "component manifest: couldn't write: "
+                          << filename_ << ": " << e.what();
+            return false;
+        }
+
+        modified_ = false;
+        LBT_(info) << "component manifest: written " << filename_;
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool component_manifest::get_entry_info(boost::filesystem::path const& p,
+        bool is_directory, entry& e)
+    {
+        namespace fs = boost::filesystem;
+
+        boost::system::error_code ec;
+        std::time_t last_write_time = fs::last_write_time(p, ec);
+        if (ec)
+            return false;
+
+        boost::uintmax_t file_size = 0;
+        if (!is_directory)
+        {
+            file_size = fs::file_size(p, ec);
+            if (ec)
+                return false;
+        }
+
+        e.last_write_time = static_cast<boost::uint64_t>(last_write_time);
+        e.file_size = static_cast<boost::uint64_t>(file_size);
+        return true;
+    }
+
+    bool component_manifest::find(entries_type const& entries,
+        boost::filesystem::path const& p, bool is_directory,
+        std::vector<std::string>& data) const
+    {
+        if (!enabled())
+            return false;
+
+        entries_type::const_iterator it = entries.find(p.string());
+        if (it == entries.end())
+            return false;
+
+        entry e;
+        if (!get_entry_info(p, is_directory, e) ||
+            e.last_write_time != it->second.last_write_time ||
+            e.file_size != it->second.file_size)
+        {
+            return false;       // modified since the manifest was written
+        }
+
+        data = it->second.data;
+        return true;
+    }
+
+    void component_manifest::add(entries_type& entries,
+        boost::filesystem::path const& p, bool is_directory,
+        std::vector<std::string> const& data)
+    {
+        if (!enabled())
+            return;
+
+        entry e;
+        if (!get_entry_info(p, is_directory, e))
+            return;
+
+        e.data = data;
+
+        entries[p.string()] = e;
+        modified_ = true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool component_manifest::find_module(boost::filesystem::path const& module,
+        std::vector<std::string>& ini_data) const
+    {
+        return find(modules_, module, false, ini_data);
+    }
+
+    void component_manifest::add_module(boost::filesystem::path const& module,
+        std::vector<std::string> const& ini_data)
+    {
+        add(modules_, module, false, ini_data);
+    }
+
+    bool component_manifest::find_directory(boost::filesystem::path const& dir,
+        std::vector<std::string>& files) const
+    {
+        return find(directories_, dir, true, files);
+    }
+
+    void component_manifest::add_directory(boost::filesystem::path const& dir,
+        std::vector<std::string> const& files)
+    {
+        add(directories_, dir, true, files);
+    }
+}}
@@ -8,6 +8,7 @@
 #include <hpx/config.hpp>
 #include <hpx/exception.hpp>
 #include <hpx/util/init_ini_data.hpp>
+#include <hpx/util/component_manifest.hpp>
 #include <hpx/util/ini.hpp>
 #include <hpx/util/filesystem_compatibility.hpp>
 #include <hpx/runtime/components/component_registry_base.hpp>
@@ -151,7 +152,7 @@ namespace hpx { namespace util
 
     ///////////////////////////////////////////////////////////////////////////
     // global function to read component ini information
-    void merge_component_inis(section& ini)
+    void merge_component_inis(section& ini, component_manifest* manifest)
     {
         namespace fs = boost::filesystem;
 
@@ -180,21 +181,35 @@ namespace hpx { namespace util
                 if (!fs::exists(this_path))
                     continue;
 
-                for (fs::directory_iterator dir(this_path); dir != nodir; ++dir)
+                // the list of ini files is cached in the manifest, avoid
+                // listing the directory if it has not changed
+                std::vector<std::string> ini_files;
+                if (0 == manifest ||
+                    !manifest->find_directory(this_path, ini_files))
                 {
-                    if (fs::extension(*dir) != ".ini")
-                        continue;
+                    for (fs::directory_iterator dir(this_path); dir != nodir; ++dir)
+                    {
+                        if (fs::extension(*dir) != ".ini")
+                            continue;
 
-                    // read and merge the ini file into the main ini hierarchy
-                    try {
 #if BOOST_FILESYSTEM_VERSION == 3
-                        ini.merge ((*dir).path().string());
-                        LBT_(info) << "loaded configuration: " << (*dir).path().string();
+                        ini_files.push_back((*dir).path().string());
 #else
-                        ini.merge ((*dir).string());
-                        LBT_(info) << "loaded configuration: " << (*dir).string();
+                        ini_files.push_back((*dir).string());
 #endif
                     }
+
+                    if (0 != manifest)
+                        manifest->add_directory(this_path, ini_files);
+                }
+
+                BOOST_FOREACH(std::string const& ini_file, ini_files)
+                {
+                    // read and merge the ini file into the main ini hierarchy
+                    try {
+                        ini.merge (ini_file);
+                        LBT_(info) << "loaded configuration: " << ini_file;
+                    }
                     catch (hpx::exception const& /*e*/) {
                         ;
                     }
@@ -255,7 +270,8 @@ namespace hpx { namespace util
         ini.parse("<component registry>", ini_data, false, false);
     }
 
-    void load_component_factory(hpx::util::plugin::dll& d, util::section& ini,
+    void load_component_factory(hpx::util::plugin::dll& d,
+        std::vector<std::string>& component_ini_data,
         std::string const& curr, std::string name, error_code& ec)
     {
         hpx::util::plugin::plugin_factory<components::component_registry_base>
@@ -296,13 +312,14 @@ namespace hpx { namespace util
             }
         }
 
-        // incorporate all information from this module's
-        // registry into our internal ini object
-        ini.parse("<component registry>", ini_data, false, false);
+        // collect all information from this module's registry
+        component_ini_data.insert(component_ini_data.end(),
+            ini_data.begin(), ini_data.end());
     }
 
     ///////////////////////////////////////////////////////////////////////////
-    void load_plugin_factory(hpx::util::plugin::dll& d, util::section& ini,
+    void load_plugin_factory(hpx::util::plugin::dll& d,
+        std::vector<std::string>& plugin_ini_data,
         std::string const& curr, std::string const& name, error_code& ec)
     {
         hpx::util::plugin::plugin_factory<plugins::plugin_registry_base>
@@ -327,9 +344,9 @@ namespace hpx { namespace util
             }
         }
 
-        // incorporate all information from this module's
-        // registry into our internal ini object
-        ini.parse("<plugin registry>", ini_data, false, false);
+        // collect all information from this module's registry
+        plugin_ini_data.insert(plugin_ini_data.end(),
+            ini_data.begin(), ini_data.end());
     }
 
     namespace detail
@@ -352,7 +369,8 @@ namespace hpx { namespace util
     ///////////////////////////////////////////////////////////////////////////
     void init_ini_data_default(std::string const& libs, util::section& ini,
         std::map<std::string, boost::filesystem::path>& basenames,
-        std::map<std::string, hpx::util::plugin::dll>& modules)
+        std::map<std::string, hpx::util::plugin::dll>& modules,
+        component_manifest* manifest)
     {
         namespace fs = boost::filesystem;
 
@@ -431,6 +449,21 @@ namespace hpx { namespace util
         BOOST_FOREACH(libdata_type const& p,
             boost::iterator_range<iterator_type>(libdata.begin(), libdata.end()))
         {
+            // use the information cached in the manifest if the module
+            // has not changed, this avoids loading it while scanning (the
+            // runtime_support still loads all components after startup)
+            std::vector<std::string> ini_data;
+            if (0 != manifest && manifest->find_module(p.first, ini_data))
+            {
+                LRT_(debug) << "using component manifest for: "
+                    << p.first.string();
+                if (!ini_data.empty())
+                {
+                    ini.parse("<component manifest>", ini_data, false, false);
+                }
+                continue;
+            }
+
             // get the handle of the library
             error_code ec(lightweight);
             hpx::util::plugin::dll d(p.first.string(), p.second);
@@ -443,19 +476,38 @@ namespace hpx { namespace util
 
             // get the component factory
             std::string curr_fullname(p.first.parent_path().string());
-            load_component_factory(d, ini, curr_fullname, p.second, ec);
+            std::vector<std::string> component_ini_data;
+            load_component_factory(d, component_ini_data, curr_fullname,
+                p.second, ec);
             if (ec) {
                 LRT_(info) << "skipping (load_component_factory failed): " << p.first.string()
                     << ": " << get_error_what(ec);
                 ec = error_code(lightweight);   // reinit ec
             }
+            else {
+                // incorporate all information from this module's
+                // registry into our internal ini object
+                ini.parse("<component registry>", component_ini_data,
+                    false, false);
+            }
 
             // get the plugin factory
-            load_plugin_factory(d, ini, curr_fullname, p.second, ec);
+            std::vector<std::string> plugin_ini_data;
+            load_plugin_factory(d, plugin_ini_data, curr_fullname, p.second, ec);
             if (ec) {
                 LRT_(info) << "skipping (load_plugin_factory failed): " << p.first.string()
                     << ": " << get_error_what(ec);
             }
+            else {
+                ini.parse("<plugin registry>", plugin_ini_data, false, false);
+            }
+
+            if (0 != manifest)
+            {
+                component_ini_data.insert(component_ini_data.end(),
+                    plugin_ini_data.begin(), plugin_ini_data.end());
+                manifest->add_module(p.first, component_ini_data);
+            }
 
             // store loaded library for future use
             modules.insert(std::make_pair(p.second, std::move(d)));
@@ -17,6 +17,7 @@
 #include <hpx/util/runtime_configuration.hpp>
 #include <hpx/util/static.hpp>
 #include <hpx/util/logging.hpp>
+#include <hpx/util/binary_log.hpp>
 #include <hpx/util/logging/format/named_write.hpp>
 #include <hpx/util/logging/format/destination/defaults.hpp>
 #include <hpx/util/init_logging.hpp>
@@ -692,6 +693,70 @@ namespace hpx { namespace util
         }
     }
 
+    ///////////////////////////////////////////////////////////////////////////
+    HPX_DEFINE_LOG_FILTER_WITH_ARGS(binary_level, filter_type,
+        hpx::util::logging::level::disable_all)
+    HPX_DEFINE_LOG(binary_logger, logger_type)
+
+    // this is invoked by the OS thread writing the records of the binary log
+    void write_binary_log(unsigned lvl, std::string const& msg)
+    {
+        HPX_LOG_USE_LOG(binary_logger(), read_msg().gather().out(),
+            binary_level()->is_enabled(
+                static_cast<hpx::util::logging::level::type>(lvl)))
+            << msg;
+    }
+
+    // initialize binary logging (see hpx/util/binary_log.hpp)
+    void init_binary_log(util::section const& ini, bool isconsole)
+    {
+        std::string loglevel, logdest, logformat;
+        std::size_t buffer_size = 0;
+
+        if (ini.has_section("hpx.logging.binary")) {
+            util::section const* logini = ini.get_section("hpx.logging.binary");
+            HPX_ASSERT(NULL != logini);
+
+            std::string empty;
+            loglevel = logini->get_entry("level", empty);
+            if (!loglevel.empty()) {
+                logdest = logini->get_entry("destination", empty);
+                logformat = detail::unescape(logini->get_entry("format", empty));
+                buffer_size = boost::lexical_cast<std::size_t>(
+                    logini->get_entry("buffer_size", "4096"));
+            }
+        }
+
+        unsigned lvl = hpx::util::logging::level::disable_all;
+        if (!loglevel.empty())
+            lvl = detail::get_log_level(loglevel);
+
+        if (hpx::util::logging::level::disable_all != lvl)
+        {
+            logger_writer_type& writer = binary_logger()->writer();
+
+#if defined(ANDROID) || defined(__ANDROID__)
+            if (logdest.empty())      // ensure minimal defaults
+                logdest = isconsole ? "android_log" : "console";
+            writer.add_destination("android_log", android_log("hpx.binary"));
+#else
+            if (logdest.empty())      // ensure minimal defaults
+                logdest = isconsole ? "cerr" : "console";
+#endif
+            if (logformat.empty())
+                logformat = "|\\n";
+
+            writer.add_destination("console", console(lvl, destination_hpx)); //-V106
+            writer.write(logformat, logdest);
+            detail::define_formatters(writer);
+
+            binary_logger()->mark_as_initialized();
+            binary_level()->set_enabled(lvl);
+
+            binary_log::start(lvl, buffer_size, &write_binary_log);
+        }
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     HPX_DEFINE_LOG_FILTER_WITH_ARGS(agas_console_level, filter_type,
         hpx::util::logging::level::disable_all)
@@ -1046,7 +1111,16 @@ namespace hpx { namespace util { namespace detail
 #else
                 "destination = ${HPX_CONSOLE_DEB_LOGDESTINATION:file(hpx.debuglog.$[system.pid].log)}",
 #endif
-                "format = ${HPX_CONSOLE_DEB_LOGFORMAT:|}"
+                "format = ${HPX_CONSOLE_DEB_LOGFORMAT:|}",
+
+                // binary logging (see hpx/util/binary_log.hpp), the records
+                // are formatted by a dedicated OS thread, thus the format
+                // should not refer to the current HPX thread
+                "[hpx.logging.binary]",
+                "level = ${HPX_BINARY_LOGLEVEL:-1}",
+                "destination = ${HPX_BINARY_LOGDESTINATION:file(hpx.binary.$[system.pid].log)}",
+                "format = ${HPX_BINARY_LOGFORMAT:(T%locality%) [%idx%] |\\n}",
+                "buffer_size = ${HPX_BINARY_LOG_BUFFER_SIZE:4096}"
             ;
         }
         catch (std::exception const&) {
@@ -1075,6 +1149,7 @@ namespace hpx { namespace util { namespace detail
         init_hpx_logs(ini, isconsole);
         init_app_logs(ini, isconsole);
         init_debuglog_logs(ini, isconsole);
+        init_binary_log(ini, isconsole);
 
         // initialize console logs
         init_agas_console_log(ini);
@@ -1083,6 +1158,12 @@ namespace hpx { namespace util { namespace detail
         init_app_console_log(ini);
         init_debuglog_console_log(ini);
     }
+
+    init_logging::~init_logging()
+    {
+        // write all remaining records of the binary log
+        binary_log::stop();
+    }
 }}}
 
 #else  // HPX_NO_LOGGING
@@ -1108,7 +1189,8 @@ namespace hpx { namespace util { namespace detail
             ini.get_entry("hpx.logging.timing.level", "0") != "0" ||
             ini.get_entry("hpx.logging.agas.level", "0") != "0" ||
             ini.get_entry("hpx.logging.debuglog.level", "0") != "0" ||
-            ini.get_entry("hpx.logging.application.level", "0") != "0")
+            ini.get_entry("hpx.logging.application.level", "0") != "0" ||
+            ini.get_entry("hpx.logging.binary.level", "0") != "0")
         {
             std::cerr << "hpx::init_logging: warning: logging is requested even "
                          "if it has has been disabled at compile time. If you "
@@ -1117,6 +1199,10 @@ namespace hpx { namespace util { namespace detail
                       << endl;
         }
     }
+
+    init_logging::~init_logging()
+    {
+    }
 }}}
 
 #endif // HPX_NO_LOGGING
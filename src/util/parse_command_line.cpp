@@ -450,7 +450,8 @@ namespace hpx { namespace util
                 ("hpx:queuing", value<std::string>(),
                   "the queue scheduling policy to use, options are "
                   "'local', 'priority_local', 'priority_abp', "
-                  "'hierarchy', 'static' and 'periodic' (default: 'priority_local'; "
+                  "'hierarchy', 'static', 'periodic' and 'deadline' "
+                  "(default: 'priority_local'; "
                   "all option values can be abbreviated)")
                 ("hpx:hierarchy-arity", value<std::size_t>(),
                   "the arity of the of the thread queue tree, valid for "
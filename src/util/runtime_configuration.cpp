@@ -9,6 +9,7 @@
 #include <hpx/hpx_fwd.hpp>
 #include <hpx/util/runtime_configuration.hpp>
 #include <hpx/util/init_ini_data.hpp>
+#include <hpx/util/component_manifest.hpp>
 #include <hpx/util/itt_notify.hpp>
 #include <hpx/util/find_prefix.hpp>
 #include <hpx/util/register_locks.hpp>
@@ -55,6 +56,12 @@ namespace hpx { namespace threads { namespace policies
     // startup code
     bool minimal_deadlock_detection = true;
 #endif
+
+    ///////////////////////////////////////////////////////////////////////////
+    // We globally control the idle behavior of the worker threads using this
+    // global variable. It will be set once by the runtime configuration
+    // startup code
+    idle_backoff_parameters idle_parameters;
 }}}
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -92,6 +99,7 @@ namespace hpx { namespace util
                 HPX_INI_PATH_DELIMITER "$[system.executable_prefix]" HPX_BASE_DIR_NAME
                 HPX_INI_PATH_DELIMITER "$[system.executable_prefix]" HPX_BASE_DIR_NAME,
             "master_ini_path_suffixes = /share/" HPX_INI_PATH_DELIMITER "/../share/",
+            "component_manifest = ${HPX_COMPONENT_MANIFEST:}",
 #if HPX_HAVE_ITTNOTIFY != 0
             "use_itt_notify = ${HPX_HAVE_ITTNOTIFY:0}",
 #endif
@@ -132,6 +140,19 @@ namespace hpx { namespace util
             "use_guard_pages = ${HPX_USE_GUARD_PAGES:1}",
 #endif
 
+            "[hpx.idle_backoff]",
+#if defined(HPX_THREAD_BACKOFF_ON_IDLE)
+            "policy = ${HPX_IDLE_BACKOFF_POLICY:backoff}",
+#else
+            "policy = ${HPX_IDLE_BACKOFF_POLICY:spin}",
+#endif
+            "spin_count = ${HPX_IDLE_BACKOFF_SPIN_COUNT:"
+                BOOST_PP_STRINGIZE(HPX_IDLE_BACKOFF_SPIN_COUNT) "}",
+            "yield_count = ${HPX_IDLE_BACKOFF_YIELD_COUNT:"
+                BOOST_PP_STRINGIZE(HPX_IDLE_BACKOFF_YIELD_COUNT) "}",
+            "max_park_time = ${HPX_IDLE_BACKOFF_MAX_PARK_TIME:"
+                BOOST_PP_STRINGIZE(HPX_IDLE_BACKOFF_MAX_PARK_TIME) "}",
+
             "[hpx.threadpools]",
             "io_pool_size = ${HPX_NUM_IO_POOL_THREADS:"
                 BOOST_PP_STRINGIZE(HPX_NUM_IO_POOL_THREADS) "}",
@@ -140,6 +161,10 @@ namespace hpx { namespace util
             "timer_pool_size = ${HPX_NUM_TIMER_POOL_THREADS:"
                 BOOST_PP_STRINGIZE(HPX_NUM_TIMER_POOL_THREADS) "}",
 
+            "[hpx.iostreams]",
+            "batch_size = ${HPX_IOSTREAMS_BATCH_SIZE:4096}",
+            "batch_interval = ${HPX_IOSTREAMS_BATCH_INTERVAL:10}",
+
             "[hpx.commandline]",
             // enable aliasing
             "aliasing = ${HPX_COMMANDLINE_ALIASING:1}",
@@ -188,6 +213,8 @@ namespace hpx { namespace util
                 BOOST_PP_STRINGIZE(HPX_AGAS_LOCAL_CACHE_SIZE_PER_THREAD) "}",
             "use_range_caching = ${HPX_AGAS_USE_RANGE_CACHING:1}",
             "use_caching = ${HPX_AGAS_USE_CACHING:1}",
+            "boot_barrier_arity = ${HPX_AGAS_BOOT_BARRIER_ARITY:"
+                BOOST_PP_STRINGIZE(HPX_INITIAL_AGAS_BOOT_BARRIER_ARITY) "}",
 
             "[hpx.components]",
             "load_external = ${HPX_LOAD_EXTERNAL_COMPONENTS:1}",
@@ -279,6 +306,13 @@ namespace hpx { namespace util
         // list of base names avoiding to load a module more than once
         std::map<std::string, fs::path> basenames;
 
+        // the manifest caches the information gathered from the modules and
+        // the ini directories, which avoids loading all modules just to
+        // query their configuration information
+        util::component_manifest manifest(
+            get_entry("hpx.component_manifest", ""));
+        manifest.load();
+
         boost::char_separator<char> sep (HPX_INI_PATH_DELIMITER);
         tokenizer_type tok_path(component_path, sep);
         tokenizer_type tok_suffixes(component_path_suffixes, sep);
@@ -305,8 +339,8 @@ namespace hpx { namespace util
                         // have all path elements, now find ini files in there...
                         fs::path this_path (hpx::util::create_path(*p.first));
                         if (fs::exists(this_path)) {
-                            util::init_ini_data_default(
-                                this_path.string(), *this, basenames, modules);
+                            util::init_ini_data_default(this_path.string(),
+                                *this, basenames, modules, &manifest);
                         }
                     }
                 }
@@ -322,7 +356,10 @@ namespace hpx { namespace util
             parse("<command line definitions>", cmdline_ini_defs, true, false);
 
         // merge all found ini files of all components
-        util::merge_component_inis(*this);
+        util::merge_component_inis(*this, &manifest);
+
+        // store the newly gathered information for the next run
+        manifest.save();
 
         need_to_call_pre_initialize = true;
 
@@ -371,6 +408,7 @@ namespace hpx { namespace util
         threads::policies::minimal_deadlock_detection =
             enable_minimal_deadlock_detection();
 #endif
+        threads::policies::idle_parameters = get_idle_backoff_parameters();
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -425,6 +463,7 @@ namespace hpx { namespace util
         threads::policies::minimal_deadlock_detection =
             enable_minimal_deadlock_detection();
 #endif
+        threads::policies::idle_parameters = get_idle_backoff_parameters();
     }
 
     // AGAS configuration information has to be stored in the global hpx.agas
@@ -802,6 +841,40 @@ namespace hpx { namespace util
         return false;
     }
 
+    // Return the parameters controlling the behavior of idle worker threads
+    threads::policies::idle_backoff_parameters
+    runtime_configuration::get_idle_backoff_parameters() const
+    {
+        threads::policies::idle_backoff_parameters params;
+#if defined(HPX_THREAD_BACKOFF_ON_IDLE)
+        params.policy_ = threads::policies::idle_backoff;
+#endif
+        if (has_section("hpx.idle_backoff")) {
+            util::section const* sec = get_section("hpx.idle_backoff");
+            if (NULL != sec) {
+                std::string policy = sec->get_entry("policy", "");
+                if (policy == "spin")
+                    params.policy_ = threads::policies::idle_spin;
+                else if (policy == "backoff")
+                    params.policy_ = threads::policies::idle_backoff;
+                else if (!policy.empty()) {
+                    HPX_THROW_EXCEPTION(bad_parameter,
+                        "runtime_configuration::get_idle_backoff_parameters",
+                        "invalid idle policy: '" + policy +
+                        "' (valid policies are 'spin' and 'backoff')");
+                }
+
+                params.spin_count_ = boost::lexical_cast<boost::int64_t>(
+                    sec->get_entry("spin_count", params.spin_count_));
+                params.yield_count_ = boost::lexical_cast<boost::int64_t>(
+                    sec->get_entry("yield_count", params.yield_count_));
+                params.max_park_time_ = boost::lexical_cast<boost::int64_t>(
+                    sec->get_entry("max_park_time", params.max_park_time_));
+            }
+        }
+        return params;
+    }
+
     // Enable minimal deadlock detection for HPX threads
     bool runtime_configuration::enable_minimal_deadlock_detection() const
     {
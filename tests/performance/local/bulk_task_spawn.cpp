@@ -0,0 +1,144 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the rate at which a single HPX thread can spawn
+// tasks. It compares creating the tasks one at a time (one call into the
+// scheduler per task) with creating all of them using a single bulk call
+// (register_work_nullary_bulk), which hands the tasks to the worker queues
+// in blocks.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/lcos/local/counting_semaphore.hpp>
+#include <hpx/util/high_resolution_timer.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/cstdint.hpp>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+using boost::program_options::value;
+
+using hpx::util::high_resolution_timer;
+
+using hpx::cout;
+using hpx::flush;
+
+///////////////////////////////////////////////////////////////////////////////
+void null_task(hpx::lcos::local::counting_semaphore& sem)
+{
+    sem.signal();
+}
+
+// returns the elapsed time in seconds for spawning and running all tasks
+double spawn_individually(boost::uint64_t tasks)
+{
+    hpx::lcos::local::counting_semaphore sem;
+
+    high_resolution_timer t;
+    for (boost::uint64_t i = 0; i != tasks; ++i)
+    {
+        hpx::applier::register_work_nullary(
+            hpx::util::bind(&null_task, boost::ref(sem)), "null_task");
+    }
+    sem.wait(static_cast<boost::int64_t>(tasks));
+    return t.elapsed();
+}
+
+double spawn_bulk(boost::uint64_t tasks)
+{
+    hpx::lcos::local::counting_semaphore sem;
+
+    high_resolution_timer t;
+    std::vector<hpx::util::unique_function_nonser<void()> > funcs;
+    funcs.reserve(tasks);
+    for (boost::uint64_t i = 0; i != tasks; ++i)
+        funcs.push_back(hpx::util::bind(&null_task, boost::ref(sem)));
+
+    hpx::applier::register_work_nullary_bulk(std::move(funcs), "null_task");
+    sem.wait(static_cast<boost::int64_t>(tasks));
+    return t.elapsed();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map& vm)
+{
+    {
+        boost::uint64_t const tasks = vm["tasks"].as<boost::uint64_t>();
+        boost::uint64_t const samples = vm["samples"].as<boost::uint64_t>();
+        bool const csv = vm.count("csv") != 0;
+
+        if (HPX_UNLIKELY(0 == tasks))
+            throw std::logic_error("error: count of 0 tasks specified\n");
+        if (HPX_UNLIKELY(0 == samples))
+            throw std::logic_error("error: count of 0 samples specified\n");
+
+        std::size_t const num_threads = hpx::get_os_thread_count();
+
+        double individual = 0., bulk = 0.;
+        for (boost::uint64_t i = 0; i != samples; ++i)
+        {
+            individual += spawn_individually(tasks);
+            bulk += spawn_bulk(tasks);
+        }
+
+        // tasks per second
+        double const individual_rate = (tasks * samples) / individual;
+        double const bulk_rate = (tasks * samples) / bulk;
+
+        if (csv)
+        {
+            cout << ( boost::format("%1%,%2%,%3%,%4%,%5%\n")
+                    % num_threads
+                    % tasks
+                    % samples
+                    % individual_rate
+                    % bulk_rate)
+                  << flush;
+        }
+        else
+        {
+            cout << ( boost::format("%1% threads, %2% tasks, %3% samples, "
+                        "spawn rate [tasks/s]: individual %4%, bulk %5%\n")
+                    % num_threads
+                    % tasks
+                    % samples
+                    % individual_rate
+                    % bulk_rate)
+                  << flush;
+        }
+    }
+
+    return hpx::finalize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    // Configure application-specific options.
+    options_description cmdline("usage: " HPX_APPLICATION_STRING " [options]");
+
+    cmdline.add_options()
+        ( "tasks"
+        , value<boost::uint64_t>()->default_value(100000)
+        , "number of tasks to spawn for each sample")
+
+        ( "samples"
+        , value<boost::uint64_t>()->default_value(10)
+        , "number of samples to measure")
+
+        ( "csv"
+        , "output results as csv (format: threads,tasks,samples,"
+          "individual rate,bulk rate)")
+        ;
+
+    // Initialize and run HPX
+    return hpx::init(cmdline, argc, argv);
+}
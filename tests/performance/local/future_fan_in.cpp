@@ -0,0 +1,188 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the cost of joining on large numbers of futures
+// (fan-in) using when_all, when_some, when_any and when_any_index. For each
+// count the futures are created from promises, the composition operation is
+// invoked while none of the futures is ready, and afterwards all promises are
+// satisfied. The reported time covers attaching the callbacks, making all
+// futures ready and retrieving the result.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/util/high_resolution_timer.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/cstdint.hpp>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+using boost::program_options::value;
+
+using hpx::util::high_resolution_timer;
+
+using hpx::cout;
+using hpx::flush;
+
+typedef hpx::lcos::local::promise<int> promise_type;
+typedef hpx::future<int> future_type;
+
+///////////////////////////////////////////////////////////////////////////////
+void make_futures(boost::uint64_t count, std::vector<promise_type>& promises,
+    std::vector<future_type>& futures)
+{
+    promises = std::vector<promise_type>(count);
+    futures.clear();
+    futures.reserve(count);
+    for (boost::uint64_t i = 0; i != count; ++i)
+        futures.push_back(promises[i].get_future());
+}
+
+void set_futures(std::vector<promise_type>& promises)
+{
+    for (std::size_t i = 0; i != promises.size(); ++i)
+        promises[i].set_value(42);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+double measure_when_all(boost::uint64_t count)
+{
+    std::vector<promise_type> promises;
+    std::vector<future_type> futures;
+    make_futures(count, promises, futures);
+
+    high_resolution_timer walltime;
+
+    hpx::future<std::vector<future_type> > r = hpx::when_all(futures);
+    set_futures(promises);
+    r.get();
+
+    return walltime.elapsed();
+}
+
+double measure_when_some(boost::uint64_t count)
+{
+    std::vector<promise_type> promises;
+    std::vector<future_type> futures;
+    make_futures(count, promises, futures);
+
+    high_resolution_timer walltime;
+
+    hpx::future<std::vector<future_type> > r =
+        hpx::when_some(futures.size(), futures);
+    set_futures(promises);
+    r.get();
+
+    return walltime.elapsed();
+}
+
+double measure_when_any(boost::uint64_t count)
+{
+    std::vector<promise_type> promises;
+    std::vector<future_type> futures;
+    make_futures(count, promises, futures);
+
+    high_resolution_timer walltime;
+
+    hpx::future<std::vector<future_type> > r = hpx::when_any(futures);
+    set_futures(promises);
+    r.get();
+
+    return walltime.elapsed();
+}
+
+double measure_when_any_index(boost::uint64_t count)
+{
+    std::vector<promise_type> promises;
+    std::vector<future_type> futures;
+    make_futures(count, promises, futures);
+
+    high_resolution_timer walltime;
+
+    hpx::future<hpx::when_any_result<std::vector<future_type> > > r =
+        hpx::when_any_index(futures);
+    set_futures(promises);
+    r.get();
+
+    return walltime.elapsed();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void print_result(char const* name, boost::uint64_t count, double duration,
+    bool csv)
+{
+    if (csv)
+    {
+        cout << ( boost::format("%1%,%2%,%3%\n")
+                % name
+                % count
+                % duration)
+              << flush;
+    }
+    else
+    {
+        cout << ( boost::format("%1%: joined %2% futures in %3% seconds "
+                    "(%4% ns per future)\n")
+                % name
+                % count
+                % duration
+                % (duration * 1e9 / count))
+              << flush;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map& vm)
+{
+    {
+        boost::uint64_t const min_count =
+            vm["min-futures"].as<boost::uint64_t>();
+        boost::uint64_t const max_count =
+            vm["max-futures"].as<boost::uint64_t>();
+        bool const csv = vm.count("csv") != 0;
+
+        if (HPX_UNLIKELY(0 == min_count || min_count > max_count))
+            throw std::logic_error("error: invalid range of futures specified\n");
+
+        for (boost::uint64_t count = min_count; count <= max_count; count *= 10)
+        {
+            print_result("when_all", count, measure_when_all(count), csv);
+            print_result("when_some", count, measure_when_some(count), csv);
+            print_result("when_any", count, measure_when_any(count), csv);
+            print_result("when_any_index", count,
+                measure_when_any_index(count), csv);
+        }
+    }
+
+    return hpx::finalize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    // Configure application-specific options.
+    options_description cmdline("usage: " HPX_APPLICATION_STRING " [options]");
+
+    cmdline.add_options()
+        ( "min-futures"
+        , value<boost::uint64_t>()->default_value(10)
+        , "smallest number of futures to join on")
+
+        ( "max-futures"
+        , value<boost::uint64_t>()->default_value(1000000)
+        , "largest number of futures to join on (the number of futures is "
+          "multiplied by 10 for each measurement)")
+
+        ( "csv"
+        , "output results as csv (format: name,count,duration)")
+        ;
+
+    // Initialize and run HPX.
+    return hpx::init(cmdline, argc, argv);
+}
@@ -0,0 +1,159 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the latency of waking up an idle worker thread. The
+// main thread lets all worker threads run out of work for a configurable
+// amount of time, then it schedules a task on another worker thread and
+// measures the time until this task starts running.
+//
+// Run it once with --hpx:ini=hpx.idle_backoff.policy=spin and once with
+// --hpx:ini=hpx.idle_backoff.policy=backoff to see the latency added by
+// parking idle worker threads.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/chrono/chrono.hpp>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+using boost::program_options::value;
+
+using hpx::util::high_resolution_clock;
+
+using hpx::cout;
+using hpx::flush;
+
+///////////////////////////////////////////////////////////////////////////////
+void record_wakeup(hpx::lcos::local::promise<boost::uint64_t>& p)
+{
+    p.set_value(high_resolution_clock::now());
+}
+
+// returns the wake-up latency in nanoseconds
+boost::uint64_t measure_wakeup(std::size_t os_thread, boost::uint64_t idle_ms)
+{
+    // let all worker threads run out of work
+    hpx::this_thread::sleep_for(boost::chrono::milliseconds(idle_ms));
+
+    hpx::lcos::local::promise<boost::uint64_t> p;
+    hpx::future<boost::uint64_t> f = p.get_future();
+
+    boost::uint64_t const start = high_resolution_clock::now();
+    hpx::applier::register_work_nullary(
+        hpx::util::bind(&record_wakeup, boost::ref(p)), "record_wakeup",
+        hpx::threads::pending, hpx::threads::thread_priority_normal, os_thread);
+
+    return f.get() - start;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map& vm)
+{
+    {
+        boost::uint64_t const samples = vm["samples"].as<boost::uint64_t>();
+        boost::uint64_t const idle_ms = vm["idle-time"].as<boost::uint64_t>();
+        bool const csv = vm.count("csv") != 0;
+
+        if (HPX_UNLIKELY(0 == samples))
+            throw std::logic_error("error: count of 0 samples specified\n");
+
+        std::size_t const num_threads = hpx::get_os_thread_count();
+        if (HPX_UNLIKELY(num_threads < 2))
+            throw std::logic_error("error: this benchmark requires at least "
+                "2 worker threads (use --hpx:threads)\n");
+
+        std::string const policy =
+            hpx::get_config_entry("hpx.idle_backoff.policy", "spin");
+
+        // the task is scheduled on a worker thread other than the one
+        // running the main thread
+        std::size_t const os_thread = (hpx::get_worker_thread_num() + 1) %
+            num_threads;
+
+        std::vector<boost::uint64_t> latencies;
+        latencies.reserve(samples);
+        for (boost::uint64_t i = 0; i != samples; ++i)
+            latencies.push_back(measure_wakeup(os_thread, idle_ms));
+
+        std::sort(latencies.begin(), latencies.end());
+
+        double mean = 0.;
+        for (std::size_t i = 0; i != latencies.size(); ++i)
+            mean += static_cast<double>(latencies[i]);
+        mean /= static_cast<double>(latencies.size());
+
+        boost::uint64_t const minimum = latencies.front();
+        boost::uint64_t const median = latencies[latencies.size() / 2];
+        boost::uint64_t const p99 = latencies[latencies.size() * 99 / 100];
+        boost::uint64_t const maximum = latencies.back();
+
+        if (csv)
+        {
+            cout << ( boost::format("%1%,%2%,%3%,%4%,%5%,%6%,%7%,%8%\n")
+                    % policy
+                    % num_threads
+                    % samples
+                    % minimum
+                    % mean
+                    % median
+                    % p99
+                    % maximum)
+                  << flush;
+        }
+        else
+        {
+            cout << ( boost::format("%1%: %2% threads, %3% samples, "
+                        "wake-up latency [ns]: min %4%, mean %5%, "
+                        "median %6%, 99%% %7%, max %8%\n")
+                    % policy
+                    % num_threads
+                    % samples
+                    % minimum
+                    % mean
+                    % median
+                    % p99
+                    % maximum)
+                  << flush;
+        }
+    }
+
+    return hpx::finalize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    // Configure application-specific options.
+    options_description cmdline("usage: " HPX_APPLICATION_STRING " [options]");
+
+    cmdline.add_options()
+        ( "samples"
+        , value<boost::uint64_t>()->default_value(1000)
+        , "number of wake-ups to measure")
+
+        ( "idle-time"
+        , value<boost::uint64_t>()->default_value(10)
+        , "time (in milliseconds) all worker threads are idle before each "
+          "wake-up")
+
+        ( "csv"
+        , "output results as csv (format: policy,threads,samples,min,mean,"
+          "median,99th percentile,max)")
+        ;
+
+    // Initialize and run HPX, at least two worker threads are required.
+    std::vector<std::string> const cfg(1, "hpx.os_threads=2");
+    return hpx::init(cmdline, argc, argv, cfg);
+}
@@ -0,0 +1,218 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark measures the throughput of the local locks under
+// contention. A number of HPX threads repeatedly acquire the same lock,
+// execute a short critical section, release the lock and do some work
+// outside of the critical section. For the reader/writer locks a
+// configurable share of the acquisitions are shared (read) acquisitions.
+//
+// Besides the overall time, the benchmark reports the spread between the
+// fastest and the slowest thread, which is a measure for the fairness of
+// the lock.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/local_lcos.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/util/high_resolution_timer.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/locks.hpp>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+using boost::program_options::value;
+
+using hpx::util::high_resolution_timer;
+
+using hpx::cout;
+using hpx::flush;
+
+///////////////////////////////////////////////////////////////////////////////
+// we use globals here to prevent the delay from being optimized away
+double global_scratch = 0;
+double shared_data = 0;
+
+boost::uint64_t iterations = 0;
+boost::uint64_t delay = 0;
+boost::uint64_t read_percentage = 0;
+
+void worker(boost::uint64_t n)
+{
+    double d = 0.;
+    for (boost::uint64_t i = 0; i < n; ++i)
+        d += 1. / (2. * i + 1.);
+    global_scratch += d;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// exclusive acquisitions only
+template <typename Mutex>
+struct exclusive_access
+{
+    static void read(Mutex& mtx)
+    {
+        write(mtx);
+    }
+
+    static void write(Mutex& mtx)
+    {
+        boost::unique_lock<Mutex> l(mtx);
+        shared_data += 1.;
+        worker(delay / 10);
+    }
+};
+
+// shared acquisitions for reading
+template <typename Mutex>
+struct shared_access : exclusive_access<Mutex>
+{
+    static void read(Mutex& mtx)
+    {
+        boost::shared_lock<Mutex> l(mtx);
+        global_scratch += shared_data;
+        worker(delay / 10);
+    }
+};
+
+template <typename Access, typename Mutex>
+double run_thread(Mutex& mtx, std::size_t index)
+{
+    high_resolution_timer walltime;
+
+    for (boost::uint64_t i = 0; i != iterations; ++i)
+    {
+        if ((i * 7 + index) % 100 < read_percentage)
+            Access::read(mtx);
+        else
+            Access::write(mtx);
+
+        worker(delay);
+    }
+
+    return walltime.elapsed();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename Access, typename Mutex>
+void measure(char const* name, boost::uint64_t tasks, bool csv)
+{
+    Mutex mtx;
+
+    high_resolution_timer walltime;
+
+    std::vector<hpx::future<double> > futures;
+    futures.reserve(tasks);
+    for (boost::uint64_t i = 0; i != tasks; ++i)
+    {
+        futures.push_back(hpx::async(
+            &run_thread<Access, Mutex>, boost::ref(mtx), std::size_t(i)));
+    }
+
+    std::vector<double> times;
+    times.reserve(tasks);
+    for (std::size_t i = 0; i != futures.size(); ++i)
+        times.push_back(futures[i].get());
+
+    double const duration = walltime.elapsed();
+    double const fastest = *std::min_element(times.begin(), times.end());
+    double const slowest = *std::max_element(times.begin(), times.end());
+
+    if (csv)
+    {
+        cout << ( boost::format("%1%,%2%,%3%,%4%,%5%\n")
+                % name
+                % tasks
+                % duration
+                % fastest
+                % slowest)
+              << flush;
+    }
+    else
+    {
+        cout << ( boost::format("%1%: %2% threads, %3% seconds "
+                    "(%4% ns per acquisition), fastest thread %5% s, "
+                    "slowest thread %6% s\n")
+                % name
+                % tasks
+                % duration
+                % (duration * 1e9 / (tasks * iterations))
+                % fastest
+                % slowest)
+              << flush;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map& vm)
+{
+    {
+        using namespace hpx::lcos::local;
+
+        boost::uint64_t const tasks = vm["tasks"].as<boost::uint64_t>();
+        bool const csv = vm.count("csv") != 0;
+
+        iterations = vm["iterations"].as<boost::uint64_t>();
+        delay = vm["delay"].as<boost::uint64_t>();
+        read_percentage = vm["read-percentage"].as<boost::uint64_t>();
+
+        if (HPX_UNLIKELY(0 == tasks || 0 == iterations))
+            throw std::logic_error("error: count of 0 tasks or iterations "
+                "specified\n");
+        if (HPX_UNLIKELY(read_percentage > 100))
+            throw std::logic_error("error: invalid read percentage specified\n");
+
+        measure<exclusive_access<spinlock>, spinlock>(
+            "spinlock", tasks, csv);
+        measure<exclusive_access<mutex>, mutex>(
+            "mutex", tasks, csv);
+        measure<exclusive_access<fair_mutex>, fair_mutex>(
+            "fair_mutex", tasks, csv);
+        measure<shared_access<shared_mutex>, shared_mutex>(
+            "shared_mutex", tasks, csv);
+        measure<shared_access<fair_shared_mutex>, fair_shared_mutex>(
+            "fair_shared_mutex", tasks, csv);
+    }
+
+    return hpx::finalize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    // Configure application-specific options.
+    options_description cmdline("usage: " HPX_APPLICATION_STRING " [options]");
+
+    cmdline.add_options()
+        ( "tasks"
+        , value<boost::uint64_t>()->default_value(64)
+        , "number of HPX threads contending for the lock")
+
+        ( "iterations"
+        , value<boost::uint64_t>()->default_value(10000)
+        , "number of lock acquisitions per HPX thread")
+
+        ( "delay"
+        , value<boost::uint64_t>()->default_value(100)
+        , "number of iterations in the delay loop executed between two "
+          "lock acquisitions (the critical section executes a tenth of it)")
+
+        ( "read-percentage"
+        , value<boost::uint64_t>()->default_value(90)
+        , "percentage of shared acquisitions for the reader/writer locks")
+
+        ( "csv"
+        , "output results as csv (format: name,tasks,duration,fastest,slowest)")
+        ;
+
+    // Initialize and run HPX.
+    return hpx::init(cmdline, argc, argv);
+}
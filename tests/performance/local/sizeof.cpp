@@ -6,6 +6,7 @@
 #include <hpx/hpx_init.hpp>
 #include <hpx/hpx.hpp>
 #include <hpx/include/iostreams.hpp>
+#include <hpx/runtime/threads/thread_data.hpp>
 
 #include <boost/format.hpp>
 #include <boost/preprocessor/stringize.hpp>
@@ -37,7 +38,13 @@ int hpx_main(
         cout << HPX_SIZEOF(hpx::naming::gid_type)
              << HPX_SIZEOF(hpx::naming::id_type)
              << HPX_SIZEOF(hpx::naming::address)
+             << HPX_SIZEOF(hpx::threads::thread_data_base)
              << HPX_SIZEOF(hpx::threads::thread_data)
+             << HPX_SIZEOF(hpx::threads::stackless_thread_data)
+#if HPX_THREAD_MAINTAIN_COLD_DATA != 0
+             // debugging information, allocated separately on first use
+             << HPX_SIZEOF(hpx::threads::detail::thread_data_cold)
+#endif
              << flush;
     }
 
@@ -0,0 +1,203 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This benchmark compares the overhead of executing work items which never
+// suspend using stackful coroutines (as measured by coroutines_call_overhead)
+// with the overhead of executing them as stackless (run-to-completion)
+// threads:
+//
+//  - coroutine: invoke a stackful coroutine and a stackless coroutine
+//    directly, which measures the cost of the context switch
+//  - task: spawn tasks using hpx::async(hpx::launch::async) and
+//    hpx::async(hpx::launch::stackless) and wait for all of them
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/hpx.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/util/high_resolution_timer.hpp>
+#include <hpx/util/coroutine/stackless_coroutine.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/cstdint.hpp>
+
+#include "worker_timed.hpp"
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+using boost::program_options::value;
+
+using hpx::threads::thread_state_enum;
+using hpx::threads::thread_state_ex_enum;
+
+using hpx::util::high_resolution_timer;
+
+using hpx::cout;
+using hpx::flush;
+
+typedef hpx::util::coroutines::stackless_coroutine<
+        hpx::threads::thread_function_sig
+    > stackless_coroutine_type;
+
+///////////////////////////////////////////////////////////////////////////////
+boost::uint64_t payload = 0;
+
+struct kernel
+{
+    kernel(thread_state_enum result = hpx::threads::terminated)
+      : result_(result)
+    {}
+
+    thread_state_enum operator()(thread_state_ex_enum) const
+    {
+        worker_timed(payload * 1000);
+        return result_;
+    }
+
+    bool operator!() const { return true; }
+
+    thread_state_enum result_;
+};
+
+void task_kernel()
+{
+    worker_timed(payload * 1000);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// returns the elapsed time in seconds
+double invoke_stackful(boost::uint64_t iterations)
+{
+    // the coroutine yields after each invocation, each invocation involves
+    // two context switches
+    hpx::threads::coroutine_type c(kernel(hpx::threads::pending),
+        hpx::find_here());
+
+    c(hpx::threads::wait_signaled);     // warmup
+
+    high_resolution_timer t;
+    for (boost::uint64_t i = 0; i != iterations; ++i)
+        c(hpx::threads::wait_signaled);
+    return t.elapsed();
+}
+
+double invoke_stackless(boost::uint64_t iterations)
+{
+    // a stackless coroutine always runs to completion, it has to be rebound
+    // before each invocation (as done when recycling a thread object)
+    stackless_coroutine_type c(kernel(hpx::threads::terminated),
+        hpx::find_here());
+
+    high_resolution_timer t;
+    for (boost::uint64_t i = 0; i != iterations; ++i)
+    {
+        c(hpx::threads::wait_signaled);
+        c.rebind(kernel(hpx::threads::terminated), hpx::find_here());
+    }
+    return t.elapsed();
+}
+
+double spawn_tasks(BOOST_SCOPED_ENUM(hpx::launch) policy,
+    boost::uint64_t tasks)
+{
+    std::vector<hpx::future<void> > futures;
+    futures.reserve(tasks);
+
+    high_resolution_timer t;
+    for (boost::uint64_t i = 0; i != tasks; ++i)
+        futures.push_back(hpx::async(policy, &task_kernel));
+    hpx::wait_all(futures);
+    return t.elapsed();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map& vm)
+{
+    {
+        boost::uint64_t const iterations =
+            vm["iterations"].as<boost::uint64_t>();
+        boost::uint64_t const tasks = vm["tasks"].as<boost::uint64_t>();
+        bool const csv = vm.count("csv") != 0;
+
+        if (HPX_UNLIKELY(0 == iterations))
+            throw std::logic_error("error: count of 0 iterations specified\n");
+        if (HPX_UNLIKELY(0 == tasks))
+            throw std::logic_error("error: count of 0 tasks specified\n");
+
+        // per invocation/task overheads in nanoseconds
+        double const payload_time = payload * 1e-6;
+        double const stackful_call =
+            (invoke_stackful(iterations) / iterations - payload_time) * 1e9;
+        double const stackless_call =
+            (invoke_stackless(iterations) / iterations - payload_time) * 1e9;
+
+        double const stackful_task =
+            (spawn_tasks(hpx::launch::async, tasks) / tasks) * 1e9;
+        double const stackless_task =
+            (spawn_tasks(hpx::launch::stackless, tasks) / tasks) * 1e9;
+
+        std::size_t const num_threads = hpx::get_os_thread_count();
+
+        if (csv)
+        {
+            cout << ( boost::format("%1%,%2%,%3%,%4%,%5%,%6%,%7%,%8%\n")
+                    % payload
+                    % num_threads
+                    % iterations
+                    % tasks
+                    % stackful_call
+                    % stackless_call
+                    % stackful_task
+                    % stackless_task)
+                  << flush;
+        }
+        else
+        {
+            cout << ( boost::format("%1% threads, payload %2% [us]\n"
+                        "coroutine invocation overhead [ns]: "
+                            "stackful %3%, stackless %4%\n"
+                        "task overhead [ns]: stackful %5%, stackless %6%\n")
+                    % num_threads
+                    % payload
+                    % stackful_call
+                    % stackless_call
+                    % stackful_task
+                    % stackless_task)
+                  << flush;
+        }
+    }
+
+    return hpx::finalize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    // Configure application-specific options.
+    options_description cmdline("usage: " HPX_APPLICATION_STRING " [options]");
+
+    cmdline.add_options()
+        ( "payload"
+        , value<boost::uint64_t>(&payload)->default_value(0)
+        , "artificial delay of each work item (in micro-seconds)")
+
+        ( "iterations"
+        , value<boost::uint64_t>()->default_value(100000)
+        , "number of coroutine invocations to measure")
+
+        ( "tasks"
+        , value<boost::uint64_t>()->default_value(100000)
+        , "number of tasks to spawn")
+
+        ( "csv"
+        , "output results as csv (format: payload,threads,iterations,tasks,"
+          "stackful call,stackless call,stackful task,stackless task)")
+        ;
+
+    // Initialize and run HPX
+    return hpx::init(cmdline, argc, argv);
+}
@@ -81,6 +81,11 @@ recv_async(hpx::naming::id_type dest, std::size_t size, std::size_t window_size)
 void print_header ()
 {
     hpx::cout << "# OSU HPX Bi-Directional Test\n"
+              << "# TCP rails: "
+              << hpx::get_config_entry("hpx.parcel.tcp.rails", "1")
+              << ", rail threshold: "
+              << hpx::get_config_entry("hpx.parcel.tcp.rail_threshold", "")
+              << "\n"
               << "# Size    Bandwidth (MB/s)\n"
               << hpx::flush;
 }
@@ -96,8 +101,15 @@ void run_benchmark(boost::program_options::variables_map & vm)
     if (!localities.empty())
         there = localities[0];
 
+    std::size_t min_size = vm["min-size"].as<std::size_t>();
+    std::size_t max_size = vm["max-size"].as<std::size_t>();
+
+    if(max_size < min_size) std::swap(max_size, min_size);
+    max_size = (std::min)(max_size, std::size_t(MAX_MSG_SIZE));
+
     // perform actual measurements
-    for (std::size_t size = 1; size <= MAX_MSG_SIZE; size *= 2)
+    for (std::size_t size = (std::max)(min_size, std::size_t(1));
+         size <= max_size; size *= 2)
     {
         std::size_t loop = LOOP_SMALL;
         std::size_t skip = SKIP_SMALL;
@@ -38,7 +38,6 @@ unsigned long getpagesize()
 
 #define LARGE_MESSAGE_SIZE  8192
 
-#define MAX_MSG_SIZE (1<<22)
 #define MAX_ALIGNMENT 65536
 
 
@@ -99,6 +98,11 @@ double ireceive(hpx::naming::id_type dest, std::size_t size, std::size_t window_
 void print_header ()
 {
     hpx::cout << "# OSU HPX Bandwidth Test\n"
+              << "# TCP rails: "
+              << hpx::get_config_entry("hpx.parcel.tcp.rails", "1")
+              << ", rail threshold: "
+              << hpx::get_config_entry("hpx.parcel.tcp.rail_threshold", "")
+              << "\n"
               << "# Size    Bandwidth (MB/s)\n"
               << hpx::flush;
 }
@@ -113,8 +117,14 @@ void run_benchmark(boost::program_options::variables_map & vm)
     if (!localities.empty())
         there = localities[0];
 
+    std::size_t min_size = vm["min-size"].as<std::size_t>();
+    std::size_t max_size = vm["max-size"].as<std::size_t>();
+
+    if(max_size < min_size) std::swap(max_size, min_size);
+
     // perform actual measurements
-    for (std::size_t size = 1; size <= MAX_MSG_SIZE; size *= 2)
+    for (std::size_t size = (std::max)(min_size, std::size_t(1));
+         size <= max_size; size *= 2)
     {
         double bw = ireceive(there, size, vm["window-size"].as<std::size_t>());
         hpx::cout << std::left << std::setw(10) << size
@@ -0,0 +1,247 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Collective operations latency and bandwidth test for the tree_communicator
+//
+// All localities run the same sequence of broadcast, reduce and all_reduce
+// operations for each message size. The reported latency is the average time
+// per operation as measured on the slowest locality, the bandwidth is the
+// message size divided by this latency.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/hpx.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/lcos/tree_communicator.hpp>
+#include <hpx/util/high_resolution_timer.hpp>
+
+#include <boost/format.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+#define SKIP 100
+#define SKIP_LARGE 10
+#define LARGE_MESSAGE_SIZE 8192
+
+HPX_REGISTER_TREE_COMMUNICATOR_DECLARATION(double, osu_double);
+HPX_REGISTER_TREE_COMMUNICATOR(double, osu_double);
+
+struct params
+{
+    std::size_t min_size;
+    std::size_t max_size;
+    std::size_t loop;
+    int topology;
+    std::size_t fanout;
+    std::size_t segment_size;
+
+    template <typename Archive>
+    void serialize(Archive & ar, unsigned)
+    {
+        ar & min_size;
+        ar & max_size;
+        ar & loop;
+        ar & topology;
+        ar & fanout;
+        ar & segment_size;
+    }
+};
+
+struct max_op
+{
+    double operator()(double lhs, double rhs) const
+    {
+        return (std::max)(lhs, rhs);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename F>
+double measure(F const& f, std::size_t size, std::size_t loop)
+{
+    std::size_t skip = (size > LARGE_MESSAGE_SIZE) ? SKIP_LARGE : SKIP;
+
+    hpx::util::high_resolution_timer t;
+    for (std::size_t i = 0; i != loop + skip; ++i)
+    {
+        // do not measure warm up phase
+        if (i == skip)
+            t.restart();
+        f();
+    }
+    return (t.elapsed() * 1e6) / loop;
+}
+
+struct run_broadcast
+{
+    typedef void result_type;
+
+    run_broadcast(hpx::lcos::tree_communicator<double>& comm,
+            std::vector<double> const& data)
+      : comm_(comm), data_(data)
+    {}
+
+    void operator()() const
+    {
+        comm_.broadcast(data_).get();
+    }
+
+    hpx::lcos::tree_communicator<double>& comm_;
+    std::vector<double> const& data_;
+};
+
+struct run_reduce
+{
+    typedef void result_type;
+
+    run_reduce(hpx::lcos::tree_communicator<double>& comm,
+            std::vector<double> const& data)
+      : comm_(comm), data_(data)
+    {}
+
+    void operator()() const
+    {
+        comm_.reduce(data_, std::plus<double>()).get();
+    }
+
+    hpx::lcos::tree_communicator<double>& comm_;
+    std::vector<double> const& data_;
+};
+
+struct run_all_reduce
+{
+    typedef void result_type;
+
+    run_all_reduce(hpx::lcos::tree_communicator<double>& comm,
+            std::vector<double> const& data)
+      : comm_(comm), data_(data)
+    {}
+
+    void operator()() const
+    {
+        comm_.all_reduce(data_, std::plus<double>()).get();
+    }
+
+    hpx::lcos::tree_communicator<double>& comm_;
+    std::vector<double> const& data_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+void run_benchmark(params const& p)
+{
+    hpx::lcos::tree_options options(
+        static_cast<hpx::lcos::tree_topology>(p.topology), p.fanout,
+        p.segment_size / sizeof(double));
+    hpx::lcos::tree_communicator<double> comm("/osu/tree_coll",
+        hpx::get_num_localities_sync(), hpx::get_locality_id(), options);
+
+    bool const root = comm.this_site() == 0;
+    if (root)
+    {
+        hpx::cout << "# Size      Bcast (us)  Reduce (us) Allreduce (us) "
+                     "Bcast (MB/s) Reduce (MB/s) Allreduce (MB/s)\n"
+                  << hpx::flush;
+    }
+
+    for (std::size_t size = p.min_size; size <= p.max_size; size *= 2)
+    {
+        std::vector<double> data(
+            (std::max)(size / sizeof(double), std::size_t(1)), 1.0);
+
+        std::vector<double> latencies(3);
+        latencies[0] = measure(run_broadcast(comm, data), size, p.loop);
+        latencies[1] = measure(run_reduce(comm, data), size, p.loop);
+        latencies[2] = measure(run_all_reduce(comm, data), size, p.loop);
+
+        // report the numbers of the slowest locality
+        latencies = comm.reduce(latencies, max_op()).get();
+
+        if (root)
+        {
+            std::size_t bytes = data.size() * sizeof(double);
+            hpx::cout << ( boost::format(
+                        "%-11d %-11.2f %-11.2f %-14.2f %-12.2f %-13.2f %-.2f\n")
+                    % bytes
+                    % latencies[0] % latencies[1] % latencies[2]
+                    % (bytes / latencies[0])
+                    % (bytes / latencies[1])
+                    % (bytes / latencies[2]))
+                << hpx::flush;
+        }
+    }
+}
+HPX_PLAIN_ACTION(run_benchmark, run_benchmark_action);
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(boost::program_options::variables_map & vm)
+{
+    std::string topology = vm["topology"].as<std::string>();
+
+    params p;
+    p.min_size = (std::max)(vm["min-size"].as<std::size_t>(), sizeof(double));
+    p.max_size = vm["max-size"].as<std::size_t>();
+    p.loop = vm["loop"].as<std::size_t>();
+    p.fanout = vm["fanout"].as<std::size_t>();
+    p.segment_size = vm["segment-size"].as<std::size_t>();
+
+    if (topology == "binomial")
+        p.topology = hpx::lcos::binomial_tree;
+    else if (topology == "kary")
+        p.topology = hpx::lcos::kary_tree;
+    else if (topology == "ring")
+        p.topology = hpx::lcos::ring_topology;
+    else
+    {
+        hpx::cout << "unknown topology: " << topology << "\n" << hpx::flush;
+        return hpx::finalize();
+    }
+
+    hpx::cout << "# OSU HPX Tree Collectives Test (" << topology
+              << ", fanout " << p.fanout << ", segment size "
+              << p.segment_size << " bytes)\n" << hpx::flush;
+
+    std::vector<hpx::id_type> localities = hpx::find_all_localities();
+
+    std::vector<hpx::future<void> > futures;
+    futures.reserve(localities.size());
+    for (std::size_t i = 0; i != localities.size(); ++i)
+    {
+        futures.push_back(hpx::async<run_benchmark_action>(localities[i], p));
+    }
+    hpx::wait_all(futures);
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    boost::program_options::options_description
+        desc("Usage: " HPX_APPLICATION_STRING " [options]");
+
+    desc.add_options()
+        ("loop",
+         boost::program_options::value<std::size_t>()->default_value(100),
+         "Number of loops")
+        ("min-size",
+         boost::program_options::value<std::size_t>()->default_value(8),
+         "Minimum size of message to send (in bytes)")
+        ("max-size",
+         boost::program_options::value<std::size_t>()->default_value((1<<22)),
+         "Maximum size of message to send (in bytes)")
+        ("topology",
+         boost::program_options::value<std::string>()->default_value("binomial"),
+         "Topology of the communication tree (binomial, kary, or ring)")
+        ("fanout",
+         boost::program_options::value<std::size_t>()->default_value(2),
+         "Number of children per site of the k-ary tree")
+        ("segment-size",
+         boost::program_options::value<std::size_t>()->default_value(65536),
+         "Maximum size of a segment (in bytes), 0 disables segmentation");
+
+    return hpx::init(desc, argc, argv);
+}
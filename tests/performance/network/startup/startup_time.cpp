@@ -0,0 +1,127 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Startup time benchmark
+//
+// This measures the time it takes for all localities to pass the startup
+// barrier (big_boot_barrier). The time stamps taken by the different
+// processes are compared, thus all localities have to run on the same
+// machine. Many localities can be launched using the TCP parcelport over the
+// loopback interface, for instance:
+//
+//      hpxrun.py -l 256 -t 1 -p tcp startup_time
+//
+// The shape of the tree used to release the localities from the startup
+// barrier can be changed with -Ihpx.agas.boot_barrier_arity=<N>.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/hpx.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// time stamps (in nanoseconds) taken on each of the localities
+boost::uint64_t process_start = 0;      // before the runtime is initialized
+boost::uint64_t runtime_start = 0;      // after the startup barrier
+
+void record_runtime_start()
+{
+    runtime_start = hpx::util::high_resolution_clock::now();
+}
+
+std::vector<boost::uint64_t> get_startup_times()
+{
+    std::vector<boost::uint64_t> times;
+    times.push_back(process_start);
+    times.push_back(runtime_start);
+    return times;
+}
+HPX_PLAIN_ACTION(get_startup_times, get_startup_times_action);
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(boost::program_options::variables_map& vm)
+{
+    boost::uint64_t const main_start = hpx::util::high_resolution_clock::now();
+
+    std::vector<hpx::naming::id_type> localities = hpx::find_all_localities();
+
+    std::vector<hpx::future<std::vector<boost::uint64_t> > > futures;
+    futures.reserve(localities.size());
+    for (std::size_t i = 0; i != localities.size(); ++i)
+    {
+        futures.push_back(
+            hpx::async<get_startup_times_action>(localities[i]));
+    }
+
+    boost::uint64_t first_process_start = process_start;
+    boost::uint64_t last_runtime_start = runtime_start;
+    boost::uint64_t max_locality_startup = 0;
+
+    for (std::size_t i = 0; i != futures.size(); ++i)
+    {
+        std::vector<boost::uint64_t> times = futures[i].get();
+
+        first_process_start = (std::min)(first_process_start, times[0]);
+        last_runtime_start = (std::max)(last_runtime_start, times[1]);
+        max_locality_startup =
+            (std::max)(max_locality_startup, times[1] - times[0]);
+    }
+
+    std::string arity = hpx::get_config_entry("hpx.agas.boot_barrier_arity", "");
+
+    if (vm.count("csv"))
+    {
+        hpx::cout
+            << ( boost::format("%1%,%2%,%3%,%4%,%5%\n")
+               % localities.size()
+               % arity
+               % ((last_runtime_start - first_process_start) / 1e9)
+               % (max_locality_startup / 1e9)
+               % ((main_start - first_process_start) / 1e9))
+            << hpx::flush;
+    }
+    else
+    {
+        hpx::cout
+            << "localities:                      " << localities.size() << "\n"
+            << "boot barrier arity:              " << arity << "\n"
+            << ( boost::format(
+                 "all localities started [s]:      %1%\n"
+                 "max. locality startup [s]:       %2%\n"
+                 "hpx_main started [s]:            %3%\n")
+               % ((last_runtime_start - first_process_start) / 1e9)
+               % (max_locality_startup / 1e9)
+               % ((main_start - first_process_start) / 1e9))
+            << hpx::flush;
+    }
+
+    return hpx::finalize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    process_start = hpx::util::high_resolution_clock::now();
+
+    boost::program_options::options_description
+        desc("Usage: " HPX_APPLICATION_STRING " [options]");
+
+    desc.add_options()
+        ("csv", "print results in csv format (localities, arity, all "
+            "localities started, max. locality startup, hpx_main started)");
+
+    // the startup functions are run on all localities once the startup
+    // barrier has been passed
+    hpx::register_startup_function(&record_runtime_start);
+
+    return hpx::init(desc, argc, argv);
+}
@@ -0,0 +1,163 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Verify that output written concurrently by many HPX threads is forwarded
+// to the console completely, without interleaving of lines (even if threads
+// are suspended in the middle of a line), and in order for each thread
+// writing it. Also check the counters reporting the forwarded output.
+
+#include <hpx/hpx.hpp>
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/iostreams.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+std::size_t const num_sources = 100;
+std::size_t const num_lines = 10;
+
+///////////////////////////////////////////////////////////////////////////////
+std::string make_line(boost::uint32_t locality, std::size_t source,
+    std::size_t i)
+{
+    return "locality " + boost::lexical_cast<std::string>(locality) +
+        ", source " + boost::lexical_cast<std::string>(source) +
+        ", line " + boost::lexical_cast<std::string>(i);
+}
+
+void write_lines(std::size_t source)
+{
+    for (std::size_t i = 0; i != num_lines; ++i)
+    {
+        hpx::consolestream << "locality " << hpx::get_locality_id()
+                           << ", source " << source;
+
+        // the rest of the line might be written from another worker thread
+        hpx::this_thread::yield();
+
+        hpx::consolestream << ", line " << i << hpx::async_endl;
+    }
+}
+
+void worker()
+{
+    std::vector<hpx::future<void> > futures;
+    futures.reserve(num_sources);
+
+    for (std::size_t i = 0; i != num_sources; ++i)
+        futures.push_back(hpx::async(&write_lines, i));
+    hpx::wait_all(futures);
+
+    // send all output collected so far
+    hpx::consolestream << hpx::flush;
+}
+HPX_PLAIN_ACTION(worker, worker_action);
+
+///////////////////////////////////////////////////////////////////////////////
+boost::int64_t query_counter(boost::uint32_t locality, char const* name)
+{
+    using hpx::performance_counters::get_counter;
+    using hpx::performance_counters::stubs::performance_counter;
+
+    boost::format counter_name("/iostreams{locality#%d/total}/count/%s");
+    hpx::naming::id_type id = get_counter(
+        boost::str(counter_name % locality % name));
+
+    return performance_counter::get_value(id).get_value<boost::int64_t>();
+}
+
+void test_counters(boost::uint32_t locality, std::size_t bytes)
+{
+    boost::int64_t messages = query_counter(locality, "forwarded-messages");
+    boost::int64_t forwarded = query_counter(locality, "forwarded-bytes");
+    boost::int64_t batches = query_counter(locality, "forwarded-batches");
+
+    // every line was flushed separately, other output might have been sent
+    // in addition
+    HPX_TEST(messages >= boost::int64_t(num_sources * num_lines));
+    HPX_TEST(forwarded >= boost::int64_t(bytes));
+
+    // batches combine messages
+    HPX_TEST(batches > 0);
+    HPX_TEST(batches <= messages);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(boost::program_options::variables_map& vm)
+{
+    std::vector<hpx::future<void> > futures;
+    std::vector<std::string> expected;
+    std::map<boost::uint32_t, std::size_t> expected_bytes;
+
+    std::vector<hpx::id_type> localities = hpx::find_all_localities();
+    BOOST_FOREACH(hpx::id_type l, localities)
+    {
+        futures.push_back(hpx::async(worker_action(), l));
+
+        boost::uint32_t locality = hpx::naming::get_locality_id_from_id(l);
+        for (std::size_t s = 0; s != num_sources; ++s)
+        {
+            for (std::size_t i = 0; i != num_lines; ++i)
+            {
+                expected.push_back(make_line(locality, s, i));
+                expected_bytes[locality] += expected.back().size() + 1;
+            }
+        }
+    }
+    hpx::wait_all(futures);
+
+    std::vector<std::string> lines;
+    {
+        std::istringstream is(hpx::get_consolestream().str());
+        std::string line;
+        while (std::getline(is, line))
+            lines.push_back(line);
+    }
+
+    // the lines written by each source have to be in order
+    std::map<std::pair<boost::uint32_t, std::size_t>, std::size_t> next_line;
+    BOOST_FOREACH(std::string const& line, lines)
+    {
+        unsigned int locality = 0;
+        unsigned long source = 0, i = 0;
+        HPX_TEST_EQ(std::sscanf(line.c_str(),
+            "locality %u, source %lu, line %lu", &locality, &source, &i), 3);
+
+        std::size_t& next = next_line[std::make_pair(
+            boost::uint32_t(locality), std::size_t(source))];
+        HPX_TEST_EQ(std::size_t(i), next);
+        next = i + 1;
+    }
+
+    // all lines have to be there
+    std::sort(lines.begin(), lines.end());
+    std::sort(expected.begin(), expected.end());
+    HPX_TEST(lines == expected);
+
+    typedef std::map<boost::uint32_t, std::size_t>::value_type value_type;
+    BOOST_FOREACH(value_type const& v, expected_bytes)
+        test_counters(v.first, v.second);
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    HPX_TEST_EQ_MSG(hpx::init(argc, argv), 0,
+        "HPX main exited with non-zero status");
+
+    return hpx::util::report_errors();
+}
@@ -8,6 +8,7 @@
 #include <hpx/include/lcos.hpp>
 #include <hpx/include/apply.hpp>
 #include <hpx/include/async.hpp>
+#include <hpx/include/threads.hpp>
 #include <hpx/util/lightweight_test.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -80,6 +81,13 @@ struct do_nothing_member
     }
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// stackless threads are not allowed to suspend
+void suspend_self()
+{
+    hpx::this_thread::suspend();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 int hpx_main()
 {
@@ -97,7 +105,30 @@ int hpx_main()
         hpx::future<void> f4 = hpx::async(hpx::launch::sync, &do_nothing, 42);
         f4.get();
     }
-    
+
+    {
+        hpx::future<boost::int32_t> f1 =
+            hpx::async(hpx::launch::stackless, &increment, 42);
+        HPX_TEST_EQ(f1.get(), 43);
+
+        hpx::future<boost::int32_t> f2 =
+            hpx::async(hpx::launch::stackless, &increment, 42);
+        hpx::future<boost::int32_t> f3 = f2.then(hpx::launch::stackless,
+            [](hpx::future<boost::int32_t> f) { return f.get() + 1; });
+        HPX_TEST_EQ(f3.get(), 44);
+
+        bool caught_exception = false;
+        try {
+            hpx::async(hpx::launch::stackless, &suspend_self).get();
+            HPX_TEST(false);
+        }
+        catch (hpx::exception const& e) {
+            caught_exception = true;
+            HPX_TEST_EQ(e.get_error(), hpx::null_thread_id);
+        }
+        HPX_TEST(caught_exception);
+    }
+
     {
         hpx::promise<boost::int32_t> p;
         hpx::shared_future<boost::int32_t> f = p.get_future();
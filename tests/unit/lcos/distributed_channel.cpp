@@ -0,0 +1,183 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/actions.hpp>
+#include <hpx/lcos/distributed_channel.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+HPX_REGISTER_DISTRIBUTED_CHANNEL_DECLARATION(std::size_t, size_t);
+HPX_REGISTER_DISTRIBUTED_CHANNEL(std::size_t, size_t);
+
+typedef hpx::lcos::distributed_channel<std::size_t> channel_type;
+typedef hpx::lcos::distributed_channel_sender<std::size_t> sender_type;
+
+std::size_t const count = 10000;
+
+///////////////////////////////////////////////////////////////////////////////
+// every producer sends the values [producer * count, (producer + 1) * count)
+void produce(hpx::id_type const& channel, std::size_t producer,
+    std::size_t batch_size)
+{
+    sender_type sender(channel, batch_size);
+    for (std::size_t i = 0; i != count; ++i)
+        sender.send(producer * count + i);
+    sender.close().get();
+}
+HPX_PLAIN_ACTION(produce, produce_action);
+
+void test_distributed_channel(std::size_t capacity, std::size_t batch_size)
+{
+    std::vector<hpx::id_type> localities = hpx::find_all_localities();
+
+    channel_type channel(hpx::find_here(), capacity);
+    hpx::id_type id = channel.get_gid();
+
+    // launch one producer on each locality
+    std::vector<hpx::future<void> > producers;
+    for (std::size_t i = 0; i != localities.size(); ++i)
+    {
+        producers.push_back(hpx::async<produce_action>(
+            localities[i], id, i, batch_size));
+    }
+
+    // receive all values, values sent by the same producer have to be
+    // received in order
+    std::vector<std::size_t> next(localities.size(), 0);
+    std::size_t received = 0;
+    while (received != count * localities.size())
+    {
+        std::vector<std::size_t> values = channel.receive_n(batch_size).get();
+        HPX_TEST(!values.empty());
+        HPX_TEST(values.size() <= batch_size);
+
+        for (std::size_t i = 0; i != values.size(); ++i)
+        {
+            std::size_t producer = values[i] / count;
+            HPX_TEST(producer < localities.size());
+            HPX_TEST_EQ(values[i] % count, next[producer]);
+            ++next[producer];
+        }
+        received += values.size();
+    }
+
+    hpx::wait_all(producers);
+
+    for (std::size_t i = 0; i != localities.size(); ++i)
+        HPX_TEST_EQ(next[i], count);
+}
+
+void test_receive_single_values()
+{
+    channel_type channel(hpx::find_here(), 4);
+
+    sender_type sender(channel.get_gid(), 1);
+    sender.send(42);
+    sender.send(43);
+
+    HPX_TEST_EQ(channel.receive().get(), std::size_t(42));
+    HPX_TEST_EQ(channel.receive().get(), std::size_t(43));
+
+    sender.close().get();
+}
+
+// every producer fills its share of the channel and closes its sender
+// while its next credit request is still pending
+void fill(hpx::id_type const& channel, std::size_t producer,
+    std::size_t num_values)
+{
+    sender_type sender(channel, num_values);
+    for (std::size_t i = 0; i != num_values; ++i)
+        sender.send(producer * count + i);
+    sender.close().get();
+}
+HPX_PLAIN_ACTION(fill, fill_action);
+
+void test_close_full_channel()
+{
+    std::vector<hpx::id_type> localities = hpx::find_all_localities();
+
+    std::size_t const num_values = 4;
+    channel_type channel(hpx::find_here(), num_values * localities.size());
+    hpx::id_type id = channel.get_gid();
+
+    // the producers have to be able to close the channel while it is full
+    std::vector<hpx::future<void> > producers;
+    for (std::size_t i = 0; i != localities.size(); ++i)
+    {
+        producers.push_back(hpx::async<fill_action>(
+            localities[i], id, i, num_values));
+    }
+    hpx::wait_all(producers);
+
+    // drain the channel only after all producers are done
+    std::vector<std::size_t> next(localities.size(), 0);
+    for (std::size_t i = 0; i != num_values * localities.size(); ++i)
+    {
+        std::size_t value = channel.receive().get();
+        std::size_t producer = value / count;
+        HPX_TEST(producer < localities.size());
+        HPX_TEST_EQ(value % count, next[producer]);
+        ++next[producer];
+    }
+
+    for (std::size_t i = 0; i != localities.size(); ++i)
+        HPX_TEST_EQ(next[i], num_values);
+
+    // the credit requested by the closed senders must have been released
+    fill(id, 0, num_values * localities.size());
+    for (std::size_t i = 0; i != num_values * localities.size(); ++i)
+        HPX_TEST_EQ(channel.receive().get(), i);
+}
+
+void test_close_drained_channel()
+{
+    std::size_t const capacity = 8;
+
+    channel_type channel(hpx::find_here(), capacity);
+    hpx::id_type id = channel.get_gid();
+
+    // the values are delivered and received before the sender is closed
+    sender_type sender(id, capacity);
+    for (std::size_t i = 0; i != capacity; ++i)
+        sender.send(i);
+
+    for (std::size_t i = 0; i != capacity; ++i)
+        HPX_TEST_EQ(channel.receive().get(), i);
+
+    sender.close().get();
+
+    // the whole capacity has to be available again, otherwise this blocks
+    fill(id, 0, capacity);
+    for (std::size_t i = 0; i != capacity; ++i)
+        HPX_TEST_EQ(channel.receive().get(), i);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main()
+{
+    test_receive_single_values();
+    test_close_full_channel();
+    test_close_drained_channel();
+
+    // the capacity is smaller than the number of values sent, which forces
+    // the producers to wait for credit
+    test_distributed_channel(16, 1);
+    test_distributed_channel(128, 16);
+    test_distributed_channel(1024, 64);
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    HPX_TEST_EQ_MSG(hpx::init(argc, argv), 0,
+        "HPX main exited with non-zero status");
+    return hpx::util::report_errors();
+}
@@ -674,6 +674,65 @@ void test_wait_swapped_for_either_of_two_futures_list_2()
     HPX_TEST_EQ(t[1].get(), 42);
 }
 
+void test_wait_index_for_either_of_two_futures_list_1()
+{
+    std::vector<hpx::lcos::future<int> > futures;
+    hpx::lcos::local::packaged_task<int()> pt1(make_int_slowly);
+    futures.push_back(pt1.get_future());
+    hpx::lcos::local::packaged_task<int()> pt2(make_int_slowly);
+    futures.push_back(pt2.get_future());
+
+    pt2();
+
+    hpx::lcos::future<hpx::when_any_result<
+        std::vector<hpx::lcos::future<int> > > > r =
+            hpx::when_any_index(futures);
+    hpx::when_any_result<std::vector<hpx::lcos::future<int> > > t = r.get();
+
+    HPX_TEST(!futures[0].valid());
+    HPX_TEST(!futures[1].valid());
+
+    HPX_TEST_EQ(t.index, 1u);
+    HPX_TEST_EQ(t.futures.size(), 2u);
+    HPX_TEST(t.futures[1].is_ready());
+    HPX_TEST_EQ(t.futures[1].get(), 42);
+}
+
+void test_wait_index_for_either_of_five_futures_1_from_list_iterators()
+{
+    std::vector<hpx::lcos::future<int> > futures;
+    std::vector<hpx::lcos::local::packaged_task<int()> > tasks;
+    for (unsigned j = 0; j < 5; ++j)
+    {
+        tasks.push_back(hpx::lcos::local::packaged_task<int()>(make_int_slowly));
+        futures.push_back(tasks.back().get_future());
+    }
+
+    hpx::lcos::future<hpx::when_any_result<
+        std::vector<hpx::lcos::future<int> > > > r =
+            hpx::when_any_index(futures.begin(), futures.end());
+
+    // none of the futures is ready yet
+    HPX_TEST(!r.is_ready());
+
+    tasks[3]();
+
+    hpx::when_any_result<std::vector<hpx::lcos::future<int> > > t = r.get();
+
+    HPX_TEST_EQ(t.index, 3u);
+    HPX_TEST_EQ(t.futures.size(), 5u);
+    HPX_TEST(t.futures[3].is_ready());
+    HPX_TEST_EQ(t.futures[3].get(), 42);
+
+    // make sure the callbacks attached to the remaining futures are safe to
+    // run after the result has been retrieved
+    for (unsigned j = 0; j < 5; ++j)
+    {
+        if (j != 3)
+            tasks[j]();
+    }
+}
+
 void test_wait_for_either_of_three_futures_1()
 {
     hpx::lcos::local::packaged_task<int()> pt1(make_int_slowly);
@@ -1335,6 +1394,40 @@ void test_wait_for_all_from_list_iterators()
     }
 }
 
+void test_wait_for_all_from_large_list()
+{
+    unsigned const count = 10000;
+    std::vector<hpx::lcos::local::promise<int> > promises(count);
+    std::vector<hpx::lcos::future<int> > futures;
+    futures.reserve(count);
+    for (unsigned j = 0; j < count; ++j)
+    {
+        futures.push_back(promises[j].get_future());
+
+        // make every other future ready before calling when_all
+        if (j % 2)
+            promises[j].set_value(42);
+    }
+
+    hpx::lcos::future<std::vector<hpx::lcos::future<int> > > r =
+        hpx::when_all(futures);
+
+    HPX_TEST(!r.is_ready());
+
+    for (unsigned j = 0; j < count; j += 2)
+        promises[j].set_value(42);
+
+    std::vector<hpx::lcos::future<int> > result = r.get();
+
+    HPX_TEST_EQ(result.size(), count);
+    for (unsigned j = 0; j < count; ++j)
+    {
+        HPX_TEST(!futures[j].valid());
+        HPX_TEST(result[j].is_ready());
+        HPX_TEST_EQ(result[j].get(), 42);
+    }
+}
+
 void test_wait_for_all_two_futures()
 {
     hpx::lcos::local::futures_factory<int()> pt1(make_int_slowly);
@@ -1585,6 +1678,8 @@ int hpx_main(variables_map&)
         test_wait_for_either_of_two_futures_list_2();
         test_wait_swapped_for_either_of_two_futures_list_1();
         test_wait_swapped_for_either_of_two_futures_list_2();
+        test_wait_index_for_either_of_two_futures_list_1();
+        test_wait_index_for_either_of_five_futures_1_from_list_iterators();
         test_wait_for_either_of_three_futures_1();
         test_wait_for_either_of_three_futures_2();
         test_wait_for_either_of_three_futures_3();
@@ -1605,6 +1700,7 @@ int hpx_main(variables_map&)
 //         test_wait_for_any_from_range();
         test_wait_for_all_from_list();
         test_wait_for_all_from_list_iterators();
+        test_wait_for_all_from_large_list();
         test_wait_for_all_two_futures();
         test_wait_for_all_three_futures();
         test_wait_for_all_four_futures();
@@ -0,0 +1,179 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/assign/std/vector.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+using boost::program_options::value;
+
+typedef hpx::lcos::local::bounded_channel<std::size_t> channel_type;
+
+///////////////////////////////////////////////////////////////////////////////
+void test_try_send_receive()
+{
+    channel_type ch(3);
+    HPX_TEST_EQ(ch.capacity(), std::size_t(4));
+    HPX_TEST(ch.empty());
+
+    for (std::size_t i = 0; i != ch.capacity(); ++i)
+        HPX_TEST(ch.try_send(i));
+
+    // the channel is full now
+    HPX_TEST(!ch.try_send(std::size_t(42)));
+    HPX_TEST_EQ(ch.size(), ch.capacity());
+
+    std::size_t value = 0;
+    for (std::size_t i = 0; i != ch.capacity(); ++i)
+    {
+        HPX_TEST(ch.try_receive(value));
+        HPX_TEST_EQ(value, i);
+    }
+
+    // the channel is empty now
+    HPX_TEST(!ch.try_receive(value));
+    HPX_TEST(ch.empty());
+}
+
+void test_try_send_receive_n()
+{
+    channel_type ch(8);
+
+    std::vector<std::size_t> values(12);
+    std::iota(values.begin(), values.end(), 0);
+
+    // only as many values as fit are stored
+    HPX_TEST_EQ(ch.try_send_n(values.begin(), values.size()), std::size_t(8));
+
+    std::vector<std::size_t> received;
+    HPX_TEST_EQ(ch.try_receive_n(std::back_inserter(received), 5),
+        std::size_t(5));
+    HPX_TEST_EQ(ch.try_receive_n(std::back_inserter(received), 5),
+        std::size_t(3));
+    HPX_TEST_EQ(ch.try_receive_n(std::back_inserter(received), 5),
+        std::size_t(0));
+
+    HPX_TEST_EQ(received.size(), std::size_t(8));
+    for (std::size_t i = 0; i != received.size(); ++i)
+        HPX_TEST_EQ(received[i], i);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void producer(channel_type& ch, std::size_t count, std::size_t batch)
+{
+    std::vector<std::size_t> values(batch, 1);
+    for (std::size_t i = 0; i < count; i += batch)
+    {
+        if (batch == 1)
+            ch.send(1);
+        else
+            ch.send_n(values.begin(), batch);
+    }
+}
+
+std::size_t consumer(channel_type& ch, std::size_t count, std::size_t batch)
+{
+    std::size_t sum = 0;
+    std::vector<std::size_t> values;
+    for (std::size_t i = 0; i < count; i += batch)
+    {
+        if (batch == 1)
+        {
+            sum += ch.receive();
+        }
+        else
+        {
+            values.clear();
+            ch.receive_n(std::back_inserter(values), batch);
+            sum += std::accumulate(values.begin(), values.end(), std::size_t(0));
+        }
+    }
+    return sum;
+}
+
+void test_producers_consumers(std::size_t num_producers,
+    std::size_t num_consumers, std::size_t count, std::size_t batch)
+{
+    // use a small capacity to make sure producers and consumers get suspended
+    channel_type ch(16);
+
+    std::size_t const total = count * num_producers;
+    std::size_t const per_consumer = total / num_consumers;
+    HPX_TEST_EQ(per_consumer * num_consumers, total);
+
+    std::vector<hpx::future<void> > producers;
+    for (std::size_t i = 0; i != num_producers; ++i)
+    {
+        producers.push_back(hpx::async(&producer, boost::ref(ch), count,
+            batch));
+    }
+
+    std::vector<hpx::future<std::size_t> > consumers;
+    for (std::size_t i = 0; i != num_consumers; ++i)
+    {
+        consumers.push_back(hpx::async(&consumer, boost::ref(ch),
+            per_consumer, batch));
+    }
+
+    hpx::wait_all(producers);
+
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i != num_consumers; ++i)
+        sum += consumers[i].get();
+
+    HPX_TEST_EQ(sum, total);
+    HPX_TEST(ch.empty());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map& vm)
+{
+    std::size_t count = vm["count"].as<std::size_t>();
+
+    test_try_send_receive();
+    test_try_send_receive_n();
+
+    test_producers_consumers(1, 1, count, 1);
+    test_producers_consumers(4, 4, count, 1);
+    test_producers_consumers(4, 2, count, 1);
+    test_producers_consumers(2, 4, count, 8);
+    test_producers_consumers(4, 4, count, 32);
+
+    return hpx::finalize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    // Configure application-specific options
+    options_description cmdline("Usage: " HPX_APPLICATION_STRING " [options]");
+
+    cmdline.add_options()
+        ("count", value<std::size_t>()->default_value(1024),
+            "the number of values to send per producer (must be a multiple "
+            "of 32)")
+        ;
+
+    // We force this test to use several threads by default.
+    using namespace boost::assign;
+    std::vector<std::string> cfg;
+    cfg += "hpx.os_threads=" +
+        boost::lexical_cast<std::string>(hpx::threads::hardware_concurrency());
+
+    // Initialize and run HPX
+    HPX_TEST_EQ_MSG(hpx::init(cmdline, argc, argv, cfg), 0,
+        "HPX main exited with non-zero status");
+    return hpx::util::report_errors();
+}
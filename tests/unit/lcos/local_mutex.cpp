@@ -21,6 +21,8 @@ using hpx::applier::register_work_nullary;
 
 using hpx::lcos::local::barrier;
 using hpx::lcos::local::mutex;
+using hpx::lcos::local::fair_mutex;
+using hpx::lcos::local::fair_shared_mutex;
 
 using hpx::init;
 using hpx::finalize;
@@ -210,20 +212,11 @@ struct test_mutexed_data_try_lock_raii
 };
 
 ///////////////////////////////////////////////////////////////////////////////
-int hpx_main(variables_map& vm)
+template <typename Mutex>
+void test_mutex(std::size_t pxthreads)
 {
-    std::size_t threads = 1;
-
-    if (vm.count("threads"))
-        threads = vm["threads"].as<std::size_t>();
-
-    std::size_t pxthreads = threads * 8;
-
-    if (vm.count("pxthreads"))
-        pxthreads = vm["pxthreads"].as<std::size_t>();
-    
     {
-        test_lock<mutex> t;
+        test_lock<Mutex> t;
 
         for (std::size_t i = 0; i < pxthreads; ++i)
             register_work_nullary(HPX_STD_FUNCTION<void()>(t), 
@@ -231,43 +224,43 @@ int hpx_main(variables_map& vm)
     }
 
     {
-        mutex mtx;
+        Mutex mtx;
         barrier barr(pxthreads + 1);
         std::size_t data = 0;
 
-        test_mutexed_data_lock<mutex> t(mtx, barr, data);
+        test_mutexed_data_lock<Mutex> t(mtx, barr, data);
         for (std::size_t i = 0; i < pxthreads; ++i)
             register_work_nullary(HPX_STD_FUNCTION<void()>(t), 
                 "test_local_mutex_lock_contention");
 
         barr.wait();
 
-        mutex::scoped_lock lock(mtx);
+        typename Mutex::scoped_lock lock(mtx);
         HPX_TEST(bool(lock));
 
         HPX_TEST_EQ(data, pxthreads);
     } 
 
     {
-        mutex mtx;
+        Mutex mtx;
         barrier barr(pxthreads + 1);
         std::size_t data = 0;
 
-        test_mutexed_data_lock_raii<mutex> t(mtx, barr, data);
+        test_mutexed_data_lock_raii<Mutex> t(mtx, barr, data);
         for (std::size_t i = 0; i < pxthreads; ++i)
             register_work_nullary(HPX_STD_FUNCTION<void()>(t), 
                 "test_local_mutex_lock_raii_contention");
 
         barr.wait();
 
-        mutex::scoped_lock lock(mtx);
+        typename Mutex::scoped_lock lock(mtx);
         HPX_TEST(bool(lock));
 
         HPX_TEST_EQ(data, pxthreads);
     }
 
     {
-        test_try_lock<mutex> t;
+        test_try_lock<Mutex> t;
 
         for (std::size_t i = 0; i < pxthreads; ++i)
             register_work_nullary(HPX_STD_FUNCTION<void()>(t), 
@@ -275,40 +268,114 @@ int hpx_main(variables_map& vm)
     }
 
     {
-        mutex mtx;
+        Mutex mtx;
         barrier barr(pxthreads + 1);
         std::size_t data = 0;
 
-        test_mutexed_data_try_lock<mutex> t(mtx, barr, data);
+        test_mutexed_data_try_lock<Mutex> t(mtx, barr, data);
         for (std::size_t i = 0; i < pxthreads; ++i)
             register_work_nullary(HPX_STD_FUNCTION<void()>(t), 
                 "test_local_mutex_try_lock_contention");
 
         barr.wait();
 
-        mutex::scoped_lock lock(mtx);
+        typename Mutex::scoped_lock lock(mtx);
         HPX_TEST(bool(lock));
 
         HPX_TEST_EQ(data, pxthreads);
     } 
 
     {
-        mutex mtx;
+        Mutex mtx;
         barrier barr(pxthreads + 1);
         std::size_t data = 0;
 
-        test_mutexed_data_try_lock_raii<mutex> t(mtx, barr, data);
+        test_mutexed_data_try_lock_raii<Mutex> t(mtx, barr, data);
         for (std::size_t i = 0; i < pxthreads; ++i)
             register_work_nullary(HPX_STD_FUNCTION<void()>(t), 
                 "test_local_mutex_try_lock_raii_contention");
 
         barr.wait();
 
-        mutex::scoped_lock lock(mtx);
+        typename Mutex::scoped_lock lock(mtx);
         HPX_TEST(bool(lock));
 
         HPX_TEST_EQ(data, pxthreads);
     }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename M>
+struct test_shared_data_lock
+{
+    typedef M mutex_type;
+
+    mutex_type* mtx;
+    barrier* barr;
+    std::size_t* data;
+
+    test_shared_data_lock(mutex_type& m, barrier& b, std::size_t& d)
+        : mtx(&m), barr(&b), data(&d) {}
+
+    void operator()() const
+    {
+        {
+            boost::shared_lock<mutex_type> lock(*mtx);
+            HPX_TEST(bool(lock));
+
+            // writers are excluded while the shared lock is held
+            std::size_t value = *data;
+            hpx::this_thread::yield();
+            HPX_TEST_EQ(value, *data);
+        }
+
+        {
+            typename mutex_type::scoped_lock lock(*mtx);
+            ++(*data);
+        }
+
+        barr->wait();
+    }
+};
+
+template <typename Mutex>
+void test_shared_mutex(std::size_t pxthreads)
+{
+    Mutex mtx;
+    barrier barr(pxthreads + 1);
+    std::size_t data = 0;
+
+    test_shared_data_lock<Mutex> t(mtx, barr, data);
+    for (std::size_t i = 0; i < pxthreads; ++i)
+        register_work_nullary(HPX_STD_FUNCTION<void()>(t),
+            "test_local_shared_mutex_contention");
+
+    barr.wait();
+
+    boost::shared_lock<Mutex> lock(mtx);
+    HPX_TEST(bool(lock));
+
+    HPX_TEST_EQ(data, pxthreads);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map& vm)
+{
+    std::size_t threads = 1;
+
+    if (vm.count("threads"))
+        threads = vm["threads"].as<std::size_t>();
+
+    std::size_t pxthreads = threads * 8;
+
+    if (vm.count("pxthreads"))
+        pxthreads = vm["pxthreads"].as<std::size_t>();
+
+    test_mutex<mutex>(pxthreads);
+    test_mutex<fair_mutex>(pxthreads);
+    test_mutex<fair_shared_mutex>(pxthreads);
+
+    test_shared_mutex<fair_shared_mutex>(pxthreads);
 
     // Initiate shutdown of the runtime system.
     finalize();
@@ -0,0 +1,179 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/actions.hpp>
+#include <hpx/lcos/tree_communicator.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+HPX_REGISTER_TREE_COMMUNICATOR_DECLARATION(std::size_t, size_t);
+HPX_REGISTER_TREE_COMMUNICATOR(std::size_t, size_t);
+
+typedef hpx::lcos::tree_communicator<std::size_t> communicator_type;
+
+// we run several sites on each locality to get deeper trees
+std::size_t const sites_per_locality = 3;
+std::size_t const size = 1000;
+
+///////////////////////////////////////////////////////////////////////////////
+std::vector<std::size_t> make_data(std::size_t site)
+{
+    std::vector<std::size_t> data(size);
+    for (std::size_t i = 0; i != size; ++i)
+        data[i] = site * size + i;
+    return data;
+}
+
+void run_site(std::string const& basename, std::size_t num_sites,
+    std::size_t site, hpx::lcos::tree_options const& options)
+{
+    communicator_type comm(basename.c_str(), num_sites, site, options);
+
+    for (std::size_t root = 0; root != num_sites; root += 2)
+    {
+        // broadcast
+        {
+            std::vector<std::size_t> data;
+            if (site == root)
+                data = make_data(root);
+
+            std::vector<std::size_t> result =
+                comm.broadcast(data, root).get();
+            HPX_TEST(result == make_data(root));
+        }
+
+        // reduce
+        {
+            std::vector<std::size_t> result =
+                comm.reduce(make_data(site), std::plus<std::size_t>(),
+                    root).get();
+
+            if (site == root)
+            {
+                HPX_TEST_EQ(result.size(), size);
+                for (std::size_t i = 0; i != result.size(); ++i)
+                {
+                    HPX_TEST_EQ(result[i], num_sites * (num_sites - 1) / 2 *
+                        size + num_sites * i);
+                }
+            }
+            else
+            {
+                HPX_TEST(result.empty());
+            }
+        }
+
+        // gather, the contributions have different sizes
+        {
+            std::vector<std::size_t> data = make_data(site);
+            data.resize(site);
+
+            std::vector<std::vector<std::size_t> > result =
+                comm.gather(data, root).get();
+
+            if (site == root)
+            {
+                HPX_TEST_EQ(result.size(), num_sites);
+                for (std::size_t i = 0; i != result.size(); ++i)
+                {
+                    std::vector<std::size_t> expected = make_data(i);
+                    expected.resize(i);
+                    HPX_TEST(result[i] == expected);
+                }
+            }
+            else
+            {
+                HPX_TEST(result.empty());
+            }
+        }
+    }
+
+    // all_reduce
+    {
+        std::vector<std::size_t> result =
+            comm.all_reduce(make_data(site), std::plus<std::size_t>()).get();
+
+        HPX_TEST_EQ(result.size(), size);
+        for (std::size_t i = 0; i != result.size(); ++i)
+        {
+            HPX_TEST_EQ(result[i],
+                num_sites * (num_sites - 1) / 2 * size + num_sites * i);
+        }
+    }
+}
+
+void run_locality(std::string const& basename, int topology,
+    std::size_t fanout, std::size_t segment_size)
+{
+    std::size_t num_localities = hpx::get_num_localities_sync();
+
+    hpx::lcos::tree_options options(
+        static_cast<hpx::lcos::tree_topology>(topology), fanout, segment_size);
+
+    std::size_t num_sites = num_localities * sites_per_locality;
+    std::size_t first_site = hpx::get_locality_id() * sites_per_locality;
+
+    std::vector<hpx::future<void> > sites;
+    for (std::size_t i = 0; i != sites_per_locality; ++i)
+    {
+        sites.push_back(hpx::async(&run_site, basename, num_sites,
+            first_site + i, options));
+    }
+    hpx::wait_all(sites);
+}
+HPX_PLAIN_ACTION(run_locality, run_locality_action);
+
+void test_tree_communicator(int topology, std::size_t fanout,
+    std::size_t segment_size)
+{
+    std::vector<hpx::id_type> localities = hpx::find_all_localities();
+
+    std::string basename = "/test/tree_communicator/" +
+        boost::lexical_cast<std::string>(topology) + "/" +
+        boost::lexical_cast<std::string>(fanout) + "/" +
+        boost::lexical_cast<std::string>(segment_size);
+
+    std::vector<hpx::future<void> > futures;
+    for (std::size_t i = 0; i != localities.size(); ++i)
+    {
+        futures.push_back(hpx::async<run_locality_action>(localities[i],
+            basename, topology, fanout, segment_size));
+    }
+    hpx::wait_all(futures);
+
+    for (std::size_t i = 0; i != futures.size(); ++i)
+        HPX_TEST(!futures[i].has_exception());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main()
+{
+    using namespace hpx::lcos;
+
+    // no segmentation, segments smaller than the data, odd segment size
+    test_tree_communicator(binomial_tree, 2, 0);
+    test_tree_communicator(binomial_tree, 2, 100);
+    test_tree_communicator(kary_tree, 3, 128);
+    test_tree_communicator(kary_tree, 2, 1);
+    test_tree_communicator(ring_topology, 2, 0);
+    test_tree_communicator(ring_topology, 2, 333);
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    HPX_TEST_EQ_MSG(hpx::init(argc, argv), 0,
+        "HPX main exited with non-zero status");
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,168 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/hpx.hpp>
+#include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/util/partitioner.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/range/functions.hpp>
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+typedef std::vector<std::size_t>::iterator iterator;
+typedef hpx::parallel::util::affinity_partitioner_tag affinity_tag;
+
+///////////////////////////////////////////////////////////////////////////////
+// run one pass over the given range, returns the worker thread which has
+// executed each of the chunks
+template <typename ExPolicy>
+std::vector<std::size_t> run_pass(ExPolicy const& policy,
+    std::vector<std::size_t>& c, std::size_t chunk_size)
+{
+    std::size_t const chunks = (c.size() + chunk_size - 1) / chunk_size;
+    std::vector<std::size_t> workers(chunks, std::size_t(-1));
+
+    std::size_t result = hpx::parallel::util::partitioner<
+            ExPolicy, std::size_t, std::size_t, affinity_tag
+        >::call_with_index(
+            policy, boost::begin(c), c.size(),
+            [&workers, chunk_size](std::size_t base_idx, iterator it,
+                std::size_t count)
+            {
+                workers[base_idx / chunk_size] = hpx::get_worker_thread_num();
+                std::iota(it, it + count, base_idx);
+                return count;
+            },
+            [](std::vector<hpx::future<std::size_t> > && r)
+            {
+                std::size_t count = 0;
+                for (hpx::future<std::size_t>& f: r)
+                    count += f.get();
+                return count;
+            });
+    HPX_TEST_EQ(result, c.size());
+
+    for (std::size_t i = 0; i != c.size(); ++i)
+        HPX_TEST_EQ(c[i], i);
+
+    return workers;
+}
+
+// the placement of the chunks is remembered after each pass
+void verify_placement(std::vector<std::size_t> const& c,
+    std::size_t chunk_size, std::vector<std::size_t> const& workers)
+{
+    std::vector<std::size_t> placement =
+        hpx::parallel::util::detail::affinity_map::get().find(
+            &c[0], c.size(), chunk_size);
+    HPX_TEST(placement == workers);
+}
+
+void test_affinity_partitioner()
+{
+    using namespace hpx::parallel;
+
+    std::vector<std::size_t> c(10007);
+
+    // without a chunk size every core gets one chunk
+    std::size_t const cores = hpx::get_os_thread_count();
+    std::size_t const chunk_size = (c.size() + cores - 1) / cores;
+
+    for (int i = 0; i != 3; ++i)
+    {
+        std::vector<std::size_t> workers = run_pass(par, c, chunk_size);
+        verify_placement(c, chunk_size, workers);
+    }
+
+    for (int i = 0; i != 3; ++i)
+    {
+        std::vector<std::size_t> workers = run_pass(par(100), c, 100);
+        verify_placement(c, 100, workers);
+    }
+
+    // the task execution policy stores the placement as well
+    std::vector<std::size_t> workers((c.size() + 16) / 17, std::size_t(-1));
+    hpx::future<iterator> f = hpx::parallel::util::foreach_n_partitioner<
+            task_execution_policy, void, affinity_tag
+        >::call(task(17), boost::begin(c), c.size(),
+            [&c, &workers](iterator it, std::size_t count)
+            {
+                std::size_t const base_idx = std::distance(boost::begin(c), it);
+                workers[base_idx / 17] = hpx::get_worker_thread_num();
+                std::fill(it, it + count, 1);
+            });
+    HPX_TEST(f.get() == boost::end(c));
+    verify_placement(c, 17, workers);
+
+    HPX_TEST_EQ(std::count(boost::begin(c), boost::end(c), 1),
+        std::ptrdiff_t(c.size()));
+
+    // empty ranges
+    std::vector<std::size_t> empty;
+    HPX_TEST(run_pass(par, empty, 1).empty());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void test_exceptions()
+{
+    std::vector<std::size_t> c(10007, 0);
+
+    bool caught_exception = false;
+    try {
+        hpx::parallel::util::partitioner<
+                hpx::parallel::parallel_execution_policy, void, void,
+                affinity_tag
+            >::call_with_index(
+                hpx::parallel::par(1000), boost::begin(c), c.size(),
+                [](std::size_t base_idx, iterator it, std::size_t count)
+                {
+                    std::fill(it, it + count, 1);
+                    if (base_idx == 0)
+                        throw std::runtime_error("test");
+                },
+                [](std::vector<hpx::future<void> > &&) {});
+
+        HPX_TEST(false);
+    }
+    catch (hpx::exception_list const& e) {
+        caught_exception = true;
+        HPX_TEST_EQ(e.size(), std::size_t(1));
+    }
+    catch (...) {
+        HPX_TEST(false);
+    }
+    HPX_TEST(caught_exception);
+
+    // all chunks have been executed
+    HPX_TEST_EQ(std::count(boost::begin(c), boost::end(c), 1),
+        std::ptrdiff_t(c.size()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main()
+{
+    test_affinity_partitioner();
+    test_exceptions();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    // By default this test should run on all available cores
+    std::vector<std::string> cfg;
+    cfg.push_back("hpx.os_threads=" +
+        boost::lexical_cast<std::string>(hpx::threads::hardware_concurrency()));
+
+    // Initialize and run HPX
+    HPX_TEST_EQ_MSG(hpx::init(argc, argv, cfg), 0,
+        "HPX main exited with non-zero status");
+
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,247 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/hpx.hpp>
+#include <hpx/include/local_lcos.hpp>
+#include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/util/partitioner.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/range/functions.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+typedef std::vector<std::size_t>::iterator iterator;
+typedef hpx::parallel::util::guided_partitioner_tag guided_tag;
+
+///////////////////////////////////////////////////////////////////////////////
+// collect the timing information reported for every chunk
+hpx::lcos::local::spinlock chunks_mtx;
+std::vector<hpx::parallel::util::chunk_info> chunks;
+
+void record_chunk(hpx::parallel::util::chunk_info const& info)
+{
+    boost::lock_guard<hpx::lcos::local::spinlock> l(chunks_mtx);
+    chunks.push_back(info);
+}
+
+bool less_base_idx(hpx::parallel::util::chunk_info const& lhs,
+    hpx::parallel::util::chunk_info const& rhs)
+{
+    return lhs.base_idx_ < rhs.base_idx_;
+}
+
+// the reported chunks cover the whole range without overlapping, their size
+// shrinks towards the end of the range
+void verify_chunks(std::size_t size, std::size_t min_chunk)
+{
+    std::sort(chunks.begin(), chunks.end(), &less_base_idx);
+
+    std::size_t next = 0;
+    std::size_t last_count = size;
+    for (hpx::parallel::util::chunk_info const& info: chunks)
+    {
+        HPX_TEST_EQ(info.base_idx_, next);
+        HPX_TEST_LTE(info.count_, last_count);
+        if (info.base_idx_ + min_chunk <= size)
+            HPX_TEST_LTE(min_chunk, info.count_);
+
+        next += info.count_;
+        last_count = info.count_;
+    }
+    HPX_TEST_EQ(next, size);
+
+    chunks.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename ExPolicy>
+std::size_t test_call_with_index(ExPolicy const& policy,
+    std::vector<std::size_t>& c)
+{
+    std::fill(boost::begin(c), boost::end(c), 0);
+    std::size_t const size = c.size();
+
+    return hpx::parallel::util::partitioner<
+            ExPolicy, std::size_t, std::size_t, guided_tag
+        >::call_with_index(
+            policy, boost::begin(c), c.size(),
+            [](std::size_t base_idx, iterator it, std::size_t count)
+            {
+                std::iota(it, it + count, base_idx);
+                return base_idx + count;
+            },
+            [size](std::vector<hpx::future<std::size_t> > && r)
+            {
+                // each chunk returns the start of the next one
+                std::size_t next = 0;
+                for (hpx::future<std::size_t>& f: r)
+                {
+                    std::size_t end = f.get();
+                    HPX_TEST_LT(next, end);
+                    next = end;
+                }
+                HPX_TEST_EQ(next, size);
+                return r.size();
+            });
+}
+
+void verify_values(std::vector<std::size_t> const& c)
+{
+    for (std::size_t i = 0; i != c.size(); ++i)
+        HPX_TEST_EQ(c[i], i);
+}
+
+void test_guided_partitioner()
+{
+    using namespace hpx::parallel;
+
+    std::vector<std::size_t> c(10007);
+
+    test_call_with_index(par, c);
+    verify_values(c);
+    verify_chunks(c.size(), 1);
+
+    test_call_with_index(par(100), c);
+    verify_values(c);
+    verify_chunks(c.size(), 100);
+
+    HPX_TEST_EQ(test_call_with_index(par(c.size() + 1), c), std::size_t(1));
+    verify_values(c);
+    verify_chunks(c.size(), c.size());
+
+    test_call_with_index(par_vec, c);
+    verify_values(c);
+    verify_chunks(c.size(), 1);
+
+    hpx::future<std::size_t> f =
+        hpx::parallel::util::partitioner<
+                task_execution_policy, std::size_t, std::size_t, guided_tag
+            >::call_with_index(
+                task(10), boost::begin(c), c.size(),
+                [](std::size_t base_idx, iterator it, std::size_t count)
+                {
+                    std::iota(it, it + count, base_idx);
+                    return count;
+                },
+                [](std::vector<hpx::future<std::size_t> > && r)
+                {
+                    std::size_t count = 0;
+                    for (hpx::future<std::size_t>& f: r)
+                        count += f.get();
+                    return count;
+                });
+    HPX_TEST_EQ(f.get(), c.size());
+    verify_values(c);
+    verify_chunks(c.size(), 10);
+
+    // empty ranges
+    std::vector<std::size_t> empty;
+    HPX_TEST_EQ(test_call_with_index(par, empty), std::size_t(0));
+    HPX_TEST(chunks.empty());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void test_foreach_n_guided_partitioner()
+{
+    using namespace hpx::parallel;
+
+    std::vector<std::size_t> c(10007, 0);
+
+    iterator result = hpx::parallel::util::foreach_n_partitioner<
+            parallel_execution_policy, void, guided_tag
+        >::call(par(13), boost::begin(c), c.size(),
+            [](iterator it, std::size_t count)
+            {
+                for (std::size_t i = 0; i != count; ++i, ++it)
+                    ++*it;
+            });
+    HPX_TEST(result == boost::end(c));
+    verify_chunks(c.size(), 13);
+
+    hpx::future<iterator> f = hpx::parallel::util::foreach_n_partitioner<
+            task_execution_policy, void, guided_tag
+        >::call(task, boost::begin(c), c.size(),
+            [](iterator it, std::size_t count)
+            {
+                for (std::size_t i = 0; i != count; ++i, ++it)
+                    ++*it;
+            });
+    HPX_TEST(f.get() == boost::end(c));
+    verify_chunks(c.size(), 1);
+
+    for (std::size_t v: c)
+        HPX_TEST_EQ(v, std::size_t(2));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void test_exceptions()
+{
+    std::vector<std::size_t> c(10007, 0);
+
+    bool caught_exception = false;
+    try {
+        hpx::parallel::util::partitioner<
+                hpx::parallel::parallel_execution_policy, void, void, guided_tag
+            >::call_with_index(
+                hpx::parallel::par, boost::begin(c), c.size(),
+                [](std::size_t base_idx, iterator it, std::size_t count)
+                {
+                    std::fill(it, it + count, 1);
+                    if (base_idx == 0)
+                        throw std::runtime_error("test");
+                },
+                [](std::vector<hpx::future<void> > &&) {});
+
+        HPX_TEST(false);
+    }
+    catch (hpx::exception_list const& e) {
+        caught_exception = true;
+        HPX_TEST_EQ(e.size(), std::size_t(1));
+    }
+    catch (...) {
+        HPX_TEST(false);
+    }
+    HPX_TEST(caught_exception);
+
+    // all chunks have been executed
+    HPX_TEST_EQ(std::count(boost::begin(c), boost::end(c), 1),
+        std::ptrdiff_t(c.size()));
+    verify_chunks(c.size(), 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main()
+{
+    hpx::parallel::util::set_chunk_timing_hook(&record_chunk);
+
+    test_guided_partitioner();
+    test_foreach_n_guided_partitioner();
+    test_exceptions();
+
+    hpx::parallel::util::set_chunk_timing_hook(
+        hpx::parallel::util::chunk_timing_hook_type());
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    // By default this test should run on all available cores
+    std::vector<std::string> cfg;
+    cfg.push_back("hpx.os_threads=" +
+        boost::lexical_cast<std::string>(hpx::threads::hardware_concurrency()));
+
+    // Initialize and run HPX
+    HPX_TEST_EQ_MSG(hpx::init(argc, argv, cfg), 0,
+        "HPX main exited with non-zero status");
+
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,211 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/hpx.hpp>
+#include <hpx/parallel/execution_policy.hpp>
+#include <hpx/parallel/util/partitioner.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/range/functions.hpp>
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+typedef std::vector<std::size_t>::iterator iterator;
+typedef hpx::parallel::util::recursive_partitioner_tag recursive_tag;
+
+///////////////////////////////////////////////////////////////////////////////
+// every element is visited exactly once, the chunk results are delivered in
+// order
+std::size_t verify_chunks(std::vector<hpx::future<std::size_t> > && r,
+    std::size_t size)
+{
+    std::size_t next = 0;
+    for (hpx::future<std::size_t>& f: r)
+    {
+        HPX_TEST_EQ(f.get(), next);
+        ++next;
+    }
+    HPX_TEST_EQ(next, size);
+    return r.size();
+}
+
+template <typename ExPolicy>
+std::size_t test_call_with_index(ExPolicy const& policy,
+    std::vector<std::size_t>& c)
+{
+    std::fill(boost::begin(c), boost::end(c), 0);
+    std::size_t const size = c.size();
+
+    return hpx::parallel::util::partitioner<
+            ExPolicy, std::size_t, std::size_t, recursive_tag
+        >::call_with_index(
+            policy, boost::begin(c), c.size(),
+            [](std::size_t base_idx, iterator it, std::size_t count)
+            {
+                std::iota(it, it + count, base_idx);
+                return base_idx + count;
+            },
+            [size](std::vector<hpx::future<std::size_t> > && r)
+            {
+                // each chunk returns the start of the next one
+                std::size_t next = 0;
+                for (hpx::future<std::size_t>& f: r)
+                {
+                    std::size_t end = f.get();
+                    HPX_TEST_LT(next, end);
+                    next = end;
+                }
+                HPX_TEST_EQ(next, size);
+                return r.size();
+            });
+}
+
+void verify_values(std::vector<std::size_t> const& c)
+{
+    for (std::size_t i = 0; i != c.size(); ++i)
+        HPX_TEST_EQ(c[i], i);
+}
+
+void test_recursive_partitioner()
+{
+    using namespace hpx::parallel;
+
+    std::vector<std::size_t> c(10007);
+
+    test_call_with_index(par, c);
+    verify_values(c);
+
+    // an explicit chunk size determines the number of chunks
+    HPX_TEST_EQ(test_call_with_index(par(17), c), (c.size() + 16) / 17);
+    verify_values(c);
+
+    HPX_TEST_EQ(test_call_with_index(par(1), c), c.size());
+    verify_values(c);
+
+    HPX_TEST_EQ(test_call_with_index(par(c.size() + 1), c), std::size_t(1));
+    verify_values(c);
+
+    HPX_TEST_EQ(test_call_with_index(par_vec, c) != 0, true);
+    verify_values(c);
+
+    hpx::future<std::size_t> f =
+        hpx::parallel::util::partitioner<
+                task_execution_policy, std::size_t, std::size_t, recursive_tag
+            >::call_with_index(
+                task(17), boost::begin(c), c.size(),
+                [](std::size_t base_idx, iterator it, std::size_t count)
+                {
+                    std::iota(it, it + count, base_idx);
+                    return base_idx / 17;
+                },
+                [&c](std::vector<hpx::future<std::size_t> > && r)
+                {
+                    return verify_chunks(std::move(r), (c.size() + 16) / 17);
+                });
+    HPX_TEST_EQ(f.get(), (c.size() + 16) / 17);
+    verify_values(c);
+
+    // empty ranges
+    std::vector<std::size_t> empty;
+    HPX_TEST_EQ(test_call_with_index(par, empty), std::size_t(0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void test_foreach_n_recursive_partitioner()
+{
+    using namespace hpx::parallel;
+
+    std::vector<std::size_t> c(10007, 0);
+
+    iterator result = hpx::parallel::util::foreach_n_partitioner<
+            parallel_execution_policy, void, recursive_tag
+        >::call(par(13), boost::begin(c), c.size(),
+            [](iterator it, std::size_t count)
+            {
+                for (std::size_t i = 0; i != count; ++i, ++it)
+                    ++*it;
+            });
+    HPX_TEST(result == boost::end(c));
+
+    hpx::future<iterator> f = hpx::parallel::util::foreach_n_partitioner<
+            task_execution_policy, void, recursive_tag
+        >::call(task, boost::begin(c), c.size(),
+            [](iterator it, std::size_t count)
+            {
+                for (std::size_t i = 0; i != count; ++i, ++it)
+                    ++*it;
+            });
+    HPX_TEST(f.get() == boost::end(c));
+
+    for (std::size_t v: c)
+        HPX_TEST_EQ(v, std::size_t(2));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename ExPolicy>
+void test_exceptions(ExPolicy const& policy)
+{
+    std::vector<std::size_t> c(10007, 0);
+
+    bool caught_exception = false;
+    try {
+        hpx::parallel::util::partitioner<
+                ExPolicy, void, void, recursive_tag
+            >::call_with_index(
+                policy, boost::begin(c), c.size(),
+                [](std::size_t base_idx, iterator it, std::size_t count)
+                {
+                    std::fill(it, it + count, 1);
+                    if (base_idx % 2)
+                        throw std::runtime_error("test");
+                },
+                [](std::vector<hpx::future<void> > &&) {});
+
+        HPX_TEST(false);
+    }
+    catch (hpx::exception_list const& e) {
+        caught_exception = true;
+
+        // every other chunk has thrown
+        HPX_TEST_EQ(e.size(), (c.size() / 7 + 1) / 2);
+    }
+    catch (...) {
+        HPX_TEST(false);
+    }
+    HPX_TEST(caught_exception);
+
+    // all chunks have been executed
+    HPX_TEST_EQ(std::count(boost::begin(c), boost::end(c), 1),
+        std::ptrdiff_t(c.size()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main()
+{
+    test_recursive_partitioner();
+    test_foreach_n_recursive_partitioner();
+
+    // the chunk size of 7 yields alternating odd and even base indices
+    test_exceptions(hpx::parallel::par(7));
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    // By default this test should run on all available cores
+    std::vector<std::string> cfg;
+    cfg.push_back("hpx.os_threads=" +
+        boost::lexical_cast<std::string>(hpx::threads::hardware_concurrency()));
+
+    // Initialize and run HPX
+    HPX_TEST_EQ_MSG(hpx::init(argc, argv, cfg), 0,
+        "HPX main exited with non-zero status");
+
+    return hpx::util::report_errors();
+}
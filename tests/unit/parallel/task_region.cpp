@@ -9,6 +9,10 @@
 #include <hpx/include/parallel_task_region.hpp>
 #include <hpx/util/lightweight_test.hpp>
 
+#include <boost/atomic.hpp>
+
+#include <vector>
+
 using hpx::parallel::task_region;
 using hpx::parallel::async_task_region;
 using hpx::parallel::task_region_handle;
@@ -113,6 +117,26 @@ void task_region_test2()
     HPX_TEST(task3_flag);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void task_region_run_n_test()
+{
+    std::vector<boost::atomic<int> > flags(1000);
+    for (boost::atomic<int>& flag: flags)
+        flag.store(0);
+
+    task_region([&](task_region_handle& trh)
+    {
+        trh.run_n(flags.size(), [&](std::size_t i)
+        {
+            ++flags[i];
+        });
+    });
+
+    for (boost::atomic<int>& flag: flags)
+        HPX_TEST_EQ(flag.load(), 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
 void task_region_exceptions_test1()
 {
     try {
@@ -228,17 +252,41 @@ void task_region_exceptions_test4()
     }
 }
 
+void task_region_run_n_exceptions_test()
+{
+    try {
+        task_region([](task_region_handle& trh)
+        {
+            trh.run_n(10, [](std::size_t i)
+            {
+                if (i % 2)
+                    throw i;
+            });
+        });
+
+        HPX_TEST(false);
+    }
+    catch (hpx::parallel::exception_list const& e) {
+        HPX_TEST_EQ(e.size(), std::size_t(5));
+    }
+    catch(...) {
+        HPX_TEST(false);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 int hpx_main()
 {
     task_region_test1();
     task_region_test2();
+    task_region_run_n_test();
 
     task_region_exceptions_test1();
     task_region_exceptions_test2();
 
     task_region_exceptions_test3();
     task_region_exceptions_test4();
+    task_region_run_n_exceptions_test();
 
     return hpx::finalize();
 }
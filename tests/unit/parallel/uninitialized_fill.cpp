@@ -0,0 +1,219 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/hpx.hpp>
+#include <hpx/include/parallel_uninitialized_fill.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/atomic.hpp>
+
+#include "test_utils.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+// counts the number of live instances, throws on the construction of the
+// instance numbered throw_after
+boost::atomic<std::size_t> instance_count(0);
+boost::atomic<std::size_t> construction_count(0);
+std::size_t throw_after = std::size_t(-1);
+
+struct data
+{
+    data(std::size_t value = 0)
+      : value_(value)
+    {
+        if (construction_count++ == throw_after)
+            throw std::runtime_error("test");
+        ++instance_count;
+    }
+
+    data(data const& rhs)
+      : value_(rhs.value_)
+    {
+        if (construction_count++ == throw_after)
+            throw std::runtime_error("test");
+        ++instance_count;
+    }
+
+    ~data()
+    {
+        --instance_count;
+    }
+
+    std::size_t value_;
+};
+
+// raw memory for the elements
+struct storage
+{
+    storage(std::size_t size)
+      : data_(static_cast<data*>(::operator new(size * sizeof(data)))),
+        size_(size)
+    {}
+
+    ~storage()
+    {
+        ::operator delete(data_);
+    }
+
+    void destroy()
+    {
+        for (std::size_t i = 0; i != size_; ++i)
+            data_[i].~data();
+    }
+
+    data* data_;
+    std::size_t size_;
+};
+
+void verify_values(storage& s, std::size_t value)
+{
+    HPX_TEST_EQ(instance_count.load(), s.size_);
+    for (std::size_t i = 0; i != s.size_; ++i)
+        HPX_TEST_EQ(s.data_[i].value_, value);
+
+    s.destroy();
+    HPX_TEST_EQ(instance_count.load(), std::size_t(0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename ExPolicy>
+void test_uninitialized_fill(ExPolicy const& policy)
+{
+    BOOST_STATIC_ASSERT(hpx::parallel::is_execution_policy<ExPolicy>::value);
+
+    storage s(10007);
+    hpx::parallel::uninitialized_fill(policy, s.data_, s.data_ + s.size_,
+        data(10));
+    verify_values(s, 10);
+
+    data* result = hpx::parallel::uninitialized_fill_n(policy, s.data_,
+        s.size_, data(11));
+    HPX_TEST(result == s.data_ + s.size_);
+    verify_values(s, 11);
+}
+
+void test_uninitialized_fill(hpx::parallel::task_execution_policy)
+{
+    storage s(10007);
+    hpx::future<void> f = hpx::parallel::uninitialized_fill(
+        hpx::parallel::task, s.data_, s.data_ + s.size_, data(10));
+    f.get();
+    verify_values(s, 10);
+
+    hpx::future<data*> r = hpx::parallel::uninitialized_fill_n(
+        hpx::parallel::task, s.data_, s.size_, data(11));
+    HPX_TEST(r.get() == s.data_ + s.size_);
+    verify_values(s, 11);
+}
+
+void uninitialized_fill_test()
+{
+    using namespace hpx::parallel;
+    test_uninitialized_fill(seq);
+    test_uninitialized_fill(par);
+    test_uninitialized_fill(par_vec);
+    test_uninitialized_fill(task);
+
+    test_uninitialized_fill(execution_policy(seq));
+    test_uninitialized_fill(execution_policy(par));
+    test_uninitialized_fill(execution_policy(par_vec));
+
+    test_uninitialized_fill(par(100));
+    test_uninitialized_fill(task(100));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// no element is left constructed if one of the constructors throws
+template <typename ExPolicy>
+void test_uninitialized_fill_exception(ExPolicy const& policy)
+{
+    BOOST_STATIC_ASSERT(hpx::parallel::is_execution_policy<ExPolicy>::value);
+
+    storage s(10007);
+
+    data value(10);
+    construction_count = 0;
+    throw_after = s.size_ / 2;
+
+    bool caught_exception = false;
+    try {
+        hpx::parallel::uninitialized_fill_n(policy, s.data_, s.size_, value);
+        HPX_TEST(false);
+    }
+    catch (hpx::exception_list const& e) {
+        caught_exception = true;
+        HPX_TEST_EQ(e.size(), std::size_t(1));
+    }
+    catch (...) {
+        HPX_TEST(false);
+    }
+
+    throw_after = std::size_t(-1);
+
+    HPX_TEST(caught_exception);
+    HPX_TEST_EQ(instance_count.load(), std::size_t(1));
+}
+
+void test_uninitialized_fill_exception(hpx::parallel::task_execution_policy)
+{
+    storage s(10007);
+
+    data value(10);
+    construction_count = 0;
+    throw_after = s.size_ / 2;
+
+    bool caught_exception = false;
+    try {
+        hpx::future<void> f = hpx::parallel::uninitialized_fill(
+            hpx::parallel::task, s.data_, s.data_ + s.size_, value);
+        f.get();
+
+        HPX_TEST(false);
+    }
+    catch (hpx::exception_list const& e) {
+        caught_exception = true;
+        HPX_TEST_EQ(e.size(), std::size_t(1));
+    }
+    catch (...) {
+        HPX_TEST(false);
+    }
+
+    throw_after = std::size_t(-1);
+
+    HPX_TEST(caught_exception);
+    HPX_TEST_EQ(instance_count.load(), std::size_t(1));
+}
+
+void uninitialized_fill_exception_test()
+{
+    using namespace hpx::parallel;
+    //If the execution policy object is of type vector_execution_policy,
+    //  std::terminate shall be called. therefore we do not test exceptions
+    //  with a vector execution policy
+    test_uninitialized_fill_exception(seq);
+    test_uninitialized_fill_exception(par);
+    test_uninitialized_fill_exception(task);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main()
+{
+    uninitialized_fill_test();
+    uninitialized_fill_exception_test();
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> cfg;
+    cfg.push_back("hpx.os_threads=" +
+        boost::lexical_cast<std::string>(hpx::threads::hardware_concurrency()));
+
+    HPX_TEST_EQ_MSG(hpx::init(argc, argv, cfg), 0,
+        "HPX main exited with non-zero status");
+
+    return hpx::util::report_errors();
+}
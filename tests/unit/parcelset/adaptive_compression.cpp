@@ -0,0 +1,127 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Verify that data sent using the adaptive compression filter arrives intact,
+// independently of whether it was sent compressed or not, and that only the
+// messages exceeding the configured threshold are compressed.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/actions.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/include/compression_adaptive.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <vector>
+
+std::size_t const num_repetitions = 32;
+
+///////////////////////////////////////////////////////////////////////////////
+boost::uint64_t checksum(std::vector<boost::uint32_t> const& data)
+{
+    return std::accumulate(data.begin(), data.end(), boost::uint64_t(0));
+}
+
+HPX_PLAIN_ACTION(checksum, checksum_action);
+HPX_ACTION_USES_ADAPTIVE_COMPRESSION(checksum_action);
+
+///////////////////////////////////////////////////////////////////////////////
+void send_data(std::vector<hpx::id_type> const& targets,
+    std::vector<boost::uint32_t> const& data)
+{
+    boost::uint64_t expected = checksum(data);
+
+    checksum_action act;
+    for (std::size_t i = 0; i != targets.size(); ++i)
+    {
+        // send the data often enough for the codecs to be sampled
+        for (std::size_t j = 0; j != num_repetitions; ++j)
+            HPX_TEST_EQ(act(targets[i], data), expected);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// the filter counts the messages it has sent on the sending locality
+boost::int64_t query_counter(char const* name)
+{
+    using hpx::performance_counters::get_counter;
+    using hpx::performance_counters::stubs::performance_counter;
+
+    boost::format counter("/compression{locality#%d/total}/count/%s");
+    hpx::naming::id_type id =
+        get_counter(boost::str(counter % hpx::get_locality_id() % name));
+    return performance_counter::get_value(id).get_value<boost::int64_t>();
+}
+
+struct message_counts
+{
+    message_counts()
+      : compressed_(query_counter("compressed-messages")),
+        uncompressed_(query_counter("uncompressed-messages"))
+    {}
+
+    boost::int64_t compressed_;
+    boost::int64_t uncompressed_;
+};
+
+int hpx_main(boost::program_options::variables_map&)
+{
+    std::vector<hpx::id_type> targets = hpx::find_all_localities();
+
+    // only the messages sent to remote localities are serialized
+    boost::int64_t num_messages = static_cast<boost::int64_t>(
+        hpx::find_remote_localities().size() * num_repetitions);
+
+    // small messages are sent uncompressed
+    {
+        message_counts before;
+        send_data(targets, std::vector<boost::uint32_t>(16, 42));
+        message_counts after;
+
+        HPX_TEST_EQ(after.compressed_, before.compressed_);
+        HPX_TEST_EQ(after.uncompressed_ - before.uncompressed_, num_messages);
+    }
+
+    // large, well compressible messages
+    {
+        message_counts before;
+        send_data(targets, std::vector<boost::uint32_t>(100000, 42));
+        message_counts after;
+
+        boost::int64_t compressed = after.compressed_ - before.compressed_;
+        boost::int64_t uncompressed = after.uncompressed_ - before.uncompressed_;
+
+        HPX_TEST_EQ(compressed + uncompressed, num_messages);
+#if defined(HPX_HAVE_COMPRESSION_LZ4) || defined(HPX_HAVE_COMPRESSION_ZSTD)
+        // each of the codecs is tried at least once, and the one chosen
+        // afterwards beats sending the data as is
+        HPX_TEST(num_messages == 0 || compressed > uncompressed);
+#endif
+    }
+
+    // large messages with random content
+    std::vector<boost::uint32_t> data(100000);
+    for (std::size_t i = 0; i != data.size(); ++i)
+        data[i] = static_cast<boost::uint32_t>(std::rand());
+    send_data(targets, data);
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    HPX_TEST_EQ_MSG(hpx::init(argc, argv), 0,
+        "HPX main exited with non-zero status");
+
+    return hpx::util::report_errors();
+}
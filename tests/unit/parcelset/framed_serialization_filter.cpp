@@ -0,0 +1,162 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Verify that data spanning several frames passes the framed serialization
+// filter intact and that corrupted or truncated frames are rejected.
+
+#include <hpx/hpx_main.hpp>
+#include <hpx/exception.hpp>
+#include <hpx/plugins/binary_filter/framed_serialization_filter.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// a codec storing the frames as they are
+struct copy_filter
+  : hpx::plugins::compression::framed_serialization_filter<copy_filter>
+{
+    std::size_t max_compressed_length(std::size_t size) const
+    {
+        return size;
+    }
+
+    std::size_t compress(char const* src, std::size_t size,
+        char* dst, std::size_t dst_size) const
+    {
+        HPX_TEST(size <= dst_size);
+        std::memcpy(dst, src, size);
+        return size;
+    }
+
+    void uncompress(char const* src, std::size_t size,
+        char* dst, std::size_t dst_size) const
+    {
+        HPX_TEST_EQ(size, dst_size);
+        std::memcpy(dst, src, size);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+std::vector<char> compress(std::vector<char> const& data, std::size_t chunk)
+{
+    copy_filter filter;
+    filter.set_max_length(data.size());
+
+    std::vector<char> result;
+    std::vector<char> buffer(4096);
+    for (std::size_t i = 0; i < data.size(); i += chunk)
+    {
+        filter.save(&data[i], (std::min)(chunk, data.size() - i));
+
+        // the frames are handed out while the data is being saved
+        while (filter.frames_available() != 0)
+        {
+            std::size_t count = filter.get_frames(&buffer[0], buffer.size());
+            result.insert(result.end(), buffer.begin(), buffer.begin() + count);
+        }
+    }
+
+    std::size_t written = 0;
+    bool done = false;
+    do {
+        done = filter.flush(&buffer[0], buffer.size(), written);
+        result.insert(result.end(), buffer.begin(), buffer.begin() + written);
+    } while (!done);
+
+    return result;
+}
+
+std::vector<char> uncompress(std::vector<char> const& data,
+    std::size_t size, std::size_t chunk)
+{
+    copy_filter filter;
+    filter.init_data(&data[0], data.size(), size);
+
+    std::vector<char> result(size);
+    for (std::size_t i = 0; i < size; i += chunk)
+        filter.load(&result[i], (std::min)(chunk, size - i));
+
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t const frame_size = HPX_SERIALIZATION_FILTER_FRAME_SIZE;
+std::size_t const header_size = 2 * sizeof(boost::uint32_t);
+
+std::vector<char> make_data(std::size_t size)
+{
+    std::vector<char> data(size);
+    for (std::size_t i = 0; i != size; ++i)
+        data[i] = static_cast<char>(std::rand());
+    return data;
+}
+
+void test_multiple_frames()
+{
+    // three and a half frames
+    std::vector<char> data = make_data(3 * frame_size + frame_size / 2);
+
+    std::vector<char> compressed = compress(data, 1000);
+    HPX_TEST_EQ(compressed.size(), data.size() + 4 * header_size);
+
+    // load in chunks crossing the frame boundaries
+    HPX_TEST(uncompress(compressed, data.size(), 999) == data);
+    HPX_TEST(uncompress(compressed, data.size(), 2 * frame_size) == data);
+}
+
+void test_empty_frame()
+{
+    std::vector<char> data = make_data(frame_size / 2);
+    std::vector<char> compressed = compress(data, data.size());
+
+    // a frame header announcing an empty frame
+    std::vector<char> corrupted(header_size, '\0');
+    corrupted.insert(corrupted.end(), compressed.begin(), compressed.end());
+
+    bool caught_exception = false;
+    try {
+        uncompress(corrupted, data.size(), data.size());
+    }
+    catch (hpx::exception const& e) {
+        HPX_TEST_EQ(e.get_error(), hpx::serialization_error);
+        caught_exception = true;
+    }
+    HPX_TEST(caught_exception);
+}
+
+void test_truncated_frame()
+{
+    std::vector<char> data = make_data(2 * frame_size);
+    std::vector<char> compressed = compress(data, data.size());
+
+    // cut off the end of the second frame
+    compressed.resize(compressed.size() - 100);
+
+    bool caught_exception = false;
+    try {
+        uncompress(compressed, data.size(), data.size());
+    }
+    catch (hpx::exception const& e) {
+        HPX_TEST_EQ(e.get_error(), hpx::serialization_error);
+        caught_exception = true;
+    }
+    HPX_TEST(caught_exception);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    test_multiple_frames();
+    test_empty_frame();
+    test_truncated_frame();
+
+    return hpx::util::report_errors();
+}
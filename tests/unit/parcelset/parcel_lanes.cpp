@@ -0,0 +1,206 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Verify that parcels are queued in the lane matching the priority of their
+// action, that a parcel for a critical action is sent ahead of the bulk
+// parcels queued before it, and that the counters reporting the send queues
+// are sane.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/runtime.hpp>
+#include <hpx/include/actions.hpp>
+#include <hpx/include/async.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/parcelset.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+
+#include <string>
+#include <vector>
+
+std::size_t const num_bulk_parcels = 100;
+std::size_t const bulk_parcel_size = 64 * 1024;
+
+///////////////////////////////////////////////////////////////////////////////
+boost::atomic<std::size_t> bulk_parcels_received(0);
+
+void bulk(std::vector<char> const& data)
+{
+    HPX_TEST_EQ(data.size(), bulk_parcel_size);
+    ++bulk_parcels_received;
+}
+HPX_PLAIN_ACTION(bulk, bulk_action);
+
+// returns the number of bulk parcels executed so far
+std::size_t critical()
+{
+    return bulk_parcels_received.load();
+}
+HPX_PLAIN_ACTION(critical, critical_action);
+HPX_ACTION_HAS_CRITICAL_PRIORITY(critical_action);
+
+void reset()
+{
+    bulk_parcels_received.store(0);
+}
+HPX_PLAIN_ACTION(reset, reset_action);
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename Action>
+hpx::parcelset::parcelport::parcel_lane get_lane(
+    hpx::threads::thread_priority priority)
+{
+    typedef typename Action::arguments_type arguments_type;
+
+    hpx::parcelset::parcel p(hpx::find_here(), hpx::naming::address(),
+        new hpx::actions::transfer_action<Action>(priority, arguments_type()));
+
+    return hpx::parcelset::parcelport::get_parcel_lane(p);
+}
+
+void test_classification()
+{
+    using hpx::parcelset::parcelport;
+
+    // the lane is determined by the priority the action is declared with
+    HPX_TEST_EQ(get_lane<reset_action>(hpx::threads::thread_priority_default),
+        parcelport::parcel_lane_normal);
+    HPX_TEST_EQ(get_lane<critical_action>(hpx::threads::thread_priority_default),
+        parcelport::parcel_lane_high);
+
+    // ... or the priority it is explicitly applied with
+    HPX_TEST_EQ(get_lane<reset_action>(hpx::threads::thread_priority_low),
+        parcelport::parcel_lane_normal);
+    HPX_TEST_EQ(get_lane<reset_action>(hpx::threads::thread_priority_boost),
+        parcelport::parcel_lane_high);
+    HPX_TEST_EQ(get_lane<reset_action>(hpx::threads::thread_priority_critical),
+        parcelport::parcel_lane_high);
+    HPX_TEST_EQ(get_lane<critical_action>(hpx::threads::thread_priority_normal),
+        parcelport::parcel_lane_normal);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void test_overtaking(hpx::id_type const& there)
+{
+    using hpx::parcelset::parcelport;
+
+    // this also establishes the connection to the destination
+    reset_action()(there);
+
+    // The bulk parcels are left in the normal lane to the threads scheduled
+    // for sending them only if serialization is asynchronous. Those threads
+    // can't run before the critical parcel is queued as this test runs on a
+    // single worker thread which does not suspend in between.
+    hpx::parcelset::parcelhandler& ph =
+        hpx::get_runtime().get_parcel_handler();
+
+    parcelport* pp = 0;
+    if (ph.here().get_type() == hpx::parcelset::connection_tcp &&
+        ph.get_parcelport().async_serialization())
+    {
+        pp = &ph.get_parcelport();
+    }
+
+    std::vector<char> data(bulk_parcel_size, '\0');
+
+    std::vector<hpx::future<void> > futures;
+    futures.reserve(num_bulk_parcels);
+    for (std::size_t i = 0; i != num_bulk_parcels; ++i)
+        futures.push_back(hpx::async<bulk_action>(there, data));
+
+    hpx::future<std::size_t> f = hpx::async<critical_action>(there);
+
+    // the critical parcel has been sent right away, without taking the bulk
+    // parcels queued before it along
+    if (pp != 0)
+    {
+        HPX_TEST_EQ(pp->get_pending_parcels_count(
+            parcelport::parcel_lane_high, false), std::size_t(0));
+        HPX_TEST(pp->get_pending_parcels_count(
+            parcelport::parcel_lane_normal, false) >= num_bulk_parcels);
+    }
+    f.get();
+
+    hpx::wait_all(futures);
+    HPX_TEST_EQ(critical_action()(there), num_bulk_parcels);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+boost::int64_t query_counter(std::string const& name)
+{
+    using hpx::performance_counters::get_counter;
+    using hpx::performance_counters::stubs::performance_counter;
+
+    hpx::naming::id_type id = get_counter(name);
+    return performance_counter::get_value(id).get_value<boost::int64_t>();
+}
+
+void test_counters()
+{
+    std::string type = hpx::parcelset::get_connection_type_name(
+        hpx::get_runtime().get_parcel_handler().here().get_type());
+    boost::uint32_t locality = hpx::get_locality_id();
+
+    // all parcels have been sent, nothing should be left in the queues
+    // besides parcels being sent concurrently by the runtime itself
+    boost::format length("/parcelport{locality#%d/total}/length/%s/send-queue-%s");
+    boost::int64_t normal_length =
+        query_counter(boost::str(length % locality % type % "normal"));
+    boost::int64_t high_length =
+        query_counter(boost::str(length % locality % type % "high"));
+
+    HPX_TEST(normal_length >= 0);
+    HPX_TEST(normal_length < boost::int64_t(num_bulk_parcels));
+    HPX_TEST(high_length >= 0);
+    HPX_TEST(high_length < boost::int64_t(num_bulk_parcels));
+
+    boost::format queue("/parcelqueue{locality#%d/total}/length/send");
+    boost::int64_t queue_length = query_counter(boost::str(queue % locality));
+
+    HPX_TEST(queue_length >= 0);
+    HPX_TEST(queue_length < boost::int64_t(num_bulk_parcels));
+
+    // parcels have been sent through both lanes
+    boost::format time("/parcelport{locality#%d/total}/time/%s/send-queue-%s");
+    boost::int64_t normal_time =
+        query_counter(boost::str(time % locality % type % "normal"));
+    boost::int64_t high_time =
+        query_counter(boost::str(time % locality % type % "high"));
+
+    HPX_TEST(normal_time > 0);
+    HPX_TEST(high_time >= 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main()
+{
+    test_classification();
+
+    std::vector<hpx::id_type> localities = hpx::find_remote_localities();
+    if (localities.empty())
+    {
+        HPX_TEST_MSG(!localities.empty(),
+            "This test must be run on more than one locality");
+    }
+    else
+    {
+        test_overtaking(localities[0]);
+        test_counters();
+    }
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    HPX_TEST_EQ_MSG(hpx::init(argc, argv), 0,
+        "HPX main exited with non-zero status");
+
+    return hpx::util::report_errors();
+}
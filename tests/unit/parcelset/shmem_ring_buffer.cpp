@@ -0,0 +1,174 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Verify that messages of odd sizes pass the ring buffer used by the shared
+// memory parcelport intact, in particular the ones wrapping around at the end
+// of the data area.
+
+#include <hpx/hpx_main.hpp>
+#include <hpx/runtime/parcelset/policies/shmem/ring_buffer.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <new>
+#include <vector>
+
+using hpx::parcelset::policies::shmem::ring_buffer;
+
+std::size_t const capacity = 1024;
+std::size_t const header_size = sizeof(ring_buffer::message_header);
+
+///////////////////////////////////////////////////////////////////////////////
+// the content of a message is derived from its sequence number
+std::vector<char> make_data(std::size_t sequence)
+{
+    std::size_t size = (sequence * 37) % 301;
+    std::vector<char> data(size);
+    for (std::size_t i = 0; i != size; ++i)
+        data[i] = static_cast<char>(sequence + i * 7);
+    return data;
+}
+
+bool push(ring_buffer& rb, std::size_t sequence)
+{
+    std::vector<char> data = make_data(sequence);
+
+    ring_buffer::message_header h;
+    h.reserved_ = 0;
+    h.size_ = data.size();
+
+    // every fifth message refers to separately allocated data
+    if (sequence % 5 == 4)
+    {
+        h.type_ = ring_buffer::message_heap;
+        h.handle_ = static_cast<boost::int64_t>(sequence);
+        return rb.push(h, 0);
+    }
+
+    h.type_ = ring_buffer::message_inline;
+    h.handle_ = 0;
+    return rb.push(h, data.empty() ? 0 : &data[0]);
+}
+
+void pop(ring_buffer& rb, std::size_t sequence)
+{
+    ring_buffer::message_header h;
+    HPX_TEST(rb.front(h));
+
+    std::vector<char> expected = make_data(sequence);
+    HPX_TEST_EQ(h.size_, boost::uint64_t(expected.size()));
+
+    if (sequence % 5 == 4)
+    {
+        HPX_TEST_EQ(h.type_, boost::uint32_t(ring_buffer::message_heap));
+        HPX_TEST_EQ(h.handle_, static_cast<boost::int64_t>(sequence));
+    }
+    else
+    {
+        HPX_TEST_EQ(h.type_, boost::uint32_t(ring_buffer::message_inline));
+
+        std::vector<char> data(expected.size());
+        if (!data.empty())
+            rb.read_data(&data[0], data.size());
+        HPX_TEST(data == expected);
+    }
+
+    rb.pop(h);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void test_wrap_around()
+{
+    // the ring buffer lives in local memory here, the data area follows the
+    // ring buffer object
+    std::vector<boost::uint64_t> storage(
+        (ring_buffer::allocation_size(capacity) + 7) / 8);
+    ring_buffer* rb = new (&storage[0]) ring_buffer(capacity);
+
+    HPX_TEST(rb->empty());
+    HPX_TEST(rb->fits(capacity - header_size));
+    HPX_TEST(!rb->fits(capacity - header_size + 1));
+
+    std::size_t const num_messages = 10000;
+    std::size_t pushed = 0, popped = 0;
+    while (popped != num_messages)
+    {
+        // fill the buffer (up to a varying level), then drain a part of it
+        std::size_t max_push = (pushed % 7) + 1;
+        for (std::size_t i = 0; i != max_push && pushed != num_messages; ++i)
+        {
+            if (!push(*rb, pushed))
+            {
+                // the buffer is full, drain it first
+                HPX_TEST(!rb->empty());
+                break;
+            }
+            ++pushed;
+        }
+
+        std::size_t max_pop = (popped % 3) + 1;
+        for (std::size_t i = 0; i != max_pop && popped != pushed; ++i)
+            pop(*rb, popped++);
+    }
+
+    HPX_TEST(rb->empty());
+    HPX_TEST_EQ(pushed, num_messages);
+
+    rb->~ring_buffer();
+}
+
+void test_full_buffer()
+{
+    std::vector<boost::uint64_t> storage(
+        (ring_buffer::allocation_size(capacity) + 7) / 8);
+    ring_buffer* rb = new (&storage[0]) ring_buffer(capacity);
+
+    // the largest message filling the whole data area
+    std::vector<char> data(capacity - header_size, 'x');
+
+    ring_buffer::message_header h;
+    h.type_ = ring_buffer::message_inline;
+    h.reserved_ = 0;
+    h.size_ = data.size();
+    h.handle_ = 0;
+
+    for (std::size_t i = 0; i != 10; ++i)
+    {
+        // move the position to a different offset in every round, the
+        // records are rounded up to multiples of 8 bytes
+        HPX_TEST(push(*rb, i));
+        pop(*rb, i);
+
+        HPX_TEST(rb->has_space(data.size()));
+        HPX_TEST(rb->push(h, &data[0]));
+
+        // not even an empty message fits anymore
+        HPX_TEST(!rb->has_space(0));
+        HPX_TEST(!push(*rb, 0));
+
+        ring_buffer::message_header r;
+        HPX_TEST(rb->front(r));
+        HPX_TEST_EQ(r.size_, boost::uint64_t(data.size()));
+
+        std::vector<char> result(data.size());
+        rb->read_data(&result[0], result.size());
+        HPX_TEST(result == data);
+
+        rb->pop(r);
+        HPX_TEST(rb->empty());
+    }
+
+    rb->~ring_buffer();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    test_wrap_around();
+    test_full_buffer();
+
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,107 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_main.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+///////////////////////////////////////////////////////////////////////////////
+boost::uint64_t get_deadline()
+{
+    return hpx::threads::get_thread_deadline(hpx::threads::get_self_id());
+}
+
+boost::uint64_t get_nested_deadline()
+{
+    // the deadline is passed on to all descendants
+    return hpx::async(&get_deadline).get();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void test_get_set_deadline()
+{
+    hpx::threads::thread_id_type id = hpx::threads::get_self_id();
+    boost::uint64_t const old_deadline =
+        hpx::threads::get_thread_deadline(id);
+
+    boost::uint64_t const deadline =
+        hpx::util::high_resolution_clock::now() + 1000000000ull;
+
+    hpx::threads::set_thread_deadline(id, deadline);
+    HPX_TEST_EQ(hpx::threads::get_thread_deadline(id), deadline);
+
+    // yielding re-schedules the thread based on its deadline
+    hpx::this_thread::yield();
+    HPX_TEST_EQ(hpx::threads::get_thread_deadline(id), deadline);
+
+    hpx::threads::set_thread_deadline(id, old_deadline);
+    HPX_TEST_EQ(hpx::threads::get_thread_deadline(id), old_deadline);
+}
+
+void test_inherit_deadline()
+{
+    hpx::threads::thread_id_type id = hpx::threads::get_self_id();
+    boost::uint64_t const old_deadline =
+        hpx::threads::get_thread_deadline(id);
+
+    boost::uint64_t const deadline =
+        hpx::util::high_resolution_clock::now() + 1000000000ull;
+    hpx::threads::set_thread_deadline(id, deadline);
+
+    std::vector<hpx::future<boost::uint64_t> > futures;
+    for (std::size_t i = 0; i != 10; ++i)
+    {
+        futures.push_back(hpx::async(&get_deadline));
+        futures.push_back(hpx::async(&get_nested_deadline));
+    }
+
+    for (std::size_t i = 0; i != futures.size(); ++i)
+        HPX_TEST_EQ(futures[i].get(), deadline);
+
+    hpx::threads::set_thread_deadline(id, old_deadline);
+}
+
+void test_missed_deadline()
+{
+    hpx::threads::thread_id_type id = hpx::threads::get_self_id();
+    boost::uint64_t const old_deadline =
+        hpx::threads::get_thread_deadline(id);
+
+    // threads which have missed their deadline are still run
+    hpx::threads::set_thread_deadline(id, 1);
+    HPX_TEST_EQ(hpx::async(&get_deadline).get(), boost::uint64_t(1));
+
+    hpx::threads::set_thread_deadline(id, old_deadline);
+}
+
+void test_invalid_thread_id()
+{
+    hpx::error_code ec(hpx::lightweight);
+    hpx::threads::get_thread_deadline(hpx::threads::invalid_thread_id, ec);
+    HPX_TEST(ec);
+    HPX_TEST_EQ(ec.value(), hpx::null_thread_id);
+
+    ec = hpx::error_code(hpx::lightweight);
+    hpx::threads::set_thread_deadline(hpx::threads::invalid_thread_id, 1, ec);
+    HPX_TEST(ec);
+    HPX_TEST_EQ(ec.value(), hpx::null_thread_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    test_get_set_deadline();
+    test_inherit_deadline();
+    test_missed_deadline();
+    test_invalid_thread_id();
+
+    return hpx::util::report_errors();
+}
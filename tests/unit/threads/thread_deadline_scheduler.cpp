@@ -0,0 +1,121 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test has to be run with --hpx:queuing=deadline on a single worker
+// thread. It verifies that pending threads with a deadline are run in
+// earliest deadline first order and that threads finishing after their
+// deadline are reported by the /threads/count/deadline-misses counter.
+
+#include <hpx/hpx_main.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/lcos/local/spinlock.hpp>
+#include <hpx/util/high_resolution_clock.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/format.hpp>
+#include <boost/cstdint.hpp>
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+boost::int64_t query_deadline_misses()
+{
+    using hpx::performance_counters::get_counter;
+    using hpx::performance_counters::stubs::performance_counter;
+
+    boost::format counter_name(
+        "/threads{locality#%d/total}/count/deadline-misses");
+    hpx::naming::id_type id = get_counter(
+        boost::str(counter_name % hpx::get_locality_id()));
+
+    return performance_counter::get_value(id).get_value<boost::int64_t>();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+hpx::lcos::local::spinlock mtx;
+std::vector<std::size_t> order;
+
+void record(std::size_t i)
+{
+    hpx::lcos::local::spinlock::scoped_lock l(mtx);
+    order.push_back(i);
+}
+
+void noop() {}
+
+///////////////////////////////////////////////////////////////////////////////
+void test_earliest_deadline_first()
+{
+    std::size_t const num_threads = 10;
+
+    hpx::threads::thread_id_type id = hpx::threads::get_self_id();
+    boost::uint64_t const old_deadline =
+        hpx::threads::get_thread_deadline(id);
+
+    boost::int64_t const misses = query_deadline_misses();
+
+    // none of the new threads can run before this thread suspends as there
+    // is only one worker thread, create them with decreasing deadlines (each
+    // new thread inherits the current deadline of this thread)
+    boost::uint64_t const base =
+        hpx::util::high_resolution_clock::now() + 10000000000ull;
+
+    std::vector<hpx::future<void> > futures;
+    for (std::size_t i = 0; i != num_threads; ++i)
+    {
+        hpx::threads::set_thread_deadline(id,
+            base + (num_threads - i) * 1000000ull);
+        futures.push_back(hpx::async(&record, i));
+    }
+    hpx::threads::set_thread_deadline(id, old_deadline);
+
+    hpx::wait_all(futures);
+
+    // the thread created last has the earliest deadline
+    HPX_TEST_EQ(order.size(), num_threads);
+    for (std::size_t i = 0; i != order.size(); ++i)
+        HPX_TEST_EQ(order[i], num_threads - i - 1);
+
+    // all of them finished well before their deadline
+    HPX_TEST_EQ(query_deadline_misses(), misses);
+}
+
+void test_deadline_misses()
+{
+    std::size_t const num_threads = 5;
+
+    hpx::threads::thread_id_type id = hpx::threads::get_self_id();
+    boost::uint64_t const old_deadline =
+        hpx::threads::get_thread_deadline(id);
+
+    boost::int64_t const misses = query_deadline_misses();
+
+    // the deadline of all new threads has passed already
+    hpx::threads::set_thread_deadline(id, 1);
+
+    std::vector<hpx::future<void> > futures;
+    for (std::size_t i = 0; i != num_threads; ++i)
+        futures.push_back(hpx::async(&noop));
+
+    hpx::threads::set_thread_deadline(id, old_deadline);
+
+    hpx::wait_all(futures);
+
+    HPX_TEST_EQ(query_deadline_misses() - misses,
+        static_cast<boost::int64_t>(num_threads));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    HPX_TEST_EQ(hpx::get_os_thread_count(), std::size_t(1));
+
+    test_earliest_deadline_first();
+    test_deadline_misses();
+
+    return hpx::util::report_errors();
+}
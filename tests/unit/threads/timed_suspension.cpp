@@ -0,0 +1,154 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// This test verifies the timed suspension of HPX threads which is based on
+// the per-worker timer wheels: timers must never fire early, timers far in
+// the future have to be cascaded correctly, and threads resumed before their
+// timer expires must not be woken up again.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/include/threads.hpp>
+#include <hpx/include/lcos.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/util/high_resolution_timer.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/format.hpp>
+#include <boost/chrono/chrono.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <vector>
+
+using boost::program_options::variables_map;
+using boost::program_options::options_description;
+using boost::program_options::value;
+
+using hpx::util::high_resolution_timer;
+
+///////////////////////////////////////////////////////////////////////////////
+boost::int64_t query_counter(char const* name)
+{
+    using hpx::performance_counters::get_counter;
+    using hpx::performance_counters::stubs::performance_counter;
+
+    boost::format counter_name("/threads{locality#%d/total}/count/%s");
+    hpx::naming::id_type id = get_counter(
+        boost::str(counter_name % hpx::get_locality_id() % name));
+
+    return performance_counter::get_value(id).get_value<boost::int64_t>();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// returns the time the thread actually slept (in milliseconds)
+double sleep_for(boost::int64_t ms)
+{
+    high_resolution_timer t;
+    hpx::this_thread::sleep_for(boost::chrono::milliseconds(ms));
+    return t.elapsed() * 1e3;
+}
+
+double sleep_until(boost::int64_t ms)
+{
+    high_resolution_timer t;
+    hpx::this_thread::sleep_until(
+        boost::chrono::system_clock::now() + boost::chrono::milliseconds(ms));
+    return t.elapsed() * 1e3;
+}
+
+void test_no_early_wakeup(std::size_t num_threads)
+{
+    std::vector<hpx::future<double> > sleep_for_results;
+    std::vector<hpx::future<double> > sleep_until_results;
+    sleep_for_results.reserve(num_threads);
+    sleep_until_results.reserve(num_threads);
+
+    // spread the deadlines over the first two levels of the wheels
+    for (std::size_t i = 0; i != num_threads; ++i)
+    {
+        boost::int64_t ms = static_cast<boost::int64_t>((i * 37) % 300 + 1);
+        sleep_for_results.push_back(hpx::async(&sleep_for, ms));
+        sleep_until_results.push_back(hpx::async(&sleep_until, ms));
+    }
+
+    for (std::size_t i = 0; i != num_threads; ++i)
+    {
+        double ms = static_cast<double>((i * 37) % 300 + 1);
+        HPX_TEST_LTE(ms, sleep_for_results[i].get());
+
+        // the system clock and the timer clock are not synchronized
+        HPX_TEST_LTE(ms - 1., sleep_until_results[i].get());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// a thread suspended with a long timeout which is resumed early
+hpx::threads::thread_state_ex_enum wait_long(
+    hpx::lcos::local::promise<hpx::threads::thread_id_type>& p)
+{
+    p.set_value(hpx::threads::get_self_id());
+    return hpx::this_thread::suspend(boost::posix_time::seconds(60));
+}
+
+void test_resumed_early()
+{
+    boost::int64_t const cancelled = query_counter("timers-cancelled");
+
+    hpx::lcos::local::promise<hpx::threads::thread_id_type> p;
+    hpx::future<hpx::threads::thread_id_type> f = p.get_future();
+
+    high_resolution_timer t;
+    hpx::future<hpx::threads::thread_state_ex_enum> result =
+        hpx::async(&wait_long, boost::ref(p));
+
+    hpx::threads::thread_id_type id = f.get();
+
+    // wait for the thread to be suspended
+    while (hpx::threads::get_thread_state(id) != hpx::threads::suspended)
+        hpx::this_thread::yield();
+
+    hpx::threads::set_thread_state(id, hpx::threads::pending,
+        hpx::threads::wait_signaled);
+
+    HPX_TEST_EQ(result.get(), hpx::threads::wait_signaled);
+    HPX_TEST_LT(t.elapsed(), 60.);
+
+    // the timer is still armed, it is cancelled once it expires
+    HPX_TEST_EQ(query_counter("timers-cancelled"), cancelled);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int hpx_main(variables_map& vm)
+{
+    std::size_t const num_threads = vm["threads"].as<std::size_t>();
+
+    boost::int64_t const armed = query_counter("timers-armed");
+    boost::int64_t const fired = query_counter("timers-fired");
+
+    test_no_early_wakeup(num_threads);
+
+    HPX_TEST_LTE(armed + boost::int64_t(2 * num_threads),
+        query_counter("timers-armed"));
+    HPX_TEST_LTE(fired + boost::int64_t(2 * num_threads),
+        query_counter("timers-fired"));
+
+    test_resumed_early();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    options_description cmdline("Usage: " HPX_APPLICATION_STRING " [options]");
+
+    cmdline.add_options()
+        ( "threads"
+        , value<std::size_t>()->default_value(1000)
+        , "number of HPX threads sleeping concurrently")
+        ;
+
+    // Initialize and run HPX
+    HPX_TEST_EQ(hpx::init(cmdline, argc, argv), 0);
+    return hpx::util::report_errors();
+}
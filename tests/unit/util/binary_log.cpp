@@ -0,0 +1,87 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/util/binary_log.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/thread/mutex.hpp>
+
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+boost::mutex mtx;
+std::vector<std::string> messages;
+
+void write_messages(unsigned, std::string const& msg)
+{
+    boost::mutex::scoped_lock l(mtx);
+    messages.push_back(msg);
+}
+
+bool ends_with(std::string const& s, std::string const& end)
+{
+    return s.size() >= end.size() &&
+        s.compare(s.size() - end.size(), end.size(), end) == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+#if !defined(HPX_NO_LOGGING)
+    using hpx::util::logging::level::info;
+    using hpx::util::binary_log::get_dropped_records;
+
+    // nothing is recorded as long as the binary log is not started
+    HPX_TEST(!LBIN_ENABLED(debug));
+
+    // records are formatted by the writing thread
+    {
+        hpx::util::binary_log::start(info, 16, &write_messages);
+        HPX_TEST(!LBIN_ENABLED(debug));
+        HPX_TEST(LBIN_ENABLED(info));
+
+        int i = -42;
+        unsigned long u = 42;
+        double d = 1.5;
+        void* p = 0;
+
+        LTM_BIN_(debug)("not recorded");
+        LTM_BIN_(info)("no arguments");
+        LTM_BIN_(info)("int %1%", i);
+        LTM_BIN_(warning)("int %1%, unsigned %2%", i, u);
+        LTM_BIN_(error)("int %1%, unsigned %2%, double %3%", i, u, d);
+        LTM_BIN_(fatal)("%1% %2% %3% %4%", i, u, d, p == 0);
+
+        hpx::util::binary_log::stop();
+        HPX_TEST(!LBIN_ENABLED(info));
+
+        HPX_TEST_EQ(messages.size(), std::size_t(5));
+        HPX_TEST(ends_with(messages[0], "no arguments"));
+        HPX_TEST(ends_with(messages[1], "int -42"));
+        HPX_TEST(ends_with(messages[2], "int -42, unsigned 42"));
+        HPX_TEST(ends_with(messages[3], "int -42, unsigned 42, double 1.5"));
+        HPX_TEST(ends_with(messages[4], "-42 42 1.5 1"));
+        HPX_TEST_EQ(get_dropped_records(true), 0);
+    }
+
+    // records are dropped if the buffer is full, but never lost otherwise
+    {
+        messages.clear();
+        hpx::util::binary_log::start(info, 2, &write_messages);
+
+        for (std::size_t i = 0; i != 1000; ++i)
+            LPT_BIN_(info)("record %1%", i);
+
+        hpx::util::binary_log::stop();
+
+        HPX_TEST_EQ(messages.size() + get_dropped_records(true),
+            std::size_t(1000));
+        HPX_TEST_EQ(get_dropped_records(false), 0);
+    }
+#endif
+
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,115 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/util/component_manifest.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+///////////////////////////////////////////////////////////////////////////////
+void write_file(fs::path const& p, std::string const& content)
+{
+    std::ofstream os(p.string().c_str());
+    os << content;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    fs::path dir = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(dir);
+
+    fs::path manifest_file = dir / "manifest";
+    fs::path module = dir / "libmodule.so";
+    fs::path ini_dir = dir / "ini";
+
+    write_file(module, "module");
+    fs::create_directories(ini_dir);
+
+    std::vector<std::string> ini_data;
+    ini_data.push_back("[hpx.components.module]");
+    ini_data.push_back("name = module");
+    ini_data.push_back("path = " + dir.string());
+
+    std::vector<std::string> ini_files;
+    ini_files.push_back((ini_dir / "module.ini").string());
+
+    // nothing is cached as long as no manifest has been written
+    {
+        hpx::util::component_manifest manifest(manifest_file.string());
+        HPX_TEST(!manifest.load());
+
+        std::vector<std::string> data;
+        HPX_TEST(!manifest.find_module(module, data));
+        HPX_TEST(!manifest.find_directory(ini_dir, data));
+
+        manifest.add_module(module, ini_data);
+        manifest.add_directory(ini_dir, ini_files);
+        HPX_TEST(manifest.save());
+        HPX_TEST(fs::exists(manifest_file));
+    }
+
+    // the cached information is used as long as nothing has changed
+    {
+        hpx::util::component_manifest manifest(manifest_file.string());
+        HPX_TEST(manifest.load());
+
+        std::vector<std::string> data;
+        HPX_TEST(manifest.find_module(module, data));
+        HPX_TEST(data == ini_data);
+
+        data.clear();
+        HPX_TEST(manifest.find_directory(ini_dir, data));
+        HPX_TEST(data == ini_files);
+    }
+
+    // modified modules are not taken from the manifest
+    {
+        write_file(module, "modified module");
+        fs::last_write_time(module, std::time(0) + 10);
+
+        hpx::util::component_manifest manifest(manifest_file.string());
+        HPX_TEST(manifest.load());
+
+        std::vector<std::string> data;
+        HPX_TEST(!manifest.find_module(module, data));
+        HPX_TEST(manifest.find_directory(ini_dir, data));
+    }
+
+    // corrupted manifests are ignored
+    {
+        write_file(manifest_file, "HPXMNFST garbage");
+
+        hpx::util::component_manifest manifest(manifest_file.string());
+        HPX_TEST(!manifest.load());
+
+        std::vector<std::string> data;
+        HPX_TEST(!manifest.find_module(module, data));
+    }
+
+    // an empty file name disables the manifest
+    {
+        hpx::util::component_manifest manifest("");
+        HPX_TEST(!manifest.enabled());
+
+        manifest.add_module(module, ini_data);
+
+        std::vector<std::string> data;
+        HPX_TEST(!manifest.find_module(module, data));
+        HPX_TEST(manifest.save());
+    }
+
+    fs::remove_all(dir);
+
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,160 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/util/connection_pool.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+struct connection
+{
+    explicit connection(int destination)
+      : destination_(destination)
+    {}
+
+    int destination_;
+};
+
+typedef hpx::util::connection_pool<connection, int> pool_type;
+typedef pool_type::connection_type connection_type;
+
+///////////////////////////////////////////////////////////////////////////////
+boost::atomic<std::size_t> checked_out(0);
+boost::atomic<std::size_t> max_checked_out(0);
+
+void use_connections(pool_type& pool, int destination, std::size_t count)
+{
+    for (std::size_t i = 0; i != count; /**/)
+    {
+        connection_type conn;
+        if (!pool.get_or_reserve(destination, conn))
+        {
+            boost::this_thread::yield();
+            continue;
+        }
+
+        if (!conn)
+            conn = boost::make_shared<connection>(destination);
+        HPX_TEST_EQ(conn->destination_, destination);
+
+        std::size_t current = ++checked_out;
+        std::size_t max_current = max_checked_out.load();
+        while (current > max_current &&
+            !max_checked_out.compare_exchange_weak(max_current, current))
+        {}
+
+        --checked_out;
+        pool.reclaim(destination, conn);
+        ++i;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    // connections are reused once they have been returned
+    {
+        pool_type pool(8, 2);
+
+        connection_type c1;
+        HPX_TEST(pool.get_or_reserve(1, c1));
+        HPX_TEST(!c1);
+        c1 = boost::make_shared<connection>(1);
+
+        connection_type c2;
+        HPX_TEST(pool.get_or_reserve(1, c2));
+        HPX_TEST(!c2);
+        c2 = boost::make_shared<connection>(1);
+
+        // the limit per destination has been reached
+        connection_type c3;
+        HPX_TEST(pool.full(1));
+        HPX_TEST(!pool.get_or_reserve(1, c3));
+        HPX_TEST(!pool.get(1));
+
+        // unless a new connection is forced
+        HPX_TEST(pool.get_or_reserve(1, c3, true));
+        HPX_TEST(!c3);
+        c3 = boost::make_shared<connection>(1);
+
+        // the first connection returned exceeds the limit and is dropped
+        pool.reclaim(1, c1);
+        pool.reclaim(1, c2);
+        pool.reclaim(1, c3);
+
+        connection_type c4 = pool.get(1);
+        HPX_TEST(c4 == c2);
+        pool.reclaim(1, c4);
+
+        HPX_TEST_EQ(pool.get_cache_insertions(false), 3);
+        HPX_TEST_EQ(pool.get_cache_reclaims(false), 3);
+        HPX_TEST_EQ(pool.get_cache_evictions(false), 1);
+        HPX_TEST_EQ(pool.get_cache_hits(false), 1);
+        HPX_TEST_EQ(pool.get_cache_misses(true), 2);
+        HPX_TEST_EQ(pool.get_cache_misses(false), 0);
+        HPX_TEST(pool.get_cache_wait_time(false) >= 0);
+
+        // different destinations don't share connections
+        HPX_TEST(!pool.get(2));
+
+        pool.clear(1);
+        HPX_TEST(!pool.get(1));
+        HPX_TEST(!pool.full(1));
+    }
+
+    // idle connections to other destinations are evicted when the overall
+    // limit is reached
+    {
+        pool_type pool(4, 2);
+
+        for (int i = 0; i != 4; ++i)
+        {
+            connection_type conn;
+            HPX_TEST(pool.get_or_reserve(i / 2, conn));
+            HPX_TEST(!conn);
+        }
+        for (int i = 0; i != 4; ++i)
+            pool.reclaim(i / 2, boost::make_shared<connection>(i / 2));
+        HPX_TEST(pool.full());
+
+        connection_type conn;
+        HPX_TEST(pool.get_or_reserve(2, conn));
+        HPX_TEST(!conn);
+        HPX_TEST_EQ(pool.get_cache_evictions(false), 1);
+    }
+
+    // many threads concurrently sending to the same destination can use
+    // several connections in parallel, but never more than allowed
+    {
+        pool_type pool(64, 4);
+
+        std::vector<boost::thread*> threads;
+        for (std::size_t i = 0; i != 8; ++i)
+        {
+            threads.push_back(new boost::thread(
+                boost::bind(&use_connections, boost::ref(pool), 1, 10000)));
+        }
+
+        for (std::size_t i = 0; i != threads.size(); ++i)
+        {
+            threads[i]->join();
+            delete threads[i];
+        }
+
+        HPX_TEST(max_checked_out.load() <= 4);
+        HPX_TEST_EQ(pool.get_cache_hits(false) + pool.get_cache_insertions(false),
+            boost::int64_t(8 * 10000));
+        HPX_TEST_EQ(pool.get_cache_reclaims(false) + pool.get_cache_evictions(false),
+            boost::int64_t(8 * 10000));
+    }
+
+    return hpx::util::report_errors();
+}
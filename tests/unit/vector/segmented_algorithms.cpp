@@ -0,0 +1,162 @@
+//  Copyright (c) 2014 Hartmut Kaiser
+//
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/hpx_main.hpp>
+#include <hpx/components/vector/vector.hpp>
+#include <hpx/components/vector/segmented_iterator.hpp>
+#include <hpx/include/parallel_copy.hpp>
+#include <hpx/include/parallel_count.hpp>
+#include <hpx/include/parallel_fill.hpp>
+#include <hpx/include/parallel_find.hpp>
+#include <hpx/include/parallel_for_each.hpp>
+#include <hpx/include/parallel_reduce.hpp>
+#include <hpx/include/parallel_transform.hpp>
+#include <hpx/util/lightweight_test.hpp>
+
+#define VAL_TYPE double
+
+#define INITIAL_NUM_CHUNKS 10
+#define INITIAL_CHUNK_SIZE 1003
+
+typedef std::size_t size_type;
+
+///////////////////////////////////////////////////////////////////////////////
+struct increment
+{
+    void operator()(double& v) const
+    {
+        v += 1;
+    }
+};
+
+struct is_odd
+{
+    bool operator()(double const& v) const
+    {
+        return static_cast<size_type>(v) % 2 != 0;
+    }
+};
+
+struct maximum
+{
+    double operator()(double const& lhs, double const& rhs) const
+    {
+        return lhs < rhs ? rhs : lhs;
+    }
+};
+
+struct twice
+{
+    double operator()(double const& v) const
+    {
+        return 2 * v;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+void initialize(hpx::vector& v)
+{
+    for (size_type i = 0; i < v.size(); ++i)
+        v.set_value(i, (VAL_TYPE) i);
+}
+
+template <typename ExPolicy>
+void test_segmented_algorithms(ExPolicy const& policy)
+{
+    hpx::vector v(INITIAL_NUM_CHUNKS, INITIAL_CHUNK_SIZE);
+    size_type const size = v.size();
+    initialize(v);
+
+    // for_each
+    hpx::parallel::for_each(policy, v.begin(), v.end(), increment());
+    for (size_type i = 0; i < size; ++i)
+        HPX_TEST_EQ(v.get_value(i), (VAL_TYPE) (i + 1));
+
+    // count and count_if, the range spans partial chunks at both ends
+    hpx::segmented_vector_iterator first = v.begin() + 10;
+    hpx::segmented_vector_iterator last = v.begin() + (size - 10);
+
+    HPX_TEST_EQ(hpx::parallel::count(policy, v.begin(), v.end(),
+        (VAL_TYPE) 42), std::ptrdiff_t(1));
+    HPX_TEST_EQ(hpx::parallel::count(policy, first, last, (VAL_TYPE) 5),
+        std::ptrdiff_t(0));
+    HPX_TEST_EQ(hpx::parallel::count_if(policy, first, last, is_odd()),
+        std::ptrdiff_t((size - 20) / 2));
+
+    // reduce
+    VAL_TYPE const sum = (VAL_TYPE) (size * (size + 1) / 2);
+    HPX_TEST_EQ(hpx::parallel::reduce(policy, v.begin(), v.end()), sum);
+    HPX_TEST_EQ(hpx::parallel::reduce(policy, v.begin(), v.end(),
+        (VAL_TYPE) 0, maximum()), (VAL_TYPE) size);
+
+    // find
+    hpx::segmented_vector_iterator it =
+        hpx::parallel::find(policy, v.begin(), v.end(),
+            (VAL_TYPE) (INITIAL_CHUNK_SIZE + 7));
+    HPX_TEST(it == v.begin() + (INITIAL_CHUNK_SIZE + 6));
+    HPX_TEST(hpx::parallel::find(policy, first, last, (VAL_TYPE) 1) == last);
+
+    // transform and copy, the destination chunks are not aligned with the
+    // source chunks
+    hpx::vector dest(INITIAL_NUM_CHUNKS + 1, INITIAL_CHUNK_SIZE);
+    hpx::segmented_vector_iterator dest_last =
+        hpx::parallel::transform(policy, v.begin(), v.end(),
+            dest.begin() + 500, twice());
+    HPX_TEST(dest_last == dest.begin() + (size + 500));
+    for (size_type i = 0; i < size; ++i)
+        HPX_TEST_EQ(dest.get_value(i + 500), (VAL_TYPE) (2 * (i + 1)));
+
+    dest_last = hpx::parallel::copy(policy, first, last, dest.begin());
+    HPX_TEST(dest_last == dest.begin() + (size - 20));
+    for (size_type i = 0; i < size - 20; ++i)
+        HPX_TEST_EQ(dest.get_value(i), (VAL_TYPE) (i + 11));
+
+    // fill
+    hpx::parallel::fill(policy, first, last, (VAL_TYPE) 0);
+    for (size_type i = 0; i < size; ++i)
+    {
+        if (i < 10 || i >= size - 10)
+            HPX_TEST_EQ(v.get_value(i), (VAL_TYPE) (i + 1));
+        else
+            HPX_TEST_EQ(v.get_value(i), (VAL_TYPE) 0);
+    }
+}
+
+void test_segmented_algorithms_async()
+{
+    using hpx::parallel::task;
+
+    hpx::vector v(INITIAL_NUM_CHUNKS, INITIAL_CHUNK_SIZE);
+    size_type const size = v.size();
+    initialize(v);
+
+    hpx::parallel::for_each(task, v.begin(), v.end(), increment()).get();
+    HPX_TEST_EQ(hpx::parallel::reduce(task, v.begin(), v.end()).get(),
+        (VAL_TYPE) (size * (size + 1) / 2));
+    HPX_TEST_EQ(hpx::parallel::count_if(task, v.begin(), v.end(),
+        is_odd()).get(), std::ptrdiff_t(size / 2));
+
+    hpx::parallel::fill(task, v.begin(), v.end(), (VAL_TYPE) 3).get();
+    HPX_TEST_EQ(hpx::parallel::count(task, v.begin(), v.end(),
+        (VAL_TYPE) 3).get(), std::ptrdiff_t(size));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int main()
+{
+    try
+    {
+        test_segmented_algorithms(hpx::parallel::seq);
+        test_segmented_algorithms(hpx::parallel::par);
+        test_segmented_algorithms_async();
+    }
+    catch(...)
+    {
+        //  Something went wrong in the program
+        HPX_TEST(false);
+    }
+
+    return hpx::util::report_errors();
+}